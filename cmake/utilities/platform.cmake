@@ -1,4 +1,4 @@
-set(BDN_AVAILABLE_PLATFORMS "mac;ios;android" CACHE STRING "List of possible build targets")
+set(BDN_AVAILABLE_PLATFORMS "mac;ios;android;linux" CACHE STRING "List of possible build targets")
 
 # Auto detect target platform
 
@@ -8,6 +8,8 @@ elseif( CMAKE_SYSTEM_NAME STREQUAL "Darwin" )
     set( BDN_DETECTED_TARGET "mac" )
 elseif( ANDROID )
     set( BDN_DETECTED_TARGET "android" )
+elseif( CMAKE_SYSTEM_NAME STREQUAL "Linux" )
+    set( BDN_DETECTED_TARGET "linux" )
 else()
     message(STATUS "Warning, could not autodetect platform!")
 endif()
@@ -28,6 +30,7 @@ set(BDN_NEEDS_TO_BE_STATIC_LIBRARY No)
 set(BDN_PLATFORM_IOS No)
 set(BDN_PLATFORM_OSX No)
 set(BDN_PLATFORM_ANDROID No)
+set(BDN_PLATFORM_LINUX No)
 
 if(BDN_TARGET STREQUAL "ios")
     set( BDN_USES_FK Yes )
@@ -43,6 +46,9 @@ elseif(BDN_TARGET STREQUAL "android")
     set( BDN_PLATFORM_FAMILY "posix")
     set( BDN_NEEDS_TO_BE_SHARED_LIBRARY Yes )
     set( BDN_PLATFORM_ANDROID Yes )
+elseif(BDN_TARGET STREQUAL "linux")
+    set( BDN_PLATFORM_FAMILY "posix")
+    set( BDN_PLATFORM_LINUX Yes )
 endif()
 
 if( "${BDN_PLATFORM_FAMILY}" STREQUAL "posix" )
@@ -86,12 +92,14 @@ set(BDN_NEEDS_TO_BE_STATIC_LIBRARY ${BDN_NEEDS_TO_BE_STATIC_LIBRARY} CACHE INTER
 set(BDN_PLATFORM_IOS            ${BDN_PLATFORM_IOS} CACHE INTERNAL "")
 set(BDN_PLATFORM_OSX            ${BDN_PLATFORM_OSX} CACHE INTERNAL "")
 set(BDN_PLATFORM_ANDROID        ${BDN_PLATFORM_ANDROID} CACHE INTERNAL "")
+set(BDN_PLATFORM_LINUX          ${BDN_PLATFORM_LINUX} CACHE INTERNAL "")
 
 set(BDN_PLATFORM_FAMILY_POSIX   ${BDN_PLATFORM_FAMILY_POSIX} CACHE INTERNAL "")
 
 mark_as_advanced(BDN_PLATFORM_IOS)
 mark_as_advanced(BDN_PLATFORM_OSX)
 mark_as_advanced(BDN_PLATFORM_ANDROID)
+mark_as_advanced(BDN_PLATFORM_LINUX)
 
 mark_as_advanced(BDN_PLATFORM_FAMILY_POSIX)
 
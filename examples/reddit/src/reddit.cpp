@@ -31,38 +31,51 @@ class RedditPost
 class RedditStore
 {
   public:
+    RedditStore()
+    {
+        _listing.field("/title", &Listed::title).field("/url", &Listed::url).field("/thumbnail", &Listed::thumbnail);
+    }
+
     void fetchPosts(const std::function<void()> &doneHandler)
     {
-        net::http::request(
-            {bdn::net::http::Method::GET, "https://www.reddit.com/hot.json?limit=100", [this, doneHandler](auto r) {
-                 try {
-                     json j = json::parse(r->data);
-
-                     for (auto child : j["data"]["children"]) {
-                         auto post = std::make_shared<RedditPost>();
-                         post->title = child["data"]["title"];
-                         post->url = child["data"]["url"];
-
-                         String thumbnail = child["data"]["thumbnail"];
-
-                         if (cpp20::starts_with(thumbnail, "https://")) {
-                             post->thumbnailUrl = thumbnail;
-                         } else {
-                             post->thumbnailUrl =
-                                 "https://www.redditstatic.com/desktop2x/img/favicon/apple-icon-180x180.png";
-                         }
-                         posts.push_back(post);
-                     }
-
-                     doneHandler();
-                 }
-                 catch (const json::parse_error &parseError) {
-                     bdn::logstream() << "Error parsing json: " << parseError.what();
-                 }
-             }});
+        // The listing is parsed on a worker thread while it arrives, only the posts reach the main thread
+        net::http::request(_listing.prepare(
+            net::HTTPRequest("https://www.reddit.com/hot.json?limit=100", nullptr),
+            [this](std::vector<Listed> batch) {
+                for (auto &listed : batch) {
+                    auto post = std::make_shared<RedditPost>();
+                    post->title = listed.title;
+                    post->url = listed.url;
+
+                    if (cpp20::starts_with(listed.thumbnail, "https://")) {
+                        post->thumbnailUrl = listed.thumbnail;
+                    } else {
+                        post->thumbnailUrl =
+                            "https://www.redditstatic.com/desktop2x/img/favicon/apple-icon-180x180.png";
+                    }
+                    posts.push_back(post);
+                }
+            },
+            [doneHandler](auto response, auto parseError) {
+                if (parseError) {
+                    bdn::logstream() << "Error parsing json: " << *parseError;
+                    return;
+                }
+                doneHandler();
+            }));
     }
 
     std::vector<std::shared_ptr<RedditPost>> posts;
+
+  private:
+    struct Listed
+    {
+        String title;
+        String url;
+        String thumbnail;
+    };
+
+    net::JsonStream<Listed> _listing{"/data/children/*/data"};
 };
 
 class RedditListViewDataSource : public ui::ListViewDataSource
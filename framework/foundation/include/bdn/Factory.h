@@ -44,6 +44,14 @@ namespace bdn
             return std::nullopt;
         }
 
+        /** Returns the function registered for name, or nullptr. The pointer stays valid as long
+            as the factory exists. */
+        const ConstructionFunction *constructionFunction(const String &name) const
+        {
+            auto it = _constructionFunctions.find(name);
+            return it != _constructionFunctions.end() ? &it->second : nullptr;
+        }
+
       private:
         std::map<String, ConstructionFunction> _constructionFunctions;
     };
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace bdn
+{
+    /** Non-owning view of a contiguous sequence of objects, a subset of C++20's std::span. */
+    template <class T> class Span
+    {
+      public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using iterator = T *;
+
+      public:
+        constexpr Span() noexcept = default;
+        constexpr Span(T *data, size_t size) noexcept : _data(data), _size(size) {}
+
+        template <class U, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+        constexpr Span(const Span<U> &other) noexcept : _data(other.data()), _size(other.size())
+        {}
+
+      public:
+        constexpr T *data() const noexcept { return _data; }
+        constexpr size_t size() const noexcept { return _size; }
+        constexpr bool empty() const noexcept { return _size == 0; }
+
+        constexpr T &operator[](size_t index) const { return _data[index]; }
+
+        constexpr iterator begin() const noexcept { return _data; }
+        constexpr iterator end() const noexcept { return _data + _size; }
+
+        constexpr Span first(size_t count) const { return Span(_data, count); }
+        constexpr Span subspan(size_t offset) const { return Span(_data + offset, _size - offset); }
+        constexpr Span subspan(size_t offset, size_t count) const { return Span(_data + offset, count); }
+
+      private:
+        T *_data = nullptr;
+        size_t _size = 0;
+    };
+
+    using ByteSpan = Span<const std::byte>;
+
+    inline ByteSpan asBytes(const void *data, size_t size)
+    {
+        return ByteSpan(static_cast<const std::byte *>(data), size);
+    }
+}
@@ -121,6 +121,9 @@ namespace bdn
             }
         }
 
+        /** Drops all bindings in which this property is the target. */
+        void unbind() { _backing->unbind(); }
+
       public:
         auto &onChange() const { return _onChange; }
 
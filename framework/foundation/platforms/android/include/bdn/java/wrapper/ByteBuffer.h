@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bdn/Span.h>
 #include <bdn/java/Env.h>
 #include <bdn/java/wrapper/Object.h>
 
@@ -72,6 +73,26 @@ namespace bdn::java::wrapper
             return bytes;
         }
 
+        /** Returns the referenced memory without copying it, or an empty span if this is null or
+         * not a direct buffer. Only valid as long as the buffer is referenced.*/
+        ByteSpan getBytes_() { return getBytes_(Env::get().getJniEnv(), getJObject_()); }
+
+        /** Like getBytes_(), for a buffer that was passed into a JNI function and has not been
+         * wrapped yet.*/
+        static ByteSpan getBytes_(JNIEnv *env, jobject buffer)
+        {
+            if (buffer == nullptr) {
+                return ByteSpan();
+            }
+
+            void *bytes = env->GetDirectBufferAddress(buffer);
+            int64_t capacity = env->GetDirectBufferCapacity(buffer);
+            if (bytes == nullptr || capacity <= 0) {
+                return ByteSpan();
+            }
+            return asBytes(bytes, static_cast<size_t>(capacity));
+        }
+
         /** Returns the java class object for the Java object's class.
          *
          *  Note that the returned class object is not necessarily unique
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <bdn/ApplicationController.h>
+#include <bdn/genericAppEntry.h>
+#include <bdn/platform/linuxplatform.h>
+
+// There is no native UI toolkit on Linux. UI apps use the headless view cores and run the
+// generic main loop, exactly like commandline apps.
+
+#define BDN_APP_INIT_WITH_CONTROLLER_CREATOR(appControllerCreator)                                                     \
+    int main(int argc, char *argv[])                                                                                   \
+    {                                                                                                                  \
+        bdn::platform::LinuxHooks::init();                                                                             \
+        return bdn::genericCommandLineAppEntry(appControllerCreator, argc, argv);                                      \
+    }
+
+#define BDN_APP_INIT(appControllerClass)                                                                               \
+    BDN_APP_INIT_WITH_CONTROLLER_CREATOR((([]() { return std::make_shared<appControllerClass>(); })))
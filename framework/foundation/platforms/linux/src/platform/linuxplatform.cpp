@@ -0,0 +1,15 @@
+#include <bdn/platform/linuxplatform.h>
+
+#include <iostream>
+
+namespace bdn
+{
+    namespace platform
+    {
+        void LinuxHooks::init() { Hooks::get() = std::make_unique<LinuxHooks>(); }
+
+        void LinuxHooks::debuggerPrint(const bdn::String &text) { std::cerr << text << std::endl; }
+
+        bool LinuxHooks::debuggerPrintGoesToStdErr() { return true; }
+    }
+}
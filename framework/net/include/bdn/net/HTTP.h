@@ -1,10 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 namespace bdn::net
 {
     class HTTPRequest;
+    class HTTPRequestHandle;
     class HTTPResponse;
 
     namespace http
@@ -21,6 +23,44 @@ namespace bdn::net
             CONNECT
         };
 
-        void request(HTTPRequest request);
+        /** Order in which backends start requests that have to wait, e.g. for a free connection. */
+        enum class Priority
+        {
+            Low,
+            Normal,
+            High
+        };
+
+        constexpr const char *methodName(Method method)
+        {
+            switch (method) {
+            case Method::GET:
+                return "GET";
+            case Method::POST:
+                return "POST";
+            case Method::PUT:
+                return "PUT";
+            case Method::DELETE:
+                return "DELETE";
+            case Method::HEAD:
+                return "HEAD";
+            case Method::TRACE:
+                return "TRACE";
+            case Method::OPTIONS:
+                return "OPTIONS";
+            case Method::CONNECT:
+                return "CONNECT";
+            }
+            return "GET";
+        }
+
+        /** Starts the request and returns a handle that cancels it.
+
+            File bodies are streamed from disk, except on Android, where Volley needs the whole body in memory
+            and the file is read completely on its network thread before it is sent. */
+        std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request);
+
+        /** Something that sends requests like request() does, e.g. an HTTPCache layered on top of it. */
+        using Transport = std::function<std::shared_ptr<HTTPRequestHandle>(HTTPRequest)>;
     }
 }
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <bdn/String.h>
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPRequestHandle.h>
+
+#include <memory>
+
+namespace bdn::net
+{
+    namespace detail
+    {
+        class HTTPCacheStore;
+    }
+
+    /** Private HTTP cache (RFC 7234) in front of http::request().
+
+        Responses to GET requests are kept in memory and, if Configuration::directory is set, on disk, where
+        they are read through memory mappings. Fresh responses are answered from the cache. Stale responses
+        with an ETag or Last-Modified field are revalidated with a conditional request, and a 304 answer
+        reuses the stored body. Stale responses whose Cache-Control allows stale-while-revalidate (RFC 5861)
+        are answered from the cache right away and revalidated in the background.
+
+        Responses to other methods pass through, and successful ones remove the stored response of their
+        URL. Requests with their own If-None-Match or If-Modified-Since field bypass the cache.
+
+        Answers from the cache are delivered on the application's dispatch queue, like those of
+        http::request(). A dataHandler receives the stored body as a single chunk.
+    */
+    class HTTPCache
+    {
+      public:
+        using Transport = http::Transport;
+
+        struct Configuration
+        {
+            size_t memoryCapacity = 8 * 1024 * 1024;
+
+            /** Directory of the disk tier, which is disabled if empty. It is created if necessary. */
+            String directory;
+            size_t diskCapacity = 64 * 1024 * 1024;
+
+            /** Responses with larger bodies are not stored. */
+            size_t maxBodySize = 4 * 1024 * 1024;
+
+            /** Sends the requests that the cache cannot answer. Defaults to http::request(). */
+            Transport transport;
+        };
+
+        struct Statistics
+        {
+            size_t hits = 0;          // answered from the cache without waiting, stale or not
+            size_t misses = 0;        // sent without a usable stored response
+            size_t revalidations = 0; // conditional requests, including background ones
+            size_t notModified = 0;   // revalidations answered with 304
+            size_t bytesSaved = 0;    // stored body bytes delivered for hits and 304 answers
+
+            size_t memorySize = 0;
+            size_t diskSize = 0;
+        };
+
+      public:
+        HTTPCache();
+        explicit HTTPCache(Configuration configuration);
+
+        /** Waits until pending disk writes are done. */
+        ~HTTPCache();
+
+        HTTPCache(const HTTPCache &) = delete;
+        HTTPCache &operator=(const HTTPCache &) = delete;
+
+      public:
+        /** Like http::request(), but answered from the cache where possible. Can be called from any thread. */
+        std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request);
+
+        Statistics statistics() const;
+
+        /** Removes all stored responses, from memory and from disk. */
+        void clear();
+
+      private:
+        std::shared_ptr<detail::HTTPCacheStore> _store;
+    };
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <bdn/String.h>
+
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+
+namespace bdn::net
+{
+    /** Header fields of an HTTP request or response, in the order they were added.
+
+        Field names are compared case insensitively. The fields are kept as a single string in their wire
+        format, "Name: value\r\n" lines, which lookups scan. A header therefore needs at most one allocation
+        however many fields it has, none if it fits into the string's small string optimisation, and
+        toString() does not copy anything.
+    */
+    class HTTPHeader
+    {
+      public:
+        struct Field
+        {
+            StringView name;
+            StringView value;
+        };
+
+        class Iterator
+        {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Field;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Field;
+
+          public:
+            explicit Iterator(StringView remaining) : _remaining(remaining) {}
+
+            Field operator*() const;
+            Iterator &operator++();
+            bool operator==(const Iterator &other) const { return _remaining.data() == other._remaining.data(); }
+            bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+          private:
+            StringView _remaining;
+        };
+
+      public:
+        HTTPHeader() = default;
+        HTTPHeader(std::initializer_list<Field> fields);
+
+        /** Parses "Name: value" lines separated by "\r\n" or "\n". Lines without a name and values
+            containing a bare "\r" are skipped, parse() never throws. */
+        static HTTPHeader parse(StringView text);
+
+        /** Compares field names, or values that are case insensitive tokens such as "close". */
+        static bool equalsIgnoreCase(StringView a, StringView b);
+
+      public:
+        /** Value of the first field called name. */
+        std::optional<StringView> get(StringView name) const;
+
+        /** Values of all fields called name, joined with ", " as RFC 7230, section 3.2.2 allows. */
+        std::optional<String> combined(StringView name) const;
+
+        bool contains(StringView name) const { return get(name).has_value(); }
+
+        /** Adds a field after the existing ones, also if there are fields with the same name. Throws
+            std::invalid_argument if the name is not a token or the value contains a line break. */
+        void add(StringView name, StringView value);
+
+        /** Replaces all fields called name with a single one at the end. */
+        void set(StringView name, StringView value);
+
+        /** Removes all fields called name and returns their number. */
+        size_t remove(StringView name);
+
+        void clear() { _text.clear(); }
+
+        bool empty() const { return _text.empty(); }
+        size_t size() const;
+
+        Iterator begin() const { return Iterator(_text); }
+        Iterator end() const { return Iterator(StringView(_text).substr(_text.size())); }
+
+        /** The fields as "Name: value\r\n" lines. */
+        const String &toString() const { return _text; }
+
+        bool operator==(const HTTPHeader &other) const { return _text == other._text; }
+        bool operator!=(const HTTPHeader &other) const { return _text != other._text; }
+
+      private:
+        String _text;
+    };
+}
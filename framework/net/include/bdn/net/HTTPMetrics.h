@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace bdn::net
+{
+    /** Where the time of a request went and how many bytes it moved, as far as the backend can tell.
+
+        Phases that did not happen, e.g. connecting on a reused connection, and phases the backend cannot
+        measure are zero. Responses that did not come from the network, e.g. from an HTTPCache, have no
+        metrics at all.
+    */
+    class HTTPMetrics
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+        using Duration = std::chrono::microseconds;
+
+      public:
+        /** When the backend started the request. */
+        Clock::time_point startTime;
+
+        Duration dnsLookup{};
+
+        /** Establishing the TCP connection, without tlsHandshake. */
+        Duration connect{};
+        Duration tlsHandshake{};
+
+        /** From sending the first byte of the request until the first byte of the response arrived. */
+        Duration timeToFirstByte{};
+
+        /** From the first until the last byte of the response. */
+        Duration transfer{};
+
+        /** From startTime until the response was complete, including the time spent waiting for a
+            connection. */
+        Duration total{};
+
+        /** Including the request and response heads where the backend can count them. bytesReceived
+            counts the body as it was transferred, before any Content-Encoding was decoded. */
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+
+        bool reusedConnection = false;
+
+        /** The request was cancelled before its response was delivered. */
+        bool cancelled = false;
+    };
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+
+namespace bdn::net
+{
+    class HTTPRequest;
+    class HTTPResponse;
+
+    /** Notified of the requests of every backend, e.g. to record latencies in a dashboard.
+
+        Every requestStarted() is followed by exactly one requestFinished(), also for requests that fail
+        or are cancelled. The calls can come from any thread and must return quickly, they hold up the
+        network or the main thread.
+    */
+    class HTTPObserver
+    {
+      public:
+        virtual ~HTTPObserver() = default;
+
+      public:
+        /** Called when the backend accepted the request. */
+        virtual void requestStarted(const HTTPRequest &request) = 0;
+
+        /** Called on the main thread before the request's doneHandler, with HTTPResponse::metrics filled
+            in. Failed requests have a responseCode of 0 or less. Cancelled requests have
+            HTTPMetrics::cancelled set, their doneHandler is not called. */
+        virtual void requestFinished(const HTTPResponse &response) = 0;
+    };
+
+    namespace http
+    {
+        /** Sets the observer of all requests started from now on, or removes it if observer is null. Can be
+            called from any thread. */
+        void setObserver(std::shared_ptr<HTTPObserver> observer);
+
+        std::shared_ptr<HTTPObserver> observer();
+    }
+
+    namespace detail
+    {
+        /** Passes the events of a backend to the observer that was set when the request started. */
+        class HTTPObservation
+        {
+          public:
+            /** Notifies http::observer() of the start of request. */
+            explicit HTTPObservation(const HTTPRequest &request);
+
+          public:
+            /** Notifies the observer, if this was not called before. */
+            void finished(const HTTPResponse &response);
+
+          private:
+            std::shared_ptr<HTTPObserver> _observer;
+        };
+    }
+}
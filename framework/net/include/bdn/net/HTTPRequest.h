@@ -1,11 +1,13 @@
 #pragma once
 
+#include <bdn/Span.h>
 #include <bdn/String.h>
 #include <bdn/net/HTTP.h>
+#include <bdn/net/HTTPHeader.h>
+#include <bdn/net/HTTPRequestBody.h>
 #include <bdn/property/Property.h>
 
-#include <utility>
-
+#include <chrono>
 #include <utility>
 
 namespace bdn::net
@@ -16,14 +18,36 @@ namespace bdn::net
     {
       public:
         using DoneHandler = std::function<void(std::shared_ptr<HTTPResponse>)>;
+        using DataHandler = std::function<void(ByteSpan chunk)>;
 
       public:
         http::Method method{bdn::net::http::Method::GET};
         String url;
-        String header;
+        HTTPHeader header;
+
+        /** Sent with Content-Length set to its size. Backends that cannot stream from files read them
+            completely before sending, see http::request(). */
+        HTTPRequestBody body;
+
+        http::Priority priority{http::Priority::Normal};
+
+        /** Time allowed for establishing a connection, or 0 for the backend's default. */
+        std::chrono::milliseconds connectTimeout{0};
+
+        /** Time allowed for the whole request including the body, or 0 for no limit. Requests that time
+            out are answered like requests that got no response at all. */
+        std::chrono::milliseconds timeout{0};
 
         DoneHandler doneHandler;
 
+        /** If set, the response body is passed to dataHandler in chunks as it arrives instead of being
+            collected in HTTPResponse::data, so that it can be processed without holding all of it in memory.
+
+            Chunks are passed in order, on a thread chosen by the backend, and are only valid during the call.
+            doneHandler is called after the last chunk. If the request fails after some chunks were passed,
+            the response given to doneHandler has a responseCode of 0. */
+        DataHandler dataHandler;
+
       public:
         HTTPRequest() = default;
         HTTPRequest(String requestUrl, DoneHandler requestDoneHandler)
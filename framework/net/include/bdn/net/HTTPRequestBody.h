@@ -0,0 +1,55 @@
+#pragma once
+
+#include <bdn/String.h>
+
+#include <memory>
+
+namespace bdn::net
+{
+    /** Body sent with an HTTPRequest, e.g. for POST or PUT.
+
+        Bytes are shared, not copied, when the request is copied. A file is read while the request is being
+        sent, so that uploads do not have to fit into memory. Requests whose file cannot be read fail like
+        requests that got no response at all.
+    */
+    class HTTPRequestBody
+    {
+      public:
+        HTTPRequestBody() = default;
+
+        static HTTPRequestBody fromBytes(String bytes)
+        {
+            return fromBytes(std::make_shared<const String>(std::move(bytes)));
+        }
+
+        static HTTPRequestBody fromBytes(std::shared_ptr<const String> bytes)
+        {
+            HTTPRequestBody body;
+            body._bytes = std::move(bytes);
+            return body;
+        }
+
+        static HTTPRequestBody fromFile(String path)
+        {
+            HTTPRequestBody body;
+            body._path = std::move(path);
+            return body;
+        }
+
+      public:
+        /** True if there is nothing to send, neither bytes nor a file. */
+        bool empty() const { return _path.empty() && (!_bytes || _bytes->empty()); }
+
+        bool isFile() const { return !_path.empty(); }
+
+        /** The bytes to send, or nullptr for file bodies. */
+        const std::shared_ptr<const String> &bytes() const { return _bytes; }
+
+        /** The path of the file to send, or empty. */
+        const String &path() const { return _path; }
+
+      private:
+        std::shared_ptr<const String> _bytes;
+        String _path;
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+
+namespace bdn::net
+{
+    /** Returned by http::request(), to cancel requests that are no longer needed, e.g. for content that
+        scrolled out of view.
+
+        Once cancelled, the backend stops transferring the request as soon as possible. The dataHandler
+        receives no more chunks after the backend noticed the cancellation. The doneHandler is not called
+        at all if cancel() was called on the main thread before the response was delivered.
+    */
+    class HTTPRequestHandle
+    {
+      public:
+        virtual ~HTTPRequestHandle() = default;
+
+      public:
+        /** Can be called on any thread, and more than once. */
+        void cancel()
+        {
+            if (!_cancelled.exchange(true)) {
+                abort();
+            }
+        }
+
+        bool isCancelled() const { return _cancelled; }
+
+      protected:
+        /** Called by the first call of cancel(), to stop the transfer. */
+        virtual void abort() {}
+
+      private:
+        std::atomic<bool> _cancelled{false};
+    };
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <bdn/net/HTTPMetrics.h>
 #include <bdn/net/HTTPRequest.h>
 
+#include <memory>
+
 namespace bdn::net
 {
     class HTTPResponse
@@ -10,9 +13,20 @@ namespace bdn::net
         HTTPRequest originalRequest;
 
         String url;
-        String header;
+        HTTPHeader header;
         String data;
 
+        /** Body that is shared with the responses of other requests instead of being copied into data, e.g.
+            by HTTPSingleFlight. data is empty if this is set. */
+        std::shared_ptr<const String> sharedData;
+
         int responseCode{};
+
+        /** Filled in by the backend that sent the request. */
+        HTTPMetrics metrics;
+
+      public:
+        /** The body, from data or sharedData. */
+        StringView body() const { return sharedData ? StringView(*sharedData) : StringView(data); }
     };
 }
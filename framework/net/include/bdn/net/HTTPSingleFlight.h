@@ -0,0 +1,53 @@
+#pragma once
+
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPRequestHandle.h>
+
+#include <memory>
+
+namespace bdn::net
+{
+    namespace detail
+    {
+        class HTTPSingleFlightGroup;
+    }
+
+    /** Sends identical GET and HEAD requests only once while they are in flight.
+
+        Requests with the same method, URL (without fragment) and header as a request that is still in flight
+        are attached to it instead of being sent. Its response is delivered to the doneHandler of every attached
+        request, each with its own HTTPResponse. If there is more than one, the body is shared immutably through
+        HTTPResponse::sharedData instead of being copied for each of them.
+
+        Cancelling one of the attached requests only detaches it. The request in flight is cancelled when all
+        of them are. Other methods and requests with a dataHandler are passed through unchanged.
+
+        To de-duplicate the requests of an HTTPCache, use the single flight as its transport.
+    */
+    class HTTPSingleFlight
+    {
+      public:
+        struct Statistics
+        {
+            size_t requests = 0; // sent through the transport
+            size_t attached = 0; // attached to a request in flight instead
+        };
+
+      public:
+        /** transport defaults to http::request(). */
+        explicit HTTPSingleFlight(http::Transport transport = nullptr);
+        ~HTTPSingleFlight();
+
+        HTTPSingleFlight(const HTTPSingleFlight &) = delete;
+        HTTPSingleFlight &operator=(const HTTPSingleFlight &) = delete;
+
+      public:
+        /** Like http::request(). Can be called from any thread. */
+        std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request);
+
+        Statistics statistics() const;
+
+      private:
+        std::shared_ptr<detail::HTTPSingleFlightGroup> _group;
+    };
+}
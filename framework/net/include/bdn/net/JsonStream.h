@@ -0,0 +1,195 @@
+#pragma once
+
+#include <bdn/String.h>
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPResponse.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace bdn::net
+{
+    namespace detail
+    {
+        /** A scalar JSON value, as passed to the fields of a JsonStream. */
+        using JsonValue = std::variant<std::nullptr_t, bool, int64_t, uint64_t, double, String>;
+
+        /** The typed half of a JsonStream, called on the parse thread. */
+        class JsonRecordBuilder
+        {
+          public:
+            virtual ~JsonRecordBuilder() = default;
+
+            virtual void begin() = 0;
+            virtual void set(size_t field, JsonValue &value) = 0;
+
+            /** Completes the record and returns pending(). Records that were begun but not ended, because
+                the document ended early, are dropped. */
+            virtual size_t end() = 0;
+
+            /** Number of records completed since the last takeBatch(). */
+            virtual size_t pending() const = 0;
+
+            /** Returns a function that passes the records built so far to the batch handler. */
+            virtual std::function<void()> takeBatch() = 0;
+        };
+
+        using JsonStreamDoneHandler =
+            std::function<void(std::shared_ptr<HTTPResponse> response, std::optional<String> parseError)>;
+
+        /** Sets the request's dataHandler and doneHandler up to parse the body on a thread of its own. */
+        HTTPRequest streamJson(HTTPRequest request, const String &recordPath, const std::vector<String> &fieldPaths,
+                               size_t batchSize, std::unique_ptr<JsonRecordBuilder> builder,
+                               JsonStreamDoneHandler onDone);
+
+        template <class T> struct IsOptional : std::false_type
+        {};
+        template <class T> struct IsOptional<std::optional<T>> : std::true_type
+        {};
+
+        /** Returns false and leaves target as it is if the value has another type, except that numbers
+            are converted. */
+        template <class T> bool assignJsonValue(T &target, JsonValue &value)
+        {
+            if constexpr (IsOptional<T>::value) {
+                if (std::holds_alternative<std::nullptr_t>(value)) {
+                    target.reset();
+                    return true;
+                }
+                typename T::value_type assigned{};
+                if (!assignJsonValue(assigned, value)) {
+                    return false;
+                }
+                target = std::move(assigned);
+                return true;
+            } else if constexpr (std::is_same_v<T, String>) {
+                auto string = std::get_if<String>(&value);
+                if (string != nullptr) {
+                    target = std::move(*string);
+                }
+                return string != nullptr;
+            } else if constexpr (std::is_same_v<T, bool>) {
+                auto boolean = std::get_if<bool>(&value);
+                if (boolean != nullptr) {
+                    target = *boolean;
+                }
+                return boolean != nullptr;
+            } else {
+                static_assert(std::is_arithmetic_v<T>,
+                              "JsonStream fields must be Strings, booleans, numbers or std::optionals of those");
+                return std::visit(
+                    [&target](auto &scalar) {
+                        using Scalar = std::decay_t<decltype(scalar)>;
+                        if constexpr (std::is_arithmetic_v<Scalar> && !std::is_same_v<Scalar, bool>) {
+                            target = static_cast<T>(scalar);
+                            return true;
+                        } else {
+                            return false;
+                        }
+                    },
+                    value);
+            }
+        }
+    }
+
+    /** Parses JSON responses while they arrive and extracts typed records from them, without building
+        the whole document in memory.
+
+        Records are selected by a JSON pointer (RFC 6901) in which the reference token "*" matches every
+        element of an array or every member of an object. Their fields are JSON pointers relative to the
+        record, the empty pointer being the record itself. Only scalar values are extracted, everything
+        else in the document is parsed but skipped.
+
+        Each response is parsed on a thread of its own, which only lives as long as the response.
+    */
+    template <class Record> class JsonStream
+    {
+      public:
+        /** Called on the main thread with the records in the order they appear in the document. */
+        using BatchHandler = std::function<void(std::vector<Record> records)>;
+
+        /** Called on the main thread after the last batch. parseError is set if the body was not valid
+            JSON, which includes failed requests, whose body is empty. */
+        using DoneHandler = detail::JsonStreamDoneHandler;
+
+      public:
+        explicit JsonStream(String recordPath) : _recordPath(std::move(recordPath)) {}
+
+      public:
+        /** Extracts the value at path into member. Members can be Strings, booleans, numbers, or
+            std::optionals of those, which null resets. Values of another type are ignored. */
+        template <class T> JsonStream &field(String path, T Record::*member)
+        {
+            _fieldPaths.push_back(std::move(path));
+            _setters.push_back(
+                [member](Record &record, detail::JsonValue &value) { detail::assignJsonValue(record.*member, value); });
+            return *this;
+        }
+
+        /** Number of records passed to the BatchHandler at once, except for the last batch. */
+        JsonStream &batchSize(size_t size)
+        {
+            _batchSize = std::max<size_t>(size, 1);
+            return *this;
+        }
+
+        /** Returns the request with its dataHandler and doneHandler replaced, ready to be sent, e.g. with
+            http::request(). The stream can prepare any number of requests. Throws std::invalid_argument
+            if the record path or a field path is not a JSON pointer. */
+        HTTPRequest prepare(HTTPRequest request, BatchHandler onBatch, DoneHandler onDone) const
+        {
+            return detail::streamJson(std::move(request), _recordPath, _fieldPaths, _batchSize,
+                                      std::make_unique<Builder>(_setters, std::move(onBatch)), std::move(onDone));
+        }
+
+      private:
+        using Setter = std::function<void(Record &, detail::JsonValue &)>;
+
+        class Builder : public detail::JsonRecordBuilder
+        {
+          public:
+            Builder(std::vector<Setter> setters, BatchHandler onBatch)
+                : _setters(std::move(setters)), _onBatch(std::move(onBatch))
+            {}
+
+            void begin() override { _record = Record(); }
+            void set(size_t field, detail::JsonValue &value) override { _setters[field](_record, value); }
+
+            size_t end() override
+            {
+                _records.push_back(std::move(_record));
+                return _records.size();
+            }
+
+            size_t pending() const override { return _records.size(); }
+
+            std::function<void()> takeBatch() override
+            {
+                return [onBatch = _onBatch, records = std::exchange(_records, {})]() mutable {
+                    if (onBatch) {
+                        onBatch(std::move(records));
+                    }
+                };
+            }
+
+          private:
+            std::vector<Setter> _setters;
+            BatchHandler _onBatch;
+            Record _record;
+            std::vector<Record> _records;
+        };
+
+      private:
+        String _recordPath;
+        std::vector<String> _fieldPaths;
+        std::vector<Setter> _setters;
+        size_t _batchSize = 64;
+    };
+}
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <bdn/java/wrapper/ByteBuffer.h>
 #include <bdn/java/wrapper/Object.h>
 #include <bdn/java/wrapper/String.h>
 #include <bdn/net/HTTP.h>
+#include <bdn/net/HTTPRequestHandle.h>
 
 #include <functional>
 
@@ -14,6 +16,16 @@ namespace bdn
         {
             namespace android
             {
+                constexpr char kFullRequestClassName[] = "io/boden/java/FullRequest";
+
+                class JFullRequest : public java::wrapper::JTObject<kFullRequestClassName>
+                {
+                  public:
+                    using JTObject<kFullRequestClassName>::JTObject;
+
+                    JavaMethod<void()> cancel{this, "cancel"};
+                };
+
                 constexpr char kVolleyAdapterClassName[] = "io/boden/java/VolleyAdapter";
 
                 class JVolleyAdapter : public java::wrapper::JTObject<kVolleyAdapterClassName>
@@ -21,7 +33,12 @@ namespace bdn
                   public:
                     using JTObject<kVolleyAdapterClassName>::JTObject;
 
-                    JavaMethod<void(int, String, std::shared_ptr<bdn::net::HTTPResponse>)> request{this, "request"};
+                    /** Returns the FullRequest. The header is passed as "Name: value\r\n" lines, the body either
+                        as a direct ByteBuffer or as the path of a file. The handle is passed back to
+                        handleResponse(). */
+                    JavaMethod<JavaObject(int, String, String, java::wrapper::ByteBuffer, String, int, int,
+                                          std::shared_ptr<bdn::net::HTTPRequestHandle>)>
+                        request{this, "request"};
 
                     static constexpr int toVolleyRequestMethod(bdn::net::http::Method bdnHttpMethod)
                     {
@@ -45,6 +62,19 @@ namespace bdn
                         }
                         return -1;
                     }
+
+                    static constexpr int toVolleyPriority(bdn::net::http::Priority priority)
+                    {
+                        switch (priority) {
+                        case bdn::net::http::Priority::Low:
+                            return 0;
+                        case bdn::net::http::Priority::Normal:
+                            return 1;
+                        case bdn::net::http::Priority::High:
+                            return 2;
+                        }
+                        return 1;
+                    }
                 };
             }
         }
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <bdn/Span.h>
+#include <bdn/jni.h>
+#include <bdn/net/HTTPResponse.h>
+
+namespace bdn::net::http::android
+{
+    /** Copies the modified UTF-8 representation of string and releases it again. */
+    inline String utfString(JNIEnv *env, jstring string)
+    {
+        if (string == nullptr) {
+            return String();
+        }
+
+        const char *chars = env->GetStringUTFChars(string, nullptr);
+        if (chars == nullptr) {
+            return String();
+        }
+        String result(chars);
+        env->ReleaseStringUTFChars(string, chars);
+        return result;
+    }
+
+    /** Fills response with the arguments of VolleyAdapter.handleResponse().
+
+        bytes are the contents of the direct ByteBuffer Volley passes the body in, see
+        java::wrapper::ByteBuffer::getBytes_(). They are passed to the request's dataHandler as they
+        are, or copied into HTTPResponse::data without any character conversion, so binary bodies
+        arrive intact. They are all that HTTPMetrics::bytesReceived counts, Volley does not report
+        the head. */
+    inline void fillResponse(JNIEnv *env, HTTPResponse &response, jint statusCode, ByteSpan bytes, jstring headers)
+    {
+        response.responseCode = statusCode;
+        response.header = HTTPHeader::parse(utfString(env, headers));
+
+        response.metrics.bytesReceived = bytes.size();
+        if (response.originalRequest.dataHandler) {
+            if (!bytes.empty()) {
+                response.originalRequest.dataHandler(bytes);
+            }
+        } else {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            response.data.assign(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        }
+    }
+}
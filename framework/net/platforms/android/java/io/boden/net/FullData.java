@@ -1,8 +1,10 @@
 package io.boden.java;
 
+import java.nio.ByteBuffer;
 
 public class FullData {
     public int statusCode;
     public String headers;
-    public String data;
+    /** Direct buffer, so that native code can access the body without copying or converting it. */
+    public ByteBuffer data;
 }
@@ -2,16 +2,21 @@ package io.boden.java;
 
 import androidx.annotation.GuardedBy;
 import androidx.annotation.Nullable;
+import com.android.volley.AuthFailureError;
 import com.android.volley.NetworkResponse;
 import com.android.volley.Request;
 import com.android.volley.Response;
 import com.android.volley.Response.ErrorListener;
 import com.android.volley.Response.Listener;
 import com.android.volley.toolbox.HttpHeaderParser;
-import java.io.UnsupportedEncodingException;
+import java.io.File;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.nio.ByteBuffer;
+import java.util.LinkedHashMap;
 import java.util.Map;
 
-/** A canned request for retrieving the response body at a given URL as a String. */
+/** A canned request for retrieving the response body at a given URL as a direct ByteBuffer. */
 public class FullRequest extends Request<FullData> {
 
     /** Lock to guard mListener as it is cleared on cancel() and read on delivery. */
@@ -21,12 +26,22 @@ public class FullRequest extends Request<FullData> {
     @GuardedBy("mLock")
     private Listener<FullData> mListener;
 
+    private Priority mPriority = Priority.NORMAL;
+
+    private final Map<String, String> mHeaders = new LinkedHashMap<>();
+
+    @Nullable
+    private ByteBuffer mBody;
+
+    @Nullable
+    private String mBodyFile;
+
     /**
      * Creates a new request with the given method.
      *
      * @param method the request {@link Method} to use
      * @param url URL to fetch the string at
-     * @param listener Listener to receive the String response
+     * @param listener Listener to receive the response
      * @param errorListener Error listener, or null to ignore errors
      */
     public FullRequest(
@@ -42,7 +57,7 @@ public class FullRequest extends Request<FullData> {
      * Creates a new GET request.
      *
      * @param url URL to fetch the string at
-     * @param listener Listener to receive the String response
+     * @param listener Listener to receive the response
      * @param errorListener Error listener, or null to ignore errors
      */
     public FullRequest(
@@ -50,6 +65,78 @@ public class FullRequest extends Request<FullData> {
         this(Method.GET, url, listener, errorListener);
     }
 
+    /** Sets the order in which the queue starts waiting requests. */
+    public void setPriority(Priority priority) {
+        mPriority = priority;
+    }
+
+    @Override
+    public Priority getPriority() {
+        return mPriority;
+    }
+
+    /** Sets the header fields from "Name: value" lines. Repeated fields are joined with commas. */
+    public void setHeaders(String headers) {
+        mHeaders.clear();
+        for (String line : headers.split("\r?\n")) {
+            int colon = line.indexOf(':');
+            if (colon <= 0) {
+                continue;
+            }
+            String name = line.substring(0, colon).trim();
+            String value = line.substring(colon + 1).trim();
+            String previous = mHeaders.get(name);
+            mHeaders.put(name, previous != null ? previous + ", " + value : value);
+        }
+    }
+
+    /**
+     * Sets the body to send, either the contents of a direct buffer or of a file.
+     *
+     * @param body the bytes to send, or null
+     * @param bodyFile path of a file to send instead, or null or empty
+     */
+    public void setBody(@Nullable ByteBuffer body, @Nullable String bodyFile) {
+        mBody = body;
+        mBodyFile = bodyFile != null && !bodyFile.isEmpty() ? bodyFile : null;
+    }
+
+    @Override
+    public Map<String, String> getHeaders() {
+        return mHeaders;
+    }
+
+    @Override
+    public String getBodyContentType() {
+        for (Map.Entry<String, String> entry : mHeaders.entrySet()) {
+            if (entry.getKey().equalsIgnoreCase("Content-Type")) {
+                return entry.getValue();
+            }
+        }
+        return "application/octet-stream";
+    }
+
+    /** Called on a network thread. Volley needs the whole body as an array, so files are read completely. */
+    @Override
+    public byte[] getBody() throws AuthFailureError {
+        if (mBodyFile != null) {
+            try (RandomAccessFile file = new RandomAccessFile(new File(mBodyFile), "r")) {
+                byte[] bytes = new byte[(int) file.length()];
+                file.readFully(bytes);
+                return bytes;
+            } catch (IOException e) {
+                // The only error Volley lets getBody() report. It is delivered like other failed requests.
+                throw new AuthFailureError("Cannot read request body from " + mBodyFile, e);
+            }
+        }
+        if (mBody != null) {
+            byte[] bytes = new byte[mBody.capacity()];
+            mBody.duplicate().get(bytes);
+            return bytes;
+        }
+        return null;
+    }
+
     @Override
     public void cancel() {
         super.cancel();
@@ -70,27 +157,28 @@ public class FullRequest extends Request<FullData> {
     }
 
     @Override
-    @SuppressWarnings("DefaultCharset")
     protected Response<FullData> parseNetworkResponse(NetworkResponse response) {
+        return Response.success(toFullData(response), HttpHeaderParser.parseCacheHeaders(response));
+    }
+
+    /** Converts a response without interpreting its body, which may be binary. */
+    public static FullData toFullData(NetworkResponse response) {
         FullData result = new FullData();
         result.statusCode = response.statusCode;
 
-        String parsed;
-        try {
-            parsed = new String(response.data, HttpHeaderParser.parseCharset(response.headers));
-        } catch (UnsupportedEncodingException e) {
-            // Since minSdkVersion = 8, we can't call
-            // new String(response.data, Charset.defaultCharset())
-            // So suppress the warning instead.
-            parsed = new String(response.data);
-        }
+        byte[] body = response.data != null ? response.data : new byte[0];
+        result.data = ByteBuffer.allocateDirect(body.length);
+        result.data.put(body);
+        result.data.flip();
 
-        result.data = parsed;
-        result.headers = "";
-        for (Map.Entry<String, String> entry : response.headers.entrySet()) {
-            result.headers += entry.getKey() + ": " + entry.getValue() + "\n\n";
+        StringBuilder headers = new StringBuilder();
+        if (response.headers != null) {
+            for (Map.Entry<String, String> entry : response.headers.entrySet()) {
+                headers.append(entry.getKey()).append(": ").append(entry.getValue()).append("\r\n");
+            }
         }
+        result.headers = headers.toString();
 
-        return Response.success(result, HttpHeaderParser.parseCacheHeaders(response));
+        return result;
     }
 }
@@ -2,6 +2,9 @@ package io.boden.java;
 
 import android.content.Context;
 
+import java.nio.ByteBuffer;
+
+import com.android.volley.DefaultRetryPolicy;
 import com.android.volley.Request;
 import com.android.volley.RequestQueue;
 import com.android.volley.Response;
@@ -22,22 +25,40 @@ public class VolleyAdapter {
         queue.start();
     }
 
-    public void request(int requestMethod, String url, final NativeStrongPointer nativeResponse) {
+    private static final Request.Priority[] PRIORITIES = {
+            Request.Priority.LOW, Request.Priority.NORMAL, Request.Priority.HIGH };
+
+    public FullRequest request(int requestMethod, String url, String headers, ByteBuffer body, String bodyFile,
+                               int priority, int timeoutMs, final NativeStrongPointer nativeResponse) {
         FullRequest request = new FullRequest(requestMethod, url,
                 new Response.Listener<FullData>() {
                     @Override
                     public void onResponse(FullData response) {
-                        handleResponse(nativeResponse, response.statusCode, response.data, response.headers);//, "Hallo Welt", "Nothing!");
+                        handleResponse(nativeResponse, response.statusCode, response.data, response.headers);
                     }
                 }, new Response.ErrorListener() {
             @Override
             public void onErrorResponse(VolleyError error) {
-                handleResponse(nativeResponse, -1, error.getMessage(), null);
-
+                // Error status codes still come with a response, whose body may explain the error
+                if (error.networkResponse != null) {
+                    FullData response = FullRequest.toFullData(error.networkResponse);
+                    handleResponse(nativeResponse, response.statusCode, response.data, response.headers);
+                } else {
+                    // Like on the other platforms, requests without a response have the status code 0
+                    handleResponse(nativeResponse, 0, null, null);
+                }
             }
         });
+        request.setHeaders(headers);
+        request.setBody(body, bodyFile);
+        request.setPriority(PRIORITIES[priority]);
+        if (timeoutMs > 0) {
+            request.setRetryPolicy(new DefaultRetryPolicy(
+                    timeoutMs, DefaultRetryPolicy.DEFAULT_MAX_RETRIES, DefaultRetryPolicy.DEFAULT_BACKOFF_MULT));
+        }
         queue.add(request);
+        return request;
     }
 
-    private native static void handleResponse(NativeStrongPointer nativeResponse, int statusCode, String data, String headers);
+    private native static void handleResponse(NativeStrongPointer nativeResponse, int statusCode, ByteBuffer data, String headers);
 }
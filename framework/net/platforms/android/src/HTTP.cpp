@@ -1,14 +1,19 @@
 #include <bdn/Application.h>
 #include <bdn/config.h>
 #include <bdn/entry.h>
+#include <bdn/java/wrapper/ByteBuffer.h>
 #include <bdn/java/wrapper/NativeStrongPointer.h>
 #include <bdn/net/HTTP.h>
+#include <bdn/net/HTTPObserver.h>
 #include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPRequestHandle.h>
 #include <bdn/net/HTTPResponse.h>
+#include <optional>
 #include <ostream>
+#include <sys/stat.h>
 
 #include "VolleyAdapter.h"
-#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/android/VolleyResponse.h>
 
 namespace bdn
 {
@@ -16,17 +21,115 @@ namespace bdn
     {
         namespace http
         {
-            void request(HTTPRequest request)
+            namespace android
+            {
+                /** Referred to by its Volley request until the response arrived. Apart from cancel(), it is
+                    only used on the main thread, where Volley delivers responses. */
+                class VolleyRequestHandle : public HTTPRequestHandle,
+                                            public std::enable_shared_from_this<VolleyRequestHandle>
+                {
+                  public:
+                    std::shared_ptr<HTTPResponse> response = std::make_shared<HTTPResponse>();
+                    std::optional<JFullRequest> volleyRequest;
+                    std::optional<net::detail::HTTPObservation> observation;
+                    bool finished = false;
+
+                  public:
+                    /** Releases the Java request, which in turn refers to this handle. */
+                    void finish()
+                    {
+                        finished = true;
+                        volleyRequest.reset();
+                    }
+
+                    /** Cancels the Java request, so that its listeners are not called anymore. Returns false
+                        if the request had finished already. */
+                    bool stop()
+                    {
+                        if (finished) {
+                            return false;
+                        }
+                        volleyRequest->cancel();
+                        finish();
+                        return true;
+                    }
+
+                    /** Completes the metrics and passes the response to the observer. */
+                    void observeFinish()
+                    {
+                        auto &metrics = response->metrics;
+                        metrics.total = std::chrono::duration_cast<HTTPMetrics::Duration>(HTTPMetrics::Clock::now() -
+                                                                                          metrics.startTime);
+                        metrics.cancelled = isCancelled();
+                        if (observation) {
+                            observation->finished(*response);
+                        }
+                    }
+
+                  protected:
+                    void abort() override
+                    {
+                        App()->dispatchQueue()->dispatchAsync([self = shared_from_this()]() {
+                            if (self->stop()) {
+                                self->observeFinish();
+                            }
+                        });
+                    }
+                };
+            }
+
+            std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request)
             {
 
                 static std::shared_ptr<android::JVolleyAdapter> staticVolleyAdapter =
                     std::make_shared<android::JVolleyAdapter>();
 
-                auto response = std::make_shared<HTTPResponse>();
-                response->originalRequest = request;
+                auto handle = std::make_shared<android::VolleyRequestHandle>();
+                handle->response->originalRequest = request;
+                handle->response->metrics.startTime = HTTPMetrics::Clock::now();
+
+                // The bytes stay alive in the handle's copy of the request until Volley has sent them
+                auto &bytes = handle->response->originalRequest.body.bytes();
+                auto body = bytes && !bytes->empty()
+                                ? java::wrapper::ByteBuffer(const_cast<char *>(bytes->data()),
+                                                            static_cast<int64_t>(bytes->size()))
+                                : java::wrapper::ByteBuffer(java::Reference());
 
-                staticVolleyAdapter->request(android::JVolleyAdapter::toVolleyRequestMethod(request.method),
-                                             request.url, response);
+                // Volley does not report what it sent, only the body is counted
+                struct stat status{};
+                if (bytes) {
+                    handle->response->metrics.bytesSent = bytes->size();
+                } else if (request.body.isFile() && ::stat(request.body.path().c_str(), &status) == 0) {
+                    handle->response->metrics.bytesSent = static_cast<uint64_t>(status.st_size);
+                }
+                handle->observation.emplace(request);
+
+                // Volley applies the timeout to connecting and to every read, per attempt
+                auto volleyRequest = staticVolleyAdapter->request(
+                    android::JVolleyAdapter::toVolleyRequestMethod(request.method), request.url,
+                    request.header.toString(), body, request.body.path(),
+                    android::JVolleyAdapter::toVolleyPriority(request.priority),
+                    static_cast<int>(request.connectTimeout.count()), handle);
+                handle->volleyRequest.emplace(volleyRequest.getRef_());
+
+                if (request.timeout.count() > 0) {
+                    App()->dispatchQueue()->dispatchAsyncDelayed(
+                        request.timeout, [weakHandle = std::weak_ptr<android::VolleyRequestHandle>(handle)]() {
+                            auto handle = weakHandle.lock();
+                            if (!handle || !handle->stop()) {
+                                return;
+                            }
+
+                            // Fails like requests without a response
+                            handle->response->responseCode = 0;
+                            handle->observeFinish();
+                            if (!handle->isCancelled() && handle->response->originalRequest.doneHandler) {
+                                handle->response->originalRequest.doneHandler(handle->response);
+                            }
+                        });
+                }
+
+                return handle;
             }
         }
     }
@@ -42,19 +145,26 @@ extern "C" JNIEXPORT void JNICALL Java_io_boden_java_VolleyAdapter_handleRespons
             bdn::java::wrapper::NativeStrongPointer nativeResponse(
                 bdn::java::Reference::convertExternalLocal(rawNativeResponse));
 
-            if (std::shared_ptr<bdn::net::HTTPResponse> cResponse =
-                    std::static_pointer_cast<bdn::net::HTTPResponse>(nativeResponse.getPointer())) {
-                jboolean isCopy;
-                cResponse->responseCode = statusCode;
-                if (data != nullptr) {
-                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
-                    cResponse->data = env->GetStringUTFChars((jstring)data, &isCopy);
+            if (auto handle = std::static_pointer_cast<bdn::net::http::android::VolleyRequestHandle>(
+                    nativeResponse.getPointer())) {
+                if (handle->finished) {
+                    return;
                 }
-                if (headers != nullptr) {
-                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
-                    cResponse->header = env->GetStringUTFChars((jstring)headers, &isCopy);
+                handle->finish();
+                if (handle->isCancelled()) {
+                    handle->observeFinish();
+                    return;
+                }
+
+                auto cResponse = handle->response;
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+                bdn::net::http::android::fillResponse(env, *cResponse, statusCode,
+                                                      bdn::java::wrapper::ByteBuffer::getBytes_(env, data),
+                                                      (jstring)headers);
+                handle->observeFinish();
+                if (cResponse->originalRequest.doneHandler) {
+                    cResponse->originalRequest.doneHandler(cResponse);
                 }
-                cResponse->originalRequest.doneHandler(cResponse);
             }
         },
         true, env);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <bdn/String.h>
+
+#include <functional>
+#include <memory>
+
+namespace bdn::net::posix
+{
+    /** Streaming decoder for a response's Content-Encoding.
+
+        Compressed data is passed to decode() as it arrives, the decoded data is passed on in pieces of
+        at most kOutputSize bytes without buffering the whole body.
+    */
+    class ContentDecoder
+    {
+      public:
+        using Output = std::function<void(const char *data, size_t size)>;
+
+        static constexpr size_t kOutputSize = 64 * 1024;
+
+      public:
+        /** The Content-Encoding values that create() supports, as an Accept-Encoding value. */
+        static StringView acceptEncoding();
+
+        /** A decoder for a single content coding such as "gzip", or nullptr if it is not supported. */
+        static std::unique_ptr<ContentDecoder> create(StringView contentEncoding);
+
+        virtual ~ContentDecoder() = default;
+
+      public:
+        /** Decodes the next part of the encoded data. Returns false if it is corrupt. */
+        virtual bool decode(const char *data, size_t size, const Output &output) = 0;
+
+        /** Whether the end of the encoded data was reached. Data that ends before is truncated. */
+        virtual bool finished() const = 0;
+    };
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPRequestHandle.h>
+
+#include <chrono>
+#include <memory>
+
+namespace bdn::net::posix
+{
+    namespace detail
+    {
+        class HTTPEventLoop;
+    }
+
+    /** HTTP/1.1 client behind http::request() on Linux.
+
+        All sockets are non-blocking and served by a single event loop thread using epoll. After a
+        response was received, its connection is kept alive and reused by the next request to the same
+        host and port. At most Configuration::maxConnectionsPerHost connections are opened per host,
+        further requests wait until one of them becomes free, those with a higher HTTPRequest::priority
+        first.
+
+        Requests without an Accept-Encoding header field offer ContentDecoder::acceptEncoding(), and
+        responses in one of these encodings are decoded as they arrive. Their Content-Encoding and
+        Content-Length fields are removed, as they no longer describe the delivered body. Requests that
+        set Accept-Encoding themselves get the body as it was sent.
+
+        HTTPResponse::metrics cover every phase but tlsHandshake. bytesReceived counts the response as
+        it arrived, before decoding. Retried requests count the bytes of both attempts.
+
+        Only http:// URLs are supported. Responses are delivered on the application's dispatch queue, or
+        on the event loop thread if there is no application. Chunks for HTTPRequest::dataHandler are
+        always passed on the event loop thread. Requests that fail are answered with a response whose
+        responseCode is 0. A request that fails because a reused connection was closed is retried once
+        on a new connection if its method is idempotent.
+    */
+    class HTTPClient
+    {
+      public:
+        struct Configuration
+        {
+            size_t maxConnectionsPerHost = 6;
+
+            /** Connections that were not used for this long are closed. */
+            std::chrono::milliseconds idleTimeout{30000};
+
+            /** Used for requests whose HTTPRequest::connectTimeout is 0. */
+            std::chrono::milliseconds connectTimeout{10000};
+        };
+
+        struct Statistics
+        {
+            size_t requests = 0;
+            size_t failedRequests = 0;
+            size_t cancelledRequests = 0;
+            size_t timedOutRequests = 0; // also counted as failed
+            size_t connectionsOpened = 0;
+            size_t connectionsReused = 0;
+        };
+
+      public:
+        HTTPClient();
+        explicit HTTPClient(Configuration configuration);
+        ~HTTPClient();
+
+        HTTPClient(const HTTPClient &) = delete;
+        HTTPClient &operator=(const HTTPClient &) = delete;
+
+      public:
+        /** The client used by http::request(). */
+        static std::shared_ptr<HTTPClient> shared();
+
+      public:
+        /** Starts the request. Can be called from any thread. */
+        std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request);
+
+        Statistics statistics() const;
+
+      private:
+        std::shared_ptr<detail::HTTPEventLoop> _loop;
+    };
+}
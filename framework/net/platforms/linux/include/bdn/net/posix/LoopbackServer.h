@@ -0,0 +1,100 @@
+#pragma once
+
+#include <bdn/String.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bdn::net::posix
+{
+    /** Minimal HTTP/1.1 server listening on 127.0.0.1, for testing and benchmarking HTTP clients
+        without network access.
+
+        Every request is answered with the response the handler returns. The handler is called on the
+        server's own thread. Connections are kept alive unless the request or the response asks for
+        them to be closed.
+    */
+    class LoopbackServer
+    {
+      public:
+        using HeaderFields = std::vector<std::pair<String, String>>;
+
+        struct Request
+        {
+            String method;
+            String target;
+            HeaderFields headerFields;
+            std::string body;
+
+            /** Value of the first header field called name, compared case insensitively. */
+            String headerField(const String &name) const;
+        };
+
+        struct Response
+        {
+            int responseCode = 200;
+            HeaderFields headerFields;
+            std::string body;
+
+            /** Sends the body with chunked transfer encoding instead of a Content-Length. */
+            bool chunked = false;
+
+            /** Closes the connection after the response was sent. */
+            bool close = false;
+        };
+
+        using Handler = std::function<Response(const Request &)>;
+
+        struct Statistics
+        {
+            size_t connections = 0;
+            size_t requests = 0;
+        };
+
+      public:
+        /** Starts listening on a free port. Throws std::system_error if that fails. */
+        explicit LoopbackServer(Handler handler);
+        ~LoopbackServer();
+
+        LoopbackServer(const LoopbackServer &) = delete;
+        LoopbackServer &operator=(const LoopbackServer &) = delete;
+
+      public:
+        uint16_t port() const { return _port; }
+
+        /** The URL of target on this server, e.g. url("/index.html"). */
+        String url(const String &target) const;
+
+        Statistics statistics() const;
+
+      private:
+        struct Connection;
+
+        void run();
+        void accept();
+        void receive(Connection &connection);
+        void send(Connection &connection);
+        bool handleRequests(Connection &connection);
+        void closeConnection(int fd);
+
+      private:
+        Handler _handler;
+        uint16_t _port = 0;
+
+        int _listenFd = -1;
+        int _epollFd = -1;
+        int _stopFd = -1;
+
+        mutable std::mutex _mutex;
+        Statistics _statistics;
+
+        std::unordered_map<int, std::unique_ptr<Connection>> _connections;
+        std::thread _thread;
+    };
+}
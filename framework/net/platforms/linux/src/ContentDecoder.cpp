@@ -0,0 +1,200 @@
+#include <bdn/net/posix/ContentDecoder.h>
+
+#include "HTTPText.h"
+
+#include <vector>
+#include <zlib.h>
+
+#ifdef BDN_NET_HAS_BROTLI
+#include <brotli/decode.h>
+#endif
+
+namespace bdn::net::posix
+{
+    namespace
+    {
+        using detail::equalsIgnoreCase;
+
+        class ZlibDecoder : public ContentDecoder
+        {
+          public:
+            explicit ZlibDecoder(bool gzip) : _gzip(gzip), _buffer(kOutputSize) {}
+
+            ~ZlibDecoder() override
+            {
+                if (_initialized) {
+                    ::inflateEnd(&_stream);
+                }
+            }
+
+            ZlibDecoder(const ZlibDecoder &) = delete;
+            ZlibDecoder &operator=(const ZlibDecoder &) = delete;
+
+          public:
+            bool decode(const char *data, size_t size, const Output &output) override
+            {
+                if (_initialized) {
+                    return inflate(data, size, output);
+                }
+
+                if (_gzip) {
+                    return initialize(16 + MAX_WBITS) && inflate(data, size, output);
+                }
+
+                // "deflate" means zlib wrapped data (RFC 7230, section 4.2.2), but some servers send raw
+                // deflate data. The first two bytes tell them apart.
+                _head.append(data, size);
+                if (_head.size() < 2) {
+                    return true;
+                }
+                auto cmf = static_cast<unsigned char>(_head[0]);
+                auto flg = static_cast<unsigned char>(_head[1]);
+                bool wrapped = (cmf & 0x0f) == Z_DEFLATED && (cmf * 256 + flg) % 31 == 0;
+
+                auto head = std::move(_head);
+                return initialize(wrapped ? MAX_WBITS : -MAX_WBITS) && inflate(head.data(), head.size(), output);
+            }
+
+            bool finished() const override { return _finished; }
+
+          private:
+            bool initialize(int windowBits)
+            {
+                _initialized = ::inflateInit2(&_stream, windowBits) == Z_OK;
+                return _initialized;
+            }
+
+            bool inflate(const char *data, size_t size, const Output &output)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-type-const-cast)
+                _stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+                _stream.avail_in = static_cast<uInt>(size);
+
+                do {
+                    if (_finished && _stream.avail_in > 0) {
+                        // A gzip body may consist of several members, anything else must end with the stream
+                        if (!_gzip || ::inflateReset(&_stream) != Z_OK) {
+                            return false;
+                        }
+                        _finished = false;
+                    }
+
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                    _stream.next_out = reinterpret_cast<Bytef *>(_buffer.data());
+                    _stream.avail_out = static_cast<uInt>(_buffer.size());
+
+                    int result = ::inflate(&_stream, Z_NO_FLUSH);
+                    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                        return false;
+                    }
+
+                    auto produced = _buffer.size() - _stream.avail_out;
+                    if (produced > 0) {
+                        output(_buffer.data(), produced);
+                    }
+
+                    if (result == Z_STREAM_END) {
+                        _finished = true;
+                    } else if (result == Z_BUF_ERROR) {
+                        break; // No progress is possible until more data arrives
+                    }
+                } while (_stream.avail_in > 0 || _stream.avail_out == 0);
+
+                return true;
+            }
+
+          private:
+            bool _gzip;
+            bool _initialized = false;
+            bool _finished = false;
+            z_stream _stream{};
+            std::string _head;
+            std::vector<char> _buffer;
+        };
+
+#ifdef BDN_NET_HAS_BROTLI
+        class BrotliDecoder : public ContentDecoder
+        {
+          public:
+            BrotliDecoder() : _state(::BrotliDecoderCreateInstance(nullptr, nullptr, nullptr)), _buffer(kOutputSize)
+            {}
+
+            ~BrotliDecoder() override { ::BrotliDecoderDestroyInstance(_state); }
+
+            BrotliDecoder(const BrotliDecoder &) = delete;
+            BrotliDecoder &operator=(const BrotliDecoder &) = delete;
+
+          public:
+            bool decode(const char *data, size_t size, const Output &output) override
+            {
+                if (_finished) {
+                    return size == 0;
+                }
+
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                auto nextIn = reinterpret_cast<const uint8_t *>(data);
+                size_t availableIn = size;
+
+                while (true) {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                    auto nextOut = reinterpret_cast<uint8_t *>(_buffer.data());
+                    size_t availableOut = _buffer.size();
+
+                    auto result = ::BrotliDecoderDecompressStream(_state, &availableIn, &nextIn, &availableOut,
+                                                                  &nextOut, nullptr);
+                    if (result == BROTLI_DECODER_RESULT_ERROR) {
+                        return false;
+                    }
+
+                    auto produced = _buffer.size() - availableOut;
+                    if (produced > 0) {
+                        output(_buffer.data(), produced);
+                    }
+
+                    if (result == BROTLI_DECODER_RESULT_SUCCESS) {
+                        _finished = true;
+                        return availableIn == 0;
+                    }
+                    if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT) {
+                        return true;
+                    }
+                }
+            }
+
+            bool finished() const override { return _finished; }
+
+          private:
+            BrotliDecoderState *_state;
+            bool _finished = false;
+            std::vector<char> _buffer;
+        };
+#endif
+    }
+
+    StringView ContentDecoder::acceptEncoding()
+    {
+#ifdef BDN_NET_HAS_BROTLI
+        return "gzip, deflate, br";
+#else
+        return "gzip, deflate";
+#endif
+    }
+
+    std::unique_ptr<ContentDecoder> ContentDecoder::create(StringView contentEncoding)
+    {
+        contentEncoding = detail::trim(contentEncoding);
+
+        if (equalsIgnoreCase(contentEncoding, "gzip") || equalsIgnoreCase(contentEncoding, "x-gzip")) {
+            return std::make_unique<ZlibDecoder>(true);
+        }
+        if (equalsIgnoreCase(contentEncoding, "deflate")) {
+            return std::make_unique<ZlibDecoder>(false);
+        }
+#ifdef BDN_NET_HAS_BROTLI
+        if (equalsIgnoreCase(contentEncoding, "br")) {
+            return std::make_unique<BrotliDecoder>();
+        }
+#endif
+        return nullptr;
+    }
+}
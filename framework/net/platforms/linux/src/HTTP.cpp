@@ -0,0 +1,11 @@
+#include <bdn/net/HTTP.h>
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/posix/HTTPClient.h>
+
+namespace bdn::net::http
+{
+    std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request)
+    {
+        return posix::HTTPClient::shared()->request(std::move(request));
+    }
+}
@@ -0,0 +1,1342 @@
+#include <bdn/net/posix/HTTPClient.h>
+
+#include <bdn/net/posix/ContentDecoder.h>
+
+#include <bdn/Application.h>
+#include <bdn/DispatchQueue.h>
+#include <bdn/net/HTTPObserver.h>
+#include <bdn/net/HTTPRequestHandle.h>
+#include <bdn/net/HTTPResponse.h>
+
+#include "HTTPText.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <limits>
+#include <map>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <optional>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace bdn::net::posix
+{
+    namespace
+    {
+        using detail::equalsIgnoreCase;
+        using detail::trim;
+
+        using Clock = std::chrono::steady_clock;
+
+        HTTPMetrics::Duration elapsed(Clock::time_point from, Clock::time_point to)
+        {
+            return std::chrono::duration_cast<HTTPMetrics::Duration>(to - from);
+        }
+
+        // RFC 7231 section 4.2.2
+        bool isIdempotent(http::Method method)
+        {
+            switch (method) {
+            case http::Method::GET:
+            case http::Method::HEAD:
+            case http::Method::PUT:
+            case http::Method::DELETE:
+            case http::Method::OPTIONS:
+            case http::Method::TRACE:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        constexpr size_t kReadBufferSize = 64 * 1024;
+        constexpr int kMaxReadsPerEvent = 4;
+        constexpr size_t kMaxLineLength = 64 * 1024;
+        constexpr uint64_t kWakeUpId = 0;
+
+        struct Target
+        {
+            String host;
+            String port;
+            String hostHeader;
+            String path;
+        };
+
+        std::optional<Target> parseUrl(const String &url)
+        {
+            constexpr StringView scheme = "http://";
+            if (url.size() <= scheme.size() || !equalsIgnoreCase(StringView(url).substr(0, scheme.size()), scheme)) {
+                return std::nullopt;
+            }
+
+            auto authorityEnd = url.find_first_of("/?#", scheme.size());
+            auto authority = url.substr(scheme.size(),
+                                        authorityEnd == String::npos ? String::npos : authorityEnd - scheme.size());
+
+            auto userInfoEnd = authority.rfind('@');
+            if (userInfoEnd != String::npos) {
+                authority.erase(0, userInfoEnd + 1);
+            }
+
+            Target target;
+            target.hostHeader = authority;
+            target.port = "80";
+
+            if (!authority.empty() && authority.front() == '[') {
+                auto closingBracket = authority.find(']');
+                if (closingBracket == String::npos) {
+                    return std::nullopt;
+                }
+                target.host = authority.substr(1, closingBracket - 1);
+                if (closingBracket + 1 < authority.size()) {
+                    if (authority[closingBracket + 1] != ':') {
+                        return std::nullopt;
+                    }
+                    target.port = authority.substr(closingBracket + 2);
+                }
+            } else {
+                auto colon = authority.find(':');
+                target.host = authority.substr(0, colon);
+                if (colon != String::npos) {
+                    target.port = authority.substr(colon + 1);
+                }
+            }
+
+            bool validPort = !target.port.empty() && target.port.find_first_not_of("0123456789") == String::npos;
+            if (target.host.empty() || !validPort) {
+                return std::nullopt;
+            }
+
+            if (authorityEnd == String::npos) {
+                target.path = "/";
+            } else {
+                auto fragment = url.find('#', authorityEnd);
+                target.path =
+                    url.substr(authorityEnd, fragment == String::npos ? String::npos : fragment - authorityEnd);
+                if (target.path.empty() || target.path.front() != '/') {
+                    target.path.insert(0, "/");
+                }
+            }
+
+            return target;
+        }
+
+        std::string serializeRequest(const HTTPRequest &request, const Target &target, size_t bodySize)
+        {
+            const auto &header = request.header.toString();
+            std::string data;
+            data.reserve(128 + target.path.size() + header.size());
+
+            data += http::methodName(request.method);
+            data += ' ';
+            data += target.path;
+            data += " HTTP/1.1\r\nHost: ";
+            data += target.hostHeader;
+            data += "\r\n";
+
+            // Requests that negotiate encodings themselves get the body as it was sent
+            if (!request.header.contains("Accept-Encoding")) {
+                data += "Accept-Encoding: ";
+                data.append(ContentDecoder::acceptEncoding());
+                data += "\r\n";
+            }
+
+            if (bodySize > 0 || request.method == http::Method::POST || request.method == http::Method::PUT) {
+                data += "Content-Length: ";
+                data += std::to_string(bodySize);
+                data += "\r\n";
+            }
+
+            // The header is in the wire format already, only the length is up to the body
+            if (request.header.contains("Content-Length")) {
+                auto withoutLength = request.header;
+                withoutLength.remove("Content-Length");
+                data += withoutLength.toString();
+            } else {
+                data += header;
+            }
+
+            data += "\r\n";
+            return data;
+        }
+
+        /** Parses a single response as it arrives, passing the body to the request's dataHandler or
+            collecting it in HTTPResponse::data. If decodeContent is set, bodies with a supported
+            Content-Encoding are decoded on the way. */
+        class ResponseParser
+        {
+          public:
+            enum class Result
+            {
+                NeedMore,
+                Complete,
+                Error
+            };
+
+          public:
+            ResponseParser(HTTPResponse &response, const HTTPRequestHandle &handle, bool headRequest,
+                           bool decodeContent)
+                : _response(response), _handle(handle), _headRequest(headRequest), _decodeContent(decodeContent)
+            {}
+
+          public:
+            Result feed(const char *data, size_t size)
+            {
+                const char *end = data + size;
+
+                while (data < end && _state != State::Done) {
+                    if (_state == State::Body || _state == State::ChunkData) {
+                        auto count = std::min<size_t>(_remaining, end - data);
+                        if (!appendBody(data, count)) {
+                            return Result::Error;
+                        }
+                        data += count;
+                        _remaining -= count;
+                        if (_remaining == 0) {
+                            _state = _state == State::Body ? State::Done : State::ChunkEnd;
+                        }
+                    } else if (_state == State::UntilClose) {
+                        if (!appendBody(data, end - data)) {
+                            return Result::Error;
+                        }
+                        data = end;
+                    } else {
+                        auto newline = static_cast<const char *>(std::memchr(data, '\n', end - data));
+                        _line.append(data, newline != nullptr ? newline : end);
+                        if (_line.size() > kMaxLineLength) {
+                            return Result::Error;
+                        }
+                        if (newline == nullptr) {
+                            break;
+                        }
+                        data = newline + 1;
+
+                        if (!_line.empty() && _line.back() == '\r') {
+                            _line.pop_back();
+                        }
+                        bool valid = parseLine(_line);
+                        _line.clear();
+                        if (!valid) {
+                            return Result::Error;
+                        }
+                    }
+                }
+
+                if (_state != State::Done) {
+                    return Result::NeedMore;
+                }
+                if (_decoder && !_decoder->finished()) {
+                    return Result::Error;
+                }
+
+                // Data beyond the end of the response leaves the connection in an unknown state
+                if (data != end) {
+                    _keepAlive = false;
+                }
+                return Result::Complete;
+            }
+
+            /** Called when the server closed the connection. Returns true if that completed the response. */
+            bool finishOnClose()
+            {
+                if (_state == State::UntilClose) {
+                    _state = State::Done;
+                }
+                return _state == State::Done && (!_decoder || _decoder->finished());
+            }
+
+            bool keepAlive() const { return _keepAlive; }
+
+          private:
+            enum class State
+            {
+                StatusLine,
+                Headers,
+                Body,
+                ChunkSize,
+                ChunkData,
+                ChunkEnd,
+                Trailers,
+                UntilClose,
+                Done
+            };
+
+            bool appendBody(const char *data, size_t size)
+            {
+                if (!_decoder) {
+                    deliverBody(data, size);
+                    return true;
+                }
+                return _decoder->decode(data, size, [this](const char *decoded, size_t decodedSize) {
+                    deliverBody(decoded, decodedSize);
+                });
+            }
+
+            void deliverBody(const char *data, size_t size)
+            {
+                if (_response.originalRequest.dataHandler) {
+                    if (!_handle.isCancelled()) {
+                        _response.originalRequest.dataHandler(asBytes(data, size));
+                    }
+                } else {
+                    _response.data.append(data, size);
+                }
+            }
+
+            bool parseLine(StringView line)
+            {
+                switch (_state) {
+                case State::StatusLine:
+                    return parseStatusLine(line);
+                case State::Headers:
+                    return line.empty() ? headersComplete() : parseHeaderField(line);
+                case State::ChunkSize:
+                    return parseChunkSize(line);
+                case State::ChunkEnd:
+                    _state = State::ChunkSize;
+                    return line.empty();
+                case State::Trailers:
+                    if (line.empty()) {
+                        _state = State::Done;
+                    }
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            bool parseStatusLine(StringView line)
+            {
+                // HTTP/1.x SP status-code SP reason-phrase
+                if (line.size() < 12 || line.substr(0, 7) != "HTTP/1." || line[8] != ' ') {
+                    return false;
+                }
+
+                int code = 0;
+                for (char c : line.substr(9, 3)) {
+                    if (std::isdigit(static_cast<unsigned char>(c)) == 0) {
+                        return false;
+                    }
+                    code = code * 10 + (c - '0');
+                }
+
+                _response.responseCode = code;
+                _response.header.clear();
+                _keepAlive = line[7] != '0';
+                _contentLength.reset();
+                _chunked = false;
+                _decoder.reset();
+                _state = State::Headers;
+                return true;
+            }
+
+            bool parseHeaderField(StringView line)
+            {
+                auto colon = line.find(':');
+                if (colon == StringView::npos || colon == 0) {
+                    return false;
+                }
+
+                auto name = line.substr(0, colon);
+                auto value = trim(line.substr(colon + 1));
+
+                if (equalsIgnoreCase(name, "Content-Length")) {
+                    // RFC 7230, section 3.3.3: invalid or differing lengths make the framing unknown,
+                    // guessing would desynchronize a kept alive connection.
+                    auto length = parseContentLength(value);
+                    if (!length || (_contentLength && *_contentLength != *length)) {
+                        return false;
+                    }
+                    _contentLength = length;
+                } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+                    _chunked = value.size() >= 7 && equalsIgnoreCase(value.substr(value.size() - 7), "chunked");
+                } else if (equalsIgnoreCase(name, "Connection")) {
+                    if (equalsIgnoreCase(value, "close")) {
+                        _keepAlive = false;
+                    } else if (equalsIgnoreCase(value, "keep-alive")) {
+                        _keepAlive = true;
+                    }
+                }
+
+                try {
+                    _response.header.add(name, value);
+                }
+                catch (const std::invalid_argument &) {
+                    return false;
+                }
+                return true;
+            }
+
+            /** Parses a Content-Length value, which may be a list of identical lengths. */
+            static std::optional<size_t> parseContentLength(StringView value)
+            {
+                std::optional<size_t> result;
+                while (true) {
+                    auto comma = value.find(',');
+                    auto element = trim(value.substr(0, comma));
+                    if (element.empty()) {
+                        return std::nullopt;
+                    }
+
+                    size_t length = 0;
+                    for (char c : element) {
+                        if (std::isdigit(static_cast<unsigned char>(c)) == 0 ||
+                            length > (std::numeric_limits<size_t>::max() - (c - '0')) / 10) {
+                            return std::nullopt;
+                        }
+                        length = length * 10 + (c - '0');
+                    }
+
+                    if (result && *result != length) {
+                        return std::nullopt;
+                    }
+                    result = length;
+
+                    if (comma == StringView::npos) {
+                        return result;
+                    }
+                    value.remove_prefix(comma + 1);
+                }
+            }
+
+            bool headersComplete()
+            {
+                auto code = _response.responseCode;
+
+                // Interim responses such as 100 Continue are followed by the actual response
+                if (code >= 100 && code < 200 && code != 101) {
+                    _state = State::StatusLine;
+                    return true;
+                }
+                if (_headRequest || code == 204 || code == 304 || code == 101) {
+                    _state = State::Done;
+                    return true;
+                }
+
+                auto contentEncoding = _response.header.get("Content-Encoding");
+                if (_decodeContent && contentEncoding && _contentLength != size_t(0)) {
+                    _decoder = ContentDecoder::create(*contentEncoding);
+                    if (_decoder) {
+                        // The response looks as if the body had been sent the way it is delivered
+                        _response.header.remove("Content-Encoding");
+                        _response.header.remove("Content-Length");
+                    }
+                }
+
+                if (_chunked) {
+                    _state = State::ChunkSize;
+                } else if (_contentLength) {
+                    _remaining = *_contentLength;
+                    if (!_response.originalRequest.dataHandler && !_decoder) {
+                        _response.data.reserve(_remaining);
+                    }
+                    _state = _remaining > 0 ? State::Body : State::Done;
+                } else {
+                    _keepAlive = false;
+                    _state = State::UntilClose;
+                }
+                return true;
+            }
+
+            bool parseChunkSize(StringView line)
+            {
+                line = trim(line.substr(0, line.find(';')));
+                if (line.empty() || line.size() > 15) {
+                    return false;
+                }
+
+                size_t size = 0;
+                for (char c : line) {
+                    if (std::isxdigit(static_cast<unsigned char>(c)) == 0) {
+                        return false;
+                    }
+                    bool decimal = std::isdigit(static_cast<unsigned char>(c)) != 0;
+                    size = size * 16 + (decimal ? c - '0' : (c | 0x20) - 'a' + 10);
+                }
+
+                _remaining = size;
+                _state = size > 0 ? State::ChunkData : State::Trailers;
+                return true;
+            }
+
+          private:
+            HTTPResponse &_response;
+            const HTTPRequestHandle &_handle;
+            bool _headRequest;
+            bool _decodeContent;
+
+            State _state = State::StatusLine;
+            std::string _line;
+            std::optional<size_t> _contentLength;
+            bool _chunked = false;
+            bool _keepAlive = true;
+            size_t _remaining = 0;
+            std::unique_ptr<ContentDecoder> _decoder;
+        };
+    }
+
+    namespace detail
+    {
+        class HTTPEventLoop;
+
+        class HTTPClientRequestHandle : public HTTPRequestHandle
+        {
+          public:
+            HTTPClientRequestHandle(std::weak_ptr<HTTPEventLoop> loop, uint64_t transferId)
+                : _loop(std::move(loop)), _transferId(transferId)
+            {}
+
+          public:
+            uint64_t transferId() const { return _transferId; }
+
+          protected:
+            void abort() override;
+
+          private:
+            std::weak_ptr<HTTPEventLoop> _loop;
+            uint64_t _transferId;
+        };
+
+        /** The state of HTTPClient. Everything but submit(), cancel() and statistics() runs on the loop
+            thread. */
+        class HTTPEventLoop : public std::enable_shared_from_this<HTTPEventLoop>
+        {
+          public:
+            explicit HTTPEventLoop(HTTPClient::Configuration configuration) : _configuration(configuration)
+            {
+                _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+                if (_epollFd < 0) {
+                    throw std::system_error(errno, std::generic_category(), "epoll_create1 failed");
+                }
+
+                _wakeUpFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                if (_wakeUpFd < 0) {
+                    ::close(_epollFd);
+                    throw std::system_error(errno, std::generic_category(), "eventfd failed");
+                }
+
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.u64 = kWakeUpId;
+                ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeUpFd, &event);
+
+                _resolver = std::make_unique<DispatchQueue>();
+                _thread = std::thread(&HTTPEventLoop::run, this);
+            }
+
+            ~HTTPEventLoop()
+            {
+                // Joins the resolver thread, so that no more results are posted
+                _resolver.reset();
+
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stopping = true;
+                }
+                wakeUp();
+                _thread.join();
+
+                for (auto &connection : _connections) {
+                    ::close(connection.second->fd);
+                }
+                ::close(_wakeUpFd);
+                ::close(_epollFd);
+            }
+
+          public:
+            std::shared_ptr<HTTPRequestHandle> submit(HTTPRequest request)
+            {
+                auto handle = std::make_shared<HTTPClientRequestHandle>(weak_from_this(), ++_lastTransferId);
+                post([this, request = std::move(request), handle]() mutable { start(std::move(request), handle); });
+                return handle;
+            }
+
+            void cancel(uint64_t transferId)
+            {
+                post([this, transferId]() { abortTransfer(transferId, false); });
+            }
+
+            HTTPClient::Statistics statistics() const
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _statistics;
+            }
+
+          private:
+            struct Transfer
+            {
+                ~Transfer()
+                {
+                    if (bodyFd >= 0) {
+                        ::close(bodyFd);
+                    }
+                }
+
+                uint64_t id = 0;
+                std::shared_ptr<HTTPClientRequestHandle> handle;
+                std::shared_ptr<HTTPResponse> response;
+                Target target;
+                String hostKey;
+                std::string requestData; // everything before the body
+
+                // The body is sent from response->originalRequest.body, files through bodyFd
+                int bodyFd = -1;
+                size_t bodySize = 0;
+                http::Priority priority = http::Priority::Normal;
+                bool retried = false;
+
+                uint64_t connectionId = 0; // 0 while pending
+                Clock::time_point deadline = Clock::time_point::max();
+                Clock::time_point connectDeadline = Clock::time_point::max();
+
+                // Of the current attempt, for response->metrics
+                Clock::time_point connectStarted;
+                Clock::time_point sendStarted;
+                Clock::time_point firstByte;
+
+                std::optional<net::detail::HTTPObservation> observation;
+            };
+
+            struct Connection
+            {
+                uint64_t id = 0;
+                int fd = -1;
+                uint32_t events = 0;
+                String hostKey;
+                size_t addressIndex = 0;
+                bool connected = false;
+                bool reused = false;
+
+                std::unique_ptr<Transfer> transfer;
+                std::optional<ResponseParser> parser;
+                size_t bytesSent = 0; // of requestData and the body
+                bool receivedData = false;
+
+                Clock::time_point idleSince;
+            };
+
+            struct Address
+            {
+                sockaddr_storage storage;
+                socklen_t length;
+            };
+
+            struct Host
+            {
+                std::deque<std::unique_ptr<Transfer>> pending;
+                std::vector<uint64_t> idleConnections; // least recently used first
+                size_t connectionCount = 0;
+                std::vector<Address> addresses;
+                bool resolving = false;
+                Clock::time_point resolveStarted;
+            };
+
+          private:
+            void post(std::function<void()> command)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _commands.push_back(std::move(command));
+                }
+                wakeUp();
+            }
+
+            void wakeUp()
+            {
+                uint64_t one = 1;
+                [[maybe_unused]] auto result = ::write(_wakeUpFd, &one, sizeof(one));
+            }
+
+            void count(size_t HTTPClient::Statistics::*counter)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++(_statistics.*counter);
+            }
+
+            void run()
+            {
+                std::vector<epoll_event> events(64);
+                _readBuffer.resize(kReadBufferSize);
+
+                while (true) {
+                    int eventCount =
+                        ::epoll_wait(_epollFd, events.data(), static_cast<int>(events.size()), nextTimeout());
+                    if (eventCount < 0 && errno != EINTR) {
+                        break;
+                    }
+
+                    for (int i = 0; i < eventCount; i++) {
+                        if (events[i].data.u64 == kWakeUpId) {
+                            uint64_t value;
+                            [[maybe_unused]] auto result = ::read(_wakeUpFd, &value, sizeof(value));
+                        } else {
+                            handleEvent(events[i].data.u64, events[i].events);
+                        }
+                    }
+
+                    if (!runCommands()) {
+                        break;
+                    }
+                    expireDeadlines();
+                    closeExpiredConnections();
+                }
+            }
+
+            bool runCommands()
+            {
+                std::vector<std::function<void()>> commands;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (_stopping) {
+                        return false;
+                    }
+                    commands.swap(_commands);
+                }
+
+                for (auto &command : commands) {
+                    command();
+                }
+                return true;
+            }
+
+            int nextTimeout() const
+            {
+                std::optional<Clock::time_point> earliest;
+                for (auto &host : _hosts) {
+                    if (!host.second.idleConnections.empty()) {
+                        auto idleSince = _connections.at(host.second.idleConnections.front())->idleSince;
+                        earliest = earliest ? std::min(*earliest, idleSince) : idleSince;
+                    }
+                }
+
+                if (earliest) {
+                    *earliest += _configuration.idleTimeout;
+                }
+                if (!_deadlines.empty()) {
+                    auto deadline = _deadlines.begin()->first;
+                    earliest = earliest ? std::min(*earliest, deadline) : deadline;
+                }
+
+                if (!earliest) {
+                    return -1;
+                }
+
+                auto remaining = *earliest - Clock::now();
+                auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+                return static_cast<int>(std::max<decltype(milliseconds)>(milliseconds, 0));
+            }
+
+            void closeExpiredConnections()
+            {
+                auto now = Clock::now();
+                std::vector<uint64_t> expired;
+                for (auto &host : _hosts) {
+                    for (auto id : host.second.idleConnections) {
+                        if (now - _connections.at(id)->idleSince >= _configuration.idleTimeout) {
+                            expired.push_back(id);
+                        }
+                    }
+                }
+
+                for (auto id : expired) {
+                    closeConnection(*_connections.at(id));
+                }
+            }
+
+            /** Stale entries of _deadlines, of transfers that finished or connected in time, are skipped. */
+            void expireDeadlines()
+            {
+                auto now = Clock::now();
+                while (!_deadlines.empty() && _deadlines.begin()->first <= now) {
+                    auto id = _deadlines.begin()->second;
+                    _deadlines.erase(_deadlines.begin());
+
+                    auto it = _transfers.find(id);
+                    if (it != _transfers.end() && (it->second->deadline <= now || it->second->connectDeadline <= now)) {
+                        count(&HTTPClient::Statistics::timedOutRequests);
+                        abortTransfer(id, true);
+                    }
+                }
+            }
+
+            void setDeadline(Transfer &transfer, Clock::time_point Transfer::*deadline,
+                             std::chrono::milliseconds timeout)
+            {
+                if (timeout.count() > 0) {
+                    transfer.*deadline = Clock::now() + timeout;
+                    _deadlines.emplace(transfer.*deadline, transfer.id);
+                }
+            }
+
+            void start(HTTPRequest request, const std::shared_ptr<HTTPClientRequestHandle> &handle)
+            {
+                count(&HTTPClient::Statistics::requests);
+
+                auto transfer = std::make_unique<Transfer>();
+                transfer->id = handle->transferId();
+                transfer->handle = handle;
+                transfer->priority = request.priority;
+                transfer->response = std::make_shared<HTTPResponse>();
+                transfer->response->originalRequest = std::move(request);
+                transfer->response->url = transfer->response->originalRequest.url;
+                transfer->response->metrics.startTime = Clock::now();
+                transfer->observation.emplace(transfer->response->originalRequest);
+                _transfers.emplace(transfer->id, transfer.get());
+                setDeadline(*transfer, &Transfer::deadline, transfer->response->originalRequest.timeout);
+
+                auto target = parseUrl(transfer->response->url);
+                if (!target) {
+                    fail(std::move(transfer));
+                    return;
+                }
+
+                const auto &body = transfer->response->originalRequest.body;
+                if (body.isFile()) {
+                    // Streamed from the file as the connection accepts it, without loading it into memory
+                    struct stat status{};
+                    transfer->bodyFd = ::open(body.path().c_str(), O_RDONLY | O_CLOEXEC);
+                    if (transfer->bodyFd < 0 || ::fstat(transfer->bodyFd, &status) != 0 || !S_ISREG(status.st_mode)) {
+                        fail(std::move(transfer));
+                        return;
+                    }
+                    transfer->bodySize = static_cast<size_t>(status.st_size);
+                } else if (body.bytes()) {
+                    transfer->bodySize = body.bytes()->size();
+                }
+
+                transfer->target = *target;
+                transfer->hostKey = target->host + ":" + target->port;
+                transfer->requestData =
+                    serializeRequest(transfer->response->originalRequest, *target, transfer->bodySize);
+
+                auto hostKey = transfer->hostKey;
+                enqueue(_hosts[hostKey], std::move(transfer), false);
+                dispatch(hostKey);
+            }
+
+            /** Queues the transfer behind all pending transfers of the same or a higher priority. Retries
+                go in front of the transfers of their priority, they have waited already. */
+            void enqueue(Host &host, std::unique_ptr<Transfer> transfer, bool retry)
+            {
+                auto priority = transfer->priority;
+                auto position = std::find_if(host.pending.begin(), host.pending.end(), [&](auto &pending) {
+                    return retry ? pending->priority <= priority : pending->priority < priority;
+                });
+                transfer->connectionId = 0;
+                host.pending.insert(position, std::move(transfer));
+            }
+
+            /** Stops the transfer, wherever it is. If it timed out it fails, otherwise it is dropped. */
+            void abortTransfer(uint64_t id, bool timedOut)
+            {
+                auto it = _transfers.find(id);
+                if (it == _transfers.end()) {
+                    return;
+                }
+
+                auto hostKey = it->second->hostKey;
+                std::unique_ptr<Transfer> transfer;
+
+                if (it->second->connectionId != 0) {
+                    // The rest of the response would still arrive, so the connection cannot be reused
+                    auto &connection = *_connections.at(it->second->connectionId);
+                    transfer = std::move(connection.transfer);
+                    closeConnection(connection);
+                } else {
+                    auto &pending = _hosts[hostKey].pending;
+                    auto position = std::find_if(pending.begin(), pending.end(),
+                                                 [&](auto &candidate) { return candidate->id == id; });
+                    if (position == pending.end()) {
+                        return;
+                    }
+                    transfer = std::move(*position);
+                    pending.erase(position);
+                }
+
+                if (timedOut) {
+                    fail(std::move(transfer));
+                } else {
+                    // Only the observer learns about it, the handle is cancelled already
+                    count(&HTTPClient::Statistics::cancelledRequests);
+                    deliver(std::move(transfer));
+                }
+
+                dispatch(hostKey);
+            }
+
+            /** Assigns pending requests of a host to idle connections or opens new ones. */
+            void dispatch(const String &hostKey)
+            {
+                auto &host = _hosts[hostKey];
+
+                while (!host.pending.empty()) {
+                    if (!host.idleConnections.empty()) {
+                        // The most recently used connection is the least likely to have been closed by the server
+                        auto &connection = *_connections.at(host.idleConnections.back());
+                        host.idleConnections.pop_back();
+                        connection.reused = true;
+                        count(&HTTPClient::Statistics::connectionsReused);
+
+                        auto transfer = std::move(host.pending.front());
+                        host.pending.pop_front();
+                        beginTransfer(connection, std::move(transfer));
+                        sendRequest(connection);
+                    } else if (host.connectionCount < _configuration.maxConnectionsPerHost) {
+                        if (host.addresses.empty()) {
+                            resolve(hostKey, host);
+                            return;
+                        }
+
+                        auto transfer = std::move(host.pending.front());
+                        host.pending.pop_front();
+                        openConnection(hostKey, host, std::move(transfer), 0);
+                    } else {
+                        return;
+                    }
+                }
+            }
+
+            void resolve(const String &hostKey, Host &host)
+            {
+                if (host.resolving) {
+                    return;
+                }
+                host.resolving = true;
+                host.resolveStarted = Clock::now();
+
+                auto name = host.pending.front()->target.host;
+                auto service = host.pending.front()->target.port;
+
+                // getaddrinfo() blocks, so it must not run on the loop thread
+                _resolver->dispatchAsync([this, hostKey, name, service]() {
+                    addrinfo hints{};
+                    hints.ai_family = AF_UNSPEC;
+                    hints.ai_socktype = SOCK_STREAM;
+                    hints.ai_flags = AI_NUMERICSERV;
+
+                    std::vector<Address> addresses;
+                    addrinfo *result = nullptr;
+                    if (::getaddrinfo(name.c_str(), service.c_str(), &hints, &result) == 0) {
+                        for (auto info = result; info != nullptr; info = info->ai_next) {
+                            Address address{};
+                            std::memcpy(&address.storage, info->ai_addr, info->ai_addrlen);
+                            address.length = info->ai_addrlen;
+                            addresses.push_back(address);
+                        }
+                        ::freeaddrinfo(result);
+                    }
+
+                    post([this, hostKey, addresses]() { resolved(hostKey, addresses); });
+                });
+            }
+
+            void resolved(const String &hostKey, std::vector<Address> addresses)
+            {
+                auto &host = _hosts[hostKey];
+                host.resolving = false;
+                host.addresses = std::move(addresses);
+
+                auto now = Clock::now();
+                for (auto &transfer : host.pending) {
+                    auto &metrics = transfer->response->metrics;
+                    metrics.dnsLookup = elapsed(std::max(host.resolveStarted, metrics.startTime), now);
+                }
+
+                if (host.addresses.empty()) {
+                    auto pending = std::move(host.pending);
+                    for (auto &transfer : pending) {
+                        fail(std::move(transfer));
+                    }
+                    return;
+                }
+
+                dispatch(hostKey);
+            }
+
+            void openConnection(const String &hostKey, Host &host, std::unique_ptr<Transfer> transfer,
+                                size_t addressIndex)
+            {
+                auto &address = host.addresses[addressIndex];
+
+                int fd = ::socket(address.storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                if (fd < 0) {
+                    fail(std::move(transfer));
+                    return;
+                }
+
+                int noDelay = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+                auto connection = std::make_unique<Connection>();
+                connection->id = ++_lastConnectionId;
+                connection->fd = fd;
+                connection->hostKey = hostKey;
+                connection->addressIndex = addressIndex;
+                if (addressIndex == 0) {
+                    // Includes the attempts with further addresses
+                    transfer->connectStarted = Clock::now();
+                }
+                beginTransfer(*connection, std::move(transfer));
+
+                auto connectTimeout = connection->transfer->response->originalRequest.connectTimeout;
+                setDeadline(*connection->transfer, &Transfer::connectDeadline,
+                            connectTimeout.count() > 0 ? connectTimeout : _configuration.connectTimeout);
+
+                // Becomes writable once connected
+                connection->events = EPOLLOUT;
+                epoll_event event{};
+                event.events = connection->events;
+                event.data.u64 = connection->id;
+                ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event);
+
+                host.connectionCount++;
+                count(&HTTPClient::Statistics::connectionsOpened);
+
+                auto &opened = *connection;
+                _connections.emplace(opened.id, std::move(connection));
+
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                auto socketAddress = reinterpret_cast<const sockaddr *>(&address.storage);
+                if (::connect(fd, socketAddress, address.length) != 0 && errno != EINPROGRESS) {
+                    connectFailed(opened);
+                }
+            }
+
+            void connectFailed(Connection &connection)
+            {
+                auto transfer = std::move(connection.transfer);
+                auto hostKey = connection.hostKey;
+                auto nextAddress = connection.addressIndex + 1;
+                closeConnection(connection);
+
+                auto &host = _hosts[hostKey];
+                if (nextAddress < host.addresses.size()) {
+                    openConnection(hostKey, host, std::move(transfer), nextAddress);
+                    return;
+                }
+
+                // Resolve again for the next request, the addresses might have changed
+                host.addresses.clear();
+                fail(std::move(transfer));
+                dispatch(hostKey);
+            }
+
+            void closeConnection(Connection &connection)
+            {
+                ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+                ::close(connection.fd);
+
+                auto &host = _hosts[connection.hostKey];
+                host.connectionCount--;
+                auto &idle = host.idleConnections;
+                idle.erase(std::remove(idle.begin(), idle.end(), connection.id), idle.end());
+
+                _connections.erase(connection.id);
+            }
+
+            void watch(Connection &connection, uint32_t events)
+            {
+                if (connection.events != events) {
+                    connection.events = events;
+                    epoll_event event{};
+                    event.events = events;
+                    event.data.u64 = connection.id;
+                    ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+                }
+            }
+
+            void handleEvent(uint64_t id, uint32_t events)
+            {
+                auto it = _connections.find(id);
+                if (it == _connections.end()) {
+                    return;
+                }
+                auto &connection = *it->second;
+
+                if (!connection.transfer) {
+                    // An idle connection becomes readable when the server closes it
+                    closeConnection(connection);
+                    return;
+                }
+
+                if (!connection.connected) {
+                    int error = 0;
+                    socklen_t length = sizeof(error);
+                    ::getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                    if (error != 0 || (events & (EPOLLERR | EPOLLHUP)) != 0) {
+                        connectFailed(connection);
+                        return;
+                    }
+                    connection.connected = true;
+                    connection.transfer->connectDeadline = Clock::time_point::max();
+                    connection.transfer->response->metrics.connect =
+                        elapsed(connection.transfer->connectStarted, Clock::now());
+                }
+
+                auto &transfer = *connection.transfer;
+                if (connection.bytesSent < transfer.requestData.size() + transfer.bodySize) {
+                    sendRequest(connection);
+                } else {
+                    receive(connection);
+                }
+            }
+
+            void beginTransfer(Connection &connection, std::unique_ptr<Transfer> transfer)
+            {
+                const auto &request = transfer->response->originalRequest;
+                bool headRequest = request.method == http::Method::HEAD;
+                bool decodeContent = !request.header.contains("Accept-Encoding");
+                transfer->connectionId = connection.id;
+                transfer->sendStarted = Clock::time_point();
+                transfer->firstByte = Clock::time_point();
+                transfer->response->metrics.reusedConnection = connection.reused;
+                if (connection.reused) {
+                    transfer->response->metrics.connect = HTTPMetrics::Duration::zero();
+                }
+                connection.transfer = std::move(transfer);
+                connection.parser.emplace(*connection.transfer->response, *connection.transfer->handle, headRequest,
+                                          decodeContent);
+                connection.bytesSent = 0;
+                connection.receivedData = false;
+            }
+
+            void sendRequest(Connection &connection)
+            {
+                auto &transfer = *connection.transfer;
+                auto &data = transfer.requestData;
+                auto &bytes = transfer.response->originalRequest.body.bytes();
+                auto total = data.size() + transfer.bodySize;
+                if (transfer.sendStarted == Clock::time_point()) {
+                    transfer.sendStarted = Clock::now();
+                }
+
+                while (connection.bytesSent < total) {
+                    ssize_t sent = 0;
+                    if (connection.bytesSent < data.size()) {
+                        // MSG_MORE lets the first part of the body share a packet with the request head
+                        int flags = MSG_NOSIGNAL | (transfer.bodySize > 0 ? MSG_MORE : 0);
+                        sent = ::send(connection.fd, data.data() + connection.bytesSent,
+                                      data.size() - connection.bytesSent, flags);
+                    } else if (transfer.bodyFd >= 0) {
+                        off_t offset = static_cast<off_t>(connection.bytesSent - data.size());
+                        sent = ::sendfile(connection.fd, transfer.bodyFd, &offset, total - connection.bytesSent);
+                        if (sent == 0) {
+                            // The file got shorter than it was when the request started
+                            transferFailed(connection);
+                            return;
+                        }
+                    } else {
+                        sent = ::send(connection.fd, bytes->data() + (connection.bytesSent - data.size()),
+                                      total - connection.bytesSent, MSG_NOSIGNAL);
+                    }
+
+                    if (sent < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                            watch(connection, EPOLLOUT);
+                            return;
+                        }
+                        transferFailed(connection);
+                        return;
+                    }
+                    connection.bytesSent += sent;
+                    transfer.response->metrics.bytesSent += sent;
+                }
+
+                watch(connection, EPOLLIN | EPOLLRDHUP);
+            }
+
+            void receive(Connection &connection)
+            {
+                for (int i = 0; i < kMaxReadsPerEvent; i++) {
+                    auto received = ::recv(connection.fd, _readBuffer.data(), _readBuffer.size(), 0);
+
+                    if (received > 0) {
+                        auto &transfer = *connection.transfer;
+                        if (!connection.receivedData) {
+                            transfer.firstByte = Clock::now();
+                            transfer.response->metrics.timeToFirstByte =
+                                elapsed(transfer.sendStarted, transfer.firstByte);
+                        }
+                        transfer.response->metrics.bytesReceived += received;
+
+                        connection.receivedData = true;
+                        auto result = connection.parser->feed(_readBuffer.data(), received);
+                        if (result == ResponseParser::Result::Complete) {
+                            transferDone(connection);
+                            return;
+                        }
+                        if (result == ResponseParser::Result::Error) {
+                            transferFailed(connection);
+                            return;
+                        }
+                    } else if (received == 0) {
+                        if (connection.parser->finishOnClose()) {
+                            transferDone(connection);
+                        } else {
+                            transferFailed(connection);
+                        }
+                        return;
+                    } else if (errno != EINTR) {
+                        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                            transferFailed(connection);
+                        }
+                        return;
+                    }
+                }
+            }
+
+            void transferDone(Connection &connection)
+            {
+                auto transfer = std::move(connection.transfer);
+                auto hostKey = connection.hostKey;
+                bool keepAlive = connection.parser->keepAlive();
+                connection.parser.reset();
+
+                deliver(std::move(transfer));
+
+                if (keepAlive) {
+                    connection.idleSince = Clock::now();
+                    _hosts[hostKey].idleConnections.push_back(connection.id);
+                    watch(connection, EPOLLIN | EPOLLRDHUP);
+                } else {
+                    closeConnection(connection);
+                }
+
+                dispatch(hostKey);
+            }
+
+            void transferFailed(Connection &connection)
+            {
+                auto transfer = std::move(connection.transfer);
+                auto hostKey = connection.hostKey;
+
+                // The server may have closed a kept alive connection just as the request was sent. Idempotent
+                // requests can safely be repeated and are retried once in that case.
+                bool retry = connection.reused && !connection.receivedData && !transfer->retried &&
+                             isIdempotent(transfer->response->originalRequest.method);
+                closeConnection(connection);
+
+                if (retry) {
+                    transfer->retried = true;
+                    transfer->response->data.clear();
+                    enqueue(_hosts[hostKey], std::move(transfer), true);
+                } else {
+                    fail(std::move(transfer));
+                }
+
+                dispatch(hostKey);
+            }
+
+            void fail(std::unique_ptr<Transfer> transfer)
+            {
+                count(&HTTPClient::Statistics::failedRequests);
+
+                auto &response = *transfer->response;
+                response.responseCode = 0;
+                response.header.clear();
+                response.data.clear();
+                deliver(std::move(transfer));
+            }
+
+            void deliver(std::unique_ptr<Transfer> transfer)
+            {
+                _transfers.erase(transfer->id);
+
+                auto now = Clock::now();
+                auto &metrics = transfer->response->metrics;
+                metrics.total = elapsed(metrics.startTime, now);
+                if (transfer->firstByte != Clock::time_point()) {
+                    metrics.transfer = elapsed(transfer->firstByte, now);
+                }
+
+                auto finish = [response = transfer->response, handle = transfer->handle,
+                               observation = std::move(transfer->observation)]() mutable {
+                    response->metrics.cancelled = handle->isCancelled();
+                    if (observation) {
+                        observation->finished(*response);
+                    }
+                    if (!response->metrics.cancelled && response->originalRequest.doneHandler) {
+                        response->originalRequest.doneHandler(response);
+                    }
+                };
+
+                if (auto app = App()) {
+                    app->dispatchQueue()->dispatchAsync(std::move(finish));
+                } else {
+                    finish();
+                }
+            }
+
+          private:
+            HTTPClient::Configuration _configuration;
+
+            int _epollFd = -1;
+            int _wakeUpFd = -1;
+
+            mutable std::mutex _mutex;
+            std::vector<std::function<void()>> _commands;
+            bool _stopping = false;
+            HTTPClient::Statistics _statistics;
+
+            // Only used on the loop thread
+            std::unordered_map<String, Host> _hosts;
+            std::unordered_map<uint64_t, std::unique_ptr<Connection>> _connections;
+            uint64_t _lastConnectionId = kWakeUpId;
+            std::unordered_map<uint64_t, Transfer *> _transfers;
+            std::multimap<Clock::time_point, uint64_t> _deadlines;
+            std::vector<char> _readBuffer;
+
+            std::atomic<uint64_t> _lastTransferId{0};
+
+            std::unique_ptr<DispatchQueue> _resolver;
+            std::thread _thread;
+        };
+
+        void HTTPClientRequestHandle::abort()
+        {
+            if (auto loop = _loop.lock()) {
+                loop->cancel(_transferId);
+            }
+        }
+    }
+
+    HTTPClient::HTTPClient() : HTTPClient(Configuration()) {}
+
+    HTTPClient::HTTPClient(Configuration configuration)
+        : _loop(std::make_shared<detail::HTTPEventLoop>(configuration))
+    {}
+
+    HTTPClient::~HTTPClient() = default;
+
+    std::shared_ptr<HTTPClient> HTTPClient::shared()
+    {
+        static auto client = std::make_shared<HTTPClient>();
+        return client;
+    }
+
+    std::shared_ptr<HTTPRequestHandle> HTTPClient::request(HTTPRequest request)
+    {
+        return _loop->submit(std::move(request));
+    }
+
+    HTTPClient::Statistics HTTPClient::statistics() const { return _loop->statistics(); }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <bdn/String.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace bdn::net::posix::detail
+{
+    inline bool equalsIgnoreCase(StringView a, StringView b)
+    {
+        auto lower = [](char c) { return std::tolower(static_cast<unsigned char>(c)); };
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [&](char x, char y) { return lower(x) == lower(y); });
+    }
+
+    inline StringView trim(StringView text)
+    {
+        auto begin = text.find_first_not_of(" \t");
+        if (begin == StringView::npos) {
+            return {};
+        }
+        auto end = text.find_last_not_of(" \t");
+        return text.substr(begin, end - begin + 1);
+    }
+}
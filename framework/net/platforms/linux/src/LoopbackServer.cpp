@@ -0,0 +1,377 @@
+#include <bdn/net/posix/LoopbackServer.h>
+
+#include "HTTPText.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <optional>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace bdn::net::posix
+{
+    namespace
+    {
+        using detail::equalsIgnoreCase;
+        using detail::trim;
+
+        constexpr size_t kReadBufferSize = 64 * 1024;
+        constexpr size_t kChunkSize = 16 * 1024;
+
+        const char *reasonPhrase(int responseCode)
+        {
+            switch (responseCode) {
+            case 200:
+                return "OK";
+            case 204:
+                return "No Content";
+            case 304:
+                return "Not Modified";
+            case 400:
+                return "Bad Request";
+            case 404:
+                return "Not Found";
+            case 500:
+                return "Internal Server Error";
+            default:
+                return "Unknown";
+            }
+        }
+
+        std::optional<LoopbackServer::Request> parseRequestHead(StringView head)
+        {
+            LoopbackServer::Request request;
+
+            auto lineEnd = head.find("\r\n");
+            auto requestLine = head.substr(0, lineEnd);
+            auto methodEnd = requestLine.find(' ');
+            auto targetEnd = requestLine.find(' ', methodEnd + 1);
+            if (methodEnd == StringView::npos || targetEnd == StringView::npos) {
+                return std::nullopt;
+            }
+            request.method = String(requestLine.substr(0, methodEnd));
+            request.target = String(requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1));
+
+            while (lineEnd != StringView::npos) {
+                head.remove_prefix(lineEnd + 2);
+                lineEnd = head.find("\r\n");
+                auto line = head.substr(0, lineEnd);
+                auto colon = line.find(':');
+                if (colon == StringView::npos) {
+                    return std::nullopt;
+                }
+                request.headerFields.emplace_back(String(line.substr(0, colon)), String(trim(line.substr(colon + 1))));
+            }
+
+            return request;
+        }
+
+        void appendResponse(std::string &output, const LoopbackServer::Response &response, bool headRequest)
+        {
+            output += "HTTP/1.1 " + std::to_string(response.responseCode) + " " + reasonPhrase(response.responseCode) +
+                      "\r\n";
+            for (auto &field : response.headerFields) {
+                output += field.first + ": " + field.second + "\r\n";
+            }
+            if (response.close) {
+                output += "Connection: close\r\n";
+            }
+
+            bool hasBody = response.responseCode != 204 && response.responseCode != 304;
+            if (hasBody && response.chunked) {
+                output += "Transfer-Encoding: chunked\r\n";
+            } else if (hasBody) {
+                output += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+            }
+            output += "\r\n";
+
+            if (!hasBody || headRequest) {
+                return;
+            }
+
+            if (!response.chunked) {
+                output += response.body;
+                return;
+            }
+
+            char sizeLine[32];
+            for (size_t offset = 0; offset < response.body.size(); offset += kChunkSize) {
+                auto size = std::min(kChunkSize, response.body.size() - offset);
+                output.append(sizeLine, std::snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", size));
+                output.append(response.body, offset, size);
+                output += "\r\n";
+            }
+            output += "0\r\n\r\n";
+        }
+    }
+
+    struct LoopbackServer::Connection
+    {
+        int fd = -1;
+        std::string input;
+        std::string output;
+        size_t outputOffset = 0;
+        bool closeAfterOutput = false;
+    };
+
+    String LoopbackServer::Request::headerField(const String &name) const
+    {
+        for (auto &field : headerFields) {
+            if (equalsIgnoreCase(field.first, name)) {
+                return field.second;
+            }
+        }
+        return String();
+    }
+
+    LoopbackServer::LoopbackServer(Handler handler) : _handler(std::move(handler))
+    {
+        auto fail = [this](const char *what) {
+            int error = errno;
+            for (int fd : {_listenFd, _epollFd, _stopFd}) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+            throw std::system_error(error, std::generic_category(), what);
+        };
+
+        _listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (_listenFd < 0) {
+            fail("socket failed");
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto socketAddress = reinterpret_cast<sockaddr *>(&address);
+        if (::bind(_listenFd, socketAddress, length) != 0 || ::listen(_listenFd, SOMAXCONN) != 0 ||
+            ::getsockname(_listenFd, socketAddress, &length) != 0) {
+            fail("listening on the loopback interface failed");
+        }
+        _port = ntohs(address.sin_port);
+
+        _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        _stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_epollFd < 0 || _stopFd < 0) {
+            fail("creating the event loop failed");
+        }
+
+        for (int fd : {_listenFd, _stopFd}) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event);
+        }
+
+        _thread = std::thread(&LoopbackServer::run, this);
+    }
+
+    LoopbackServer::~LoopbackServer()
+    {
+        uint64_t one = 1;
+        [[maybe_unused]] auto result = ::write(_stopFd, &one, sizeof(one));
+        _thread.join();
+
+        for (auto &connection : _connections) {
+            ::close(connection.first);
+        }
+        ::close(_listenFd);
+        ::close(_stopFd);
+        ::close(_epollFd);
+    }
+
+    String LoopbackServer::url(const String &target) const
+    {
+        return "http://127.0.0.1:" + std::to_string(_port) + target;
+    }
+
+    LoopbackServer::Statistics LoopbackServer::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _statistics;
+    }
+
+    void LoopbackServer::run()
+    {
+        std::vector<epoll_event> events(64);
+
+        while (true) {
+            int eventCount = ::epoll_wait(_epollFd, events.data(), static_cast<int>(events.size()), -1);
+            if (eventCount < 0 && errno != EINTR) {
+                return;
+            }
+
+            for (int i = 0; i < eventCount; i++) {
+                int fd = events[i].data.fd;
+                if (fd == _stopFd) {
+                    return;
+                }
+                if (fd == _listenFd) {
+                    accept();
+                    continue;
+                }
+
+                auto it = _connections.find(fd);
+                if (it == _connections.end()) {
+                    continue;
+                }
+                if ((events[i].events & EPOLLOUT) != 0) {
+                    send(*it->second);
+                } else {
+                    receive(*it->second);
+                }
+            }
+        }
+    }
+
+    void LoopbackServer::accept()
+    {
+        while (true) {
+            int fd = ::accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event);
+
+            auto connection = std::make_unique<Connection>();
+            connection->fd = fd;
+            _connections[fd] = std::move(connection);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _statistics.connections++;
+        }
+    }
+
+    void LoopbackServer::receive(Connection &connection)
+    {
+        char buffer[kReadBufferSize];
+
+        while (true) {
+            auto received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                connection.input.append(buffer, received);
+            } else if (received < 0 && errno == EINTR) {
+                continue;
+            } else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                closeConnection(connection.fd);
+                return;
+            }
+        }
+
+        if (handleRequests(connection)) {
+            send(connection);
+        }
+    }
+
+    bool LoopbackServer::handleRequests(Connection &connection)
+    {
+        while (!connection.closeAfterOutput) {
+            auto headEnd = connection.input.find("\r\n\r\n");
+            if (headEnd == String::npos) {
+                break;
+            }
+
+            auto request = parseRequestHead(StringView(connection.input).substr(0, headEnd));
+            if (!request) {
+                closeConnection(connection.fd);
+                return false;
+            }
+
+            auto contentLength = request->headerField("Content-Length");
+            if (contentLength.find_first_not_of("0123456789") != String::npos || contentLength.size() > 15) {
+                closeConnection(connection.fd);
+                return false;
+            }
+            size_t bodyLength = contentLength.empty() ? 0 : std::stoul(contentLength);
+            if (connection.input.size() < headEnd + 4 + bodyLength) {
+                break;
+            }
+            request->body = connection.input.substr(headEnd + 4, bodyLength);
+            connection.input.erase(0, headEnd + 4 + bodyLength);
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _statistics.requests++;
+            }
+
+            Response response;
+            try {
+                response = _handler(*request);
+            }
+            catch (std::exception &) {
+                response = Response();
+                response.responseCode = 500;
+            }
+
+            response.close = response.close || equalsIgnoreCase(request->headerField("Connection"), "close");
+            appendResponse(connection.output, response, request->method == "HEAD");
+            connection.closeAfterOutput = response.close;
+        }
+
+        return true;
+    }
+
+    void LoopbackServer::send(Connection &connection)
+    {
+        while (connection.outputOffset < connection.output.size()) {
+            auto sent = ::send(connection.fd, connection.output.data() + connection.outputOffset,
+                               connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                epoll_event event{};
+                event.events = EPOLLOUT;
+                event.data.fd = connection.fd;
+                ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+                return;
+            }
+            if (sent < 0) {
+                closeConnection(connection.fd);
+                return;
+            }
+            connection.outputOffset += sent;
+        }
+
+        connection.output.clear();
+        connection.outputOffset = 0;
+
+        if (connection.closeAfterOutput) {
+            closeConnection(connection.fd);
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = connection.fd;
+        ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    }
+
+    void LoopbackServer::closeConnection(int fd)
+    {
+        ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        _connections.erase(fd);
+    }
+}
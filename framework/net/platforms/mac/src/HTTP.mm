@@ -1,56 +1,294 @@
 #include <bdn/Application.h>
 #include <bdn/config.h>
 #include <bdn/net/HTTP.h>
+#include <bdn/net/HTTPObserver.h>
 #include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPRequestBody.h>
+#include <bdn/net/HTTPRequestHandle.h>
 #include <bdn/net/HTTPResponse.h>
 
 #import <bdn/foundationkit/stringUtil.hh>
 
 #import <Foundation/Foundation.h>
 
-namespace bdn
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace bdn::net::http
 {
-    namespace net
+    namespace
     {
-        namespace http
+        class SessionTaskHandle : public HTTPRequestHandle
         {
-            void request(HTTPRequest request)
-            {
-                std::shared_ptr<HTTPResponse> response = std::make_shared<HTTPResponse>();
+          public:
+            NSURLSessionTask *task = nil;
 
-                response->originalRequest = request;
+          protected:
+            void abort() override { [task cancel]; }
+        };
 
-                NSURLSession *session = [NSURLSession sharedSession];
-                NSURL *nsURL = [NSURL URLWithString:fk::stringToNSString(request.url)];
-                if (nsURL == nullptr) {
-                    return;
-                }
+        void fillResponse(HTTPResponse &response, NSURLResponse *nsResponse)
+        {
+            auto nsHTTPResponse = (NSHTTPURLResponse *)nsResponse;
 
-                NSURLSessionDataTask *dataTask = [session
-                      dataTaskWithURL:nsURL
-                    completionHandler:^(NSData *_Nullable nsData, NSURLResponse *_Nullable nsResponse,
-                                        NSError *_Nullable error) {
-                      App()->dispatchQueue()->dispatchAsync([nsData, nsResponse, response]() {
-                          auto nsHTTPResponse = (NSHTTPURLResponse *)nsResponse;
+            response.url = fk::nsStringToString([nsHTTPResponse.URL absoluteString]);
+            response.responseCode = (int)nsHTTPResponse.statusCode;
+
+            response.header.clear();
+            for (NSString *name in nsHTTPResponse.allHeaderFields) {
+                NSString *value = nsHTTPResponse.allHeaderFields[name];
+                response.header.add(fk::nsStringToString(name), fk::nsStringToString(value));
+            }
+        }
 
-                          response->url = fk::nsStringToString([nsHTTPResponse.URL absoluteString]);
-                          response->responseCode = (int)nsHTTPResponse.statusCode;
+        /** A task of the session, from its start until its response is delivered. */
+        struct Exchange
+        {
+            std::shared_ptr<HTTPResponse> response;
+            std::shared_ptr<HTTPRequestHandle> handle;
+            std::optional<net::detail::HTTPObservation> observation;
+        };
 
-                          response->header =
-                              fk::nsStringToString([NSString stringWithFormat:@"%@", nsHTTPResponse.allHeaderFields]);
+        HTTPMetrics::Duration between(NSDate *from, NSDate *to)
+        {
+            if (from == nil || to == nil) {
+                return HTTPMetrics::Duration::zero();
+            }
+            return std::chrono::duration_cast<HTTPMetrics::Duration>(
+                std::chrono::duration<double>([to timeIntervalSinceDate:from]));
+        }
 
-                          response->data = String(static_cast<const char *>(nsData.bytes), nsData.length);
+        /** The phases are those of the last transaction, which received the response after any redirects.
+            The bytes are those of all transactions. */
+        void fillMetrics(HTTPMetrics &metrics, NSURLSessionTask *task, NSURLSessionTaskMetrics *taskMetrics)
+        {
+            NSURLSessionTaskTransactionMetrics *last = taskMetrics.transactionMetrics.lastObject;
+            if (last == nil) {
+                return;
+            }
 
-                          if (response->originalRequest.doneHandler) {
-                              response->originalRequest.doneHandler(response);
-                          }
-                      });
-                    }];
+            NSDate *tlsStart = last.secureConnectionStartDate;
+            metrics.dnsLookup = between(last.domainLookupStartDate, last.domainLookupEndDate);
+            metrics.connect = between(last.connectStartDate, tlsStart != nil ? tlsStart : last.connectEndDate);
+            metrics.tlsHandshake = between(tlsStart, last.secureConnectionEndDate);
+            metrics.timeToFirstByte = between(last.requestStartDate, last.responseStartDate);
+            metrics.transfer = between(last.responseStartDate, last.responseEndDate);
+            metrics.reusedConnection = last.reusedConnection;
 
-                if (dataTask != nullptr) {
-                    [dataTask resume];
+            if (@available(macOS 10.15, iOS 13.0, *)) {
+                metrics.bytesSent = 0;
+                metrics.bytesReceived = 0;
+                for (NSURLSessionTaskTransactionMetrics *transaction in taskMetrics.transactionMetrics) {
+                    metrics.bytesSent += transaction.countOfRequestHeaderBytesSent +
+                                         transaction.countOfRequestBodyBytesSent;
+                    metrics.bytesReceived += transaction.countOfResponseHeaderBytesReceived +
+                                             transaction.countOfResponseBodyBytesReceived;
                 }
+            } else {
+                metrics.bytesSent = static_cast<uint64_t>(task.countOfBytesSent);
+                metrics.bytesReceived = static_cast<uint64_t>(task.countOfBytesReceived);
             }
         }
     }
 }
+
+/** Collects the body and the metrics of every task. The body of streaming requests is passed to their
+    HTTPRequest::dataHandler as it arrives instead. */
+@interface BdnHTTPSessionDelegate : NSObject <NSURLSessionDataDelegate>
+- (void)addTask:(NSURLSessionTask *)task exchange:(std::shared_ptr<bdn::net::http::Exchange>)exchange;
+@end
+
+@implementation BdnHTTPSessionDelegate {
+    std::mutex _mutex;
+    std::unordered_map<NSUInteger, std::shared_ptr<bdn::net::http::Exchange>> _exchanges;
+}
+
+- (void)addTask:(NSURLSessionTask *)task exchange:(std::shared_ptr<bdn::net::http::Exchange>)exchange
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _exchanges[task.taskIdentifier] = std::move(exchange);
+}
+
+- (std::shared_ptr<bdn::net::http::Exchange>)exchangeForTask:(NSURLSessionTask *)task remove:(BOOL)remove
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _exchanges.find(task.taskIdentifier);
+    if (it == _exchanges.end()) {
+        return nullptr;
+    }
+    auto exchange = it->second;
+    if (remove) {
+        _exchanges.erase(it);
+    }
+    return exchange;
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
+{
+    auto exchange = [self exchangeForTask:dataTask remove:NO];
+    if (!exchange || exchange->handle->isCancelled()) {
+        return;
+    }
+
+    // NSData may consist of several discontiguous buffers, none of which is copied for streaming requests
+    auto &response = *exchange->response;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+      if (response.originalRequest.dataHandler) {
+          response.originalRequest.dataHandler(bdn::asBytes(bytes, byteRange.length));
+      } else {
+          response.data.append(static_cast<const char *>(bytes), byteRange.length);
+      }
+    }];
+}
+
+// Called before URLSession:task:didCompleteWithError:
+- (void)URLSession:(NSURLSession *)session
+                          task:(NSURLSessionTask *)task
+    didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
+{
+    if (auto exchange = [self exchangeForTask:task remove:NO]) {
+        bdn::net::http::fillMetrics(exchange->response->metrics, task, metrics);
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
+{
+    auto exchange = [self exchangeForTask:task remove:YES];
+    if (!exchange) {
+        return;
+    }
+
+    auto &metrics = exchange->response->metrics;
+    metrics.total = std::chrono::duration_cast<bdn::net::HTTPMetrics::Duration>(
+        bdn::net::HTTPMetrics::Clock::now() - metrics.startTime);
+
+    NSURLResponse *nsResponse = error == nil ? task.response : nil;
+    bdn::App()->dispatchQueue()->dispatchAsync([exchange, nsResponse]() {
+        auto &response = exchange->response;
+        response->metrics.cancelled = exchange->handle->isCancelled();
+        if (response->metrics.cancelled) {
+            exchange->observation->finished(*response);
+            return;
+        }
+
+        // Observed before the doneHandler, but with the status and header of the response
+        bdn::net::http::fillResponse(*response, nsResponse);
+        exchange->observation->finished(*response);
+        if (response->originalRequest.doneHandler) {
+            response->originalRequest.doneHandler(response);
+        }
+    });
+}
+@end
+
+namespace bdn::net::http
+{
+    namespace
+    {
+        // Metrics and streaming need a delegate, which the shared session does not have. The delegate queue
+        // is serial, so the chunks of a response arrive in order.
+        std::pair<NSURLSession *, BdnHTTPSessionDelegate *> delegateSession()
+        {
+            static BdnHTTPSessionDelegate *delegate = [[BdnHTTPSessionDelegate alloc] init];
+            static NSURLSession *session = []() {
+                NSOperationQueue *queue = [[NSOperationQueue alloc] init];
+                queue.maxConcurrentOperationCount = 1;
+                return [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]
+                                                     delegate:delegate
+                                                delegateQueue:queue];
+            }();
+            return {session, delegate};
+        }
+
+        float taskPriority(Priority priority)
+        {
+            switch (priority) {
+            case Priority::Low:
+                return NSURLSessionTaskPriorityLow;
+            case Priority::Normal:
+                return NSURLSessionTaskPriorityDefault;
+            case Priority::High:
+                return NSURLSessionTaskPriorityHigh;
+            }
+            return NSURLSessionTaskPriorityDefault;
+        }
+
+        void start(NSURLSessionTask *task, const HTTPRequest &request)
+        {
+            task.priority = taskPriority(request.priority);
+
+            // Cancelling the task without cancelling the handle delivers a response without a status code
+            if (request.timeout.count() > 0) {
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, std::chrono::nanoseconds(request.timeout).count()),
+                               dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                                 [task cancel];
+                               });
+            }
+
+            [task resume];
+        }
+
+        /** Byte bodies are passed without copying them. File bodies are uploaded by the task itself. */
+        void setBody(NSMutableURLRequest *nsRequest, const HTTPRequestBody &body)
+        {
+            if (auto bytes = body.bytes(); bytes && !bytes->empty()) {
+                nsRequest.HTTPBody = [[NSData alloc] initWithBytesNoCopy:const_cast<char *>(bytes->data())
+                                                                  length:bytes->size()
+                                                             deallocator:^(void *, NSUInteger) {
+                                                               // Keeps the bytes alive until then
+                                                               (void)bytes;
+                                                             }];
+            }
+        }
+
+        NSURL *fileURL(const HTTPRequestBody &body)
+        {
+            return body.isFile() ? [NSURL fileURLWithPath:fk::stringToNSString(body.path())] : nil;
+        }
+    }
+
+    std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request)
+    {
+        std::shared_ptr<HTTPResponse> response = std::make_shared<HTTPResponse>();
+        auto handle = std::make_shared<SessionTaskHandle>();
+
+        response->originalRequest = request;
+        response->metrics.startTime = HTTPMetrics::Clock::now();
+
+        NSURL *nsURL = [NSURL URLWithString:fk::stringToNSString(request.url)];
+        if (nsURL == nullptr) {
+            return handle;
+        }
+
+        // timeoutInterval limits the time without any data arriving, not only connecting
+        NSMutableURLRequest *nsRequest = [NSMutableURLRequest requestWithURL:nsURL];
+        if (request.connectTimeout.count() > 0) {
+            nsRequest.timeoutInterval = std::chrono::duration<double>(request.connectTimeout).count();
+        }
+
+        nsRequest.HTTPMethod = fk::stringToNSString(methodName(request.method));
+        for (auto field : request.header) {
+            [nsRequest addValue:fk::stringToNSString(String(field.value))
+                forHTTPHeaderField:fk::stringToNSString(String(field.name))];
+        }
+        setBody(nsRequest, request.body);
+        NSURL *bodyFile = fileURL(request.body);
+
+        // Upload tasks read the file while sending it
+        auto [session, delegate] = delegateSession();
+        NSURLSessionDataTask *dataTask = bodyFile != nil
+                                             ? [session uploadTaskWithRequest:nsRequest fromFile:bodyFile]
+                                             : [session dataTaskWithRequest:nsRequest];
+        if (dataTask != nullptr) {
+            handle->task = dataTask;
+            auto exchange = std::make_shared<Exchange>();
+            exchange->response = response;
+            exchange->handle = handle;
+            exchange->observation.emplace(request);
+            [delegate addTask:dataTask exchange:exchange];
+            start(dataTask, request);
+        }
+        return handle;
+    }
+}
@@ -0,0 +1,1039 @@
+#include <bdn/net/HTTPCache.h>
+
+#include <bdn/Application.h>
+#include <bdn/DispatchQueue.h>
+#include <bdn/net/HTTPHeader.h>
+#include <bdn/net/HTTPResponse.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace bdn::net
+{
+    namespace
+    {
+        using Clock = std::chrono::system_clock;
+        using Seconds = std::chrono::seconds;
+
+        constexpr char kFileMagic[] = "BDNHTTPCACHE1\n";
+        constexpr Seconds kMaxHeuristicLifetime{24 * 60 * 60};
+
+        constexpr auto equalsIgnoreCase = &HTTPHeader::equalsIgnoreCase;
+
+        StringView trim(StringView text)
+        {
+            auto begin = text.find_first_not_of(" \t\r");
+            if (begin == StringView::npos) {
+                return {};
+            }
+            auto end = text.find_last_not_of(" \t\r");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        /** Calls function(item) for every item of a comma separated list. */
+        template <class Function> void forEachListItem(StringView list, Function function)
+        {
+            while (!list.empty()) {
+                auto comma = list.find(',');
+                auto item = trim(list.substr(0, comma));
+                if (!item.empty()) {
+                    function(item);
+                }
+                list = comma == StringView::npos ? StringView() : list.substr(comma + 1);
+            }
+        }
+
+        std::optional<Seconds> parseSeconds(StringView text)
+        {
+            if (text.empty() || text.size() > 12) {
+                return std::nullopt;
+            }
+            Seconds::rep value = 0;
+            for (char c : text) {
+                if (std::isdigit(static_cast<unsigned char>(c)) == 0) {
+                    return std::nullopt;
+                }
+                value = value * 10 + (c - '0');
+            }
+            return Seconds(value);
+        }
+
+        /** Accepts the IMF-fixdate, RFC 850 and asctime formats of RFC 7231, section 7.1.1.1. */
+        std::optional<Clock::time_point> parseHTTPDate(StringView text)
+        {
+            static const char *const months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                                 "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+            String copy(text);
+            char month[4] = {};
+            int day = 0;
+            int year = 0;
+            int hour = 0;
+            int minute = 0;
+            int second = 0;
+
+            if (std::sscanf(copy.c_str(), "%*[a-zA-Z], %d %3s %d %d:%d:%d GMT", &day, month, &year, &hour, &minute,
+                            &second) == 6) {
+            } else if (std::sscanf(copy.c_str(), "%*[a-zA-Z], %d-%3s-%d %d:%d:%d GMT", &day, month, &year, &hour,
+                                   &minute, &second) == 6) {
+                if (year < 100) {
+                    year += year < 70 ? 2000 : 1900;
+                }
+            } else if (std::sscanf(copy.c_str(), "%*[a-zA-Z] %3s %d %d:%d:%d %d", month, &day, &hour, &minute,
+                                   &second, &year) != 6) {
+                return std::nullopt;
+            }
+
+            auto monthIt = std::find_if(std::begin(months), std::end(months),
+                                        [&](const char *name) { return equalsIgnoreCase(name, month); });
+            if (monthIt == std::end(months)) {
+                return std::nullopt;
+            }
+
+            std::tm time{};
+            time.tm_year = year - 1900;
+            time.tm_mon = static_cast<int>(monthIt - std::begin(months));
+            time.tm_mday = day;
+            time.tm_hour = hour;
+            time.tm_min = minute;
+            time.tm_sec = second;
+
+            auto seconds = ::timegm(&time);
+            if (seconds == -1) {
+                return std::nullopt;
+            }
+            return Clock::from_time_t(seconds);
+        }
+
+        /** The Cache-Control directives that a private cache acts on. */
+        struct CacheControl
+        {
+            bool noStore = false;
+            bool noCache = false;
+            bool mustRevalidate = false;
+            std::optional<Seconds> maxAge;
+            std::optional<Seconds> staleWhileRevalidate;
+
+            static CacheControl parse(const HTTPHeader &header)
+            {
+                CacheControl result;
+
+                auto field = header.combined("Cache-Control");
+                if (!field) {
+                    // Only used by HTTP/1.0 caches that do not know Cache-Control (RFC 7234, section 5.4)
+                    auto pragma = header.get("Pragma");
+                    result.noCache = pragma && equalsIgnoreCase(*pragma, "no-cache");
+                    return result;
+                }
+
+                forEachListItem(*field, [&](StringView directive) {
+                    auto equals = directive.find('=');
+                    auto name = trim(directive.substr(0, equals));
+                    auto value = equals == StringView::npos ? StringView() : trim(directive.substr(equals + 1));
+                    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                        value = value.substr(1, value.size() - 2);
+                    }
+
+                    if (equalsIgnoreCase(name, "no-store")) {
+                        result.noStore = true;
+                    } else if (equalsIgnoreCase(name, "no-cache")) {
+                        result.noCache = true;
+                    } else if (equalsIgnoreCase(name, "must-revalidate")) {
+                        result.mustRevalidate = true;
+                    } else if (equalsIgnoreCase(name, "max-age")) {
+                        result.maxAge = parseSeconds(value);
+                    } else if (equalsIgnoreCase(name, "stale-while-revalidate")) {
+                        result.staleWhileRevalidate = parseSeconds(value);
+                    }
+                });
+                return result;
+            }
+        };
+
+        /** Status codes that may be cached without explicit freshness (RFC 7231, section 6.1). */
+        bool isHeuristicallyCacheable(int responseCode)
+        {
+            switch (responseCode) {
+            case 200:
+            case 203:
+            case 204:
+            case 300:
+            case 301:
+            case 404:
+            case 405:
+            case 410:
+            case 414:
+            case 501:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /** A stored response. Its body points into storage, a string or a file mapping. */
+        struct Entry
+        {
+            String key;
+            String url;
+            HTTPHeader header;
+            HTTPHeader varyFields; // the request's values of the fields named by Vary
+            int responseCode = 0;
+            Clock::time_point requestTime;
+            Clock::time_point responseTime;
+
+            std::shared_ptr<const void> storage;
+            ByteSpan body;
+
+            // Derived from the fields above by analyze()
+            CacheControl cacheControl;
+            bool explicitFreshness = false;
+            Seconds freshnessLifetime{0};
+            Seconds correctedInitialAge{0};
+            std::optional<String> etag;
+            std::optional<String> lastModified;
+
+            size_t size() const
+            {
+                return key.size() + url.size() + header.toString().size() + varyFields.toString().size() + body.size();
+            }
+
+            bool hasValidator() const { return etag || lastModified; }
+
+            Seconds currentAge(Clock::time_point now) const
+            {
+                auto residentTime = std::chrono::duration_cast<Seconds>(now - responseTime);
+                return correctedInitialAge + std::max(residentTime, Seconds(0));
+            }
+
+            /** Freshness and age as defined by RFC 7234, sections 4.2.1 to 4.2.3. */
+            void analyze()
+            {
+                cacheControl = CacheControl::parse(header);
+                etag = header.get("ETag");
+                lastModified = header.get("Last-Modified");
+
+                auto dateField = header.get("Date");
+                auto date = dateField ? parseHTTPDate(*dateField) : std::nullopt;
+                auto dateValue = date.value_or(responseTime);
+
+                freshnessLifetime = Seconds(0);
+                explicitFreshness = true;
+                if (cacheControl.maxAge) {
+                    freshnessLifetime = *cacheControl.maxAge;
+                } else if (auto expiresField = header.get("Expires")) {
+                    // Invalid dates like "0" mean already expired
+                    if (auto expires = parseHTTPDate(*expiresField); expires && *expires > dateValue) {
+                        freshnessLifetime = std::chrono::duration_cast<Seconds>(*expires - dateValue);
+                    }
+                } else {
+                    explicitFreshness = false;
+                    auto lastModifiedDate = lastModified ? parseHTTPDate(*lastModified) : std::nullopt;
+                    if (lastModifiedDate && *lastModifiedDate < dateValue && isHeuristicallyCacheable(responseCode)) {
+                        auto sinceModified = std::chrono::duration_cast<Seconds>(dateValue - *lastModifiedDate);
+                        freshnessLifetime = std::min(sinceModified / 10, kMaxHeuristicLifetime);
+                    }
+                }
+
+                auto ageField = header.get("Age");
+                auto ageValue = (ageField ? parseSeconds(*ageField) : std::nullopt).value_or(Seconds(0));
+                auto apparentAge = std::max(std::chrono::duration_cast<Seconds>(responseTime - dateValue), Seconds(0));
+                auto responseDelay = std::chrono::duration_cast<Seconds>(responseTime - requestTime);
+                correctedInitialAge = std::max(apparentAge, ageValue + std::max(responseDelay, Seconds(0)));
+            }
+
+            bool isStorable() const
+            {
+                if (cacheControl.noStore || responseCode == 206 || responseCode == 304 || responseCode < 200) {
+                    return false;
+                }
+                if (!isHeuristicallyCacheable(responseCode) && !explicitFreshness) {
+                    return false;
+                }
+                return freshnessLifetime.count() > 0 || hasValidator() || cacheControl.staleWhileRevalidate;
+            }
+        };
+
+        /** The request's values of the fields named by a response's Vary field, or nullopt for "Vary: *". */
+        std::optional<HTTPHeader> varyFields(const HTTPHeader &responseHeader, const HTTPHeader &requestHeader)
+        {
+            auto vary = responseHeader.combined("Vary");
+            if (!vary) {
+                return HTTPHeader();
+            }
+
+            std::optional<HTTPHeader> result = HTTPHeader();
+            forEachListItem(*vary, [&](StringView name) {
+                if (name == "*") {
+                    result.reset();
+                } else if (result) {
+                    try {
+                        result->add(name, requestHeader.combined(name).value_or(String()));
+                    }
+                    catch (const std::invalid_argument &) {
+                        // Not a field name, so the response cannot be matched to requests
+                        result.reset();
+                    }
+                }
+            });
+            return result;
+        }
+
+        String cacheKey(const String &url) { return url.substr(0, url.find('#')); }
+
+        String fileName(const String &key)
+        {
+            // 64 bit FNV-1a
+            uint64_t hash = 14695981039346656037ULL;
+            for (char c : key) {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+            }
+
+            char name[17];
+            std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+            return name;
+        }
+
+        class FileMapping
+        {
+          public:
+            static std::shared_ptr<FileMapping> open(const String &path)
+            {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    return nullptr;
+                }
+
+                struct stat status
+                {};
+                void *address = MAP_FAILED;
+                if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+                    address = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                }
+                // The mapping stays valid after closing, and after the file was replaced or removed
+                ::close(fd);
+
+                if (address == MAP_FAILED) {
+                    return nullptr;
+                }
+                return std::shared_ptr<FileMapping>(new FileMapping(address, static_cast<size_t>(status.st_size)));
+            }
+
+            ~FileMapping() { ::munmap(_address, _size); }
+
+            FileMapping(const FileMapping &) = delete;
+            FileMapping &operator=(const FileMapping &) = delete;
+
+            StringView contents() const { return StringView(static_cast<const char *>(_address), _size); }
+
+          private:
+            FileMapping(void *address, size_t size) : _address(address), _size(size) {}
+
+            void *_address;
+            size_t _size;
+        };
+
+        /** Everything of a cache file but the body, which follows it. */
+        String fileHead(const Entry &entry)
+        {
+            char line[200];
+            std::snprintf(line, sizeof(line), "%d %lld %lld %zu %zu %zu %zu %zu\n", entry.responseCode,
+                          static_cast<long long>(Clock::to_time_t(entry.requestTime)),
+                          static_cast<long long>(Clock::to_time_t(entry.responseTime)), entry.key.size(),
+                          entry.url.size(), entry.header.toString().size(), entry.varyFields.toString().size(),
+                          entry.body.size());
+
+            String head = kFileMagic;
+            head += line;
+            head += entry.key;
+            head += entry.url;
+            head += entry.header.toString();
+            head += entry.varyFields.toString();
+            return head;
+        }
+
+        std::shared_ptr<Entry> readFile(const String &path)
+        {
+            auto mapping = FileMapping::open(path);
+            if (!mapping) {
+                return nullptr;
+            }
+
+            auto contents = mapping->contents();
+            StringView magic(kFileMagic);
+            if (contents.substr(0, magic.size()) != magic) {
+                return nullptr;
+            }
+            contents.remove_prefix(magic.size());
+
+            auto lineEnd = contents.find('\n');
+            if (lineEnd == StringView::npos || lineEnd > 200) {
+                return nullptr;
+            }
+
+            String line(contents.substr(0, lineEnd));
+            contents.remove_prefix(lineEnd + 1);
+
+            int responseCode = 0;
+            long long requestTime = 0;
+            long long responseTime = 0;
+            size_t sizes[5] = {};
+            if (std::sscanf(line.c_str(), "%d %lld %lld %zu %zu %zu %zu %zu", &responseCode, &requestTime,
+                            &responseTime, &sizes[0], &sizes[1], &sizes[2], &sizes[3], &sizes[4]) != 8) {
+                return nullptr;
+            }
+
+            StringView parts[5];
+            for (size_t i = 0; i < 5; i++) {
+                if (sizes[i] > contents.size()) {
+                    return nullptr;
+                }
+                parts[i] = contents.substr(0, sizes[i]);
+                contents.remove_prefix(sizes[i]);
+            }
+            if (!contents.empty()) {
+                return nullptr;
+            }
+
+            auto entry = std::make_shared<Entry>();
+            entry->key = parts[0];
+            entry->url = parts[1];
+            entry->header = HTTPHeader::parse(parts[2]);
+            entry->varyFields = HTTPHeader::parse(parts[3]);
+            entry->responseCode = responseCode;
+            entry->requestTime = Clock::from_time_t(static_cast<std::time_t>(requestTime));
+            entry->responseTime = Clock::from_time_t(static_cast<std::time_t>(responseTime));
+            entry->body = asBytes(parts[4].data(), parts[4].size());
+            entry->storage = std::move(mapping);
+            entry->analyze();
+            return entry;
+        }
+
+        bool writeAll(int fd, const void *data, size_t size)
+        {
+            auto bytes = static_cast<const char *>(data);
+            while (size > 0) {
+                auto written = ::write(fd, bytes, size);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        /** Replaces the file atomically, so that readers never see a partially written one. */
+        void writeFile(const String &path, const String &head, ByteSpan body)
+        {
+            auto temporaryPath = path + ".tmp";
+            int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+            if (fd < 0) {
+                return;
+            }
+
+            bool written = writeAll(fd, head.data(), head.size()) && writeAll(fd, body.data(), body.size());
+            ::close(fd);
+
+            if (!written || ::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+                ::unlink(temporaryPath.c_str());
+            }
+        }
+
+        void createDirectories(const String &path)
+        {
+            for (auto slash = path.find('/', 1); slash != String::npos; slash = path.find('/', slash + 1)) {
+                ::mkdir(path.substr(0, slash).c_str(), 0700);
+            }
+            ::mkdir(path.c_str(), 0700);
+        }
+
+        /** Least recently used items first, each with a size that counts towards the total. */
+        template <class Value> class LRUList
+        {
+          public:
+            Value *find(const String &key)
+            {
+                auto it = _index.find(key);
+                if (it == _index.end()) {
+                    return nullptr;
+                }
+                _items.splice(_items.end(), _items, it->second);
+                return &it->second->value;
+            }
+
+            void insert(const String &key, Value value, size_t size)
+            {
+                remove(key);
+                _items.push_back(Item{key, std::move(value), size});
+                _index[key] = std::prev(_items.end());
+                _size += size;
+            }
+
+            void remove(const String &key)
+            {
+                auto it = _index.find(key);
+                if (it != _index.end()) {
+                    _size -= it->second->size;
+                    _items.erase(it->second);
+                    _index.erase(it);
+                }
+            }
+
+            Value removeOldest()
+            {
+                auto value = std::move(_items.front().value);
+                _size -= _items.front().size;
+                _index.erase(_items.front().key);
+                _items.pop_front();
+                return value;
+            }
+
+            void clear()
+            {
+                _items.clear();
+                _index.clear();
+                _size = 0;
+            }
+
+            bool empty() const { return _items.empty(); }
+            size_t size() const { return _size; }
+
+          private:
+            struct Item
+            {
+                String key;
+                Value value;
+                size_t size;
+            };
+
+            std::list<Item> _items;
+            std::unordered_map<String, typename std::list<Item>::iterator> _index;
+            size_t _size = 0;
+        };
+
+        /** Keeps the beginning of a streamed body, for storing it once it is complete. */
+        class BodyCollector
+        {
+          public:
+            explicit BodyCollector(size_t limit) : _limit(limit) {}
+
+            void append(ByteSpan chunk)
+            {
+                if (!_overflowed && _body.size() + chunk.size() <= _limit) {
+                    _body.append(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+                } else {
+                    _overflowed = true;
+                    _body = String();
+                }
+            }
+
+            std::optional<String> take() { return _overflowed ? std::nullopt : std::optional(std::move(_body)); }
+
+          private:
+            size_t _limit;
+            String _body;
+            bool _overflowed = false;
+        };
+
+        std::shared_ptr<HTTPResponse> responseFromEntry(const Entry &entry, HTTPRequest request)
+        {
+            auto response = std::make_shared<HTTPResponse>();
+            response->originalRequest = std::move(request);
+            response->url = entry.url;
+            response->header = entry.header;
+            response->responseCode = entry.responseCode;
+            if (!response->originalRequest.dataHandler) {
+                response->data.assign(reinterpret_cast<const char *>(entry.body.data()), entry.body.size());
+            }
+            return response;
+        }
+
+        void complete(const std::shared_ptr<HTTPResponse> &response, ByteSpan storedBody)
+        {
+            auto &request = response->originalRequest;
+            if (request.dataHandler && !storedBody.empty()) {
+                request.dataHandler(storedBody);
+            }
+            if (request.doneHandler) {
+                request.doneHandler(response);
+            }
+        }
+
+        /** The stored header with the fields of a 304 response replacing those of the same name. */
+        HTTPHeader updatedHeader(const HTTPHeader &storedHeader, const HTTPHeader &notModifiedHeader)
+        {
+            auto isUpdated = [&](StringView name) {
+                // Describe the 304 message itself, not the stored body (RFC 7232, section 4.1)
+                if (equalsIgnoreCase(name, "Content-Length") || equalsIgnoreCase(name, "Transfer-Encoding") ||
+                    equalsIgnoreCase(name, "Content-Encoding")) {
+                    return false;
+                }
+                return notModifiedHeader.contains(name);
+            };
+
+            HTTPHeader result;
+            for (auto field : storedHeader) {
+                if (!isUpdated(field.name)) {
+                    result.add(field.name, field.value);
+                }
+            }
+            for (auto field : notModifiedHeader) {
+                if (isUpdated(field.name)) {
+                    result.add(field.name, field.value);
+                }
+            }
+            return result;
+        }
+
+        // RFC 7234, section 4.4: every method that is not known to be safe invalidates
+        bool invalidatesStoredResponse(http::Method method)
+        {
+            switch (method) {
+            case http::Method::GET:
+            case http::Method::HEAD:
+            case http::Method::OPTIONS:
+            case http::Method::TRACE:
+                return false;
+            default:
+                return true;
+            }
+        }
+    }
+
+    namespace detail
+    {
+        class HTTPCacheStore : public std::enable_shared_from_this<HTTPCacheStore>
+        {
+          public:
+            explicit HTTPCacheStore(HTTPCache::Configuration configuration) : _configuration(std::move(configuration))
+            {
+                if (!_configuration.transport) {
+                    _configuration.transport = [](HTTPRequest request) { return http::request(std::move(request)); };
+                }
+
+                if (!_configuration.directory.empty()) {
+                    createDirectories(_configuration.directory);
+                    indexDirectory();
+                    _writer = std::make_unique<DispatchQueue>();
+                }
+            }
+
+            ~HTTPCacheStore() { flush(); }
+
+          public:
+            /** Waits until the disk writes scheduled so far are done. */
+            void flush()
+            {
+                if (_writer) {
+                    _writer->dispatchSync([]() {});
+                }
+            }
+
+            std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request)
+            {
+                if (request.method != http::Method::GET) {
+                    if (invalidatesStoredResponse(request.method)) {
+                        invalidateOnSuccess(request);
+                    }
+                    return _configuration.transport(std::move(request));
+                }
+
+                auto key = cacheKey(request.url);
+                auto requestCacheControl = CacheControl::parse(request.header);
+                if (requestCacheControl.noStore || request.header.contains("If-None-Match") ||
+                    request.header.contains("If-Modified-Since")) {
+                    count(&HTTPCache::Statistics::misses);
+                    return _configuration.transport(std::move(request));
+                }
+
+                if (auto entry = lookup(key, request.header)) {
+                    auto age = entry->currentAge(Clock::now());
+                    bool mayServeStored = !requestCacheControl.noCache && !entry->cacheControl.noCache;
+                    bool fresh = mayServeStored && age < entry->freshnessLifetime &&
+                                 (!requestCacheControl.maxAge || age <= *requestCacheControl.maxAge);
+                    if (fresh) {
+                        return answer(entry, std::move(request));
+                    }
+
+                    auto staleWhileRevalidate = entry->cacheControl.staleWhileRevalidate;
+                    if (mayServeStored && !entry->cacheControl.mustRevalidate && staleWhileRevalidate &&
+                        age < entry->freshnessLifetime + *staleWhileRevalidate) {
+                        revalidateInBackground(key, entry, request);
+                        return answer(entry, std::move(request));
+                    }
+
+                    if (entry->hasValidator()) {
+                        return send(key, std::move(request), entry);
+                    }
+                }
+
+                count(&HTTPCache::Statistics::misses);
+                return send(key, std::move(request), nullptr);
+            }
+
+            HTTPCache::Statistics statistics() const
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto statistics = _statistics;
+                statistics.memorySize = _memory.size();
+                statistics.diskSize = _disk.size();
+                return statistics;
+            }
+
+            void clear()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _memory.clear();
+                while (!_disk.empty()) {
+                    removeFile(_disk.removeOldest());
+                }
+            }
+
+          private:
+            void count(size_t HTTPCache::Statistics::*counter, size_t amount = 1)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _statistics.*counter += amount;
+            }
+
+            /** Memory first, then disk. Stored responses for other values of the Vary fields do not count. */
+            std::shared_ptr<const Entry> lookup(const String &key, const HTTPHeader &requestHeader)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                std::shared_ptr<const Entry> entry;
+                if (auto stored = _memory.find(key)) {
+                    entry = *stored;
+                } else if (auto path = _disk.find(fileName(key))) {
+                    auto loaded = readFile(*path);
+                    if (!loaded || loaded->key != key) {
+                        // Damaged, or another key with the same hash
+                        return nullptr;
+                    }
+
+                    entry = loaded;
+                    insertIntoMemory(entry);
+                    touchFile(*path);
+                }
+
+                if (entry && varyFields(entry->header, requestHeader) != entry->varyFields) {
+                    return nullptr;
+                }
+                return entry;
+            }
+
+            void insertIntoMemory(const std::shared_ptr<const Entry> &entry)
+            {
+                if (entry->size() > _configuration.memoryCapacity) {
+                    _memory.remove(entry->key);
+                    return;
+                }
+
+                _memory.insert(entry->key, entry, entry->size());
+                while (_memory.size() > _configuration.memoryCapacity) {
+                    _memory.removeOldest();
+                }
+            }
+
+            void store(const std::shared_ptr<const Entry> &entry)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                insertIntoMemory(entry);
+
+                if (_writer && entry->size() <= _configuration.diskCapacity) {
+                    auto path = _configuration.directory + "/" + fileName(entry->key);
+                    _disk.insert(fileName(entry->key), path, entry->size());
+                    _writer->dispatchAsync([path, entry]() { writeFile(path, fileHead(*entry), entry->body); });
+
+                    while (_disk.size() > _configuration.diskCapacity) {
+                        removeFile(_disk.removeOldest());
+                    }
+                }
+            }
+
+            void remove(const String &key)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _memory.remove(key);
+
+                auto name = fileName(key);
+                if (auto path = _disk.find(name)) {
+                    removeFile(*path);
+                    _disk.remove(name);
+                }
+            }
+
+            void removeFile(String path)
+            {
+                _writer->dispatchAsync([path = std::move(path)]() { ::unlink(path.c_str()); });
+            }
+
+            /** Keeps the order of least recent use across restarts. */
+            void touchFile(String path)
+            {
+                _writer->dispatchAsync([path = std::move(path)]() { ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0); });
+            }
+
+            void indexDirectory()
+            {
+                DIR *directory = ::opendir(_configuration.directory.c_str());
+                if (directory == nullptr) {
+                    return;
+                }
+
+                struct File
+                {
+                    String name;
+                    size_t size;
+                    std::time_t lastUsed;
+                };
+                std::vector<File> files;
+
+                while (auto directoryEntry = ::readdir(directory)) {
+                    String name = directoryEntry->d_name;
+                    auto path = _configuration.directory + "/" + name;
+
+                    struct stat status
+                    {};
+                    if (name.size() == 16 && ::stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode)) {
+                        files.push_back(File{name, static_cast<size_t>(status.st_size), status.st_mtime});
+                    } else if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+                        // Left behind by an interrupted write
+                        ::unlink(path.c_str());
+                    }
+                }
+                ::closedir(directory);
+
+                std::sort(files.begin(), files.end(),
+                          [](const File &a, const File &b) { return a.lastUsed < b.lastUsed; });
+                for (auto &file : files) {
+                    _disk.insert(file.name, _configuration.directory + "/" + file.name, file.size);
+                }
+                while (_disk.size() > _configuration.diskCapacity) {
+                    ::unlink(_disk.removeOldest().c_str());
+                }
+            }
+
+            std::shared_ptr<HTTPRequestHandle> answer(const std::shared_ptr<const Entry> &entry, HTTPRequest request)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _statistics.hits++;
+                    _statistics.bytesSaved += entry->body.size();
+                }
+
+                auto handle = std::make_shared<HTTPRequestHandle>();
+                App()->dispatchQueue()->dispatchAsync([entry, handle, request = std::move(request)]() mutable {
+                    if (!handle->isCancelled()) {
+                        complete(responseFromEntry(*entry, std::move(request)), entry->body);
+                    }
+                });
+                return handle;
+            }
+
+            void revalidateInBackground(const String &key, const std::shared_ptr<const Entry> &entry,
+                                        const HTTPRequest &request)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!_revalidating.insert(key).second) {
+                        return;
+                    }
+                }
+
+                HTTPRequest revalidation(request.url, [weakStore = weak_from_this(), key](auto) {
+                    if (auto store = weakStore.lock()) {
+                        std::lock_guard<std::mutex> lock(store->_mutex);
+                        store->_revalidating.erase(key);
+                    }
+                });
+                revalidation.header = request.header;
+                revalidation.priority = http::Priority::Low;
+                revalidation.connectTimeout = request.connectTimeout;
+                revalidation.timeout = request.timeout;
+
+                send(key, std::move(revalidation), entry->hasValidator() ? entry : nullptr);
+            }
+
+            /** A request sent by send(), with what is needed to store and deliver its response. */
+            struct Exchange
+            {
+                String key;
+                HTTPRequest originalRequest;
+                std::shared_ptr<BodyCollector> collector;
+                std::shared_ptr<const Entry> validated;
+                Clock::time_point requestTime;
+            };
+
+            /** Sends the request, conditionally if validated is set, and stores the response. */
+            std::shared_ptr<HTTPRequestHandle> send(const String &key, HTTPRequest request,
+                                                    std::shared_ptr<const Entry> validated)
+            {
+                auto exchange = std::make_shared<Exchange>();
+                exchange->key = key;
+                exchange->originalRequest = request;
+                exchange->validated = validated;
+                exchange->requestTime = Clock::now();
+
+                if (request.dataHandler) {
+                    exchange->collector = std::make_shared<BodyCollector>(_configuration.maxBodySize);
+                    request.dataHandler = [collector = exchange->collector,
+                                           dataHandler = std::move(request.dataHandler)](ByteSpan chunk) {
+                        collector->append(chunk);
+                        dataHandler(chunk);
+                    };
+                }
+
+                if (validated) {
+                    count(&HTTPCache::Statistics::revalidations);
+                    if (validated->etag) {
+                        request.header.set("If-None-Match", *validated->etag);
+                    }
+                    if (validated->lastModified) {
+                        request.header.set("If-Modified-Since", *validated->lastModified);
+                    }
+                }
+
+                request.doneHandler = [weakStore = weak_from_this(), exchange](std::shared_ptr<HTTPResponse> response) {
+                    // Restoring the original request destroys this handler, so its captures are copied first
+                    auto store = weakStore.lock();
+                    auto keptExchange = exchange;
+                    response->originalRequest = keptExchange->originalRequest;
+                    received(store, *keptExchange, response);
+                };
+
+                return _configuration.transport(std::move(request));
+            }
+
+            static void received(const std::shared_ptr<HTTPCacheStore> &store, const Exchange &exchange,
+                                 const std::shared_ptr<HTTPResponse> &response)
+            {
+                if (exchange.validated && response->responseCode == 304) {
+                    auto updated = std::make_shared<Entry>(*exchange.validated);
+                    updated->header = updatedHeader(exchange.validated->header, response->header);
+                    updated->requestTime = exchange.requestTime;
+                    updated->responseTime = Clock::now();
+                    updated->analyze();
+
+                    if (store) {
+                        store->count(&HTTPCache::Statistics::notModified);
+                        store->count(&HTTPCache::Statistics::bytesSaved, updated->body.size());
+                        store->store(updated);
+                    }
+                    // The metrics are those of the revalidation
+                    auto revalidated = responseFromEntry(*updated, exchange.originalRequest);
+                    revalidated->metrics = response->metrics;
+                    complete(revalidated, updated->body);
+                    return;
+                }
+
+                if (store) {
+                    store->storeIfAllowed(exchange, *response);
+                }
+                if (exchange.originalRequest.doneHandler) {
+                    exchange.originalRequest.doneHandler(response);
+                }
+            }
+
+            void storeIfAllowed(const Exchange &exchange, const HTTPResponse &response)
+            {
+                if (response.responseCode <= 0) {
+                    return;
+                }
+
+                auto entry = std::make_shared<Entry>();
+                entry->key = exchange.key;
+                entry->url = response.url;
+                entry->header = response.header;
+                entry->responseCode = response.responseCode;
+                entry->requestTime = exchange.requestTime;
+                entry->responseTime = Clock::now();
+                entry->analyze();
+
+                auto vary = varyFields(response.header, exchange.originalRequest.header);
+                auto body = exchange.collector ? exchange.collector->take() : std::optional(String(response.body()));
+                if (!entry->isStorable() || !vary || !body || body->size() > _configuration.maxBodySize) {
+                    // The stored response is outdated either way
+                    remove(exchange.key);
+                    return;
+                }
+
+                auto storage = std::make_shared<const String>(std::move(*body));
+                entry->varyFields = std::move(*vary);
+                entry->body = asBytes(storage->data(), storage->size());
+                entry->storage = std::move(storage);
+                store(entry);
+            }
+
+            void invalidateOnSuccess(HTTPRequest &request)
+            {
+                request.doneHandler = [weakStore = weak_from_this(), key = cacheKey(request.url),
+                                       doneHandler = std::move(request.doneHandler)](
+                                          std::shared_ptr<HTTPResponse> response) {
+                    if (response->responseCode >= 200 && response->responseCode < 400) {
+                        if (auto store = weakStore.lock()) {
+                            store->remove(key);
+                        }
+                    }
+
+                    // Destroys this handler, so its captures are copied first
+                    auto originalDoneHandler = doneHandler;
+                    response->originalRequest.doneHandler = originalDoneHandler;
+                    if (originalDoneHandler) {
+                        originalDoneHandler(response);
+                    }
+                };
+            }
+
+          private:
+            HTTPCache::Configuration _configuration;
+
+            mutable std::mutex _mutex;
+            HTTPCache::Statistics _statistics;
+            LRUList<std::shared_ptr<const Entry>> _memory;
+            LRUList<String> _disk; // file name to path
+            std::unordered_set<String> _revalidating;
+
+            // Writes and removes files in order
+            std::unique_ptr<DispatchQueue> _writer;
+        };
+    }
+
+    HTTPCache::HTTPCache() : HTTPCache(Configuration()) {}
+
+    HTTPCache::HTTPCache(Configuration configuration)
+        : _store(std::make_shared<detail::HTTPCacheStore>(std::move(configuration)))
+    {}
+
+    HTTPCache::~HTTPCache()
+    {
+        // A response handler that is still running may hold the last reference to the store
+        _store->flush();
+    }
+
+    std::shared_ptr<HTTPRequestHandle> HTTPCache::request(HTTPRequest request)
+    {
+        return _store->request(std::move(request));
+    }
+
+    HTTPCache::Statistics HTTPCache::statistics() const { return _store->statistics(); }
+
+    void HTTPCache::clear() { _store->clear(); }
+}
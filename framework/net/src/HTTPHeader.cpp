@@ -0,0 +1,163 @@
+#include <bdn/net/HTTPHeader.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace bdn::net
+{
+    namespace
+    {
+        StringView trim(StringView text)
+        {
+            auto begin = text.find_first_not_of(" \t\r");
+            if (begin == StringView::npos) {
+                return {};
+            }
+            auto end = text.find_last_not_of(" \t\r");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        bool isToken(StringView name)
+        {
+            return !name.empty() && std::all_of(name.begin(), name.end(), [](char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) != 0 || std::strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+            });
+        }
+
+        /** Splits off the first "Name: value\r\n" line of text, which must be in the wire format. */
+        HTTPHeader::Field firstField(StringView text, size_t *lineSize)
+        {
+            auto colon = text.find(':');
+            auto lineEnd = text.find("\r\n", colon);
+            *lineSize = lineEnd + 2;
+            return {text.substr(0, colon), text.substr(colon + 2, lineEnd - colon - 2)};
+        }
+    }
+
+    HTTPHeader::Field HTTPHeader::Iterator::operator*() const
+    {
+        size_t lineSize = 0;
+        return firstField(_remaining, &lineSize);
+    }
+
+    HTTPHeader::Iterator &HTTPHeader::Iterator::operator++()
+    {
+        size_t lineSize = 0;
+        firstField(_remaining, &lineSize);
+        _remaining.remove_prefix(lineSize);
+        return *this;
+    }
+
+    HTTPHeader::HTTPHeader(std::initializer_list<Field> fields)
+    {
+        for (auto &field : fields) {
+            add(field.name, field.value);
+        }
+    }
+
+    HTTPHeader HTTPHeader::parse(StringView text)
+    {
+        HTTPHeader header;
+        while (!text.empty()) {
+            auto lineEnd = text.find('\n');
+            auto line = text.substr(0, lineEnd);
+            text = lineEnd == StringView::npos ? StringView() : text.substr(lineEnd + 1);
+
+            auto colon = line.find(':');
+            auto name = colon == StringView::npos ? StringView() : trim(line.substr(0, colon));
+            if (!isToken(name)) {
+                continue;
+            }
+
+            // The text comes from the network or the disk cache, so invalid values are skipped
+            // rather than passed on to add(), which would throw.
+            auto value = trim(line.substr(colon + 1));
+            if (value.find('\r') == StringView::npos) {
+                header.add(name, value);
+            }
+        }
+        return header;
+    }
+
+    bool HTTPHeader::equalsIgnoreCase(StringView a, StringView b)
+    {
+        auto lower = [](char c) { return std::tolower(static_cast<unsigned char>(c)); };
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [&](char x, char y) { return lower(x) == lower(y); });
+    }
+
+    std::optional<StringView> HTTPHeader::get(StringView name) const
+    {
+        for (auto field : *this) {
+            if (equalsIgnoreCase(field.name, name)) {
+                return field.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<String> HTTPHeader::combined(StringView name) const
+    {
+        std::optional<String> values;
+        for (auto field : *this) {
+            if (equalsIgnoreCase(field.name, name)) {
+                if (values) {
+                    *values += ", ";
+                    values->append(field.value);
+                } else {
+                    values = String(field.value);
+                }
+            }
+        }
+        return values;
+    }
+
+    void HTTPHeader::add(StringView name, StringView value)
+    {
+        if (!isToken(name)) {
+            throw std::invalid_argument("Invalid HTTP header field name: " + String(name));
+        }
+        value = trim(value);
+        if (value.find_first_of("\r\n") != StringView::npos) {
+            throw std::invalid_argument("HTTP header field value with a line break: " + String(name));
+        }
+
+        _text.reserve(_text.size() + name.size() + value.size() + 4);
+        _text.append(name);
+        _text += ": ";
+        _text.append(value);
+        _text += "\r\n";
+    }
+
+    void HTTPHeader::set(StringView name, StringView value)
+    {
+        remove(name);
+        add(name, value);
+    }
+
+    size_t HTTPHeader::remove(StringView name)
+    {
+        size_t removed = 0;
+        String kept;
+        StringView text = _text;
+        while (!text.empty()) {
+            size_t lineSize = 0;
+            auto field = firstField(text, &lineSize);
+            if (equalsIgnoreCase(field.name, name)) {
+                removed++;
+            } else {
+                kept.append(text.substr(0, lineSize));
+            }
+            text.remove_prefix(lineSize);
+        }
+
+        if (removed > 0) {
+            _text = std::move(kept);
+        }
+        return removed;
+    }
+
+    size_t HTTPHeader::size() const { return std::distance(begin(), end()); }
+}
@@ -0,0 +1,44 @@
+#include <bdn/net/HTTPObserver.h>
+
+#include <mutex>
+
+namespace bdn::net
+{
+    namespace
+    {
+        std::mutex observerMutex;
+        std::shared_ptr<HTTPObserver> currentObserver;
+    }
+
+    namespace http
+    {
+        void setObserver(std::shared_ptr<HTTPObserver> observer)
+        {
+            std::lock_guard<std::mutex> lock(observerMutex);
+            currentObserver = std::move(observer);
+        }
+
+        std::shared_ptr<HTTPObserver> observer()
+        {
+            std::lock_guard<std::mutex> lock(observerMutex);
+            return currentObserver;
+        }
+    }
+
+    namespace detail
+    {
+        HTTPObservation::HTTPObservation(const HTTPRequest &request) : _observer(http::observer())
+        {
+            if (_observer) {
+                _observer->requestStarted(request);
+            }
+        }
+
+        void HTTPObservation::finished(const HTTPResponse &response)
+        {
+            if (auto observer = std::move(_observer)) {
+                observer->requestFinished(response);
+            }
+        }
+    }
+}
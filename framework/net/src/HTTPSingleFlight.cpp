@@ -0,0 +1,236 @@
+#include <bdn/net/HTTPSingleFlight.h>
+
+#include <bdn/net/HTTPResponse.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace bdn::net
+{
+    namespace
+    {
+        bool isDeduplicated(const HTTPRequest &request)
+        {
+            // Streamed chunks are only valid during the call, so they cannot be shared
+            return (request.method == http::Method::GET || request.method == http::Method::HEAD) &&
+                   !request.dataHandler && request.body.empty();
+        }
+
+        String flightKey(const HTTPRequest &request)
+        {
+            // Fields like Authorization or Accept-Language change the response, so the header is part of the key
+            String key(request.method == http::Method::HEAD ? "HEAD " : "GET ");
+            key.append(request.url, 0, request.url.find('#'));
+            key += '\n';
+            key += request.header.toString();
+            return key;
+        }
+    }
+
+    namespace detail
+    {
+        class HTTPSingleFlightGroup : public std::enable_shared_from_this<HTTPSingleFlightGroup>
+        {
+          private:
+            class AttachedHandle;
+
+            struct Waiter
+            {
+                HTTPRequest request;
+                std::shared_ptr<AttachedHandle> handle;
+            };
+
+            struct Flight
+            {
+                String key;
+                std::vector<Waiter> waiters;
+                std::shared_ptr<HTTPRequestHandle> handle; // of the request in flight, once the transport returned
+                bool done = false;
+            };
+
+            class AttachedHandle : public HTTPRequestHandle
+            {
+              public:
+                AttachedHandle(std::weak_ptr<HTTPSingleFlightGroup> group, std::weak_ptr<Flight> flight)
+                    : _group(std::move(group)), _flight(std::move(flight))
+                {}
+
+              protected:
+                void abort() override
+                {
+                    if (auto group = _group.lock()) {
+                        group->detach(_flight.lock(), this);
+                    }
+                }
+
+              private:
+                std::weak_ptr<HTTPSingleFlightGroup> _group;
+                std::weak_ptr<Flight> _flight;
+            };
+
+          public:
+            explicit HTTPSingleFlightGroup(http::Transport transport) : _transport(std::move(transport))
+            {
+                if (!_transport) {
+                    _transport = [](HTTPRequest request) { return http::request(std::move(request)); };
+                }
+            }
+
+          public:
+            std::shared_ptr<HTTPRequestHandle> request(HTTPRequest request)
+            {
+                if (!isDeduplicated(request)) {
+                    return _transport(std::move(request));
+                }
+
+                auto key = flightKey(request);
+                std::shared_ptr<Flight> flight;
+                std::shared_ptr<AttachedHandle> handle;
+                HTTPRequest sent = request;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    auto it = _flights.find(key);
+                    if (it != _flights.end()) {
+                        handle = std::make_shared<AttachedHandle>(weak_from_this(), it->second);
+                        it->second->waiters.push_back(Waiter{std::move(request), handle});
+                        _statistics.attached++;
+                        return handle;
+                    }
+
+                    flight = std::make_shared<Flight>();
+                    flight->key = key;
+                    handle = std::make_shared<AttachedHandle>(weak_from_this(), flight);
+                    flight->waiters.push_back(Waiter{std::move(request), handle});
+                    _flights.emplace(std::move(key), flight);
+                    _statistics.requests++;
+                }
+
+                sent.doneHandler = [weakGroup = weak_from_this(), flight](std::shared_ptr<HTTPResponse> response) {
+                    land(weakGroup.lock(), flight, response);
+                };
+                auto inFlight = _transport(std::move(sent));
+
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!flight->waiters.empty() || flight->done) {
+                        flight->handle = inFlight;
+                        return handle;
+                    }
+                }
+                // Every attached request was cancelled before the transport returned
+                inFlight->cancel();
+                return handle;
+            }
+
+            HTTPSingleFlight::Statistics statistics() const
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _statistics;
+            }
+
+          private:
+            /** Delivers the response of the request in flight to every request attached to it. */
+            static void land(const std::shared_ptr<HTTPSingleFlightGroup> &group, const std::shared_ptr<Flight> &flight,
+                             const std::shared_ptr<HTTPResponse> &response)
+            {
+                std::vector<Waiter> waiters;
+                {
+                    // Without the group, nobody can attach to or detach from the flight anymore
+                    std::unique_lock<std::mutex> lock;
+                    if (group) {
+                        lock = std::unique_lock<std::mutex>(group->_mutex);
+                        group->forget(flight);
+                    }
+                    flight->done = true;
+                    waiters = std::move(flight->waiters);
+                }
+
+                waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                             [](const Waiter &waiter) { return waiter.handle->isCancelled(); }),
+                              waiters.end());
+
+                std::shared_ptr<const String> sharedData;
+                if (waiters.size() > 1) {
+                    sharedData = response->sharedData ? response->sharedData
+                                                      : std::make_shared<const String>(std::move(response->data));
+                }
+
+                for (auto &waiter : waiters) {
+                    auto attachedResponse = std::make_shared<HTTPResponse>();
+                    attachedResponse->originalRequest = waiter.request;
+                    attachedResponse->url = response->url;
+                    attachedResponse->header = response->header;
+                    attachedResponse->responseCode = response->responseCode;
+                    attachedResponse->metrics = response->metrics;
+                    if (sharedData) {
+                        attachedResponse->sharedData = sharedData;
+                    } else {
+                        attachedResponse->data = std::move(response->data);
+                        attachedResponse->sharedData = response->sharedData;
+                    }
+
+                    if (waiter.request.doneHandler) {
+                        waiter.request.doneHandler(attachedResponse);
+                    }
+                }
+            }
+
+            void detach(const std::shared_ptr<Flight> &flight, const AttachedHandle *handle)
+            {
+                std::shared_ptr<HTTPRequestHandle> inFlight;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!flight || flight->done) {
+                        return;
+                    }
+
+                    auto &waiters = flight->waiters;
+                    waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                                 [&](const Waiter &waiter) { return waiter.handle.get() == handle; }),
+                                  waiters.end());
+                    if (!waiters.empty()) {
+                        return;
+                    }
+
+                    // Later requests must not attach to a cancelled flight
+                    forget(flight);
+                    inFlight = flight->handle;
+                }
+
+                if (inFlight) {
+                    inFlight->cancel();
+                }
+            }
+
+            void forget(const std::shared_ptr<Flight> &flight)
+            {
+                auto it = _flights.find(flight->key);
+                if (it != _flights.end() && it->second == flight) {
+                    _flights.erase(it);
+                }
+            }
+
+          private:
+            http::Transport _transport;
+
+            mutable std::mutex _mutex;
+            std::unordered_map<String, std::shared_ptr<Flight>> _flights;
+            HTTPSingleFlight::Statistics _statistics;
+        };
+    }
+
+    HTTPSingleFlight::HTTPSingleFlight(http::Transport transport)
+        : _group(std::make_shared<detail::HTTPSingleFlightGroup>(std::move(transport)))
+    {}
+
+    HTTPSingleFlight::~HTTPSingleFlight() = default;
+
+    std::shared_ptr<HTTPRequestHandle> HTTPSingleFlight::request(HTTPRequest request)
+    {
+        return _group->request(std::move(request));
+    }
+
+    HTTPSingleFlight::Statistics HTTPSingleFlight::statistics() const { return _group->statistics(); }
+}
@@ -0,0 +1,396 @@
+#include <bdn/net/JsonStream.h>
+
+#include <bdn/Application.h>
+#include <bdn/DispatchQueue.h>
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <stdexcept>
+#include <streambuf>
+#include <thread>
+
+namespace bdn::net::detail
+{
+    namespace
+    {
+        /** A reference token of a JSON pointer, "*" matching anything. */
+        struct PathToken
+        {
+            String key;
+            std::optional<size_t> index; // if key is an array index
+            bool any = false;
+        };
+
+        using Path = std::vector<PathToken>;
+
+        Path parsePath(StringView pointer)
+        {
+            if (!pointer.empty() && pointer.front() != '/') {
+                throw std::invalid_argument("JSON pointer does not start with '/': " + String(pointer));
+            }
+
+            Path path;
+            while (!pointer.empty()) {
+                pointer.remove_prefix(1);
+                auto end = std::min(pointer.find('/'), pointer.size());
+
+                PathToken token;
+                for (size_t i = 0; i < end; i++) {
+                    if (pointer[i] == '~' && i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+                        token.key += pointer[++i] == '0' ? '~' : '/';
+                    } else {
+                        token.key += pointer[i];
+                    }
+                }
+                token.any = token.key == "*";
+                if (!token.key.empty() && token.key.find_first_not_of("0123456789") == String::npos &&
+                    token.key.size() < 19) {
+                    token.index = std::stoull(token.key);
+                }
+
+                path.push_back(std::move(token));
+                pointer.remove_prefix(end);
+            }
+            return path;
+        }
+
+        /** Hands the chunks passed to the request's dataHandler to the parse thread. */
+        class ChunkBuffer : public std::streambuf
+        {
+          public:
+            void push(ByteSpan chunk)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                _chunks.emplace_back(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+                _changed.notify_one();
+            }
+
+            void close()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _closed = true;
+                _changed.notify_one();
+            }
+
+          protected:
+            int_type underflow() override
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _changed.wait(lock, [this]() { return !_chunks.empty() || _closed; });
+                if (_chunks.empty()) {
+                    return traits_type::eof();
+                }
+
+                _current = std::move(_chunks.front());
+                _chunks.pop_front();
+                setg(_current.data(), _current.data(), _current.data() + _current.size());
+                return traits_type::to_int_type(*gptr());
+            }
+
+          private:
+            std::mutex _mutex;
+            std::condition_variable _changed;
+            std::deque<std::string> _chunks;
+            bool _closed = false;
+
+            std::string _current; // only used on the parse thread
+        };
+
+        /** Tracks the position in the document and passes the values of the selected records on. */
+        class RecordExtractor
+        {
+          public:
+            RecordExtractor(Path recordPath, std::vector<Path> fieldPaths, JsonRecordBuilder &builder,
+                            std::function<void()> batchFull, size_t batchSize)
+                : _recordPath(std::move(recordPath)), _fieldPaths(std::move(fieldPaths)), _builder(builder),
+                  _batchFull(std::move(batchFull)), _batchSize(batchSize)
+            {}
+
+          public:
+            bool null() { return scalar(nullptr); }
+            bool boolean(bool value) { return scalar(value); }
+            bool number_integer(int64_t value) { return scalar(value); }
+            bool number_unsigned(uint64_t value) { return scalar(value); }
+            bool number_float(double value, const std::string & /*unused*/) { return scalar(value); }
+            bool string(std::string &value) { return scalar(String(std::move(value))); }
+
+            // Only part of the SAX interface since nlohmann::json 3.8
+            template <class Binary> bool binary(Binary & /*unused*/) { return scalar(nullptr); }
+
+            bool start_object(size_t /*unused*/) { return startContainer(false); }
+            bool start_array(size_t /*unused*/) { return startContainer(true); }
+            bool end_object() { return endContainer(); }
+            bool end_array() { return endContainer(); }
+
+            bool key(std::string &key)
+            {
+                _levels.back().key = std::move(key);
+                return true;
+            }
+
+            template <class Exception>
+            bool parse_error(size_t /*unused*/, const std::string & /*unused*/, const Exception &exception)
+            {
+                _error = exception.what();
+                return false;
+            }
+
+            const std::optional<String> &error() const { return _error; }
+
+          private:
+            struct Level
+            {
+                bool array;
+                size_t count = 0; // of array elements started so far
+                String key;
+            };
+
+            bool scalar(JsonValue value)
+            {
+                enterValue();
+                if (!_recordDepth && atRecord()) {
+                    _builder.begin();
+                    _recordDepth = _levels.size();
+                    setFields(value);
+                    _recordDepth.reset();
+                    endRecord();
+                } else if (_recordDepth) {
+                    setFields(value);
+                }
+                return true;
+            }
+
+            bool startContainer(bool array)
+            {
+                enterValue();
+                if (!_recordDepth && atRecord()) {
+                    _recordDepth = _levels.size();
+                    _builder.begin();
+                }
+                _levels.push_back(Level{array, 0, {}});
+                return true;
+            }
+
+            bool endContainer()
+            {
+                _levels.pop_back();
+                if (_recordDepth == _levels.size()) {
+                    _recordDepth.reset();
+                    endRecord();
+                }
+                return true;
+            }
+
+            void enterValue()
+            {
+                if (!_levels.empty() && _levels.back().array) {
+                    _levels.back().count++;
+                }
+            }
+
+            bool matches(const PathToken &token, const Level &level) const
+            {
+                if (token.any) {
+                    return true;
+                }
+                return level.array ? token.index == level.count - 1 : token.key == level.key;
+            }
+
+            bool matches(const Path &path, size_t firstLevel) const
+            {
+                if (_levels.size() - firstLevel != path.size()) {
+                    return false;
+                }
+                for (size_t i = 0; i < path.size(); i++) {
+                    if (!matches(path[i], _levels[firstLevel + i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool atRecord() const { return matches(_recordPath, 0); }
+
+            void setFields(JsonValue &value)
+            {
+                for (size_t i = 0; i < _fieldPaths.size(); i++) {
+                    if (matches(_fieldPaths[i], *_recordDepth)) {
+                        // Fields may share a path, so every one of them gets a copy
+                        auto copy = i + 1 < _fieldPaths.size() ? value : std::move(value);
+                        _builder.set(i, copy);
+                    }
+                }
+            }
+
+            void endRecord()
+            {
+                if (_builder.end() >= _batchSize) {
+                    _batchFull();
+                }
+            }
+
+          private:
+            Path _recordPath;
+            std::vector<Path> _fieldPaths;
+            JsonRecordBuilder &_builder;
+            std::function<void()> _batchFull;
+            size_t _batchSize;
+
+            std::vector<Level> _levels;
+            std::optional<size_t> _recordDepth; // of the record being extracted, in _levels
+            std::optional<String> _error;
+        };
+
+        class JsonStreamSession : public std::enable_shared_from_this<JsonStreamSession>
+        {
+          public:
+            JsonStreamSession(Path recordPath, std::vector<Path> fieldPaths, size_t batchSize,
+                              std::unique_ptr<JsonRecordBuilder> builder, JsonStreamDoneHandler onDone)
+                : _builder(std::move(builder)), _onDone(std::move(onDone)),
+                  _extractor(std::move(recordPath), std::move(fieldPaths), *_builder, [this]() { postBatch(); },
+                             batchSize)
+            {}
+
+            ~JsonStreamSession()
+            {
+                // The last reference may be released by the parse thread itself
+                if (_thread.get_id() == std::this_thread::get_id()) {
+                    _thread.detach();
+                } else if (_thread.joinable()) {
+                    _thread.join();
+                }
+            }
+
+            JsonStreamSession(const JsonStreamSession &) = delete;
+            JsonStreamSession &operator=(const JsonStreamSession &) = delete;
+
+          public:
+            void start()
+            {
+                _thread = std::thread([self = shared_from_this()]() mutable {
+                    std::istream input(&self->_input);
+                    nlohmann::json::sax_parse(input, &self->_extractor);
+
+                    if (!self->_cancelled) {
+                        self->postBatch();
+                        App()->dispatchQueue()->dispatchAsync([self = std::move(self)]() { self->finish(); });
+                    }
+                });
+            }
+
+            void push(ByteSpan chunk) { _input.push(chunk); }
+
+            /** Called once the response arrived, on the main thread. */
+            void done(std::shared_ptr<HTTPResponse> response)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _response = std::move(response);
+                }
+                _input.close();
+            }
+
+            /** Called when the request was cancelled, before the response arrived. */
+            void cancel()
+            {
+                _cancelled = true;
+                _input.close();
+            }
+
+          private:
+            void postBatch()
+            {
+                if (_cancelled || _builder->pending() == 0) {
+                    return;
+                }
+                App()->dispatchQueue()->dispatchAsync(
+                    [self = shared_from_this(), batch = _builder->takeBatch()]() {
+                        if (!self->_cancelled) {
+                            batch();
+                        }
+                    });
+            }
+
+            void finish()
+            {
+                std::shared_ptr<HTTPResponse> response;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    response = std::move(_response);
+                }
+
+                if (_onDone && !_cancelled) {
+                    _onDone(response, _extractor.error());
+                }
+            }
+
+          private:
+            std::unique_ptr<JsonRecordBuilder> _builder;
+            JsonStreamDoneHandler _onDone;
+            RecordExtractor _extractor;
+            ChunkBuffer _input;
+            std::atomic<bool> _cancelled{false};
+
+            std::mutex _mutex;
+            std::shared_ptr<HTTPResponse> _response;
+
+            std::thread _thread;
+        };
+
+        /** Owned by the request's handlers. If they are destroyed before the response arrived, the request
+            was cancelled. */
+        class SessionInput
+        {
+          public:
+            explicit SessionInput(std::shared_ptr<JsonStreamSession> session) : _session(std::move(session)) {}
+
+            ~SessionInput()
+            {
+                if (!_done) {
+                    _session->cancel();
+                }
+            }
+
+            SessionInput(const SessionInput &) = delete;
+            SessionInput &operator=(const SessionInput &) = delete;
+
+          public:
+            void push(ByteSpan chunk) { _session->push(chunk); }
+
+            void done(std::shared_ptr<HTTPResponse> response)
+            {
+                _done = true;
+                _session->done(std::move(response));
+            }
+
+          private:
+            std::shared_ptr<JsonStreamSession> _session;
+            std::atomic<bool> _done{false};
+        };
+    }
+
+    HTTPRequest streamJson(HTTPRequest request, const String &recordPath, const std::vector<String> &fieldPaths,
+                           size_t batchSize, std::unique_ptr<JsonRecordBuilder> builder, JsonStreamDoneHandler onDone)
+    {
+        std::vector<Path> fields;
+        fields.reserve(fieldPaths.size());
+        for (auto &fieldPath : fieldPaths) {
+            fields.push_back(parsePath(fieldPath));
+        }
+
+        auto session = std::make_shared<JsonStreamSession>(parsePath(recordPath), std::move(fields), batchSize,
+                                                           std::move(builder), std::move(onDone));
+        session->start();
+
+        auto input = std::make_shared<SessionInput>(session);
+        request.dataHandler = [input](ByteSpan chunk) { input->push(chunk); };
+        request.doneHandler = [input](std::shared_ptr<HTTPResponse> response) { input->done(std::move(response)); };
+        return request;
+    }
+}
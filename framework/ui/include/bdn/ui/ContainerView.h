@@ -3,7 +3,9 @@
 #include <bdn/ui/View.h>
 #include <bdn/ui/ViewUtilities.h>
 
+#include <iterator>
 #include <list>
+#include <vector>
 
 namespace bdn::ui
 {
@@ -23,9 +25,27 @@ namespace bdn::ui
         void removeAllChildViews() override;
         std::list<std::shared_ptr<View>> childViews() override;
 
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override;
+        size_t childCount() override;
+        std::shared_ptr<View> childAt(size_t index) override;
+
+        /** Replaces the children with the views in range, keeping the longest common prefix of
+            the current children in place. All changes are applied in a single update batch. */
+        template <class Range> void setChildViews(const Range &range);
+
+        /** Starts a batch of child changes. Until the matching endUpdates() call the layout defers
+            applying the styles of the new children and rebuilding its tree, and the core may defer
+            platform side work, so that both are done once for the whole batch. Calls can be nested. */
+        void beginUpdates();
+        void endUpdates();
+
       public:
         void childViewStolen(const std::shared_ptr<View> &childView) override;
 
+      private:
+        int _updateDepth = 0;
+        std::shared_ptr<Layout> _batchLayout;
+
       public:
         class Core
         {
@@ -37,6 +57,42 @@ namespace bdn::ui
             virtual void removeChildView(std::shared_ptr<View> child) = 0;
 
             virtual std::list<std::shared_ptr<View>> childViews() = 0;
+
+            virtual void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) = 0;
+            virtual size_t childCount() = 0;
+            virtual std::shared_ptr<View> childAt(size_t index) = 0;
+
+            /** Called around a batch of addChildView()/removeChildView() calls. Cores can use it to
+                defer work that only needs to be done once after all children changed. */
+            virtual void beginUpdates() {}
+            virtual void endUpdates() {}
         };
     };
+
+    template <class Range> void ContainerView::setChildViews(const Range &range)
+    {
+        std::vector<std::shared_ptr<View>> newChildren(std::begin(range), std::end(range));
+
+        beginUpdates();
+        try {
+            size_t current = childCount();
+            size_t common = 0;
+            while (common < current && common < newChildren.size() && childAt(common) == newChildren[common]) {
+                common++;
+            }
+
+            for (size_t i = current; i > common; i--) {
+                removeChildView(childAt(i - 1));
+            }
+
+            for (size_t i = common; i < newChildren.size(); i++) {
+                addChildView(newChildren[i]);
+            }
+        }
+        catch (...) {
+            endUpdates();
+            throw;
+        }
+        endUpdates();
+    }
 }
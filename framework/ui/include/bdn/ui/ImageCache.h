@@ -0,0 +1,212 @@
+#pragma once
+
+#include <bdn/DispatchQueue.h>
+#include <bdn/Size.h>
+#include <bdn/String.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace bdn::ui
+{
+    namespace detail
+    {
+        class ImageDiskStore;
+    }
+
+    /** Shared loading pipeline for images shown by image views.
+
+        Decoded images are kept in a memory tier that is evicted least recently used first once
+        it exceeds its byte budget. The encoded bytes are kept in an optional disk tier that stores
+        every distinct content only once, no matter how many URLs refer to it. Concurrent loads of
+        the same URL share a single fetch.
+
+        At most Configuration::maxConcurrentFetches fetches run at the same time. Queued fetches start
+        in order of priority, so images that are visible are fetched before prefetched ones. A fetch
+        is aborted once every load waiting for it was cancelled.
+
+        Reading from disk and decoding happen on a worker queue. Images are decoded so that their
+        larger side does not exceed the requested pixel size, which is rounded up to a power of two
+        so that views of similar sizes share one decoded image.
+
+        Fetching and decoding are provided by the platform (see Configuration), so the cache itself
+        works the same everywhere. The cache must be owned by a std::shared_ptr. load(), cancel()
+        and cachedImage() must be called on the main thread, and handlers are called there as well.
+    */
+    class ImageCache : public std::enable_shared_from_this<ImageCache>
+    {
+      public:
+        struct Image
+        {
+            /** Size of the encoded image in pixels. */
+            Size originalSize;
+
+            /** Size of the decoded bitmap in pixels. Smaller than originalSize if it was downsampled. */
+            Size pixelSize;
+
+            /** Memory occupied by the decoded bitmap, charged against the memory budget. */
+            size_t byteCost = 0;
+
+            /** Decoder specific bitmap, e.g. a CGImageRef. */
+            std::shared_ptr<const void> bitmap;
+        };
+
+        enum class Priority
+        {
+            Prefetch,
+            Visible
+        };
+
+        using FetchHandler = std::function<void(std::optional<std::string> data)>;
+        using CancelFetch = std::function<void()>;
+
+        /** Fetches the encoded bytes of url and calls done with them, or with std::nullopt on failure.
+            done may be called on any thread. Returns a function that aborts the fetch, or nullptr if
+            it cannot be aborted. */
+        using Fetcher = std::function<CancelFetch(const String &url, FetchHandler done)>;
+
+        /** Decodes data so that neither side exceeds maxPixelSize, or at full size if maxPixelSize is 0.
+            Called on the worker queue. Returns nullptr if data cannot be decoded. */
+        using Decoder = std::function<std::shared_ptr<const Image>(const std::string &data, size_t maxPixelSize)>;
+
+        using Handler = std::function<void(std::shared_ptr<const Image>)>;
+        using LoadId = uint64_t;
+
+        struct Configuration
+        {
+            size_t memoryBudget = 32 * 1024 * 1024;
+
+            /** Directory of the disk tier. The disk tier is disabled if this is empty. */
+            String diskDirectory;
+            size_t diskBudget = 128 * 1024 * 1024;
+
+            size_t maxConcurrentFetches = 4;
+
+            /** Used for all URLs but file:// URLs, which the cache reads itself. */
+            Fetcher fetcher;
+            Decoder decoder;
+        };
+
+        struct Statistics
+        {
+            size_t memoryHits = 0;
+            size_t diskHits = 0;
+            size_t fetches = 0;
+            size_t cancelledFetches = 0;
+            size_t decodes = 0;
+            size_t memoryBytes = 0;
+        };
+
+      public:
+        explicit ImageCache(Configuration configuration);
+        ~ImageCache();
+
+      public:
+        /** The cache used by image views, or nullptr if none was set. */
+        static std::shared_ptr<ImageCache> shared();
+        static void setShared(std::shared_ptr<ImageCache> cache);
+
+        /** The pixel size images are actually decoded at when maxPixelSize is requested. */
+        static size_t pixelSizeBucket(size_t maxPixelSize);
+
+        /** Whether an image decoded for bucket available is large enough for bucket required. */
+        static bool bucketCovers(size_t available, size_t required)
+        {
+            return available == 0 || (required != 0 && available >= required);
+        }
+
+      public:
+        /** Loads the image at url, decoded to at most maxPixelSize (0 for full size).
+
+            If the image is already in memory, handler is called right away and 0 is returned.
+            Otherwise handler is called later with the image, or with nullptr if it could not be
+            loaded, unless the returned id is passed to cancel() first. Loads complete on the main
+            queue, so without an application handler is called right away with nullptr. */
+        LoadId load(const String &url, size_t maxPixelSize, Handler handler, Priority priority = Priority::Visible);
+
+        /** Loads the image into the cache without a handler, at prefetch priority. */
+        LoadId prefetch(const String &url, size_t maxPixelSize)
+        {
+            return load(url, maxPixelSize, nullptr, Priority::Prefetch);
+        }
+
+        /** Drops the handler of a pending load. If no other load waits for the same URL, a fetch
+            that is queued or running is aborted. */
+        void cancel(LoadId id);
+
+        /** Changes the priority of a pending load, e.g. when its view scrolls into view. */
+        void setPriority(LoadId id, Priority priority);
+
+        /** Returns the image if it is in memory at maxPixelSize or larger. */
+        std::shared_ptr<const Image> cachedImage(const String &url, size_t maxPixelSize);
+
+        void clearMemory();
+        Statistics statistics() const;
+
+      private:
+        struct Waiter
+        {
+            LoadId id;
+            size_t bucket;
+            Handler handler;
+            Priority priority;
+        };
+
+        struct ActiveFetch
+        {
+            uint64_t id;
+            CancelFetch cancel;
+        };
+
+        struct MemoryEntry
+        {
+            String url;
+            size_t key;
+            std::shared_ptr<const Image> image;
+        };
+
+        using DecodedImages = std::vector<std::pair<size_t, std::shared_ptr<const Image>>>;
+
+        void startLoading(const String &url);
+        void fetch(const String &url);
+        void startFetches();
+        void fetchDone(const String &url, uint64_t fetchId, std::optional<std::string> data);
+        Priority priority(const String &url) const;
+        void dataAvailable(const String &url, std::shared_ptr<const std::string> data, bool storeOnDisk);
+        void decoded(const String &url, const DecodedImages &images);
+        void failed(const String &url);
+
+        std::shared_ptr<const Image> lookupMemory(const String &url, size_t bucket);
+        void insertMemory(const String &url, size_t bucket, std::shared_ptr<const Image> image);
+        void trimMemory();
+
+        void postToMain(std::function<void(ImageCache &)> function);
+
+      private:
+        Configuration _configuration;
+        Statistics _statistics;
+
+        std::list<MemoryEntry> _memory; // most recently used first
+        std::unordered_map<String, std::map<size_t, std::list<MemoryEntry>::iterator>> _memoryIndex;
+
+        LoadId _nextLoadId = 0;
+        std::unordered_map<String, std::vector<Waiter>> _pendingLoads;
+        std::unordered_map<LoadId, String> _pendingUrls;
+
+        std::vector<String> _queuedFetches;
+        std::unordered_map<String, ActiveFetch> _activeFetches;
+        uint64_t _nextFetchId = 0;
+
+        // Only used on the worker queue
+        std::unique_ptr<detail::ImageDiskStore> _diskStore;
+
+        // Declared last so the worker thread is joined before the state it uses is destroyed.
+        std::unique_ptr<DispatchQueue> _worker;
+    };
+}
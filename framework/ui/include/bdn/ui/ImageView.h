@@ -10,24 +10,55 @@ namespace bdn::ui
         VIEW_CORE_REGISTRY_DECLARATION(ImageView)
     }
 
+    class ScrollView;
+
     class ImageView : public View
     {
+      public:
+        /** Position of the view relative to the visible client rect of the enclosing ScrollView. */
+        enum class ViewportPosition
+        {
+            Outside,
+            /** Within ScrollView::lookAheadMargin of the visible client rect. */
+            Nearby,
+            Inside
+        };
+
       private:
         Property<Size> iOriginalSize;
         Property<float> iAspectRatio;
+        Property<ViewportPosition> iViewportPosition = ViewportPosition::Outside;
 
       public:
         Property<String> url;
         const Property<Size> originalSize = iOriginalSize;
         const Property<float> aspectRatio = iAspectRatio;
 
+        /** Image views only load their image while they are Inside or Nearby the visible part of the
+            enclosing ScrollView, visible ones first. Loads that end up Outside before they finish are
+            cancelled. Image views that are not in a ScrollView are always Inside.
+
+            The position is updated asynchronously after the view or one of its ancestors up to the
+            ScrollView was laid out, or the ScrollView was scrolled. */
+        const Property<ViewportPosition> viewportPosition = iViewportPosition;
+
       public:
         ImageView(std::shared_ptr<ViewCoreFactory> viewCoreFactory = nullptr);
-        ~ImageView() override = default;
+        ~ImageView() override;
 
       protected:
         void bindViewCore() override;
 
+      private:
+        friend class ScrollView;
+
+        void scheduleViewportUpdate();
+        void updateViewportPosition();
+
+      private:
+        std::weak_ptr<ScrollView> _scrollView;
+        bool _viewportUpdateScheduled = false;
+
       public:
         class Core
         {
@@ -35,6 +66,7 @@ namespace bdn::ui
             Property<String> url;
             Property<Size> originalSize;
             Property<float> aspectRatio;
+            Property<ViewportPosition> viewportPosition = ViewportPosition::Inside;
         };
     };
 }
@@ -19,5 +19,12 @@ namespace bdn::ui
         virtual void updateStylesheet(View *view) = 0;
 
         virtual void layout(View *view) = 0;
+
+        /** Starts a batch of stylesheet updates. Until the matching endUpdates() call the layout may
+            defer processing updateStylesheet() calls, including the ones registerView() makes for new
+            children, and apply them all at once. Views are still registered right away. Calls can be
+            nested. */
+        virtual void beginUpdates() {}
+        virtual void endUpdates() {}
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bdn/Notifier.h>
+#include <bdn/ui/ListViewChanges.h>
 #include <bdn/ui/ListViewDataSource.h>
 #include <bdn/ui/View.h>
 #include <bdn/ui/ViewUtilities.h>
@@ -30,6 +31,12 @@ namespace bdn::ui
         void reloadData();
         void refreshDone();
 
+        /** Updates only the rows affected by changes, keeping the rest of the rows and the scroll
+            position intact. The data source must already return the new rows.
+
+            Use ListViewDiff to calculate the changes between two versions of the data. */
+        void applyChanges(const ListViewChanges &changes);
+
       protected:
         void bindViewCore() override;
 
@@ -51,6 +58,9 @@ namespace bdn::ui
             virtual void reloadData() = 0;
             virtual void refreshDone() = 0;
 
+            /** Platforms that cannot update rows selectively fall back to reloadData(). */
+            virtual void applyChanges(const ListViewChanges & /*changes*/) { reloadData(); }
+
           protected:
             WeakCallback<void()> _refreshCallback;
         };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+namespace bdn::ui
+{
+    /** Describes how the rows of a list view changed, so that only the affected rows need to be
+        updated natively (see ListView::applyChanges()).
+
+        Indices follow the conventions of UITableView batch updates: deletes and the source of moves
+        refer to the rows before the change, inserts, the destination of moves and updates refer to
+        the rows after the change.
+    */
+    struct ListViewChanges
+    {
+        struct Move
+        {
+            size_t from = 0;
+            size_t to = 0;
+
+            bool operator==(const Move &other) const { return from == other.from && to == other.to; }
+            bool operator!=(const Move &other) const { return !(*this == other); }
+        };
+
+        std::vector<size_t> inserts;
+        std::vector<size_t> deletes;
+        std::vector<Move> moves;
+        std::vector<size_t> updates;
+
+        bool empty() const { return inserts.empty() && deletes.empty() && moves.empty() && updates.empty(); }
+
+        /** Number of rows after the change. Throws std::invalid_argument if there were fewer than
+            deletes.size() rows. */
+        size_t newRowCount(size_t oldRowCount) const;
+
+        /** For every row before the change its index afterwards, or std::nullopt if it was deleted.
+            Throws std::out_of_range if an index does not fit the given row count. */
+        std::vector<std::optional<size_t>> indexMapping(size_t oldRowCount) const;
+
+        /** Moves that rearrange the rows that were not deleted into their new order when applied
+            one at a time, for table views that process updates sequentially (e.g. NSTableView).
+            Each move refers to the row positions after the previous one, with the deleted rows
+            removed and the inserted ones not yet added. */
+        std::vector<Move> sequentialMoves(size_t oldRowCount) const;
+    };
+}
@@ -3,15 +3,113 @@
 #include <bdn/String.h>
 #include <bdn/ui/View.h>
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace bdn::ui
 {
     class ListViewDataSource
     {
+      public:
+        /** Half open range [begin, end) of row indices. */
+        struct RowRange
+        {
+            size_t begin = 0;
+            size_t end = 0;
+
+            bool empty() const { return end <= begin; }
+            size_t size() const { return empty() ? 0 : end - begin; }
+
+            bool operator==(const RowRange &other) const { return begin == other.begin && end == other.end; }
+            bool operator!=(const RowRange &other) const { return !(*this == other); }
+        };
+
+        using RowId = uint64_t;
+
       public:
         virtual ~ListViewDataSource() = default;
 
         virtual size_t numberOfRows() = 0;
         virtual std::shared_ptr<View> viewForRowIndex(size_t rowIndex, std::shared_ptr<View> reusableView) = 0;
         virtual float heightForRowIndex(size_t rowIndex) = 0;
+
+      public:
+        /** Writes the heights of the rows [begin, end) to out, which has room for end - begin values.
+
+            List views query heights through this function in blocks. Override it if heights can be
+            calculated cheaper in bulk. The default calls heightForRowIndex() for every row. */
+        virtual void heightsForRange(size_t begin, size_t end, float *out)
+        {
+            for (size_t i = begin; i < end; i++) {
+                *out++ = heightForRowIndex(i);
+            }
+        }
+
+        /** Called with rows that are about to scroll into view, so that their data can be loaded
+            ahead of time, e.g. images with ImageCache::prefetch(). */
+        virtual void prefetchRows(RowRange /*range*/) {}
+
+        /** Called for rows previously passed to prefetchRows() that are no longer expected to become
+            visible. Prefetches are not cancelled when the data is reloaded, since the row indices
+            refer to the previous contents by then. */
+        virtual void cancelPrefetch(RowRange /*range*/) {}
+
+        /** Return true if rowIdForRowIndex() identifies the contents of a row.
+
+            List views then assume that a row whose id did not change since it was last shown still
+            displays the right contents and do not call viewForRowIndex() for it again. */
+        virtual bool hasStableRowIds() { return false; }
+        virtual RowId rowIdForRowIndex(size_t rowIndex) { return rowIndex; }
+
+        /** Rows of different view types are recycled separately: viewForRowIndex() only receives a
+            reusableView that was created for a row of the same type, so it can rebind that view in
+            place. Types must be smaller than viewTypeCount(). */
+        virtual size_t viewTypeCount() { return 1; }
+        virtual size_t viewTypeForRowIndex(size_t /*rowIndex*/) { return 0; }
     };
+
+    namespace detail
+    {
+        /** Caches row heights for list view cores, fetching them from the data source in blocks of
+            kBlockSize rows via heightsForRange(). */
+        class ListViewRowHeights
+        {
+          public:
+            static constexpr size_t kBlockSize = 256;
+
+          public:
+            /** Forgets all cached heights. */
+            void reset(size_t rowCount);
+
+            float height(ListViewDataSource &dataSource, size_t rowIndex);
+
+          private:
+            std::vector<float> _heights;
+            std::vector<bool> _loadedBlocks;
+        };
+
+        /** Keeps the data source's prefetch windows a fixed number of rows ahead of and behind the
+            visible rows, cancelling rows that drop out of them without becoming visible. */
+        class ListViewPrefetcher
+        {
+          public:
+            static constexpr size_t kDefaultDistance = 10;
+
+          public:
+            explicit ListViewPrefetcher(size_t distance = kDefaultDistance) : _distance(distance) {}
+
+          public:
+            void update(const std::shared_ptr<ListViewDataSource> &dataSource, ListViewDataSource::RowRange visible,
+                        size_t rowCount);
+
+            /** Forgets the current windows without cancelling them, e.g. after the data was reloaded. */
+            void invalidate();
+
+          private:
+            size_t _distance;
+            std::weak_ptr<ListViewDataSource> _dataSource;
+            std::vector<ListViewDataSource::RowRange> _windows;
+        };
+    }
 }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <bdn/DispatchQueue.h>
+#include <bdn/ui/ListViewChanges.h>
+#include <bdn/ui/ListViewDataSource.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace bdn::ui
+{
+    /** Calculates the ListViewChanges between two keyed snapshots of a list.
+
+        Rows are matched by id using Heckel's algorithm. Of the matched rows, the longest run that
+        kept its relative order stays in place and all others are reported as moves, which keeps
+        the number of moves minimal. Matched rows whose version differs are reported as updates.
+        Ids that occur more than once in a snapshot are treated as deleted and reinserted.
+
+        calculateAsync() runs the calculation on a background queue, so that large feeds do not
+        block the main thread.
+    */
+    class ListViewDiff : public std::enable_shared_from_this<ListViewDiff>
+    {
+      public:
+        struct Row
+        {
+            ListViewDataSource::RowId id = 0;
+
+            /** Changes whenever the contents of the row change, e.g. a hash or modification count. */
+            size_t version = 0;
+        };
+
+        using Snapshot = std::vector<Row>;
+
+      public:
+        ListViewDiff();
+        ~ListViewDiff();
+
+      public:
+        static ListViewChanges calculate(const Snapshot &before, const Snapshot &after);
+
+        /** Calculates the changes on a background queue and calls done with the result on the
+            application's main dispatch queue. If calculateAsync() is called again before a result
+            is delivered, only the result of the newer call is delivered. Without an application,
+            the changes are calculated and delivered right away. */
+        void calculateAsync(Snapshot before, Snapshot after, std::function<void(ListViewChanges)> done);
+
+      private:
+        std::atomic<size_t> _generation{0};
+
+        // Declared last so that the worker thread is joined before the state it uses is destroyed.
+        std::unique_ptr<DispatchQueue> _worker;
+    };
+}
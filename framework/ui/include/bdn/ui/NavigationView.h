@@ -24,6 +24,10 @@ namespace bdn::ui
       public:
         std::list<std::shared_ptr<View>> childViews() override;
 
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override;
+        size_t childCount() override;
+        std::shared_ptr<View> childAt(size_t index) override;
+
       protected:
         void bindViewCore() override;
 
@@ -35,6 +39,9 @@ namespace bdn::ui
             virtual void popView() = 0;
 
             virtual std::list<std::shared_ptr<View>> childViews() = 0;
+
+            /** The view currently shown, i.e. the only child of the navigation view. May be null. */
+            virtual std::shared_ptr<View> currentChild() = 0;
         };
     };
 }
@@ -3,6 +3,10 @@
 #include <bdn/ui/View.h>
 #include <bdn/ui/ViewUtilities.h>
 
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 namespace bdn::ui
 {
     namespace detail
@@ -10,6 +14,8 @@ namespace bdn::ui
         VIEW_CORE_REGISTRY_DECLARATION(ScrollView)
     }
 
+    class ImageView;
+
     class ScrollView : public View
     {
       public:
@@ -35,6 +41,11 @@ namespace bdn::ui
         */
         Property<Rect> visibleClientRect;
 
+        /** Distance in DIPs around the visible client rect within which image views start loading
+            before they are scrolled into view.
+            Default: 500 */
+        Property<double> lookAheadMargin = 500.0;
+
       public:
         void scrollClientRectToVisible(const Rect &area);
 
@@ -44,6 +55,13 @@ namespace bdn::ui
       public:
         std::list<std::shared_ptr<View>> childViews() override;
 
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override
+        {
+            _contentView.forEachChild(function);
+        }
+        size_t childCount() override { return _contentView.childCount(); }
+        std::shared_ptr<View> childAt(size_t index) override { return _contentView.childAt(index); }
+
         void removeAllChildViews() override { contentView = nullptr; }
 
         void childViewStolen(const std::shared_ptr<View> &childView) override;
@@ -51,9 +69,41 @@ namespace bdn::ui
       protected:
         void bindViewCore() override;
 
+      private:
+        friend class ImageView;
+
+        // Image views inside this scroll view register here, so that their viewport positions are
+        // updated in a single pass when it is scrolled or one of their ancestors is laid out again.
+        void trackViewport(const std::shared_ptr<ImageView> &imageView,
+                           const std::vector<std::shared_ptr<View>> &ancestors);
+        void untrackViewport(const ImageView *imageView);
+        void releaseAncestors(const std::vector<View *> &ancestors);
+
+        void scheduleViewportUpdate();
+        void updateViewportPositions();
+        void updateViewportPosition(ImageView &imageView, std::unordered_map<View *, Point> &offsets);
+        std::optional<Point> clientOffset(std::shared_ptr<View> view, std::unordered_map<View *, Point> &offsets);
+
       private:
         SingleChildHelper _contentView;
 
+        struct TrackedImageView
+        {
+            std::weak_ptr<ImageView> imageView;
+            std::vector<View *> ancestors;
+        };
+
+        struct TrackedAncestor
+        {
+            std::weak_ptr<View> view;
+            Notifier<Property<Rect> &>::Subscription subscription;
+            size_t references = 0;
+        };
+
+        std::unordered_map<const ImageView *, TrackedImageView> _trackedImageViews;
+        std::unordered_map<View *, TrackedAncestor> _trackedAncestors;
+        bool _viewportUpdateScheduled = false;
+
       public:
         class Core
         {
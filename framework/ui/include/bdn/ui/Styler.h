@@ -1,22 +1,30 @@
 #pragma once
 
+#include <bdn/WeakCallback.h>
 #include <bdn/ui/Json.h>
+#include <bdn/ui/Stylesheet.h>
 #include <bdn/ui/View.h>
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace bdn::ui
 {
+    /** Computes view stylesheets from rule lists whose entries can depend on named conditions.
+
+        Condition changes are not applied right away. setCondition() only marks the affected views
+        as stale and schedules a single rematch pass on the application's main dispatch queue, so
+        changing several conditions in a row (e.g. on rotation) updates every view at most once.
+        Call flush() to apply pending changes immediately.
+    */
     class Styler
     {
-        struct Data // TODO: Find better name
-        {
-            json json;
-            std::set<String> usedMatchers;
-        };
-
       public:
+        Styler();
+        Styler(const Styler &) = delete;
+        Styler &operator=(const Styler &) = delete;
         struct condition
         {
             virtual ~condition() = default;
@@ -50,12 +58,64 @@ namespace bdn::ui
         void setStyleSheet(std::shared_ptr<View> view, json stylesheet);
         void setCondition(String name, std::shared_ptr<condition> condition);
 
+        /** Rematches all views affected by condition changes since the last pass. All new stylesheets
+            are applied inside a single Layout::beginUpdates()/endUpdates() batch per layout. */
+        void flush();
+
       private:
-        void rematchView(const std::shared_ptr<View> &view);
-        void rematchAllViews(const String &matcherName);
+        using ConditionMask = std::vector<bool>;
+        using ViewSet = std::set<std::weak_ptr<View>, std::owner_less<std::weak_ptr<View>>>;
+
+        struct RuleProgram;
+
+        struct ConditionSlot
+        {
+            std::shared_ptr<Styler::condition> matcher;
+            // Inverted index: the compiled programs whose result depends on this condition
+            std::vector<std::weak_ptr<RuleProgram>> programs;
+        };
+
+        struct Predicate
+        {
+            ConditionSlot *slot;
+            json::value_type argument;
+        };
+
+        struct Rule
+        {
+            json patch;
+            std::vector<size_t> predicates;
+        };
+
+        /** A stylesheet compiled once and shared by all views that use the same stylesheet. */
+        struct RuleProgram
+        {
+            Stylesheet source;
+            std::vector<Predicate> predicates;
+            std::vector<Rule> rules;
+
+            Stylesheet result;
+            std::unordered_map<ConditionMask, Stylesheet> memo;
+
+            ViewSet views;
+            bool stale = false;
+        };
 
       private:
-        std::map<std::weak_ptr<View>, Data, std::owner_less<std::weak_ptr<View>>> _data;
-        std::map<String, std::shared_ptr<condition>> _conditions;
+        std::shared_ptr<RuleProgram> compile(const json &stylesheet);
+        void evaluate(RuleProgram &program);
+        void rematchProgram(const std::shared_ptr<RuleProgram> &program,
+                            std::vector<std::shared_ptr<View>> &changedViews);
+        void scheduleFlush();
+
+      private:
+        std::map<std::weak_ptr<View>, std::shared_ptr<RuleProgram>, std::owner_less<std::weak_ptr<View>>> _data;
+        std::unordered_multimap<size_t, std::weak_ptr<RuleProgram>> _programs;
+        std::map<String, ConditionSlot> _conditions;
+
+        std::vector<std::weak_ptr<RuleProgram>> _stalePrograms;
+        bool _flushScheduled = false;
+        WeakCallback<void()> _flushCallback;
+        WeakCallback<void()>::Receiver _flushReceiver;
     };
 }
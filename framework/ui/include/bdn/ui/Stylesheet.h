@@ -0,0 +1,87 @@
+#pragma once
+
+#include <bdn/String.h>
+#include <bdn/ui/Json.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <utility>
+
+namespace bdn::ui
+{
+    namespace detail
+    {
+        struct StylesheetData
+        {
+            StylesheetData(json v, size_t h) : value(std::move(v)), hash(h) {}
+
+            const json value;
+            const size_t hash;
+
+            mutable std::mutex sectionMutex;
+            mutable std::map<std::pair<std::type_index, String>, std::shared_ptr<const void>> sections;
+        };
+    }
+
+    /** Immutable, interned stylesheet.
+
+        Stylesheets with identical content share a single storage block, so copying one is a
+        pointer copy and comparing two is a pointer compare. Typed sections (see section()) are
+        decoded from the json on first access and cached in the shared storage, so every view
+        using the same stylesheet benefits from a single decode.
+
+        Stylesheets are implicitly constructible from json, so existing code that assigns json
+        to View::stylesheet keeps working. Use toJson() to get the underlying json back.
+    */
+    class Stylesheet
+    {
+      public:
+        Stylesheet();
+        Stylesheet(const json &value);
+        Stylesheet(json &&value);
+
+      public:
+        const json &toJson() const { return _data->value; }
+        const json *operator->() const { return &_data->value; }
+
+        size_t hash() const { return _data->hash; }
+
+        bool operator==(const Stylesheet &other) const { return _data == other._data; }
+        bool operator!=(const Stylesheet &other) const { return _data != other._data; }
+
+        /** Returns the entry key decoded as T, or nullptr if the stylesheet has no such entry.
+
+            The result is decoded only once per distinct stylesheet and type. */
+        template <class T> std::shared_ptr<const T> section(const String &key) const
+        {
+            std::lock_guard<std::mutex> lock(_data->sectionMutex);
+
+            auto sectionKey = std::make_pair(std::type_index(typeid(T)), key);
+
+            auto it = _data->sections.find(sectionKey);
+            if (it != _data->sections.end()) {
+                return std::static_pointer_cast<const T>(it->second);
+            }
+
+            std::shared_ptr<const T> result;
+            if (_data->value.is_object()) {
+                auto valueIt = _data->value.find(key);
+                if (valueIt != _data->value.end()) {
+                    result = std::make_shared<const T>(valueIt->template get<T>());
+                }
+            }
+
+            _data->sections.emplace(sectionKey, result);
+            return result;
+        }
+
+      public:
+        /** Number of distinct stylesheets that are currently alive. */
+        static size_t internedCount();
+
+      private:
+        std::shared_ptr<const detail::StylesheetData> _data;
+    };
+}
@@ -8,8 +8,11 @@
 #include <bdn/property/Property.h>
 #include <bdn/ui/Json.h>
 #include <bdn/ui/Layout.h>
+#include <bdn/ui/Stylesheet.h>
 
+#include <functional>
 #include <list>
+#include <stdexcept>
 
 namespace bdn::ui
 {
@@ -26,7 +29,7 @@ namespace bdn::ui
         Property<Rect> geometry;
         Property<bool> visible = true;
         Property<bool> isLayoutRoot = false;
-        Property<json> stylesheet;
+        Property<Stylesheet> stylesheet;
 
       public:
         static bool &debugViewEnabled();
@@ -48,6 +51,14 @@ namespace bdn::ui
         std::shared_ptr<ViewCoreFactory> viewCoreFactory() { return _viewCoreFactory; }
 
         virtual std::list<std::shared_ptr<View>> childViews() { return std::list<std::shared_ptr<View>>(); }
+
+        /** Calls function for every child view, in order, without copying the list of children.
+            Children must not be added or removed while the iteration is running. */
+        virtual void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function);
+        virtual size_t childCount();
+        /** Throws std::out_of_range if index is not smaller than childCount(). */
+        virtual std::shared_ptr<View> childAt(size_t index);
+
         virtual void removeAllChildViews() {}
         virtual void childViewStolen(const std::shared_ptr<View> &childView) {}
 
@@ -91,6 +102,7 @@ namespace bdn::ui
         std::shared_ptr<ViewCoreFactory> _viewCoreFactory;
         std::weak_ptr<View> _parentView;
         bool _hasLayoutSchedulePending{false};
+        mutable const std::type_info *_coreViewType = nullptr;
 
       public:
         class Core
@@ -123,12 +135,22 @@ namespace bdn::ui
 
             virtual void visitInternalChildren(const std::function<void(std::shared_ptr<View::Core>)> & /*unused*/) {}
 
-            std::shared_ptr<ViewCoreFactory> viewCoreFactory() { return _viewCoreFactory; }
+            std::shared_ptr<ViewCoreFactory> viewCoreFactory() { return _viewCoreFactory.lock(); }
+
+            virtual void updateFromStylesheet(const Stylesheet &stylesheet) {}
+
+            /** Called when the view owning the core is destroyed and the ViewCoreFactory wants to
+                park the core in its pool. Implementations must bring the core back into the state
+                it had right after init() and return true. By default cores are not reused. */
+            virtual bool prepareForReuse() { return false; }
 
-            virtual void updateFromStylesheet(json stylesheet) {}
+          protected:
+            /** Resets the View::Core properties and drops the bindings to the previous view. */
+            void resetViewCore();
 
           private:
-            std::shared_ptr<ViewCoreFactory> _viewCoreFactory;
+            // Weak, so cores parked in the factory's pool do not keep the factory alive
+            std::weak_ptr<ViewCoreFactory> _viewCoreFactory;
             std::shared_ptr<Layout> _layout;
 
             WeakCallback<void()> _layoutCallback;
@@ -165,6 +187,23 @@ namespace bdn::ui
             }
         }
 
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) const
+        {
+            if (_currentChild) {
+                function(_currentChild);
+            }
+        }
+
+        size_t childCount() const { return _currentChild ? 1 : 0; }
+
+        std::shared_ptr<View> childAt(size_t index) const
+        {
+            if (index >= childCount()) {
+                throw std::out_of_range("Child index out of range");
+            }
+            return _currentChild;
+        }
+
       private:
         std::shared_ptr<View> _currentChild;
     };
@@ -10,21 +10,70 @@ namespace bdn::ui
 #include <bdn/ui/View.h>
 #include <bdn/ui/ViewCoreTypeNotSupportedError.h>
 
+#include <array>
+#include <mutex>
+#include <optional>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
 namespace bdn::ui
 {
+    /** Creates the platform specific cores for views.
+
+        Cores are registered per view type with registerCoreType() and looked up by
+        std::type_index. The most recently used construction functions are kept in a small
+        direct mapped cache, so creating many views of the same few types does not hash or
+        compare type names at all.
+
+        Construction functions registered by name through the inherited Factory API (e.g. by
+        plugins) are still found: on a miss the factory falls back to a lookup by
+        type_info::name() and remembers the result for the type.
+
+        Cores of destroyed views are parked in a per view type pool if the core supports it
+        (see View::Core::prepareForReuse()) and handed to the next view of the same type. Pool
+        sizes can be configured per view type, setting a size of 0 disables pooling.
+    */
     class ViewCoreFactory : public bdn::Factory<std::shared_ptr<View::Core>, std::shared_ptr<ViewCoreFactory>>,
                             public std::enable_shared_from_this<ViewCoreFactory>
     {
       public:
         using ContextStack = std::vector<std::shared_ptr<UIContext>>;
 
+      public:
+        struct PoolStatistics
+        {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t parked = 0;
+        };
+
+        static constexpr size_t kDefaultPoolSize = 16;
+
       public:
         std::shared_ptr<View::Core> createViewCore(const std::type_info &viewType);
 
+        /** Parks core in the pool for viewType if it is not used elsewhere, the pool has room and
+            the core can be reset. Otherwise the core is released. */
+        void recycleCore(const std::type_info &viewType, std::shared_ptr<View::Core> core);
+
+        void setPoolSize(const std::type_info &viewType, size_t size);
+        template <class ViewType> void setPoolSize(size_t size) { setPoolSize(typeid(ViewType), size); }
+
+        /** Pool size for view types that do not have an explicit size. */
+        void setDefaultPoolSize(size_t size);
+
+        PoolStatistics poolStatistics(const std::type_info &viewType);
+        template <class ViewType> PoolStatistics poolStatistics() { return poolStatistics(typeid(ViewType)); }
+
+        /** Releases all parked cores, e.g. when the system is low on memory. */
+        void drainPools();
+
       public:
         template <class CoreType, class ViewType> void registerCoreType()
         {
             registerConstruction(typeid(ViewType).name(), &makeCore<CoreType>);
+            _coreConstructors.try_emplace(std::type_index(typeid(ViewType)), &makeCore<CoreType>);
         }
 
       public:
@@ -54,6 +103,36 @@ namespace bdn::ui
         }
 
       private:
+        struct CorePool
+        {
+            std::vector<std::shared_ptr<View::Core>> cores;
+            std::optional<size_t> size;
+            PoolStatistics statistics;
+        };
+
+      private:
+        const ConstructionFunction *findConstructionFunction(const std::type_info &viewType);
+
+        std::shared_ptr<View::Core> reclaimCore(const std::type_info &viewType);
+        size_t poolSize(const CorePool &pool) const { return pool.size.value_or(_defaultPoolSize); }
+        void trimPool(CorePool &pool, std::vector<std::shared_ptr<View::Core>> &released);
+
         static ContextStack *contextStack();
+
+      private:
+        struct CacheEntry
+        {
+            const std::type_info *viewType = nullptr;
+            const ConstructionFunction *construct = nullptr;
+        };
+
+        static constexpr size_t kCacheSize = 16;
+
+        std::unordered_map<std::type_index, ConstructionFunction> _coreConstructors;
+        std::array<CacheEntry, kCacheSize> _cache{};
+
+        std::mutex _poolMutex;
+        std::unordered_map<std::type_index, CorePool> _pools;
+        size_t _defaultPoolSize = kDefaultPoolSize;
     };
 }
@@ -46,6 +46,13 @@ namespace bdn::ui
         std::list<std::shared_ptr<View>> childViews() override;
         void removeAllChildViews() override;
 
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override
+        {
+            _contentView.forEachChild(function);
+        }
+        size_t childCount() override { return _contentView.childCount(); }
+        std::shared_ptr<View> childAt(size_t index) override { return _contentView.childAt(index); }
+
         void childViewStolen(const std::shared_ptr<View> &childView) override;
 
       protected:
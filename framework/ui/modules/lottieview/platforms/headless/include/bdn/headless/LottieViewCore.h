@@ -0,0 +1,22 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/lottie/View.h>
+
+namespace bdn::ui::headless
+{
+    /** Records the requested animation without loading or playing it. */
+    class LottieViewCore : public ViewCore, virtual public bdn::ui::lottie::View::Core
+    {
+      public:
+        LottieViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        void loadURL(const String &url) override;
+
+        const String &currentURL() const { return _currentURL; }
+
+      private:
+        String _currentURL;
+    };
+}
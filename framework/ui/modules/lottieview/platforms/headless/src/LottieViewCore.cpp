@@ -0,0 +1,16 @@
+#include <bdn/headless/LottieViewCore.h>
+#include <bdn/ui/ViewUtilities.h>
+
+namespace bdn::ui::lottie::detail
+{
+    CORE_REGISTER(View, bdn::ui::headless::LottieViewCore, View)
+}
+
+namespace bdn::ui::headless
+{
+    LottieViewCore::LottieViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory)
+        : ViewCore(viewCoreFactory)
+    {}
+
+    void LottieViewCore::loadURL(const String &url) { _currentURL = url; }
+}
@@ -1,13 +1,22 @@
 #pragma once
 
+#include <bdn/ui/yoga/LayoutCoordinator.h>
 #include <bdn/ui/yoga/ViewData.h>
 
 #include <map>
+#include <vector>
 
 namespace bdn::ui::yoga
 {
     class Layout : public ui::Layout
     {
+      public:
+        Layout() = default;
+
+        /** Creates a layout that hands its dirty roots to coordinator instead of calculating them
+            right away. Several layouts may share one coordinator. */
+        explicit Layout(std::shared_ptr<LayoutCoordinator> coordinator);
+
       public:
         void registerView(View *view) override;
         void unregisterView(View *view) override;
@@ -17,13 +26,24 @@ namespace bdn::ui::yoga
 
         void layout(View *view) override;
 
+        void beginUpdates() override;
+        void endUpdates() override;
+
       private:
         void applyStyle(View *view, YGNodeRef ygNode);
 
         void insert(View *view);
         void remove(View *view);
+        void rebuildChildren(View *parent, YGNodeRef parentNode);
 
       private:
         std::map<View *, std::unique_ptr<ViewData>> _views;
+        std::shared_ptr<LayoutCoordinator> _coordinator;
+
+        int _updateDepth = 0;
+        std::vector<View *> _pendingStyleUpdates;
+
+        bool _deferChildRebuilds = false;
+        std::vector<View *> _pendingChildRebuilds;
     };
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <bdn/DispatchQueue.h>
+#include <bdn/Size.h>
+#include <bdn/ui/View.h>
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace bdn::ui::yoga
+{
+    class ViewData;
+
+    /** Collects the layout roots that become dirty during a frame, calculates them in parallel
+        on a pool of worker queues and commits the resulting geometry on the main thread in one go.
+
+        Roots are calculated in nesting order: first all roots that are not nested inside another
+        dirty root, then the next level and so on. Roots on the same level own disjoint yoga
+        subtrees, so they are handed to the workers together. yoga's calculation modifies process
+        wide state though, so the calculation itself runs one root at a time. The workers first
+        measure the dirty views of their root concurrently (ViewData::premeasure()), which the
+        calculation then finds in the measurement cache, and collect the resulting geometry
+        concurrently afterwards.
+
+        Most platforms only allow measuring views on the main thread. Unless threadSafeMeasurement
+        is set, measure requests coming from the workers are forwarded to the thread that called
+        flush() and executed there while it waits for the workers to finish.
+    */
+    class LayoutCoordinator : public std::enable_shared_from_this<LayoutCoordinator>
+    {
+      public:
+        /** \param workerCount number of worker queues. 0 picks one per hardware thread.
+            \param threadSafeMeasurement allow View::sizeForSpace() to be called from the workers */
+        LayoutCoordinator(size_t workerCount = 0, bool threadSafeMeasurement = false);
+        ~LayoutCoordinator();
+
+      public:
+        /** Marks root as dirty and schedules a flush on the application's main dispatch queue. */
+        void schedule(ViewData *root);
+
+        /** Removes root from the set of dirty roots, e.g. because it is about to be destroyed. */
+        void cancel(ViewData *root);
+
+        /** Calculates and commits all dirty roots. Must be called on the main thread. */
+        void flush();
+
+        size_t pendingRootCount() const { return _dirtyRoots.size(); }
+        size_t workerCount() const { return _workers.size(); }
+
+      public:
+        /** Measures view, forwarding the call to the flushing thread if it is issued by a worker
+            of a coordinator that does not allow concurrent measurement. */
+        static Size measure(View *view, Size availableSpace);
+
+      private:
+        void calculate(const std::vector<ViewData *> &roots);
+        static size_t nestingDepth(ViewData *root);
+
+      private:
+        const bool _threadSafeMeasurement;
+
+        std::vector<ViewData *> _dirtyRoots;
+        bool _flushScheduled = false;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::queue<std::function<void()>> _measureRequests;
+        size_t _pendingCalculations = 0;
+        std::exception_ptr _calculationError;
+
+        // Declared last so the worker threads are joined before the state they use is destroyed.
+        std::vector<std::unique_ptr<DispatchQueue>> _workers;
+    };
+}
@@ -6,27 +6,61 @@
 #include <bdn/ui/View.h>
 #include <yoga/Yoga.h>
 
+#include <vector>
+
 struct YGNode;
 
 namespace bdn::ui::yoga
 {
     class ViewData
     {
+      public:
+        struct GeometryChange
+        {
+            ViewData *viewData;
+            Rect geometry;
+        };
+
+        using GeometryChanges = std::vector<GeometryChange>;
+
       public:
         ViewData(View *v);
         ~ViewData();
 
         void doLayout();
 
+        /** Runs the yoga calculation for this root and records the resulting geometry changes
+            without touching any view. Safe to call off the main thread as long as no other
+            calculation touches the same yoga subtree at the same time. yoga keeps process wide
+            state, so the calculation itself is serialized process wide. Only measuring (see
+            premeasure()) and collecting the changes run concurrently. */
+        void calculateLayout();
+
+        /** Measures the dirty views below this root again for the constraints yoga used before they
+            were marked dirty, so that the following calculateLayout() mostly finds the sizes in
+            the measurement cache instead of measuring while it holds the calculation lock. */
+        void premeasure();
+
+        /** Drops the cached measurements of this view, e.g. because its content changed. Their
+            constraints are kept for premeasure(). */
+        void invalidateMeasurements();
+
+        /** Applies the geometry recorded by the last calculateLayout() call. */
+        void commitLayout();
+
         static void onDirtied(YGNodeRef node);
 
         static YGSize measureFunc(YGNodeRef node, float width, YGMeasureMode widthMode, float height,
                                   YGMeasureMode heightMode);
 
-        static void applyLayout(YGNodeRef node, Point offset);
+        static Rect layoutRect(YGNodeRef node, Point offset);
+
+        /** Walks the yoga tree below node and appends the geometry of every view whose layout
+            changed during the last calculation to changes. Subtrees yoga did not touch
+            (hasNewLayout == false) are skipped entirely, as are nested layout roots. */
+        static void yogaVisit(YGNodeRef node, GeometryChanges &changes, Point initialOffset = {0, 0});
 
-        static void yogaVisit(YGNodeRef node, const std::function<void(YGNodeRef, Point)> &function,
-                              Point initialOffset = {0, 0});
+        static void applyLayout(const GeometryChanges &changes);
 
         void childrenChanged(bool adding = false);
 
@@ -38,5 +72,27 @@ namespace bdn::ui::yoga
         std::function<void()> layoutFunction;
         bool isRootNode;
         bool isIn;
+
+      private:
+        struct Measurement
+        {
+            float width;
+            YGMeasureMode widthMode;
+            float height;
+            YGMeasureMode heightMode;
+            YGSize size;
+            bool valid;
+
+            bool hasConstraints(float w, YGMeasureMode wMode, float h, YGMeasureMode hMode) const;
+        };
+
+        // yoga itself keeps up to 16 measurements per node, most nodes only need one or two
+        static constexpr size_t kMaxMeasurements = 8;
+
+        YGSize measure(float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode);
+
+      private:
+        GeometryChanges _geometryChanges;
+        std::vector<Measurement> _measurements;
     };
 }
@@ -4,6 +4,8 @@
 
 #include <yoga/YGNode.h>
 
+#include <algorithm>
+
 namespace bdn::ui::yoga
 {
     constexpr YGFlexDirection toYGFlexDirection(FlexStylesheet::Direction direction)
@@ -102,36 +104,117 @@ namespace bdn::ui::yoga
         return YGPositionTypeRelative;
     }
 
+    Layout::Layout(std::shared_ptr<LayoutCoordinator> coordinator) : _coordinator(std::move(coordinator)) {}
+
     void Layout::registerView(View *view)
     {
-        _views[view] = std::make_unique<ViewData>(view);
+        auto &viewData = _views[view];
+        if (viewData && _coordinator) {
+            _coordinator->cancel(viewData.get());
+        }
+
+        viewData = std::make_unique<ViewData>(view);
         updateStylesheet(view);
     }
 
     void Layout::unregisterView(View *view)
     {
+        _pendingStyleUpdates.erase(std::remove(_pendingStyleUpdates.begin(), _pendingStyleUpdates.end(), view),
+                                   _pendingStyleUpdates.end());
+        _pendingChildRebuilds.erase(std::remove(_pendingChildRebuilds.begin(), _pendingChildRebuilds.end(), view),
+                                    _pendingChildRebuilds.end());
+
         remove(view);
         auto it = _views.find(view);
         if (it != _views.end()) {
+            if (_coordinator) {
+                _coordinator->cancel(it->second.get());
+            }
             _views.erase(it);
         }
     }
 
-    void Layout::markDirty(View *view) { _views[view]->ygNode->markDirtyAndPropogate(); }
+    void Layout::markDirty(View *view)
+    {
+        auto &viewData = _views[view];
+        viewData->invalidateMeasurements();
+        viewData->ygNode->markDirtyAndPropogate();
+    }
+
+    void Layout::updateStylesheet(View *view)
+    {
+        if (_updateDepth > 0) {
+            auto it = std::find(_pendingStyleUpdates.begin(), _pendingStyleUpdates.end(), view);
+            if (it == _pendingStyleUpdates.end()) {
+                _pendingStyleUpdates.push_back(view);
+            }
+            return;
+        }
 
-    void Layout::updateStylesheet(View *view) { applyStyle(view, _views[view]->ygNode); }
+        auto &viewData = _views[view];
+        viewData->invalidateMeasurements();
+        applyStyle(view, viewData->ygNode);
+    }
 
-    void Layout::layout(View *view) { _views[view]->doLayout(); }
+    void Layout::beginUpdates() { _updateDepth++; }
 
-    FlexStylesheet fromStyleSheet(const json &jsonStyleSheet)
+    void Layout::endUpdates()
     {
-        FlexStylesheet result;
+        if (_updateDepth == 0 || --_updateDepth > 0) {
+            return;
+        }
 
-        if (jsonStyleSheet.count("flex")) {
-            result = (FlexStylesheet)jsonStyleSheet.at("flex");
+        auto pending = std::move(_pendingStyleUpdates);
+        _pendingStyleUpdates.clear();
+
+        // Views registered in the same batch usually share a parent. Rebuild each parent's yoga
+        // children once instead of once per inserted child.
+        _deferChildRebuilds = true;
+        try {
+            for (auto view : pending) {
+                auto it = _views.find(view);
+                if (it != _views.end()) {
+                    it->second->invalidateMeasurements();
+                    applyStyle(view, it->second->ygNode);
+                }
+            }
+        }
+        catch (...) {
+            _deferChildRebuilds = false;
+            _pendingChildRebuilds.clear();
+            throw;
         }
+        _deferChildRebuilds = false;
+
+        auto parents = std::move(_pendingChildRebuilds);
+        _pendingChildRebuilds.clear();
 
-        return result;
+        for (auto parent : parents) {
+            auto it = _views.find(parent);
+            if (it != _views.end()) {
+                rebuildChildren(parent, it->second->ygNode);
+            }
+        }
+    }
+
+    void Layout::layout(View *view)
+    {
+        auto &viewData = _views[view];
+
+        if (_coordinator && viewData->isRootNode) {
+            _coordinator->schedule(viewData.get());
+        } else {
+            viewData->doLayout();
+        }
+    }
+
+    std::shared_ptr<const FlexStylesheet> fromStyleSheet(const Stylesheet &stylesheet)
+    {
+        static const auto s_defaultFlexStylesheet = std::make_shared<const FlexStylesheet>();
+
+        // Decoded once per distinct stylesheet and shared by all views using it
+        auto result = stylesheet.section<FlexStylesheet>("flex");
+        return result ? result : s_defaultFlexStylesheet;
     }
 
 #define UPDATE_VALUE(FuncName, Value, ...)                                                                             \
@@ -159,7 +242,8 @@ namespace bdn::ui::yoga
 
     void Layout::applyStyle(View *view, YGNodeRef ygNode)
     {
-        FlexStylesheet stylesheet = fromStyleSheet(view->stylesheet.get());
+        auto flexStylesheet = fromStyleSheet(view->stylesheet.get());
+        const FlexStylesheet &stylesheet = *flexStylesheet;
 
         if (view->visible.get()) {
             insert(view);
@@ -216,24 +300,34 @@ namespace bdn::ui::yoga
             if (it != _views.end()) {
                 viewData->isIn = true;
 
-                auto childList = parent->childViews();
-
-                YGNodeRemoveAllChildren(it->second->ygNode);
-                YGNodeSetMeasureFunc(it->second->ygNode, nullptr);
-
-                for (auto &child : parent->childViews()) {
-                    if (child->visible.get()) {
-                        auto itChild = _views.find(child.get());
-                        if (itChild != _views.end()) {
-                            YGNodeInsertChild(it->second->ygNode, itChild->second->ygNode,
-                                              YGNodeGetChildCount(it->second->ygNode));
-                        }
+                if (_deferChildRebuilds) {
+                    if (std::find(_pendingChildRebuilds.begin(), _pendingChildRebuilds.end(), parent.get()) ==
+                        _pendingChildRebuilds.end()) {
+                        _pendingChildRebuilds.push_back(parent.get());
                     }
+                    return;
                 }
+
+                rebuildChildren(parent.get(), it->second->ygNode);
             }
         }
     }
 
+    void Layout::rebuildChildren(View *parent, YGNodeRef parentNode)
+    {
+        YGNodeRemoveAllChildren(parentNode);
+        YGNodeSetMeasureFunc(parentNode, nullptr);
+
+        parent->forEachChild([this, parentNode](const std::shared_ptr<View> &child) {
+            if (child->visible.get()) {
+                auto itChild = _views.find(child.get());
+                if (itChild != _views.end()) {
+                    YGNodeInsertChild(parentNode, itChild->second->ygNode, YGNodeGetChildCount(parentNode));
+                }
+            }
+        });
+    }
+
     void Layout::remove(View *view)
     {
         auto it = _views.find(view);
@@ -0,0 +1,169 @@
+#include <bdn/Application.h>
+#include <bdn/ui/yoga/LayoutCoordinator.h>
+#include <bdn/ui/yoga/ViewData.h>
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <thread>
+
+namespace bdn::ui::yoga
+{
+    namespace
+    {
+        // Set while a worker calculates a root so that measure() knows where to forward requests.
+        thread_local LayoutCoordinator *t_calculatingCoordinator = nullptr;
+    }
+
+    LayoutCoordinator::LayoutCoordinator(size_t workerCount, bool threadSafeMeasurement)
+        : _threadSafeMeasurement(threadSafeMeasurement)
+    {
+        if (workerCount == 0) {
+            workerCount = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        _workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; i++) {
+            _workers.push_back(std::make_unique<DispatchQueue>());
+        }
+    }
+
+    LayoutCoordinator::~LayoutCoordinator() = default;
+
+    void LayoutCoordinator::schedule(ViewData *root)
+    {
+        if (std::find(_dirtyRoots.begin(), _dirtyRoots.end(), root) == _dirtyRoots.end()) {
+            _dirtyRoots.push_back(root);
+        }
+
+        if (_flushScheduled) {
+            return;
+        }
+
+        if (auto app = App()) {
+            _flushScheduled = true;
+            app->dispatchQueue()->dispatchAsync([weakSelf = weak_from_this()]() {
+                if (auto self = weakSelf.lock()) {
+                    self->flush();
+                }
+            });
+        }
+    }
+
+    void LayoutCoordinator::cancel(ViewData *root)
+    {
+        _dirtyRoots.erase(std::remove(_dirtyRoots.begin(), _dirtyRoots.end(), root), _dirtyRoots.end());
+    }
+
+    void LayoutCoordinator::flush()
+    {
+        _flushScheduled = false;
+
+        if (_dirtyRoots.empty()) {
+            return;
+        }
+
+        std::map<size_t, std::vector<ViewData *>> levels;
+        for (auto root : _dirtyRoots) {
+            levels[nestingDepth(root)].push_back(root);
+        }
+        _dirtyRoots.clear();
+
+        for (auto &level : levels) {
+            calculate(level.second);
+        }
+
+        for (auto &level : levels) {
+            for (auto root : level.second) {
+                root->commitLayout();
+            }
+        }
+    }
+
+    void LayoutCoordinator::calculate(const std::vector<ViewData *> &roots)
+    {
+        if (roots.size() == 1) {
+            roots.front()->calculateLayout();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lk(_mutex);
+        _pendingCalculations = roots.size();
+        _calculationError = nullptr;
+
+        for (size_t i = 0; i < roots.size(); i++) {
+            _workers[i % _workers.size()]->dispatchAsync([this, root = roots[i]]() {
+                t_calculatingCoordinator = this;
+
+                std::exception_ptr error;
+                try {
+                    // Measuring runs concurrently, the calculation itself is serialized
+                    root->premeasure();
+                    root->calculateLayout();
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+
+                t_calculatingCoordinator = nullptr;
+
+                std::unique_lock<std::mutex> workerLock(_mutex);
+                if (error && !_calculationError) {
+                    _calculationError = error;
+                }
+                _pendingCalculations--;
+                _condition.notify_all();
+            });
+        }
+
+        while (_pendingCalculations > 0 || !_measureRequests.empty()) {
+            _condition.wait(lk, [this]() { return _pendingCalculations == 0 || !_measureRequests.empty(); });
+
+            while (!_measureRequests.empty()) {
+                auto request = std::move(_measureRequests.front());
+                _measureRequests.pop();
+
+                lk.unlock();
+                request();
+                lk.lock();
+            }
+        }
+
+        if (_calculationError) {
+            std::rethrow_exception(std::exchange(_calculationError, nullptr));
+        }
+    }
+
+    size_t LayoutCoordinator::nestingDepth(ViewData *root)
+    {
+        size_t depth = 0;
+
+        for (auto node = YGNodeGetOwner(root->ygNode); node != nullptr; node = YGNodeGetOwner(node)) {
+            auto viewData = static_cast<ViewData *>(YGNodeGetContext(node));
+            if (viewData != nullptr && viewData->isRootNode) {
+                depth++;
+            }
+        }
+
+        return depth;
+    }
+
+    Size LayoutCoordinator::measure(View *view, Size availableSpace)
+    {
+        auto coordinator = t_calculatingCoordinator;
+        if (coordinator == nullptr || coordinator->_threadSafeMeasurement) {
+            return view->sizeForSpace(availableSpace);
+        }
+
+        std::packaged_task<Size()> task([view, availableSpace]() { return view->sizeForSpace(availableSpace); });
+        auto result = task.get_future();
+
+        {
+            std::unique_lock<std::mutex> lk(coordinator->_mutex);
+            coordinator->_measureRequests.emplace([&task]() { task(); });
+        }
+        coordinator->_condition.notify_all();
+
+        return result.get();
+    }
+}
@@ -1,9 +1,24 @@
 #include <bdn/ui/Window.h>
+#include <bdn/ui/yoga/LayoutCoordinator.h>
 #include <bdn/ui/yoga/ViewData.h>
 #include <yoga/YGNode.h>
 
+#include <algorithm>
+#include <mutex>
+
 namespace bdn::ui::yoga
 {
+    namespace
+    {
+        // yoga keeps process wide state (e.g. the layout generation counter) that every
+        // YGNodeCalculateLayout() call modifies without synchronization.
+        std::mutex &calculationMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+    }
+
     ViewData::ViewData(View *v) : view(v), isRootNode(false), isIn(false)
     {
         ygNode = YGNodeNew();
@@ -30,8 +45,30 @@ namespace bdn::ui::yoga
     void ViewData::doLayout()
     {
         if (isRootNode) {
-            YGNodeCalculateLayout(ygNode, geometry->width, geometry->height, YGDirectionLTR);
-            yogaVisit(ygNode, &applyLayout);
+            calculateLayout();
+            commitLayout();
+        }
+    }
+
+    void ViewData::calculateLayout()
+    {
+        if (isRootNode) {
+            {
+                std::lock_guard<std::mutex> lk(calculationMutex());
+                YGNodeCalculateLayout(ygNode, geometry->width, geometry->height, YGDirectionLTR);
+            }
+
+            _geometryChanges.clear();
+            yogaVisit(ygNode, _geometryChanges);
+            YGNodeSetHasNewLayout(ygNode, false);
+        }
+    }
+
+    void ViewData::commitLayout()
+    {
+        if (isRootNode) {
+            applyLayout(_geometryChanges);
+            _geometryChanges.clear();
 
             ygNode->setDirty(false);
         }
@@ -62,57 +99,152 @@ namespace bdn::ui::yoga
     {
         auto viewData = static_cast<ViewData *>(YGNodeGetContext(node));
 
+        for (auto &measurement : viewData->_measurements) {
+            if (measurement.valid && measurement.hasConstraints(width, widthMode, height, heightMode)) {
+                return measurement.size;
+            }
+        }
+
+        return viewData->measure(width, widthMode, height, heightMode);
+    }
+
+    YGSize ViewData::measure(float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode)
+    {
         Size constraintSize = Size(widthMode == YGMeasureModeUndefined ? Size::componentNone() : width,
                                    heightMode == YGMeasureModeUndefined ? Size::componentNone() : height);
 
-        Size s = viewData->view->sizeForSpace(constraintSize);
+        Size s = LayoutCoordinator::measure(view, constraintSize);
+        YGSize size{(float)s.width, (float)s.height};
+
+        auto it = std::find_if(_measurements.begin(), _measurements.end(), [&](auto &measurement) {
+            return measurement.hasConstraints(width, widthMode, height, heightMode);
+        });
+        if (it == _measurements.end()) {
+            if (_measurements.size() == kMaxMeasurements) {
+                _measurements.erase(_measurements.begin());
+            }
+            it = _measurements.insert(_measurements.end(), Measurement{width, widthMode, height, heightMode});
+        }
+        it->size = size;
+        it->valid = true;
+
+        return size;
+    }
+
+    bool ViewData::Measurement::hasConstraints(float w, YGMeasureMode wMode, float h, YGMeasureMode hMode) const
+    {
+        // Undefined constraints come with an arbitrary (usually NaN) value
+        return widthMode == wMode && heightMode == hMode && (wMode == YGMeasureModeUndefined || width == w) &&
+               (hMode == YGMeasureModeUndefined || height == h);
+    }
 
-        return (YGSize){.width = (float)s.width, .height = (float)s.height};
+    void ViewData::invalidateMeasurements()
+    {
+        for (auto &measurement : _measurements) {
+            measurement.valid = false;
+        }
     }
 
-    void ViewData::applyLayout(YGNodeRef node, Point offset)
+    void ViewData::premeasure()
     {
-        if (auto ctxt = YGNodeGetContext(node)) {
-            auto viewData = static_cast<ViewData *>(ctxt);
+        if (!isRootNode) {
+            return;
+        }
 
-            Rect r{YGNodeLayoutGetLeft(node), YGNodeLayoutGetTop(node), YGNodeLayoutGetWidth(node),
-                   YGNodeLayoutGetHeight(node)};
+        // Dirtiness propagates to the root, so clean subtrees have nothing to measure
+        std::vector<YGNodeRef> pending{ygNode};
+        while (!pending.empty()) {
+            auto node = pending.back();
+            pending.pop_back();
 
-            if (std::isnan(r.x)) {
-                r.x = 0;
-            }
-            if (std::isnan(r.y)) {
-                r.y = 0;
+            if (!YGNodeIsDirty(node)) {
+                continue;
             }
-            if (std::isnan(r.width)) {
-                r.width = 0;
+
+            auto viewData = static_cast<ViewData *>(YGNodeGetContext(node));
+            if (viewData != nullptr && YGNodeHasMeasureFunc(node)) {
+                for (size_t i = 0; i < viewData->_measurements.size(); i++) {
+                    auto measurement = viewData->_measurements[i];
+                    if (!measurement.valid) {
+                        viewData->measure(measurement.width, measurement.widthMode, measurement.height,
+                                          measurement.heightMode);
+                    }
+                }
             }
-            if (std::isnan(r.height)) {
-                r.height = 0;
+
+            for (auto i = YGNodeGetChildCount(node); i > 0; i--) {
+                pending.push_back(YGNodeGetChild(node, i - 1));
             }
+        }
+    }
 
-            r.x += offset.x;
-            r.y += offset.y;
+    Rect ViewData::layoutRect(YGNodeRef node, Point offset)
+    {
+        Rect r{YGNodeLayoutGetLeft(node), YGNodeLayoutGetTop(node), YGNodeLayoutGetWidth(node),
+               YGNodeLayoutGetHeight(node)};
 
-            viewData->view->geometry = r;
+        if (std::isnan(r.x)) {
+            r.x = 0;
+        }
+        if (std::isnan(r.y)) {
+            r.y = 0;
+        }
+        if (std::isnan(r.width)) {
+            r.width = 0;
+        }
+        if (std::isnan(r.height)) {
+            r.height = 0;
         }
+
+        r.x += offset.x;
+        r.y += offset.y;
+
+        return r;
     }
 
-    void ViewData::yogaVisit(YGNodeRef node, const std::function<void(YGNodeRef, Point)> &function, Point initialOffset)
+    void ViewData::yogaVisit(YGNodeRef node, GeometryChanges &changes, Point initialOffset)
     {
-        for (int i = 0; i < YGNodeGetChildCount(node); i++) {
-            auto child = YGNodeGetChild(node, i);
+        // View geometry is relative to the parent view, so only the direct children of node are shifted by
+        // initialOffset. Everything below them is pushed with a zero offset.
+        std::vector<std::pair<YGNodeRef, Point>> pending;
 
-            if (auto ctxt = YGNodeGetContext(child)) {
-                auto viewData = static_cast<ViewData *>(ctxt);
+        auto pushChildren = [&pending](YGNodeRef parent, Point offset) {
+            for (auto i = YGNodeGetChildCount(parent); i > 0; i--) {
+                pending.emplace_back(YGNodeGetChild(parent, i - 1), offset);
+            }
+        };
 
-                if (viewData->view->isLayoutRoot) {
-                    continue;
-                }
+        pushChildren(node, initialOffset);
+
+        while (!pending.empty()) {
+            auto [child, offset] = pending.back();
+            pending.pop_back();
+
+            auto viewData = static_cast<ViewData *>(YGNodeGetContext(child));
+            if (viewData == nullptr || viewData->view->isLayoutRoot) {
+                continue;
+            }
 
-                function(child, initialOffset);
-                yogaVisit(child, function);
+            // Yoga only flags nodes it actually laid out. If this node was served from the
+            // layout cache, its whole subtree kept its previous geometry.
+            if (!YGNodeGetHasNewLayout(child)) {
+                continue;
             }
+            YGNodeSetHasNewLayout(child, false);
+
+            Rect r = layoutRect(child, offset);
+            if (r != viewData->view->geometry.get()) {
+                changes.push_back({viewData, r});
+            }
+
+            pushChildren(child, Point{0, 0});
+        }
+    }
+
+    void ViewData::applyLayout(const GeometryChanges &changes)
+    {
+        for (const auto &change : changes) {
+            change.viewData->view->geometry = change.geometry;
         }
     }
 
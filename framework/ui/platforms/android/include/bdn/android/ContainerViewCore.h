@@ -7,6 +7,8 @@
 #include <bdn/android/wrapper/NativeViewGroup.h>
 #include <bdn/android/wrapper/View.h>
 
+#include <vector>
+
 namespace bdn::ui::android
 {
 
@@ -30,8 +32,21 @@ namespace bdn::ui::android
         void removeChildView(std::shared_ptr<View> child) override;
         std::list<std::shared_ptr<View>> childViews() override;
 
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override;
+        size_t childCount() override;
+        std::shared_ptr<View> childAt(size_t index) override;
+
+        void beginUpdates() override;
+        void endUpdates() override;
+
+        bool prepareForReuse() override;
+
       private:
-        std::list<std::shared_ptr<View>> _children;
+        std::vector<std::shared_ptr<View>> _children;
+
+        int _updateDepth = 0;
+        bool _childrenAddedInBatch = false;
+        bool _childrenChangedInBatch = false;
 
         // ViewCore interface
       public:
@@ -14,14 +14,17 @@ namespace bdn::ui::android
 
       public:
         void imageLoaded(int width, int height);
+        void imageLoadFailed();
 
       private:
         Size sizeForSpace(Size availableSpace = Size::none()) const override;
 
       private:
-        void loadUrl();
+        void updateLoad();
 
       private:
         Size _imageSize;
+        String _requestedUrl;
+        bool _loading = false;
     };
 }
@@ -17,6 +17,8 @@ namespace bdn::ui::android
 
         Size sizeForSpace(Size availableSpace = Size::none()) const override;
 
+        bool prepareForReuse() override;
+
       protected:
         bool canAdjustWidthToAvailableSpace() const override { return false; }
 
@@ -8,6 +8,8 @@
 
 #include <bdn/android/wrapper/NativeListAdapter.h>
 
+#include <unordered_set>
+
 namespace bdn::ui::android
 {
     class ListViewCore : public ViewCore, virtual public ListView::Core
@@ -17,9 +19,23 @@ namespace bdn::ui::android
 
         void reloadData() override;
         void refreshDone() override;
+        void applyChanges(const ListViewChanges &changes) override;
 
         void fireRefresh();
 
+        /** Height of the row, served from a cache that is filled in blocks via heightsForRange(). */
+        float rowHeight(size_t rowIndex);
+
+        /** Called by the native list view whenever the range of visible rows changes. */
+        void visibleRowsChanged(size_t firstVisibleRow, size_t visibleRowCount);
+
+        /** Returns true once if the row was marked as updated by applyChanges() and must be bound again
+            even though its row id did not change. */
+        bool takeUpdatedRowId(ListViewDataSource::RowId rowId);
+
+        /** Number of view types the native list view was set up with, at least 1. */
+        size_t viewTypeCount() const { return _viewTypeCount; }
+
       protected:
         void initTag() override;
 
@@ -27,5 +43,11 @@ namespace bdn::ui::android
         bdn::android::wrapper::NativeListView _jNativeListView;
         bdn::android::wrapper::ListView _jListView;
         bdn::android::wrapper::NativeListAdapter _jNativeListAdapter;
+
+        detail::ListViewRowHeights _rowHeights;
+        detail::ListViewPrefetcher _prefetcher;
+
+        std::unordered_set<ListViewDataSource::RowId> _updatedRowIds;
+        size_t _viewTypeCount = 1;
     };
 }
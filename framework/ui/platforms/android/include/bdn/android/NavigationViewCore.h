@@ -19,6 +19,7 @@ namespace bdn::ui::android
         void pushView(std::shared_ptr<View> view, String title) override;
         void popView() override;
         std::list<std::shared_ptr<View>> childViews() override;
+        std::shared_ptr<View> currentChild() override;
 
       public:
         void visitInternalChildren(const std::function<void(std::shared_ptr<View::Core>)> &function) override;
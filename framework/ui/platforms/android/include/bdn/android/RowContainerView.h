@@ -3,6 +3,9 @@
 #include <bdn/android/ContainerViewCore.h>
 #include <bdn/android/wrapper/NativeListAdapter.h>
 #include <bdn/ui/ContainerView.h>
+#include <bdn/ui/ListViewDataSource.h>
+
+#include <optional>
 
 namespace bdn::ui::android
 {
@@ -18,6 +21,13 @@ namespace bdn::ui::android
             isLayoutRoot = true;
         }
 
+      public:
+        /** Id of the row the container currently displays, if the data source has stable row ids. */
+        std::optional<ListViewDataSource::RowId> boundRowId;
+
+        /** View type of the row the container was last bound to. */
+        size_t viewType = 0;
+
       public:
         class Core : public bdn::ui::android::ContainerViewCore
         {
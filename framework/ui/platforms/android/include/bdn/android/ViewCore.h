@@ -54,6 +54,10 @@ namespace bdn::ui::android
       protected:
         virtual void initTag();
 
+        /** Common part of prepareForReuse() for the cores that support pooling. Detaches the java
+            view from its parent so that it can be attached to a new one. */
+        void resetForReuse();
+
         virtual bool canAdjustWidthToAvailableSpace() const { return false; }
         virtual bool canAdjustHeightToAvailableSpace() const { return false; }
 
@@ -14,5 +14,7 @@ namespace bdn::android::wrapper
 
         JavaMethod<void(int)> setChoiceMode{this, "setChoiceMode"};
         JavaMethod<void(bool)> setStackFromBottom{this, "setStackFromBottom"};
+        JavaMethod<int()> getFirstVisiblePosition{this, "getFirstVisiblePosition"};
+        JavaMethod<void(int, int)> setSelectionFromTop{this, "setSelectionFromTop"};
     };
 }
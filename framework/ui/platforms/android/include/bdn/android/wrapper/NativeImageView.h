@@ -12,5 +12,6 @@ namespace bdn::android::wrapper
 
       public:
         JavaMethod<void(String)> loadUrl{this, "loadUrl"};
+        JavaMethod<void()> cancelLoad{this, "cancelLoad"};
     };
 }
@@ -47,14 +47,18 @@ public class NativeImageView extends AppCompatImageView
 
         @Override
         protected void onPostExecute(Bitmap bitmap) {
+            mBitmap = bitmap;
             try {
-                mBitmap = bitmap;
                 imageView.setImageBitmap(bitmap);
-
-                native_imageLoaded(getImageWidth(), getImageHeight());
             } catch (Exception e) {
                 e.printStackTrace();
             }
+
+            if (bitmap != null) {
+                native_imageLoaded(getImageWidth(), getImageHeight());
+            } else {
+                native_imageLoadFailed();
+            }
         }
     }
 
@@ -75,14 +79,20 @@ public class NativeImageView extends AppCompatImageView
     public void loadUrl(String url) {
         mBitmap = null;
 
+        cancelLoad();
+        this.loadImageTask = new AsyncTaskLoadImage(this);
+        loadImageTask.execute(url);
+    }
+
+    public void cancelLoad() {
         if(this.loadImageTask != null) {
             this.loadImageTask.cancel(true);
+            this.loadImageTask = null;
         }
-        this.loadImageTask = new AsyncTaskLoadImage(this);
-        loadImageTask.execute(url);
     }
 
     private AsyncTaskLoadImage loadImageTask;
 
     private native void native_imageLoaded(int width, int height);
+    private native void native_imageLoadFailed();
 }
\ No newline at end of file
@@ -37,25 +37,43 @@ public class NativeListAdapter extends BaseAdapter
         return nativeGetCount(_view);
     }
 
-    // Everytime you call either getItemId() or getItem() a little bunny
-    // will die in unprecedented pain.
+    @Override
+    public boolean hasStableIds() {
+        return nativeHasStableIds(_view);
+    }
 
     @Override
     public long getItemId(int position) {
-        return position;
+        return nativeGetItemId(_view, position);
     }
 
+    // Everytime you call getItem() a little bunny will die in unprecedented pain.
+
     @Override
     public Object getItem(int position) {
         return null;
     }
 
+    @Override
+    public int getViewTypeCount() {
+        return nativeGetViewTypeCount(_view);
+    }
+
+    @Override
+    public int getItemViewType(int position) {
+        return nativeGetItemViewType(_view, position);
+    }
+
     @Override
     public View getView(int position, View convertView, ViewGroup container) {
         return nativeViewForRowIndex(_view, position, convertView, container);
     }
 
     public native int nativeGetCount(View view);
+    public native boolean nativeHasStableIds(View view);
+    public native long nativeGetItemId(View view, int position);
+    public native int nativeGetViewTypeCount(View view);
+    public native int nativeGetItemViewType(View view, int position);
     public native View nativeViewForRowIndex(View view, int rowIndex, View reusableView, ViewGroup container);
 
     private View _view;
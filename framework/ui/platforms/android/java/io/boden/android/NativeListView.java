@@ -4,6 +4,7 @@ import android.content.Context;
 import androidx.annotation.NonNull;
 import androidx.swiperefreshlayout.widget.SwipeRefreshLayout;
 
+import android.widget.AbsListView;
 import android.widget.ListView;
 
 public class NativeListView extends SwipeRefreshLayout {
@@ -24,6 +25,19 @@ public class NativeListView extends SwipeRefreshLayout {
             }
         });
 
+        _listView.setOnScrollListener(new AbsListView.OnScrollListener() {
+            @Override
+            public void onScrollStateChanged(AbsListView view, int scrollState) {}
+
+            @Override
+            public void onScroll(AbsListView view, int firstVisibleItem, int visibleItemCount, int totalItemCount) {
+                if (firstVisibleItem != _firstVisibleItem || visibleItemCount != _visibleItemCount) {
+                    _firstVisibleItem = firstVisibleItem;
+                    _visibleItemCount = visibleItemCount;
+                    doVisibleRowsChanged(firstVisibleItem, visibleItemCount);
+                }
+            }
+        });
     }
 
     ListView getListView() {
@@ -31,6 +45,9 @@ public class NativeListView extends SwipeRefreshLayout {
     }
 
     private ListView _listView;
+    private int _firstVisibleItem = -1;
+    private int _visibleItemCount = -1;
 
     private native void doRefresh();
+    private native void doVisibleRowsChanged(int firstVisibleRow, int visibleRowCount);
 }
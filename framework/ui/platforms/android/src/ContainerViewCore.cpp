@@ -2,6 +2,9 @@
 #include <bdn/android/ContainerViewCore.h>
 #include <bdn/entry.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace bdn::ui::detail
 {
     CORE_REGISTER(ContainerView, bdn::ui::android::ContainerViewCore, ContainerView)
@@ -27,6 +30,12 @@ namespace bdn::ui::android
             throw std::runtime_error("Tried adding Child with incompatible core");
         }
 
+        if (_updateDepth > 0) {
+            _childrenAddedInBatch = true;
+            _childrenChangedInBatch = true;
+            return;
+        }
+
         scheduleLayout();
         updateChildren();
     }
@@ -34,17 +43,66 @@ namespace bdn::ui::android
     void ContainerViewCore::removeChildView(std::shared_ptr<View> child)
     {
         if (auto childCore = child->core<android::ViewCore>()) {
-            _children.remove(child);
+            _children.erase(std::remove(_children.begin(), _children.end(), child), _children.end());
             auto group = getJViewAS<bdn::android::wrapper::NativeViewGroup>();
             group.removeView(childCore->getJView());
         } else {
             throw std::runtime_error("Tried removing Child with incompatible core");
         }
 
+        if (_updateDepth > 0) {
+            _childrenChangedInBatch = true;
+            return;
+        }
+
         scheduleLayout();
     }
 
-    std::list<std::shared_ptr<View>> ContainerViewCore::childViews() { return _children; }
+    std::list<std::shared_ptr<View>> ContainerViewCore::childViews()
+    {
+        return std::list<std::shared_ptr<View>>(_children.begin(), _children.end());
+    }
+
+    void ContainerViewCore::forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function)
+    {
+        for (const auto &child : _children) {
+            function(child);
+        }
+    }
+
+    size_t ContainerViewCore::childCount() { return _children.size(); }
+
+    std::shared_ptr<View> ContainerViewCore::childAt(size_t index) { return _children.at(index); }
+
+    void ContainerViewCore::beginUpdates() { _updateDepth++; }
+
+    void ContainerViewCore::endUpdates()
+    {
+        if (_updateDepth == 0 || --_updateDepth > 0) {
+            return;
+        }
+
+        // Propagate the scale factor and request a layout once for the whole batch
+        if (std::exchange(_childrenAddedInBatch, false)) {
+            updateChildren();
+        }
+        if (std::exchange(_childrenChangedInBatch, false)) {
+            scheduleLayout();
+        }
+    }
+
+    bool ContainerViewCore::prepareForReuse()
+    {
+        getJViewAS<bdn::android::wrapper::NativeViewGroup>().removeAllViews();
+        _children.clear();
+
+        _updateDepth = 0;
+        _childrenAddedInBatch = false;
+        _childrenChangedInBatch = false;
+
+        resetForReuse();
+        return true;
+    }
 
     void ContainerViewCore::visitInternalChildren(const std::function<void(std::shared_ptr<View::Core>)> &function)
     {
@@ -15,17 +15,50 @@ namespace bdn::ui::android
     {
         url.onChange() += [=](auto &property) {
             _imageSize = Size{0, 0};
-            getJViewAS<bdn::android::wrapper::NativeImageView>().loadUrl(property.get());
+            updateLoad();
         };
+        viewportPosition.onChange() += [=](auto &property) { updateLoad(); };
+    }
+
+    void ImageViewCore::updateLoad()
+    {
+        auto imageView = getJViewAS<bdn::android::wrapper::NativeImageView>();
+
+        // Images that finished loading stay, only pending loads are dropped
+        if (viewportPosition.get() == ImageView::ViewportPosition::Outside) {
+            if (_loading) {
+                imageView.cancelLoad();
+                _loading = false;
+                _requestedUrl = String();
+            }
+            return;
+        }
+
+        if (_requestedUrl != url.get()) {
+            _requestedUrl = url.get();
+            _loading = true;
+            imageView.loadUrl(_requestedUrl);
+        }
     }
 
     void ImageViewCore::imageLoaded(int width, int height)
     {
+        _loading = false;
         _imageSize = Size{(double)width, (double)height};
 
         scheduleLayout();
     }
 
+    void ImageViewCore::imageLoadFailed()
+    {
+        // Forgetting the URL lets the load be retried once the view comes into view again
+        _loading = false;
+        _requestedUrl = String();
+        _imageSize = Size{0, 0};
+
+        scheduleLayout();
+    }
+
     Size ImageViewCore::sizeForSpace(Size availableSpace) const
     {
         Size result = _imageSize;
@@ -58,3 +91,18 @@ extern "C" JNIEXPORT void JNICALL Java_io_boden_android_NativeImageView_native_1
         },
         true, env);
 }
+
+extern "C" JNIEXPORT void JNICALL Java_io_boden_android_NativeImageView_native_1imageLoadFailed(JNIEnv *env,
+                                                                                                jobject rawSelf)
+{
+    bdn::platformEntryWrapper(
+        [&]() {
+            if (auto core =
+                    bdn::ui::android::viewCoreFromJavaViewRef(bdn::java::Reference::convertExternalLocal(rawSelf))) {
+                if (auto imageCore = std::dynamic_pointer_cast<bdn::ui::android::ImageViewCore>(core)) {
+                    imageCore->imageLoadFailed();
+                }
+            }
+        },
+        true, env);
+}
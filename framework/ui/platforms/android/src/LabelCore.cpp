@@ -50,4 +50,15 @@ namespace bdn::ui::android
 
         return result;
     }
+
+    bool LabelCore::prepareForReuse()
+    {
+        text.unbind();
+        wrap.unbind();
+        text = String();
+        wrap = false;
+
+        resetForReuse();
+        return true;
+    }
 }
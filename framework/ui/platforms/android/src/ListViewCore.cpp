@@ -4,6 +4,8 @@
 #include <bdn/android/wrapper/NativeListAdapter.h>
 #include <bdn/android/wrapper/NativeListView.h>
 
+#include <algorithm>
+
 namespace bdn::ui::detail
 {
     CORE_REGISTER(ListView, bdn::ui::android::ListViewCore, ListView)
@@ -25,6 +27,20 @@ namespace bdn::ui::android
         _jListView.setOnItemClickListener(listener.cast<bdn::android::wrapper::OnItemClickListener>());
 
         enableRefresh.onChange() += [this](auto &property) { _jNativeListView.setEnabled(property.get()); };
+        dataSource.onChange() += [this](auto &property) {
+            auto source = property.get();
+            size_t viewTypeCount = source ? std::max<size_t>(source->viewTypeCount(), 1) : 1;
+            if (viewTypeCount == _viewTypeCount) {
+                reloadData();
+                return;
+            }
+
+            // ListView only queries the number of view types when the adapter is set, which also
+            // drops all recycled views
+            _viewTypeCount = viewTypeCount;
+            _rowHeights.reset(source ? source->numberOfRows() : 0);
+            _jListView.setAdapter(bdn::android::wrapper::ListAdapter(_jNativeListAdapter.getRef_()));
+        };
     }
 
     void ListViewCore::refreshDone() { _jNativeListView.setRefreshing(false); }
@@ -39,5 +55,65 @@ namespace bdn::ui::android
         _jListView.setTag(JavaObject(tag.getRef_()));
     }
 
-    void ListViewCore::reloadData() { _jNativeListAdapter.notifyDataSetChanged(); }
+    void ListViewCore::reloadData()
+    {
+        auto source = dataSource.get();
+        _rowHeights.reset(source ? source->numberOfRows() : 0);
+        _prefetcher.invalidate();
+        _updatedRowIds.clear();
+
+        _jNativeListAdapter.notifyDataSetChanged();
+    }
+
+    void ListViewCore::applyChanges(const ListViewChanges &changes)
+    {
+        auto source = dataSource.get();
+        size_t rowCount = source ? source->numberOfRows() + changes.deletes.size() : 0;
+        if (!source || rowCount < changes.inserts.size()) {
+            reloadData();
+            return;
+        }
+
+        // BaseAdapter only knows notifyDataSetChanged(). With stable row ids, rows that were not
+        // updated are not bound again (see NativeListAdapter.cpp), and the first visible row is
+        // kept in place so the list does not jump.
+        auto mapping = changes.indexMapping(rowCount - changes.inserts.size());
+
+        int firstVisible = _jListView.getFirstVisiblePosition();
+        int firstVisibleTop = 0;
+        if (_jListView.getChildCount() > 0) {
+            firstVisibleTop = _jListView.getChildAt(0).getTop();
+        }
+
+        reloadData();
+
+        if (source->hasStableRowIds()) {
+            for (auto index : changes.updates) {
+                _updatedRowIds.insert(source->rowIdForRowIndex(index));
+            }
+        }
+
+        if (firstVisible >= 0 && static_cast<size_t>(firstVisible) < mapping.size()) {
+            if (auto newIndex = mapping[firstVisible]) {
+                _jListView.setSelectionFromTop(static_cast<int>(*newIndex), firstVisibleTop);
+            }
+        }
+    }
+
+    bool ListViewCore::takeUpdatedRowId(ListViewDataSource::RowId rowId) { return _updatedRowIds.erase(rowId) > 0; }
+
+    float ListViewCore::rowHeight(size_t rowIndex)
+    {
+        if (auto source = dataSource.get()) {
+            return _rowHeights.height(*source, rowIndex);
+        }
+        return 0.0f;
+    }
+
+    void ListViewCore::visibleRowsChanged(size_t firstVisibleRow, size_t visibleRowCount)
+    {
+        auto source = dataSource.get();
+        _prefetcher.update(source, {firstVisibleRow, firstVisibleRow + visibleRowCount},
+                           source ? source->numberOfRows() : 0);
+    }
 }
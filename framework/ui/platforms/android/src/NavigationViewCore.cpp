@@ -45,6 +45,11 @@ namespace bdn::ui::android
         return {};
     }
 
+    std::shared_ptr<View> NavigationViewCore::currentChild()
+    {
+        return _stack.empty() ? nullptr : _stack.back().container;
+    }
+
     void NavigationViewCore::visitInternalChildren(const std::function<void(std::shared_ptr<View::Core>)> &function)
     {
         for (const auto &entry : _stack) {
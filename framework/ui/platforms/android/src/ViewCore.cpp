@@ -35,6 +35,16 @@ namespace bdn::ui::android
         _jView.setTag(bdn::JavaObject(bdn::java::Reference()));
     }
 
+    void ViewCore::resetForReuse()
+    {
+        resetViewCore();
+
+        bdn::android::wrapper::ViewGroup parent(_jView.getParent().getRef_());
+        if (!parent.isNull_()) {
+            parent.removeView(_jView);
+        }
+    }
+
     void ViewCore::initTag()
     {
         auto tag = bdn::java::wrapper::NativeWeakPointer(shared_from_this());
@@ -10,10 +10,18 @@
 
 #include <bdn/Rect.h>
 
+#include <algorithm>
+#include <cassert>
+
+std::shared_ptr<bdn::ui::android::ListViewCore> listCoreFromRawView(jobject rawView)
+{
+    return std::dynamic_pointer_cast<bdn::ui::android::ListViewCore>(
+        bdn::ui::android::viewCoreFromJavaViewRef(bdn::java::Reference::convertExternalLocal(rawView)));
+}
+
 std::shared_ptr<bdn::ui::ListViewDataSource> dataSourceFromRawView(jobject rawView)
 {
-    if (auto listCore = std::dynamic_pointer_cast<bdn::ui::android::ListViewCore>(
-            bdn::ui::android::viewCoreFromJavaViewRef(bdn::java::Reference::convertExternalLocal(rawView)))) {
+    if (auto listCore = listCoreFromRawView(rawView)) {
         return listCore->dataSource.get();
     }
     return nullptr;
@@ -32,22 +40,107 @@ extern "C" JNIEXPORT jint JNICALL Java_io_boden_android_NativeListAdapter_native
         true, env);
 }
 
+extern "C" JNIEXPORT jboolean JNICALL Java_io_boden_android_NativeListAdapter_nativeHasStableIds(JNIEnv *env,
+                                                                                                  jobject rawSelf,
+                                                                                                  jobject rawView)
+{
+    return bdn::nonVoidPlatformEntryWrapper<jboolean>(
+        [&]() -> jboolean {
+            if (auto dataSource = dataSourceFromRawView(rawView)) {
+                return static_cast<jboolean>(dataSource->hasStableRowIds());
+            }
+            return JNI_FALSE;
+        },
+        true, env);
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_io_boden_android_NativeListAdapter_nativeGetItemId(JNIEnv *env,
+                                                                                           jobject rawSelf,
+                                                                                           jobject rawView,
+                                                                                           jint position)
+{
+    return bdn::nonVoidPlatformEntryWrapper<jlong>(
+        [&]() -> jlong {
+            if (auto dataSource = dataSourceFromRawView(rawView)) {
+                return static_cast<jlong>(dataSource->rowIdForRowIndex(position));
+            }
+            return position;
+        },
+        true, env);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_io_boden_android_NativeListAdapter_nativeGetViewTypeCount(JNIEnv *env,
+                                                                                               jobject rawSelf,
+                                                                                               jobject rawView)
+{
+    return bdn::nonVoidPlatformEntryWrapper<jint>(
+        [&]() -> jint {
+            if (auto listCore = listCoreFromRawView(rawView)) {
+                return static_cast<jint>(listCore->viewTypeCount());
+            }
+            return 1;
+        },
+        true, env);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_io_boden_android_NativeListAdapter_nativeGetItemViewType(JNIEnv *env,
+                                                                                              jobject rawSelf,
+                                                                                              jobject rawView,
+                                                                                              jint position)
+{
+    return bdn::nonVoidPlatformEntryWrapper<jint>(
+        [&]() -> jint {
+            auto listCore = listCoreFromRawView(rawView);
+            auto dataSource = listCore ? listCore->dataSource.get() : nullptr;
+            if (!dataSource) {
+                return 0;
+            }
+
+            // ListView indexes its recycled views by type, types it was not told about would crash it.
+            // Rows with a clamped type get a view of the right type in viewForRowIndex() anyway.
+            auto viewType = dataSource->viewTypeForRowIndex(position);
+            assert(viewType < listCore->viewTypeCount());
+            return static_cast<jint>(std::min(viewType, listCore->viewTypeCount() - 1));
+        },
+        true, env);
+}
+
 namespace bdn::ui::android
 {
-    jobject viewForRowIndex(const std::shared_ptr<bdn::ui::ListViewDataSource> &dataSource, int rowIndex,
-                            const std::shared_ptr<RowContainerView> &reusable)
+    jobject viewForRowIndex(ListViewCore &listCore, const std::shared_ptr<bdn::ui::ListViewDataSource> &dataSource,
+                            int rowIndex, const std::shared_ptr<RowContainerView> &reusable)
     {
 
         if (dataSource) {
+            // ListView only hands out convert views of the row's view type, the check guards
+            // against data sources that change the type of a row without an update.
+            auto viewType = dataSource->viewTypeForRowIndex(rowIndex);
+
             std::shared_ptr<View> clientView;
-            if (!reusable->childViews().empty()) {
-                clientView = reusable->childViews().front();
+            if (reusable->childCount() > 0 && reusable->viewType == viewType) {
+                clientView = reusable->childAt(0);
             }
+            reusable->viewType = viewType;
 
-            reusable->removeAllChildViews();
+            std::optional<ListViewDataSource::RowId> rowId;
+            if (dataSource->hasStableRowIds()) {
+                rowId = dataSource->rowIdForRowIndex(rowIndex);
 
-            if (auto delegate = dataSource->viewForRowIndex(rowIndex, clientView)) {
-                reusable->addChildView(delegate);
+                // The container still shows this row, no need to bind it again
+                if (clientView && rowId == reusable->boundRowId && !listCore.takeUpdatedRowId(*rowId)) {
+                    return reusable->core<RowContainerView::Core>()->getJView().getJObject_();
+                }
+            }
+            reusable->boundRowId = rowId;
+
+            auto delegate = dataSource->viewForRowIndex(rowIndex, clientView);
+
+            // A delegate that was rebound in place stays where it is
+            if (!delegate || delegate != clientView || reusable->childCount() != 1) {
+                reusable->removeAllChildViews();
+                if (delegate) {
+                    reusable->addChildView(delegate);
+                }
             }
         }
 
@@ -85,10 +178,10 @@ extern "C" JNIEXPORT jobject JNICALL Java_io_boden_android_NativeListAdapter_nat
                 reusableCore->setUIScaleFactor(listCore->getUIScaleFactor());
 
                 if (auto dataSource = dataSourceFromRawView(rawView)) {
-                    float height = dataSource->heightForRowIndex(rowIndex);
+                    float height = listCore->rowHeight(rowIndex);
 
                     reusable->geometry.set(bdn::Rect{0, 0, listCore->geometry->width, height});
-                    return bdn::ui::android::viewForRowIndex(dataSource, rowIndex, reusable);
+                    return bdn::ui::android::viewForRowIndex(*listCore, dataSource, rowIndex, reusable);
                 }
             }
 
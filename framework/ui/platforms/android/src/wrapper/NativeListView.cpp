@@ -4,6 +4,8 @@
 #include <bdn/entry.h>
 #include <bdn/java/Env.h>
 
+#include <algorithm>
+
 extern "C" JNIEXPORT void JNICALL Java_io_boden_android_NativeListView_doRefresh(JNIEnv *env, jobject rawSelf)
 {
     bdn::platformEntryWrapper(
@@ -15,3 +17,19 @@ extern "C" JNIEXPORT void JNICALL Java_io_boden_android_NativeListView_doRefresh
         },
         true, env);
 }
+
+extern "C" JNIEXPORT void JNICALL Java_io_boden_android_NativeListView_doVisibleRowsChanged(JNIEnv *env,
+                                                                                          jobject rawSelf,
+                                                                                          jint firstVisibleRow,
+                                                                                          jint visibleRowCount)
+{
+    bdn::platformEntryWrapper(
+        [&]() {
+            if (auto core = bdn::ui::android::viewCoreFromJavaReference<bdn::ui::android::ListViewCore>(
+                    bdn::java::Reference::convertExternalLocal(rawSelf))) {
+                core->visibleRowsChanged(static_cast<size_t>(std::max(firstVisibleRow, 0)),
+                                         static_cast<size_t>(std::max(visibleRowCount, 0)));
+            }
+        },
+        true, env);
+}
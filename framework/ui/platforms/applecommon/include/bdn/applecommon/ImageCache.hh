@@ -0,0 +1,15 @@
+#pragma once
+
+#import <CoreGraphics/CoreGraphics.h>
+
+#include <bdn/ui/ImageCache.h>
+
+namespace bdn::ui::applecommon
+{
+    /** Returns ImageCache::shared(), setting up a cache that fetches through NSURLSession, decodes
+        with ImageIO and keeps its disk tier in the caches directory if none was set yet. */
+    std::shared_ptr<ImageCache> imageCache();
+
+    /** The bitmap of an image decoded by the cache returned from imageCache(). */
+    CGImageRef cgImage(const ImageCache::Image &image);
+}
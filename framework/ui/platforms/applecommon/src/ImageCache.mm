@@ -0,0 +1,117 @@
+#import <bdn/applecommon/ImageCache.hh>
+#import <bdn/foundationkit/stringUtil.hh>
+
+#import <Foundation/Foundation.h>
+#import <ImageIO/ImageIO.h>
+
+#include <bdn/log.h>
+
+namespace bdn::ui::applecommon
+{
+    namespace
+    {
+        ImageCache::CancelFetch fetch(const String &url, ImageCache::FetchHandler done)
+        {
+            NSURL *nsURL = [NSURL URLWithString:fk::stringToNSString(url)];
+            if (nsURL == nullptr) {
+                done(std::nullopt);
+                return nullptr;
+            }
+
+            NSURLSessionDataTask *dataTask = [[NSURLSession sharedSession]
+                  dataTaskWithURL:nsURL
+                completionHandler:^(NSData *_Nullable nsData, NSURLResponse *_Nullable nsResponse,
+                                    NSError *_Nullable error) {
+                  if (error != nullptr || nsData == nullptr) {
+                      if (error.code != NSURLErrorCancelled) {
+                          logstream() << "Failed loading '" << url << "' ("
+                                      << fk::nsStringToString([error localizedDescription]) << ")";
+                      }
+                      done(std::nullopt);
+                      return;
+                  }
+                  done(std::string(static_cast<const char *>(nsData.bytes), nsData.length));
+                }];
+
+            [dataTask resume];
+
+            return [dataTask]() { [dataTask cancel]; };
+        }
+
+        std::shared_ptr<const ImageCache::Image> decode(const std::string &data, size_t maxPixelSize)
+        {
+            NSData *nsData = [NSData dataWithBytesNoCopy:const_cast<char *>(data.data())
+                                                  length:data.size()
+                                            freeWhenDone:NO];
+
+            CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)nsData, nullptr);
+            if (source == nullptr) {
+                return nullptr;
+            }
+
+            auto image = std::make_shared<ImageCache::Image>();
+
+            NSDictionary *properties =
+                CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, 0, nullptr));
+            image->originalSize = Size{[properties[(NSString *)kCGImagePropertyPixelWidth] doubleValue],
+                                       [properties[(NSString *)kCGImagePropertyPixelHeight] doubleValue]};
+
+            // Decode right away, so that the worker queue and not the main thread pays for it
+            CGImageRef cgImage = nullptr;
+            if (maxPixelSize == 0) {
+                NSDictionary *options = @{(NSString *)kCGImageSourceShouldCacheImmediately : @YES};
+                cgImage = CGImageSourceCreateImageAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+            } else {
+                NSDictionary *options = @{
+                    (NSString *)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+                    (NSString *)kCGImageSourceCreateThumbnailWithTransform : @YES,
+                    (NSString *)kCGImageSourceShouldCacheImmediately : @YES,
+                    (NSString *)kCGImageSourceThumbnailMaxPixelSize : @(maxPixelSize)
+                };
+                cgImage = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+            }
+            CFRelease(source);
+
+            if (cgImage == nullptr) {
+                return nullptr;
+            }
+
+            image->pixelSize = Size{static_cast<double>(CGImageGetWidth(cgImage)),
+                                    static_cast<double>(CGImageGetHeight(cgImage))};
+            image->byteCost = CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage);
+            image->bitmap = std::shared_ptr<const void>(cgImage, [](const void *p) { CGImageRelease((CGImageRef)p); });
+
+            if (image->originalSize.width <= 0 || image->originalSize.height <= 0) {
+                image->originalSize = image->pixelSize;
+            }
+
+            return image;
+        }
+
+        String diskDirectory()
+        {
+            NSArray *paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
+            if (paths.count == 0) {
+                return String();
+            }
+            return fk::nsStringToString([paths.firstObject stringByAppendingPathComponent:@"bdn-images"]);
+        }
+    }
+
+    std::shared_ptr<ImageCache> imageCache()
+    {
+        auto cache = ImageCache::shared();
+        if (!cache) {
+            ImageCache::Configuration configuration;
+            configuration.diskDirectory = diskDirectory();
+            configuration.fetcher = &fetch;
+            configuration.decoder = &decode;
+
+            cache = std::make_shared<ImageCache>(std::move(configuration));
+            ImageCache::setShared(cache);
+        }
+        return cache;
+    }
+
+    CGImageRef cgImage(const ImageCache::Image &image) { return (CGImageRef)image.bitmap.get(); }
+}
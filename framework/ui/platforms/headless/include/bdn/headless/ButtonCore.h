@@ -0,0 +1,21 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/Button.h>
+
+namespace bdn::ui::headless
+{
+    class ButtonCore : public ViewCore, virtual public Button::Core
+    {
+      public:
+        ButtonCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        Size sizeForSpace(Size availableSpace) const override;
+
+        bool prepareForReuse() override;
+
+        /** Simulates a click by the user. */
+        void click();
+    };
+}
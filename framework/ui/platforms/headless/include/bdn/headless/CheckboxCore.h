@@ -0,0 +1,21 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/Checkbox.h>
+
+namespace bdn::ui::headless
+{
+    class CheckboxCore : public ViewCore, virtual public Checkbox::Core
+    {
+      public:
+        CheckboxCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        Size sizeForSpace(Size availableSpace) const override;
+
+        bool prepareForReuse() override;
+
+        /** Simulates a click by the user, toggling the state. */
+        void click();
+    };
+}
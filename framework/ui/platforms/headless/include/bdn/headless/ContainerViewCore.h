@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/ContainerView.h>
+
+#include <vector>
+
+namespace bdn::ui::headless
+{
+    class ContainerViewCore : public ViewCore, virtual public ContainerView::Core
+    {
+      public:
+        ContainerViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        void addChildView(std::shared_ptr<View> child) override;
+        void removeChildView(std::shared_ptr<View> child) override;
+
+        std::list<std::shared_ptr<View>> childViews() override;
+
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override;
+        size_t childCount() override;
+        std::shared_ptr<View> childAt(size_t index) override;
+
+        void beginUpdates() override;
+        void endUpdates() override;
+
+        bool prepareForReuse() override;
+
+      private:
+        void childrenChanged();
+
+      private:
+        std::vector<std::shared_ptr<View>> _children;
+
+        int _updateDepth = 0;
+        bool _childrenChangedInBatch = false;
+    };
+}
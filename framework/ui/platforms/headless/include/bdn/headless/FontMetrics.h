@@ -0,0 +1,51 @@
+#pragma once
+
+#include <bdn/Size.h>
+#include <bdn/String.h>
+
+#include <memory>
+
+namespace bdn::ui::headless
+{
+    /** Text measurement model used by the headless view cores.
+
+        There is no font rendering on the headless backend. Cores ask the current FontMetrics
+        instance for the size of their text instead, so layout results only depend on the model
+        and are identical on every machine. Install a custom model with setDefault() to mimic the
+        metrics of a real platform.
+    */
+    class FontMetrics
+    {
+      public:
+        virtual ~FontMetrics() = default;
+
+      public:
+        virtual double lineHeight() const = 0;
+        virtual double advance(char32_t codepoint) const = 0;
+
+        /** Returns the size of text. If maxWidth is finite, lines are wrapped at word boundaries
+            so that they do not exceed it. Words that are wider than maxWidth are not broken up. */
+        Size measure(const String &text, double maxWidth = Size::componentNone()) const;
+
+      public:
+        static std::shared_ptr<FontMetrics> current();
+        static void setDefault(std::shared_ptr<FontMetrics> metrics);
+    };
+
+    /** Every character has the same advance. Used by default. */
+    class MonospaceFontMetrics : public FontMetrics
+    {
+      public:
+        MonospaceFontMetrics(double advance = 8.0, double lineHeight = 16.0)
+            : _advance(advance), _lineHeight(lineHeight)
+        {}
+
+      public:
+        double lineHeight() const override { return _lineHeight; }
+        double advance(char32_t /*codepoint*/) const override { return _advance; }
+
+      private:
+        double _advance;
+        double _lineHeight;
+    };
+}
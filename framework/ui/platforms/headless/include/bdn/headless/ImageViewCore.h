@@ -0,0 +1,40 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/ImageCache.h>
+#include <bdn/ui/ImageView.h>
+
+namespace bdn::ui::headless
+{
+    /** Loads images through ImageCache::shared() if a cache was set, decoded to the size of the view,
+        while the view is not outside of the viewport. Otherwise does not load anything, set
+        originalSize to simulate a loaded image then. */
+    class ImageViewCore : public ViewCore, virtual public ImageView::Core
+    {
+      public:
+        ImageViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+        ~ImageViewCore() override;
+
+      public:
+        void init() override;
+
+        Size sizeForSpace(Size availableSpace) const override;
+
+        bool prepareForReuse() override;
+
+        /** The image currently shown, or nullptr. */
+        std::shared_ptr<const ImageCache::Image> image() const { return _image; }
+
+      private:
+        size_t requiredPixelSize() const;
+        void updateLoad();
+        void loadImage();
+        void cancelLoad();
+
+      private:
+        std::shared_ptr<const ImageCache::Image> _image;
+        size_t _imageBucket = 0;
+        ImageCache::LoadId _loadId = 0;
+        size_t _loadBucket = 0;
+    };
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/Label.h>
+
+namespace bdn::ui::headless
+{
+    class LabelCore : public ViewCore, virtual public Label::Core
+    {
+      public:
+        LabelCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        Size sizeForSpace(Size availableSpace) const override;
+
+        bool prepareForReuse() override;
+    };
+}
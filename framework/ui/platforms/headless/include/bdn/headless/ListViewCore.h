@@ -0,0 +1,77 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/ListView.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace bdn::ui::headless
+{
+    /** Materializes the rows that intersect the visible area, recycling row containers that
+        scroll out of view the same way the native table views do.
+
+        Rows next to the visible area are announced to the data source via prefetchRows(). If the
+        data source has stable row ids, rows that stay visible across reloadData() keep their view.
+        applyChanges() keeps the views of all rows that were not updated and keeps the first visible
+        row at its position on screen.
+
+        Row containers are pooled per view type (see ListViewDataSource::viewTypeForRowIndex()), so
+        the data source is only ever handed a reusable view of the type it asked for. */
+    class ListViewCore : public ViewCore, virtual public ListView::Core
+    {
+      public:
+        ListViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        void init() override;
+
+        void reloadData() override;
+        void refreshDone() override;
+        void applyChanges(const ListViewChanges &changes) override;
+
+        void setLayout(std::shared_ptr<Layout> layout) override;
+
+      public:
+        /** Scrolls the list so that offset is the top of the visible area. */
+        void scrollTo(double offset);
+        double scrollOffset() const { return _scrollOffset; }
+        double contentHeight() const { return _rowOffsets.empty() ? 0.0 : _rowOffsets.back(); }
+
+        /** Row index to row view for all rows that are currently materialized. */
+        std::map<size_t, std::shared_ptr<View>> visibleRows() const;
+
+        /** Simulates a pull to refresh gesture. */
+        void fireRefresh();
+
+      private:
+        struct VisibleRow
+        {
+            std::shared_ptr<ContainerView> container;
+            ListViewDataSource::RowId rowId = 0;
+            size_t viewType = 0;
+            bool needsBinding = false;
+        };
+
+        void updateRowOffsets(ListViewDataSource *source);
+        void updateVisibleRows();
+        void bindRow(ListViewDataSource &source, size_t rowIndex, VisibleRow &row);
+        void recycleRow(const VisibleRow &row);
+        void recycleVisibleRows();
+        std::shared_ptr<ContainerView> obtainRowContainer(size_t viewType);
+
+      private:
+        std::vector<double> _rowOffsets;
+        double _scrollOffset = 0.0;
+
+        std::map<size_t, VisibleRow> _visibleRows;
+        std::unordered_map<size_t, std::vector<std::shared_ptr<ContainerView>>> _reusableRows;
+
+        // Rows that were visible before reloadData(), by row id, while the visible rows are rebuilt
+        std::unordered_map<ListViewDataSource::RowId, VisibleRow> _reloadedRows;
+
+        detail::ListViewPrefetcher _prefetcher;
+    };
+}
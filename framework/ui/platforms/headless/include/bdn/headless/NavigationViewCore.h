@@ -0,0 +1,46 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/NavigationView.h>
+
+#include <deque>
+
+namespace bdn::ui::headless
+{
+    class NavigationViewCore : public ViewCore, virtual public NavigationView::Core
+    {
+      public:
+        static constexpr double kNavigationBarHeight = 44.0;
+
+      public:
+        NavigationViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        void init() override;
+
+        void pushView(std::shared_ptr<View> view, String title) override;
+        void popView() override;
+        std::list<std::shared_ptr<View>> childViews() override;
+        std::shared_ptr<View> currentChild() override;
+
+        void setLayout(std::shared_ptr<Layout> layout) override;
+
+        String currentTitle() const;
+
+      private:
+        void updateCurrentView();
+        void reLayout();
+
+      private:
+        struct StackEntry
+        {
+            std::shared_ptr<View> view;
+            String title;
+        };
+
+        std::deque<StackEntry> _stack;
+        std::shared_ptr<View> _currentView;
+        std::shared_ptr<ContainerView> _container;
+    };
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/ScrollView.h>
+
+namespace bdn::ui::headless
+{
+    class ScrollViewCore : public ViewCore, virtual public ScrollView::Core
+    {
+      public:
+        ScrollViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        void init() override;
+
+        void scrollClientRectToVisible(const Rect &clientRect) override;
+
+        /** Moves the top left corner of the visible area to position, clamped to the content. */
+        void scrollTo(Point position);
+
+      private:
+        void updateVisibleClientRect();
+        Size contentSize() const;
+
+      private:
+        Point _scrollPosition;
+    };
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/Slider.h>
+
+namespace bdn::ui::headless
+{
+    class SliderCore : public ViewCore, virtual public Slider::Core
+    {
+      public:
+        SliderCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        Size sizeForSpace(Size availableSpace) const override;
+
+        bool prepareForReuse() override;
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/Switch.h>
+
+namespace bdn::ui::headless
+{
+    class SwitchCore : public ViewCore, virtual public Switch::Core
+    {
+      public:
+        SwitchCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        Size sizeForSpace(Size availableSpace) const override;
+
+        bool prepareForReuse() override;
+
+        /** Simulates a click by the user, toggling the switch. */
+        void click();
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/TextField.h>
+
+namespace bdn::ui::headless
+{
+    class TextFieldCore : public ViewCore, virtual public TextField::Core
+    {
+      public:
+        TextFieldCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        Size sizeForSpace(Size availableSpace) const override;
+
+        bool prepareForReuse() override;
+
+        /** Simulates the user pressing return. */
+        void submit();
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <bdn/ui/View.h>
+#include <bdn/ui/ViewCoreFactory.h>
+
+#include <memory>
+
+namespace bdn::ui::headless
+{
+    class ViewCore : public View::Core, public std::enable_shared_from_this<ViewCore>
+    {
+      public:
+        ViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : View::Core(viewCoreFactory) {}
+
+      public:
+        void init() override {}
+
+        template <class T> std::shared_ptr<T> shared_from_this()
+        {
+            return std::dynamic_pointer_cast<T>(std::enable_shared_from_this<ViewCore>::shared_from_this());
+        }
+
+        bool canMoveToParentView(std::shared_ptr<View> newParentView) const override { return true; }
+
+        /** Schedules a layout on the application's main dispatch queue. Without an application
+            the layout stays pending until layoutIfNeeded() is called. */
+        void scheduleLayout() override;
+
+        /** Runs a scheduled layout right away. */
+        void layoutIfNeeded();
+
+        bool isLayoutScheduled() const { return _layoutScheduled; }
+
+      protected:
+        /** Common part of prepareForReuse() for the cores that support pooling. */
+        void resetForReuse();
+
+      private:
+        bool _layoutScheduled = false;
+    };
+}
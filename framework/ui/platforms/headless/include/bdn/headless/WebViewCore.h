@@ -0,0 +1,22 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/WebView.h>
+
+namespace bdn::ui::headless
+{
+    /** Records the requested URL without loading it. */
+    class WebViewCore : public ViewCore, virtual public WebView::Core
+    {
+      public:
+        WebViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        void loadURL(const String &url) override;
+
+        const String &currentURL() const { return _currentURL; }
+
+      private:
+        String _currentURL;
+    };
+}
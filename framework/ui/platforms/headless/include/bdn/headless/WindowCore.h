@@ -0,0 +1,21 @@
+#pragma once
+
+#include <bdn/headless/ViewCore.h>
+#include <bdn/ui/Window.h>
+
+namespace bdn::ui::headless
+{
+    class WindowCore : public ViewCore, virtual public Window::Core
+    {
+      public:
+        WindowCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+
+      public:
+        void init() override;
+
+        bool canMoveToParentView(std::shared_ptr<View> newParentView) const override;
+
+      private:
+        void updateContentGeometry(const Rect &windowGeometry);
+    };
+}
@@ -0,0 +1,40 @@
+#include <bdn/headless/ButtonCore.h>
+#include <bdn/headless/FontMetrics.h>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(Button, bdn::ui::headless::ButtonCore, Button)
+}
+
+namespace bdn::ui::headless
+{
+    namespace
+    {
+        constexpr double kHorizontalPadding = 12.0;
+        constexpr double kVerticalPadding = 6.0;
+    }
+
+    ButtonCore::ButtonCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory)
+    {
+        label.onChange() += [=](auto &property) {
+            markDirty();
+            scheduleLayout();
+        };
+    }
+
+    Size ButtonCore::sizeForSpace(Size availableSpace) const
+    {
+        auto textSize = FontMetrics::current()->measure(label.get());
+        return Size{textSize.width + 2 * kHorizontalPadding, textSize.height + 2 * kVerticalPadding};
+    }
+
+    void ButtonCore::click() { _clickCallback.fire(); }
+
+    bool ButtonCore::prepareForReuse()
+    {
+        label.unbind();
+        label = String();
+        resetForReuse();
+        return true;
+    }
+}
@@ -0,0 +1,52 @@
+#include <bdn/headless/CheckboxCore.h>
+#include <bdn/headless/FontMetrics.h>
+
+#include <algorithm>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(Checkbox, bdn::ui::headless::CheckboxCore, Checkbox)
+}
+
+namespace bdn::ui::headless
+{
+    namespace
+    {
+        constexpr double kBoxSize = 16.0;
+        constexpr double kSpacing = 4.0;
+    }
+
+    CheckboxCore::CheckboxCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory)
+    {
+        label.onChange() += [=](auto &property) {
+            markDirty();
+            scheduleLayout();
+        };
+    }
+
+    Size CheckboxCore::sizeForSpace(Size availableSpace) const
+    {
+        if (label->empty()) {
+            return Size{kBoxSize, kBoxSize};
+        }
+
+        auto textSize = FontMetrics::current()->measure(label.get());
+        return Size{kBoxSize + kSpacing + textSize.width, std::max(kBoxSize, textSize.height)};
+    }
+
+    void CheckboxCore::click()
+    {
+        state = (state.get() == TriState::on) ? TriState::off : TriState::on;
+        _clickCallback.fire();
+    }
+
+    bool CheckboxCore::prepareForReuse()
+    {
+        label.unbind();
+        state.unbind();
+        label = String();
+        state = TriState::off;
+        resetForReuse();
+        return true;
+    }
+}
@@ -0,0 +1,82 @@
+#include <bdn/headless/ContainerViewCore.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(ContainerView, bdn::ui::headless::ContainerViewCore, ContainerView)
+}
+
+namespace bdn::ui::headless
+{
+    ContainerViewCore::ContainerViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory)
+        : ViewCore(viewCoreFactory)
+    {}
+
+    void ContainerViewCore::addChildView(std::shared_ptr<View> child)
+    {
+        if (!child->core<headless::ViewCore>()) {
+            throw std::runtime_error("Cannot add this type of View");
+        }
+
+        _children.push_back(child);
+        childrenChanged();
+    }
+
+    void ContainerViewCore::removeChildView(std::shared_ptr<View> child)
+    {
+        _children.erase(std::remove(_children.begin(), _children.end(), child), _children.end());
+        childrenChanged();
+    }
+
+    std::list<std::shared_ptr<View>> ContainerViewCore::childViews()
+    {
+        return std::list<std::shared_ptr<View>>(_children.begin(), _children.end());
+    }
+
+    void ContainerViewCore::forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function)
+    {
+        for (const auto &child : _children) {
+            function(child);
+        }
+    }
+
+    size_t ContainerViewCore::childCount() { return _children.size(); }
+
+    std::shared_ptr<View> ContainerViewCore::childAt(size_t index) { return _children.at(index); }
+
+    void ContainerViewCore::beginUpdates() { _updateDepth++; }
+
+    void ContainerViewCore::endUpdates()
+    {
+        if (_updateDepth == 0 || --_updateDepth > 0) {
+            return;
+        }
+
+        // Request a layout once for the whole batch
+        if (std::exchange(_childrenChangedInBatch, false)) {
+            scheduleLayout();
+        }
+    }
+
+    void ContainerViewCore::childrenChanged()
+    {
+        if (_updateDepth > 0) {
+            _childrenChangedInBatch = true;
+        } else {
+            scheduleLayout();
+        }
+    }
+
+    bool ContainerViewCore::prepareForReuse()
+    {
+        _children.clear();
+
+        _updateDepth = 0;
+        _childrenChangedInBatch = false;
+
+        resetForReuse();
+        return true;
+    }
+}
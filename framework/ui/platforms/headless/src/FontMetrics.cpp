@@ -0,0 +1,101 @@
+#include <bdn/headless/FontMetrics.h>
+
+#include <algorithm>
+#include <cmath>
+#include <codecvt>
+#include <locale>
+#include <mutex>
+
+namespace bdn::ui::headless
+{
+    namespace
+    {
+        std::mutex s_metricsMutex;
+
+        std::shared_ptr<FontMetrics> &defaultMetrics()
+        {
+            static std::shared_ptr<FontMetrics> s_metrics = std::make_shared<MonospaceFontMetrics>();
+            return s_metrics;
+        }
+
+        std::u32string decode(const String &text)
+        {
+            std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> convert;
+            try {
+                return convert.from_bytes(text);
+            }
+            catch (std::range_error &) {
+                // Invalid UTF-8: measure the raw bytes rather than failing the layout
+                return std::u32string(text.begin(), text.end());
+            }
+        }
+    }
+
+    std::shared_ptr<FontMetrics> FontMetrics::current()
+    {
+        std::lock_guard<std::mutex> lock(s_metricsMutex);
+        return defaultMetrics();
+    }
+
+    void FontMetrics::setDefault(std::shared_ptr<FontMetrics> metrics)
+    {
+        std::lock_guard<std::mutex> lock(s_metricsMutex);
+        defaultMetrics() = metrics ? std::move(metrics) : std::make_shared<MonospaceFontMetrics>();
+    }
+
+    Size FontMetrics::measure(const String &text, double maxWidth) const
+    {
+        const bool wrap = std::isfinite(maxWidth);
+
+        double widest = 0.0;
+        size_t lines = 0;
+
+        auto measureParagraph = [&](std::u32string_view paragraph) {
+            double lineWidth = 0.0;
+            size_t wordsOnLine = 0;
+
+            size_t pos = 0;
+            while (pos <= paragraph.size()) {
+                auto end = paragraph.find(U' ', pos);
+                if (end == std::u32string_view::npos) {
+                    end = paragraph.size();
+                }
+
+                double wordWidth = 0.0;
+                for (size_t i = pos; i < end; i++) {
+                    wordWidth += advance(paragraph[i]);
+                }
+
+                double spaceWidth = wordsOnLine > 0 ? advance(U' ') : 0.0;
+                if (wrap && wordsOnLine > 0 && lineWidth + spaceWidth + wordWidth > maxWidth) {
+                    widest = std::max(widest, lineWidth);
+                    lines++;
+                    lineWidth = wordWidth;
+                    wordsOnLine = 1;
+                } else {
+                    lineWidth += spaceWidth + wordWidth;
+                    wordsOnLine++;
+                }
+
+                pos = end + 1;
+            }
+
+            widest = std::max(widest, lineWidth);
+            lines++;
+        };
+
+        auto decoded = decode(text);
+        std::u32string_view remaining(decoded);
+
+        while (true) {
+            auto newline = remaining.find(U'\n');
+            measureParagraph(remaining.substr(0, newline));
+            if (newline == std::u32string_view::npos) {
+                break;
+            }
+            remaining = remaining.substr(newline + 1);
+        }
+
+        return Size{widest, static_cast<double>(lines) * lineHeight()};
+    }
+}
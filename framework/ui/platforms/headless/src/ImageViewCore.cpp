@@ -0,0 +1,141 @@
+#include <bdn/headless/ImageViewCore.h>
+
+#include <cmath>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(ImageView, bdn::ui::headless::ImageViewCore, ImageView)
+}
+
+namespace bdn::ui::headless
+{
+    namespace
+    {
+        ImageCache::Priority loadPriority(ImageView::ViewportPosition position)
+        {
+            return position == ImageView::ViewportPosition::Inside ? ImageCache::Priority::Visible
+                                                                     : ImageCache::Priority::Prefetch;
+        }
+    }
+
+    ImageViewCore::ImageViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory)
+    {
+        originalSize.onChange() += [=](auto &property) {
+            markDirty();
+            scheduleLayout();
+        };
+    }
+
+    ImageViewCore::~ImageViewCore() { cancelLoad(); }
+
+    void ImageViewCore::init()
+    {
+        ViewCore::init();
+
+        url.onChange() += [=](auto &property) {
+            _image = nullptr;
+            loadImage();
+        };
+
+        geometry.onChange() += [=](auto &property) { updateLoad(); };
+        viewportPosition.onChange() += [=](auto &property) { updateLoad(); };
+    }
+
+    Size ImageViewCore::sizeForSpace(Size availableSpace) const { return originalSize.get(); }
+
+    bool ImageViewCore::prepareForReuse()
+    {
+        cancelLoad();
+        _image = nullptr;
+
+        url.unbind();
+        url = String();
+        viewportPosition.unbind();
+        viewportPosition = ImageView::ViewportPosition::Inside;
+        originalSize = Size{};
+        aspectRatio = 0.0f;
+        resetForReuse();
+        return true;
+    }
+
+    size_t ImageViewCore::requiredPixelSize() const
+    {
+        // Before the first layout only the original size is needed, so the smallest size is enough
+        auto size = geometry->size();
+        return std::max<size_t>(1, static_cast<size_t>(std::ceil(std::max(size.width, size.height))));
+    }
+
+    void ImageViewCore::updateLoad()
+    {
+        if (url->empty()) {
+            return;
+        }
+
+        if (viewportPosition.get() == ImageView::ViewportPosition::Outside) {
+            cancelLoad();
+            return;
+        }
+
+        // Load a larger version once the view grows beyond the size the image was decoded for
+        size_t required = ImageCache::pixelSizeBucket(requiredPixelSize());
+        if (_loadId != 0) {
+            if (ImageCache::bucketCovers(_loadBucket, required)) {
+                if (auto cache = ImageCache::shared()) {
+                    cache->setPriority(_loadId, loadPriority(viewportPosition.get()));
+                }
+                return;
+            }
+        } else if (_image && ImageCache::bucketCovers(_imageBucket, required)) {
+            return;
+        }
+
+        loadImage();
+    }
+
+    void ImageViewCore::loadImage()
+    {
+        cancelLoad();
+
+        auto cache = ImageCache::shared();
+        if (!cache || url->empty() || viewportPosition.get() == ImageView::ViewportPosition::Outside) {
+            return;
+        }
+
+        size_t bucket = ImageCache::pixelSizeBucket(requiredPixelSize());
+        std::weak_ptr<ImageViewCore> weakSelf = shared_from_this<ImageViewCore>();
+
+        _loadBucket = bucket;
+        auto handler = [weakSelf, bucket](auto image) {
+            auto self = weakSelf.lock();
+            if (!self) {
+                return;
+            }
+
+            self->_loadId = 0;
+            if (!image) {
+                return;
+            }
+
+            self->_image = image;
+            self->_imageBucket = bucket;
+            self->originalSize = image->originalSize;
+            self->aspectRatio = image->originalSize.height > 0
+                                    ? static_cast<float>(image->originalSize.width / image->originalSize.height)
+                                    : 0.0f;
+        };
+
+        _loadId = cache->load(url.get(), bucket, handler, loadPriority(viewportPosition.get()));
+    }
+
+    void ImageViewCore::cancelLoad()
+    {
+        if (_loadId == 0) {
+            return;
+        }
+
+        if (auto cache = ImageCache::shared()) {
+            cache->cancel(_loadId);
+        }
+        _loadId = 0;
+    }
+}
@@ -0,0 +1,38 @@
+#include <bdn/headless/FontMetrics.h>
+#include <bdn/headless/LabelCore.h>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(Label, bdn::ui::headless::LabelCore, Label)
+}
+
+namespace bdn::ui::headless
+{
+    LabelCore::LabelCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory)
+    {
+        text.onChange() += [=](auto &property) {
+            markDirty();
+            scheduleLayout();
+        };
+
+        wrap.onChange() += [=](auto &property) {
+            markDirty();
+            scheduleLayout();
+        };
+    }
+
+    Size LabelCore::sizeForSpace(Size availableSpace) const
+    {
+        return FontMetrics::current()->measure(text.get(), wrap.get() ? availableSpace.width : Size::componentNone());
+    }
+
+    bool LabelCore::prepareForReuse()
+    {
+        text.unbind();
+        wrap.unbind();
+        text = String();
+        wrap = false;
+        resetForReuse();
+        return true;
+    }
+}
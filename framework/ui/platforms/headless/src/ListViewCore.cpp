@@ -0,0 +1,259 @@
+#include <bdn/headless/ContainerViewCore.h>
+#include <bdn/headless/ListViewCore.h>
+
+#include <algorithm>
+#include <set>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(ListView, bdn::ui::headless::ListViewCore, ListView)
+}
+
+namespace bdn::ui::headless
+{
+    ListViewCore::ListViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory) {}
+
+    void ListViewCore::init()
+    {
+        ViewCore::init();
+
+        geometry.onChange() += [=](auto &property) { updateVisibleRows(); };
+        dataSource.onChange() += [=](auto &property) { reloadData(); };
+    }
+
+    void ListViewCore::reloadData()
+    {
+        auto source = dataSource.get();
+        bool keepRows = source && source->hasStableRowIds();
+
+        for (auto &row : _visibleRows) {
+            if (keepRows) {
+                _reloadedRows.emplace(row.second.rowId, row.second);
+            } else {
+                recycleRow(row.second);
+            }
+        }
+        _visibleRows.clear();
+        _prefetcher.invalidate();
+
+        updateRowOffsets(source.get());
+        scrollTo(_scrollOffset);
+
+        for (auto &row : _reloadedRows) {
+            recycleRow(row.second);
+        }
+        _reloadedRows.clear();
+    }
+
+    void ListViewCore::applyChanges(const ListViewChanges &changes)
+    {
+        auto source = dataSource.get();
+        size_t oldRowCount = _rowOffsets.empty() ? 0 : _rowOffsets.size() - 1;
+
+        if (!source || oldRowCount < changes.deletes.size() ||
+            changes.newRowCount(oldRowCount) != source->numberOfRows()) {
+            reloadData();
+            return;
+        }
+
+        auto mapping = changes.indexMapping(oldRowCount);
+        std::set<size_t> updates(changes.updates.begin(), changes.updates.end());
+
+        // Anchor the list to the first visible row that survives the change
+        std::optional<size_t> anchorRow;
+        double anchorOffset = 0.0;
+        for (auto &row : _visibleRows) {
+            if (mapping[row.first]) {
+                anchorRow = mapping[row.first];
+                anchorOffset = _rowOffsets[row.first] - _scrollOffset;
+                break;
+            }
+        }
+
+        // Updated rows keep their container if the view type did not change, so that the data
+        // source can rebind the view in place.
+        std::map<size_t, VisibleRow> visibleRows;
+        for (auto &row : _visibleRows) {
+            auto newIndex = mapping[row.first];
+            if (!newIndex) {
+                recycleRow(row.second);
+            } else if (updates.count(*newIndex) == 0) {
+                visibleRows.emplace(*newIndex, row.second);
+            } else if (source->viewTypeForRowIndex(*newIndex) == row.second.viewType) {
+                auto &updated = visibleRows.emplace(*newIndex, row.second).first->second;
+                updated.needsBinding = true;
+            } else {
+                recycleRow(row.second);
+            }
+        }
+        _visibleRows = std::move(visibleRows);
+        _prefetcher.invalidate();
+
+        updateRowOffsets(source.get());
+        scrollTo(anchorRow ? _rowOffsets[*anchorRow] - anchorOffset : _scrollOffset);
+    }
+
+    void ListViewCore::refreshDone() {}
+
+    void ListViewCore::updateRowOffsets(ListViewDataSource *source)
+    {
+        _rowOffsets.assign(1, 0.0);
+        if (source) {
+            size_t rowCount = source->numberOfRows();
+            std::vector<float> heights(rowCount);
+            source->heightsForRange(0, rowCount, heights.data());
+
+            _rowOffsets.reserve(rowCount + 1);
+            for (float height : heights) {
+                _rowOffsets.push_back(_rowOffsets.back() + height);
+            }
+        }
+    }
+
+    void ListViewCore::setLayout(std::shared_ptr<Layout> layout)
+    {
+        for (auto &row : _visibleRows) {
+            row.second.container->offerLayout(layout);
+        }
+        for (auto &pool : _reusableRows) {
+            for (auto &row : pool.second) {
+                row->offerLayout(layout);
+            }
+        }
+        ViewCore::setLayout(std::move(layout));
+    }
+
+    void ListViewCore::scrollTo(double offset)
+    {
+        double maxOffset = std::max(0.0, contentHeight() - geometry->height);
+        _scrollOffset = std::clamp(offset, 0.0, maxOffset);
+        updateVisibleRows();
+    }
+
+    std::map<size_t, std::shared_ptr<View>> ListViewCore::visibleRows() const
+    {
+        std::map<size_t, std::shared_ptr<View>> result;
+        for (auto &row : _visibleRows) {
+            if (row.second.container->childCount() > 0) {
+                result.emplace(row.first, row.second.container->childAt(0));
+            }
+        }
+        return result;
+    }
+
+    void ListViewCore::fireRefresh()
+    {
+        if (enableRefresh.get()) {
+            _refreshCallback.fire();
+        }
+    }
+
+    void ListViewCore::updateVisibleRows()
+    {
+        auto source = dataSource.get();
+        if (!source || _rowOffsets.size() < 2) {
+            recycleVisibleRows();
+            _prefetcher.update(source, {}, 0);
+            return;
+        }
+
+        double top = _scrollOffset;
+        double bottom = _scrollOffset + geometry->height;
+
+        // _rowOffsets[i] is the top of row i, the last entry is the total height
+        auto firstIt = std::upper_bound(_rowOffsets.begin(), _rowOffsets.end() - 1, top);
+        size_t first = std::distance(_rowOffsets.begin(), firstIt) - 1;
+        auto lastIt = std::lower_bound(_rowOffsets.begin(), _rowOffsets.end() - 1, bottom);
+        size_t last = std::distance(_rowOffsets.begin(), lastIt);
+
+        for (auto it = _visibleRows.begin(); it != _visibleRows.end();) {
+            if (it->first < first || it->first >= last) {
+                recycleRow(it->second);
+                it = _visibleRows.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        bool stableRowIds = source->hasStableRowIds();
+
+        for (size_t i = first; i < last; i++) {
+            auto &row = _visibleRows[i];
+
+            if (!row.container) {
+                auto rowId = stableRowIds ? source->rowIdForRowIndex(i) : i;
+                auto viewType = source->viewTypeForRowIndex(i);
+
+                auto reloadedIt = stableRowIds ? _reloadedRows.find(rowId) : _reloadedRows.end();
+                if (reloadedIt != _reloadedRows.end() && reloadedIt->second.viewType == viewType) {
+                    row = reloadedIt->second;
+                    _reloadedRows.erase(reloadedIt);
+                } else {
+                    row.rowId = rowId;
+                    row.viewType = viewType;
+                    row.container = obtainRowContainer(viewType);
+                    row.needsBinding = true;
+                }
+            }
+
+            if (row.needsBinding) {
+                bindRow(*source, i, row);
+            }
+
+            row.container->geometry =
+                Rect{0, _rowOffsets[i] - _scrollOffset, geometry->width, _rowOffsets[i + 1] - _rowOffsets[i]};
+        }
+
+        _prefetcher.update(source, {first, last}, _rowOffsets.size() - 1);
+    }
+
+    void ListViewCore::bindRow(ListViewDataSource &source, size_t rowIndex, VisibleRow &row)
+    {
+        row.needsBinding = false;
+
+        std::shared_ptr<View> reusableView;
+        if (row.container->childCount() > 0) {
+            reusableView = row.container->childAt(0);
+        }
+
+        auto view = source.viewForRowIndex(rowIndex, reusableView);
+
+        // A view that was rebound in place stays where it is
+        if (view != reusableView) {
+            row.container->removeAllChildViews();
+            if (view) {
+                row.container->addChildView(view);
+            }
+        }
+    }
+
+    void ListViewCore::recycleRow(const VisibleRow &row) { _reusableRows[row.viewType].push_back(row.container); }
+
+    void ListViewCore::recycleVisibleRows()
+    {
+        for (auto &row : _visibleRows) {
+            recycleRow(row.second);
+        }
+        _visibleRows.clear();
+    }
+
+    std::shared_ptr<ContainerView> ListViewCore::obtainRowContainer(size_t viewType)
+    {
+        auto &pool = _reusableRows[viewType];
+        if (!pool.empty()) {
+            auto container = pool.back();
+            pool.pop_back();
+            return container;
+        }
+
+        auto container = std::make_shared<ContainerView>(viewCoreFactory());
+        container->isLayoutRoot = true;
+        container->offerLayout(layout());
+
+        if (!container->core<headless::ContainerViewCore>()) {
+            throw std::runtime_error("View did not have the correct core");
+        }
+
+        return container;
+    }
+}
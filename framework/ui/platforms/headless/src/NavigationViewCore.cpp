@@ -0,0 +1,97 @@
+#include <bdn/headless/ContainerViewCore.h>
+#include <bdn/headless/NavigationViewCore.h>
+
+#include <algorithm>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(NavigationView, bdn::ui::headless::NavigationViewCore, NavigationView)
+}
+
+namespace bdn::ui::headless
+{
+    NavigationViewCore::NavigationViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory)
+        : ViewCore(viewCoreFactory)
+    {}
+
+    void NavigationViewCore::init()
+    {
+        ViewCore::init();
+
+        geometry.onChange() += [=](auto &property) { reLayout(); };
+    }
+
+    void NavigationViewCore::pushView(std::shared_ptr<View> view, String title)
+    {
+        _stack.push_back({std::move(view), std::move(title)});
+        updateCurrentView();
+    }
+
+    void NavigationViewCore::popView()
+    {
+        if (_stack.empty()) {
+            return;
+        }
+
+        _stack.pop_back();
+        updateCurrentView();
+    }
+
+    std::list<std::shared_ptr<View>> NavigationViewCore::childViews()
+    {
+        if (_container) {
+            return {_container};
+        }
+        return {};
+    }
+
+    std::shared_ptr<View> NavigationViewCore::currentChild() { return _container; }
+
+    void NavigationViewCore::setLayout(std::shared_ptr<Layout> layout)
+    {
+        if (_container) {
+            _container->offerLayout(layout);
+        }
+        ViewCore::setLayout(std::move(layout));
+    }
+
+    String NavigationViewCore::currentTitle() const { return _stack.empty() ? String() : _stack.back().title; }
+
+    void NavigationViewCore::updateCurrentView()
+    {
+        if (!_container) {
+            _container = std::make_shared<ContainerView>(viewCoreFactory());
+            _container->isLayoutRoot = true;
+            _container->offerLayout(layout());
+            if (!_container->core<headless::ContainerViewCore>()) {
+                throw std::runtime_error("Container did not have the right core type!");
+            }
+        }
+
+        _container->removeAllChildViews();
+
+        if (_currentView) {
+            _currentView->setParentView(nullptr);
+            _currentView = nullptr;
+        }
+
+        if (!_stack.empty()) {
+            _currentView = _stack.back().view;
+            _container->addChildView(_currentView);
+        }
+
+        reLayout();
+    }
+
+    void NavigationViewCore::reLayout()
+    {
+        if (!_container) {
+            return;
+        }
+
+        Size outerSize = geometry->size();
+        _container->geometry =
+            Rect{0, kNavigationBarHeight, outerSize.width, std::max(0.0, outerSize.height - kNavigationBarHeight)};
+        _container->scheduleLayout();
+    }
+}
@@ -0,0 +1,77 @@
+#include <bdn/headless/ScrollViewCore.h>
+
+#include <algorithm>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(ScrollView, bdn::ui::headless::ScrollViewCore, ScrollView)
+}
+
+namespace bdn::ui::headless
+{
+    ScrollViewCore::ScrollViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory)
+    {}
+
+    void ScrollViewCore::init()
+    {
+        ViewCore::init();
+
+        geometry.onChange() += [=](auto &property) {
+            scrollTo(_scrollPosition);
+            scheduleLayout();
+        };
+
+        contentView.onChange() += [=](auto &property) {
+            _scrollPosition = Point{};
+            updateVisibleClientRect();
+            scheduleLayout();
+        };
+    }
+
+    void ScrollViewCore::scrollClientRectToVisible(const Rect &clientRect)
+    {
+        Point position = _scrollPosition;
+        Size viewportSize = geometry->size();
+
+        if (clientRect.x + clientRect.width > position.x + viewportSize.width) {
+            position.x = clientRect.x + clientRect.width - viewportSize.width;
+        }
+        if (clientRect.x < position.x) {
+            position.x = clientRect.x;
+        }
+        if (clientRect.y + clientRect.height > position.y + viewportSize.height) {
+            position.y = clientRect.y + clientRect.height - viewportSize.height;
+        }
+        if (clientRect.y < position.y) {
+            position.y = clientRect.y;
+        }
+
+        scrollTo(position);
+    }
+
+    void ScrollViewCore::scrollTo(Point position)
+    {
+        Size content = contentSize();
+        Size viewportSize = geometry->size();
+
+        double maxX = horizontalScrollingEnabled.get() ? std::max(0.0, content.width - viewportSize.width) : 0.0;
+        double maxY = verticalScrollingEnabled.get() ? std::max(0.0, content.height - viewportSize.height) : 0.0;
+
+        _scrollPosition = Point{std::clamp(position.x, 0.0, maxX), std::clamp(position.y, 0.0, maxY)};
+        updateVisibleClientRect();
+    }
+
+    void ScrollViewCore::updateVisibleClientRect()
+    {
+        Size viewportSize = geometry->size();
+        visibleClientRect = Rect{_scrollPosition.x, _scrollPosition.y, viewportSize.width, viewportSize.height};
+    }
+
+    Size ScrollViewCore::contentSize() const
+    {
+        if (auto content = contentView.get()) {
+            return content->geometry->size();
+        }
+        return Size{0, 0};
+    }
+}
@@ -0,0 +1,21 @@
+#include <bdn/headless/SliderCore.h>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(Slider, bdn::ui::headless::SliderCore, Slider)
+}
+
+namespace bdn::ui::headless
+{
+    SliderCore::SliderCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory) {}
+
+    Size SliderCore::sizeForSpace(Size availableSpace) const { return Size{100.0, 20.0}; }
+
+    bool SliderCore::prepareForReuse()
+    {
+        value.unbind();
+        value = 0.0;
+        resetForReuse();
+        return true;
+    }
+}
@@ -0,0 +1,53 @@
+#include <bdn/headless/FontMetrics.h>
+#include <bdn/headless/SwitchCore.h>
+
+#include <algorithm>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(Switch, bdn::ui::headless::SwitchCore, Switch)
+}
+
+namespace bdn::ui::headless
+{
+    namespace
+    {
+        constexpr double kSwitchWidth = 40.0;
+        constexpr double kSwitchHeight = 20.0;
+        constexpr double kSpacing = 8.0;
+    }
+
+    SwitchCore::SwitchCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory)
+    {
+        label.onChange() += [=](auto &property) {
+            markDirty();
+            scheduleLayout();
+        };
+    }
+
+    Size SwitchCore::sizeForSpace(Size availableSpace) const
+    {
+        if (label->empty()) {
+            return Size{kSwitchWidth, kSwitchHeight};
+        }
+
+        auto textSize = FontMetrics::current()->measure(label.get());
+        return Size{textSize.width + kSpacing + kSwitchWidth, std::max(kSwitchHeight, textSize.height)};
+    }
+
+    void SwitchCore::click()
+    {
+        on = !on.get();
+        _clickCallback.fire();
+    }
+
+    bool SwitchCore::prepareForReuse()
+    {
+        label.unbind();
+        on.unbind();
+        label = String();
+        on = false;
+        resetForReuse();
+        return true;
+    }
+}
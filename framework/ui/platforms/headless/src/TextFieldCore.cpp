@@ -0,0 +1,42 @@
+#include <bdn/headless/FontMetrics.h>
+#include <bdn/headless/TextFieldCore.h>
+
+#include <algorithm>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(TextField, bdn::ui::headless::TextFieldCore, TextField)
+}
+
+namespace bdn::ui::headless
+{
+    namespace
+    {
+        constexpr double kMinimumWidth = 100.0;
+        constexpr double kPadding = 4.0;
+    }
+
+    TextFieldCore::TextFieldCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory)
+    {
+        text.onChange() += [=](auto &property) {
+            markDirty();
+            scheduleLayout();
+        };
+    }
+
+    Size TextFieldCore::sizeForSpace(Size availableSpace) const
+    {
+        auto textSize = FontMetrics::current()->measure(text.get());
+        return Size{std::max(kMinimumWidth, textSize.width + 2 * kPadding), textSize.height + 2 * kPadding};
+    }
+
+    void TextFieldCore::submit() { submitCallback.fire(); }
+
+    bool TextFieldCore::prepareForReuse()
+    {
+        text.unbind();
+        text = String();
+        resetForReuse();
+        return true;
+    }
+}
@@ -0,0 +1,37 @@
+#include <bdn/Application.h>
+#include <bdn/headless/ViewCore.h>
+
+namespace bdn::ui::headless
+{
+    void ViewCore::scheduleLayout()
+    {
+        if (_layoutScheduled) {
+            return;
+        }
+        _layoutScheduled = true;
+
+        if (auto app = App()) {
+            app->dispatchQueue()->dispatchAsync([weakSelf = weak_from_this()]() {
+                if (auto self = weakSelf.lock()) {
+                    self->layoutIfNeeded();
+                }
+            });
+        }
+    }
+
+    void ViewCore::layoutIfNeeded()
+    {
+        if (!_layoutScheduled) {
+            return;
+        }
+        _layoutScheduled = false;
+
+        startLayout();
+    }
+
+    void ViewCore::resetForReuse()
+    {
+        resetViewCore();
+        _layoutScheduled = false;
+    }
+}
@@ -0,0 +1,13 @@
+#include <bdn/headless/WebViewCore.h>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(WebView, bdn::ui::headless::WebViewCore, WebView)
+}
+
+namespace bdn::ui::headless
+{
+    WebViewCore::WebViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory) {}
+
+    void WebViewCore::loadURL(const String &url) { _currentURL = url; }
+}
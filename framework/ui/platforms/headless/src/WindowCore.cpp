@@ -0,0 +1,35 @@
+#include <bdn/headless/WindowCore.h>
+
+namespace bdn::ui::detail
+{
+    CORE_REGISTER(Window, bdn::ui::headless::WindowCore, Window)
+}
+
+namespace bdn::ui::headless
+{
+    WindowCore::WindowCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory) : ViewCore(viewCoreFactory) {}
+
+    void WindowCore::init()
+    {
+        ViewCore::init();
+
+        geometry.onChange() += [=](auto &property) {
+            updateContentGeometry(property.get());
+            scheduleLayout();
+        };
+
+        contentView.onChange() += [=](auto &property) { scheduleLayout(); };
+
+        updateContentGeometry(geometry.get());
+    }
+
+    bool WindowCore::canMoveToParentView(std::shared_ptr<View> newParentView) const { return false; }
+
+    void WindowCore::updateContentGeometry(const Rect &windowGeometry)
+    {
+        contentGeometry = Rect{0, 0, windowGeometry.width, windowGeometry.height};
+        currentOrientation =
+            windowGeometry.width > windowGeometry.height ? Window::Core::Orientation::LandscapeLeft
+                                                         : Window::Core::Orientation::Portrait;
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bdn/ios/ViewCore.hh>
+#include <bdn/ui/ImageCache.h>
 #include <bdn/ui/ImageView.h>
 
 namespace bdn::ui::ios
@@ -9,6 +10,7 @@ namespace bdn::ui::ios
     {
       public:
         ImageViewCore(const std::shared_ptr<ViewCoreFactory> &viewCoreFactory);
+        ~ImageViewCore() override;
 
       protected:
         void setUrl(const String &url);
@@ -16,5 +18,16 @@ namespace bdn::ui::ios
       private:
         static UIView<UIViewWithFrameNotification> *createUIImageView();
         Size sizeForSpace(Size availableSize) const override;
+
+        size_t requiredPixelSize() const;
+        void updateLoad();
+        void loadImage();
+        void cancelLoad();
+
+      private:
+        String _imageUrl;
+        size_t _imageBucket = 0;
+        ImageCache::LoadId _loadId = 0;
+        size_t _loadBucket = 0;
     };
 }
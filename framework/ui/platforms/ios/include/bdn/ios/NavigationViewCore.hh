@@ -25,6 +25,7 @@ namespace bdn::ui::ios
         void popView() override;
 
         std::list<std::shared_ptr<View>> childViews() override;
+        std::shared_ptr<View> currentChild() override;
 
       private:
         UINavigationController *getNavigationController();
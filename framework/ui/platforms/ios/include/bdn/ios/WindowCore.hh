@@ -45,7 +45,7 @@ namespace bdn::ui::ios
 
         void frameChanged() override;
 
-        void updateFromStylesheet(json stylesheet) override;
+        void updateFromStylesheet(const ui::Stylesheet &sheet) override;
 
       private:
         void updateContent(const std::shared_ptr<View> &newContent);
@@ -1,11 +1,13 @@
+#import <bdn/applecommon/ImageCache.hh>
 #import <bdn/foundationkit/stringUtil.hh>
 #import <bdn/ios/ImageViewCore.hh>
 
 #include <bdn/Application.h>
-#include <bdn/log.h>
 
 #import <Foundation/Foundation.h>
 
+#include <cmath>
+
 using namespace std::string_literals;
 
 @interface BodenUIImageView : UIImageView <UIViewWithFrameNotification>
@@ -29,6 +31,15 @@ namespace bdn::ui::detail
 
 namespace bdn::ui::ios
 {
+    namespace
+    {
+        ImageCache::Priority loadPriority(ImageView::ViewportPosition position)
+        {
+            return position == ImageView::ViewportPosition::Inside ? ImageCache::Priority::Visible
+                                                                     : ImageCache::Priority::Prefetch;
+        }
+    }
+
     UIView<UIViewWithFrameNotification> *ImageViewCore::createUIImageView()
     {
         BodenUIImageView *view = [[BodenUIImageView alloc] initWithFrame:CGRectZero];
@@ -61,11 +72,20 @@ namespace bdn::ui::ios
         : ViewCore(viewCoreFactory, createUIImageView())
     {
         url.onChange() += [=](auto &property) { setUrl(property.get()); };
+
+        geometry.onChange() += [=](auto &property) { updateLoad(); };
+        viewportPosition.onChange() += [=](auto &property) { updateLoad(); };
     }
 
+    ImageViewCore::~ImageViewCore() { cancelLoad(); }
+
     void ImageViewCore::setUrl(const String &url)
     {
+        cancelLoad();
+        _imageBucket = 0;
         ((UIImageView *)this->uiView()).image = nullptr;
+        originalSize = Size{0, 0};
+        aspectRatio = 1.0;
 
         auto uri = App()->uriToBundledFileUri(url);
 
@@ -73,54 +93,106 @@ namespace bdn::ui::ios
             uri = url;
         }
 
+        _imageUrl = uri;
+
+        // The cache reads file URLs itself and expects a plain path after the scheme
         if (cpp20::starts_with(uri, "file:///")) {
             if (auto nsURL = [NSURL URLWithString:fk::stringToNSString(uri)]) {
                 if (auto localPath = nsURL.relativePath) {
-                    UIImage *image = [[UIImage alloc] initWithContentsOfFile:localPath];
-                    ((UIImageView *)this->uiView()).image = image;
-
-                    if (image) {
-                        originalSize = iosSizeToSize(image.size);
-                        aspectRatio = originalSize->width / originalSize->height;
-                    }
+                    _imageUrl = "file://" + fk::nsStringToString(localPath);
                 }
             }
-        } else {
-            NSURLSession *session = [NSURLSession sharedSession];
-            NSURL *nsURL = [NSURL URLWithString:fk::stringToNSString(url)];
+        }
+
+        loadImage();
+    }
+
+    size_t ImageViewCore::requiredPixelSize() const
+    {
+        UIView *view = this->uiView();
+        CGFloat scale = view.window ? view.window.screen.scale : [UIScreen mainScreen].scale;
 
-            if (nsURL == nullptr) {
+        // Before the first layout only the original size is needed, so the smallest size is enough
+        auto size = geometry->size();
+        return std::max<size_t>(1, static_cast<size_t>(std::ceil(std::max(size.width, size.height) * scale)));
+    }
+
+    void ImageViewCore::updateLoad()
+    {
+        if (_imageUrl.empty()) {
+            return;
+        }
+
+        if (viewportPosition.get() == ImageView::ViewportPosition::Outside) {
+            cancelLoad();
+            return;
+        }
+
+        // Load a larger version once the view grows beyond the size the image was decoded for
+        size_t required = ImageCache::pixelSizeBucket(requiredPixelSize());
+        bool hasImage = ((UIImageView *)this->uiView()).image != nullptr;
+        if (_loadId != 0) {
+            if (ImageCache::bucketCovers(_loadBucket, required)) {
+                applecommon::imageCache()->setPriority(_loadId, loadPriority(viewportPosition.get()));
                 return;
             }
+        } else if (hasImage && ImageCache::bucketCovers(_imageBucket, required)) {
+            return;
+        }
+
+        loadImage();
+    }
+
+    void ImageViewCore::loadImage()
+    {
+        cancelLoad();
+
+        if (_imageUrl.empty() || viewportPosition.get() == ImageView::ViewportPosition::Outside) {
+            return;
+        }
+
+        size_t bucket = ImageCache::pixelSizeBucket(requiredPixelSize());
+        std::weak_ptr<ImageViewCore> weakSelf = shared_from_this<ImageViewCore>();
+
+        _loadBucket = bucket;
+        auto handler = [weakSelf, bucket](auto image) {
+            auto self = weakSelf.lock();
+            if (!self) {
+                return;
+            }
+
+            self->_loadId = 0;
+            if (!image) {
+                return;
+            }
+
+            // The image keeps its original size in points, even if it was decoded smaller
+            CGFloat scale = image->originalSize.width > 0 ? image->pixelSize.width / image->originalSize.width : 1.0;
+            UIImage *uiImage = [UIImage imageWithCGImage:applecommon::cgImage(*image)
+                                                   scale:scale
+                                             orientation:UIImageOrientationUp];
+            ((UIImageView *)self->uiView()).image = uiImage;
+
+            self->_imageBucket = bucket;
+            self->originalSize = image->originalSize;
+            self->aspectRatio = self->originalSize->width / self->originalSize->height;
+
+            self->scheduleLayout();
+            self->markDirty();
+        };
+
+        _loadId = applecommon::imageCache()->load(_imageUrl, bucket, handler, loadPriority(viewportPosition.get()));
+    }
+
+    void ImageViewCore::cancelLoad()
+    {
+        if (_loadId == 0) {
+            return;
+        }
 
-            ((UIImageView *)this->uiView()).image = nullptr;
-            originalSize = Size{0, 0};
-            aspectRatio = 1.0;
-
-            NSURLSessionDataTask *dataTask =
-                [session dataTaskWithURL:nsURL
-                       completionHandler:^(NSData *_Nullable nsData, NSURLResponse *_Nullable nsResponse,
-                                           NSError *_Nullable error) {
-                         if (auto err = error) {
-                             logstream() << "Failed loading '" << fk::nsStringToString([nsURL absoluteString]) << "' ("
-                                         << fk::nsStringToString([err localizedDescription]) << ")";
-                         } else {
-
-                             App()->dispatchQueue()->dispatchAsync([=]() {
-                                 UIImage *image = [[UIImage alloc] initWithData:nsData];
-                                 ((UIImageView *)this->uiView()).image = image;
-
-                                 if (image) {
-                                     originalSize = iosSizeToSize(image.size);
-                                     aspectRatio = originalSize->width / originalSize->height;
-                                 }
-                                 this->scheduleLayout();
-                                 this->markDirty();
-                             });
-                         }
-                       }];
-
-            [dataTask resume];
+        if (auto cache = ImageCache::shared()) {
+            cache->cancel(_loadId);
         }
+        _loadId = 0;
     }
 }
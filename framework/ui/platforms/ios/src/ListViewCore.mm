@@ -69,18 +69,20 @@
 - (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath
 {
     if (auto dataSource = self.outerDataSource) {
+        // One reuse queue per view type, so rows only get cells of their own type
+        NSString *identifier =
+            [NSString stringWithFormat:@"Cell%zu", dataSource->viewTypeForRowIndex(static_cast<size_t>(indexPath.row))];
         FollowSizeUITableViewCell *cell =
-            (FollowSizeUITableViewCell *)[tableView dequeueReusableCellWithIdentifier:@"Cell"];
+            (FollowSizeUITableViewCell *)[tableView dequeueReusableCellWithIdentifier:identifier];
 
         std::shared_ptr<bdn::ui::ContainerView> containerView;
         std::shared_ptr<bdn::ui::View> view;
-        bool reuse = false;
 
         auto core = self.core.lock();
 
         if (cell == nil) {
-            cell =
-                [[FollowSizeUITableViewCell alloc] initWithStyle:UITableViewCellStyleDefault reuseIdentifier:@"Cell"];
+            cell = [[FollowSizeUITableViewCell alloc] initWithStyle:UITableViewCellStyleDefault
+                                                    reuseIdentifier:identifier];
             cell.clipsToBounds = YES;
 
             containerView = std::make_shared<bdn::ui::ContainerView>(core->viewCoreFactory());
@@ -91,19 +93,23 @@
             cell.containerView = containerView;
 
         } else {
-            reuse = true;
             containerView = cell.containerView;
 
-            if (!containerView->childViews().empty()) {
-                view = containerView->childViews().front();
+            if (containerView->childCount() > 0) {
+                view = containerView->childAt(0);
             }
         }
 
         if (containerView) {
-            view = self.outerDataSource->viewForRowIndex(indexPath.row, view);
-            if (!reuse) {
+            auto reusableView = view;
+            view = dataSource->viewForRowIndex(indexPath.row, reusableView);
+
+            // A view that was rebound in place stays where it is
+            if (!view || view != reusableView) {
                 containerView->removeAllChildViews();
-                containerView->addChildView(view);
+                if (view) {
+                    containerView->addChildView(view);
+                }
             }
             containerView->scheduleLayout();
         }
@@ -194,4 +194,6 @@ namespace bdn::ui::ios
         }
         return {};
     }
+
+    std::shared_ptr<View> NavigationViewCore::currentChild() { return getCurrentContainer(); }
 }
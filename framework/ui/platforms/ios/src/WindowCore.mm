@@ -301,8 +301,10 @@ namespace bdn::ui::ios
         }
     }
 
-    void WindowCore::updateFromStylesheet(nlohmann::json stylesheet)
+    void WindowCore::updateFromStylesheet(const ui::Stylesheet &sheet)
     {
+        const nlohmann::json &stylesheet = sheet.toJson();
+
         if (stylesheet.count("status-bar-style")) {
             if (stylesheet.at("status-bar-style") == "light") {
                 _rootViewController.statusBarStyle = UIStatusBarStyleLightContent;
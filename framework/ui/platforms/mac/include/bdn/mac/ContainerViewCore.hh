@@ -3,6 +3,8 @@
 #import <bdn/mac/ViewCore.hh>
 #include <bdn/ui/ContainerView.h>
 
+#include <vector>
+
 namespace bdn::ui::mac
 {
     class ContainerViewCore : public ViewCore, virtual public ContainerView::Core
@@ -22,7 +24,20 @@ namespace bdn::ui::mac
 
         std::list<std::shared_ptr<View>> childViews() override;
 
+        void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override;
+        size_t childCount() override;
+        std::shared_ptr<View> childAt(size_t index) override;
+
+        void beginUpdates() override;
+        void endUpdates() override;
+
       private:
-        std::list<std::shared_ptr<View>> _children;
+        void childrenChanged();
+
+      private:
+        std::vector<std::shared_ptr<View>> _children;
+
+        int _updateDepth = 0;
+        bool _childrenChangedInBatch = false;
     };
 }
@@ -18,14 +18,24 @@ namespace bdn::ui::mac
 
         void reloadData() override;
         void refreshDone() override;
+        void applyChanges(const ListViewChanges &changes) override;
 
       public:
         void fireRefresh();
 
+        /** Height of the row, served from a cache that is filled in blocks via heightsForRange(). */
+        float rowHeight(size_t rowIndex);
+
+        /** Updates the data source's prefetch windows after the visible area changed. */
+        void visibleRowsChanged();
+
       private:
         static NSScrollView *createNSTableView();
 
         ListViewDelegateMac *_nativeDelegate;
         NSTableView *_nsTableView;
+
+        detail::ListViewRowHeights _rowHeights;
+        detail::ListViewPrefetcher _prefetcher;
     };
 }
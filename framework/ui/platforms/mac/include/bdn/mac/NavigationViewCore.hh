@@ -21,6 +21,7 @@ namespace bdn::ui::mac
         void pushView(std::shared_ptr<View> view, String title) override;
         void popView() override;
         std::list<std::shared_ptr<View>> childViews() override;
+        std::shared_ptr<View> currentChild() override;
 
       public:
         void setLayout(std::shared_ptr<Layout> layout) override;
@@ -1,5 +1,8 @@
 #import <bdn/mac/ContainerViewCore.hh>
 
+#include <algorithm>
+#include <utility>
+
 /** NSView implementation that is used internally by
  bdn::mac::ContainerViewCore.
 
@@ -60,19 +63,56 @@ namespace bdn::ui::mac
             throw std::runtime_error("Cannot add this type of View");
         }
 
-        scheduleLayout();
+        childrenChanged();
     }
 
     void ContainerViewCore::removeChildView(std::shared_ptr<View> child)
     {
         if (auto childCore = child->core<ViewCore>()) {
             childCore->removeFromNsSuperview();
-            _children.remove(child);
+            _children.erase(std::remove(_children.begin(), _children.end(), child), _children.end());
         } else {
             throw std::runtime_error("Cannot remove this type of View");
         }
-        scheduleLayout();
+        childrenChanged();
+    }
+
+    std::list<std::shared_ptr<View>> ContainerViewCore::childViews()
+    {
+        return std::list<std::shared_ptr<View>>(_children.begin(), _children.end());
     }
 
-    std::list<std::shared_ptr<View>> ContainerViewCore::childViews() { return _children; }
+    void ContainerViewCore::forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function)
+    {
+        for (const auto &child : _children) {
+            function(child);
+        }
+    }
+
+    size_t ContainerViewCore::childCount() { return _children.size(); }
+
+    std::shared_ptr<View> ContainerViewCore::childAt(size_t index) { return _children.at(index); }
+
+    void ContainerViewCore::beginUpdates() { _updateDepth++; }
+
+    void ContainerViewCore::endUpdates()
+    {
+        if (_updateDepth == 0 || --_updateDepth > 0) {
+            return;
+        }
+
+        // Request a layout once for the whole batch
+        if (std::exchange(_childrenChangedInBatch, false)) {
+            scheduleLayout();
+        }
+    }
+
+    void ContainerViewCore::childrenChanged()
+    {
+        if (_updateDepth > 0) {
+            _childrenChangedInBatch = true;
+        } else {
+            scheduleLayout();
+        }
+    }
 }
@@ -1,8 +1,10 @@
+#import <bdn/applecommon/ImageCache.hh>
 #import <bdn/mac/ImageViewCore.hh>
 
 #include <bdn/Application.h>
 #include <bdn/String.h>
-#include <bdn/log.h>
+
+#include <cmath>
 
 using namespace std::string_literals;
 
@@ -13,6 +15,15 @@ namespace bdn::ui::detail
 
 namespace bdn::ui::mac
 {
+    namespace
+    {
+        ImageCache::Priority loadPriority(ImageView::ViewportPosition position)
+        {
+            return position == ImageView::ViewportPosition::Inside ? ImageCache::Priority::Visible
+                                                                     : ImageCache::Priority::Prefetch;
+        }
+    }
+
     NSView *ImageViewCore::createNSImageView()
     {
         NSImageView *view = [[NSImageView alloc] init];
@@ -25,8 +36,13 @@ namespace bdn::ui::mac
         : mac::ViewCore(viewCoreFactory, createNSImageView())
     {
         url.onChange() += [=](auto &property) { setUrl(property.get()); };
+
+        geometry.onChange() += [=](auto &property) { updateLoad(); };
+        viewportPosition.onChange() += [=](auto &property) { updateLoad(); };
     }
 
+    ImageViewCore::~ImageViewCore() { cancelLoad(); }
+
     Size ImageViewCore::sizeForSpace(Size availableSize) const
     {
         if (NSImage *image = ((NSImageView *)this->nsView()).image) {
@@ -49,7 +65,11 @@ namespace bdn::ui::mac
 
     void ImageViewCore::setUrl(const String &url)
     {
+        cancelLoad();
+        _imageBucket = 0;
         ((NSImageView *)this->nsView()).image = nullptr;
+        originalSize = Size{0, 0};
+        aspectRatio = 1.0;
 
         auto uri = App()->uriToBundledFileUri(url);
 
@@ -57,57 +77,107 @@ namespace bdn::ui::mac
             uri = url;
         }
 
+        _imageUrl = uri;
+
+        // The cache reads file URLs itself and expects a plain path after the scheme
         if (cpp20::starts_with(uri, "file:///")) {
             if (auto nsURL = [NSURL URLWithString:fk::stringToNSString(uri)]) {
                 if (auto localPath = nsURL.relativePath) {
-                    NSImage *image = [[NSImage alloc] initWithContentsOfFile:localPath];
-                    ((NSImageView *)this->nsView()).image = image;
-
-                    if (image) {
-                        originalSize = macSizeToSize(image.size);
-                        aspectRatio = originalSize->width / originalSize->height;
-                    }
+                    _imageUrl = "file://" + fk::nsStringToString(localPath);
                 }
             }
-        } else {
-            NSURLSession *session = [NSURLSession sharedSession];
-            NSURL *nsURL = [NSURL URLWithString:fk::stringToNSString(url)];
+        }
+
+        loadImage();
+
+        this->scheduleLayout();
+        this->markDirty();
+    }
+
+    size_t ImageViewCore::requiredPixelSize() const
+    {
+        NSView *view = this->nsView();
+        CGFloat scale = view.window ? view.window.backingScaleFactor : [NSScreen mainScreen].backingScaleFactor;
+
+        // Before the first layout only the original size is needed, so the smallest size is enough
+        auto size = geometry->size();
+        return std::max<size_t>(1, static_cast<size_t>(std::ceil(std::max(size.width, size.height) * scale)));
+    }
+
+    void ImageViewCore::updateLoad()
+    {
+        if (_imageUrl.empty()) {
+            return;
+        }
+
+        if (viewportPosition.get() == ImageView::ViewportPosition::Outside) {
+            cancelLoad();
+            return;
+        }
 
-            if (nsURL == nullptr) {
+        // Load a larger version once the view grows beyond the size the image was decoded for
+        size_t required = ImageCache::pixelSizeBucket(requiredPixelSize());
+        bool hasImage = ((NSImageView *)this->nsView()).image != nullptr;
+        if (_loadId != 0) {
+            if (ImageCache::bucketCovers(_loadBucket, required)) {
+                applecommon::imageCache()->setPriority(_loadId, loadPriority(viewportPosition.get()));
                 return;
             }
+        } else if (hasImage && ImageCache::bucketCovers(_imageBucket, required)) {
+            return;
+        }
+
+        loadImage();
+    }
 
-            ((NSImageView *)this->nsView()).image = nullptr;
-            originalSize = Size{0, 0};
-            aspectRatio = 1.0;
-
-            NSURLSessionDataTask *dataTask =
-                [session dataTaskWithURL:nsURL
-                       completionHandler:^(NSData *_Nullable nsData, NSURLResponse *_Nullable nsResponse,
-                                           NSError *_Nullable error) {
-                         if (auto err = error) {
-                             logstream() << "Failed loading '" << fk::nsStringToString([nsURL absoluteString]) << "' ("
-                                         << fk::nsStringToString([err localizedDescription]) << ")";
-                         } else {
-
-                             App()->dispatchQueue()->dispatchAsync([=]() {
-                                 NSImage *image = [[NSImage alloc] initWithData:nsData];
-                                 ((NSImageView *)this->nsView()).image = image;
-
-                                 if (image) {
-                                     originalSize = macSizeToSize(image.size);
-                                     aspectRatio = originalSize->width / originalSize->height;
-                                 }
-                                 this->scheduleLayout();
-                                 this->markDirty();
-                             });
-                         }
-                       }];
-
-            [dataTask resume];
+    void ImageViewCore::loadImage()
+    {
+        cancelLoad();
+
+        if (_imageUrl.empty() || viewportPosition.get() == ImageView::ViewportPosition::Outside) {
+            return;
         }
 
-        this->scheduleLayout();
-        this->markDirty();
+        size_t bucket = ImageCache::pixelSizeBucket(requiredPixelSize());
+        std::weak_ptr<ImageViewCore> weakSelf = shared_from_this<ImageViewCore>();
+
+        _loadBucket = bucket;
+        auto handler = [weakSelf, bucket](auto image) {
+            auto self = weakSelf.lock();
+            if (!self) {
+                return;
+            }
+
+            self->_loadId = 0;
+            if (!image) {
+                return;
+            }
+
+            // The image keeps its original size in points, even if it was decoded smaller
+            NSSize size = NSMakeSize(image->originalSize.width, image->originalSize.height);
+            NSImage *nsImage = [[NSImage alloc] initWithCGImage:applecommon::cgImage(*image) size:size];
+            ((NSImageView *)self->nsView()).image = nsImage;
+
+            self->_imageBucket = bucket;
+            self->originalSize = image->originalSize;
+            self->aspectRatio = self->originalSize->width / self->originalSize->height;
+
+            self->scheduleLayout();
+            self->markDirty();
+        };
+
+        _loadId = applecommon::imageCache()->load(_imageUrl, bucket, handler, loadPriority(viewportPosition.get()));
+    }
+
+    void ImageViewCore::cancelLoad()
+    {
+        if (_loadId == 0) {
+            return;
+        }
+
+        if (auto cache = ImageCache::shared()) {
+            cache->cancel(_loadId);
+        }
+        _loadId = 0;
     }
 }
@@ -4,8 +4,11 @@
 #include <bdn/mac/ContainerViewCore.hh>
 #include <bdn/ui/ContainerView.h>
 
+#include <optional>
+
 @interface FixedNSView : NSView <BdnLayoutable>
 @property(nonatomic, assign) std::shared_ptr<bdn::ui::ContainerView> view;
+@property(nonatomic, assign) std::optional<bdn::ui::ListViewDataSource::RowId> rowId;
 @end
 
 @implementation FixedNSView
@@ -54,11 +57,14 @@
             std::shared_ptr<bdn::ui::ContainerView> container;
             std::shared_ptr<bdn::ui::View> view;
 
-            FixedNSView *result = [tableView makeViewWithIdentifier:@"Column" owner:self];
+            // One reuse queue per view type, so rows only get views of their own type
+            NSString *identifier =
+                [NSString stringWithFormat:@"Column%zu", dataSource->viewTypeForRowIndex(static_cast<size_t>(row))];
+            FixedNSView *result = [tableView makeViewWithIdentifier:identifier owner:self];
 
             if (result == nil) {
                 result = [[FixedNSView alloc] initWithFrame:NSMakeRect(0, 0, 0, 0)];
-                result.identifier = @"Column";
+                result.identifier = identifier;
 
                 container = std::make_shared<bdn::ui::ContainerView>(listCore->viewCoreFactory());
                 container->isLayoutRoot = true;
@@ -73,15 +79,32 @@
                 result.view = container;
             } else {
                 container = result.view;
-                if (!container->childViews().empty()) {
-                    view = container->childViews().front();
+                if (container->childCount() > 0) {
+                    view = container->childAt(0);
+                }
+            }
+
+            std::optional<bdn::ui::ListViewDataSource::RowId> rowId;
+            if (dataSource->hasStableRowIds()) {
+                rowId = dataSource->rowIdForRowIndex(row);
+
+                // The recycled view still shows this row, no need to bind it again
+                if (view && rowId == result.rowId) {
+                    return result;
                 }
             }
+            result.rowId = rowId;
 
-            view = dataSource->viewForRowIndex(row, view);
+            auto reusableView = view;
+            view = dataSource->viewForRowIndex(row, reusableView);
 
-            container->removeAllChildViews();
-            container->addChildView(view);
+            // A view that was rebound in place stays where it is
+            if (!view || view != reusableView) {
+                container->removeAllChildViews();
+                if (view) {
+                    container->addChildView(view);
+                }
+            }
 
             return result;
         }
@@ -100,10 +123,11 @@
 
 - (CGFloat)tableView:(NSTableView *)tableView heightOfRow:(NSInteger)row
 {
-    if (self.outerDataSource == nullptr) {
+    auto listCore = self.listCore.lock();
+    if (listCore == nullptr || listCore->dataSource.get() == nullptr) {
         return 20.0f;
     }
-    return self.outerDataSource->heightForRowIndex(row);
+    return listCore->rowHeight(row);
 }
 
 @end
@@ -143,10 +167,23 @@
                                                  selector:@selector(didScroll)
                                                      name:NSScrollViewDidLiveScrollNotification
                                                    object:self];
+
+        self.contentView.postsBoundsChangedNotifications = YES;
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(boundsDidChange)
+                                                     name:NSViewBoundsDidChangeNotification
+                                                   object:self.contentView];
     }
     return self;
 }
 
+- (void)boundsDidChange
+{
+    if (auto listCore = self.listCore.lock()) {
+        listCore->visibleRowsChanged();
+    }
+}
+
 - (void)setRefreshEnabled:(bool)enable
 {
     _refreshEnabled = enable;
@@ -255,9 +292,72 @@ namespace bdn::ui::mac
         _nsTableView.delegate = nativeDelegate;
         _nsTableView.headerView = nil;
         _nativeDelegate = nativeDelegate;
+
+        dataSource.onChange() += [=](auto &property) {
+            _rowHeights.reset(property.get() ? property.get()->numberOfRows() : 0);
+        };
+    }
+
+    void ListViewCore::reloadData()
+    {
+        auto source = dataSource.get();
+        _rowHeights.reset(source ? source->numberOfRows() : 0);
+        _prefetcher.invalidate();
+
+        [_nsTableView reloadData];
+        visibleRowsChanged();
     }
 
-    void ListViewCore::reloadData() { [_nsTableView reloadData]; }
+    void ListViewCore::applyChanges(const ListViewChanges &changes)
+    {
+        auto source = dataSource.get();
+        auto oldRowCount = static_cast<size_t>(_nsTableView.numberOfRows);
+        if (!source || oldRowCount < changes.deletes.size() ||
+            changes.newRowCount(oldRowCount) != source->numberOfRows()) {
+            reloadData();
+            return;
+        }
+
+        _rowHeights.reset(source->numberOfRows());
+        _prefetcher.invalidate();
+
+        // NSTableView applies the updates one after another, so the moves have to refer to
+        // the rows as they are after the deletes and previous moves.
+        NSMutableIndexSet *deletes = [NSMutableIndexSet indexSet];
+        for (auto index : changes.deletes) {
+            [deletes addIndex:index];
+        }
+        NSMutableIndexSet *inserts = [NSMutableIndexSet indexSet];
+        for (auto index : changes.inserts) {
+            [inserts addIndex:index];
+        }
+        NSMutableIndexSet *updates = [NSMutableIndexSet indexSet];
+        for (auto index : changes.updates) {
+            [updates addIndex:index];
+        }
+
+        [_nsTableView beginUpdates];
+        [_nsTableView removeRowsAtIndexes:deletes withAnimation:NSTableViewAnimationEffectFade];
+        for (auto &move : changes.sequentialMoves(oldRowCount)) {
+            [_nsTableView moveRowAtIndex:move.from toIndex:move.to];
+        }
+        [_nsTableView insertRowsAtIndexes:inserts withAnimation:NSTableViewAnimationEffectFade];
+        [_nsTableView endUpdates];
+
+        if (updates.count > 0) {
+            // Make sure the updated rows are bound again even though their row ids did not change
+            NSTableView *tableView = _nsTableView;
+            [updates enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+              FixedNSView *rowView = [tableView viewAtColumn:0 row:(NSInteger)index makeIfNecessary:NO];
+              rowView.rowId = std::nullopt;
+            }];
+
+            [_nsTableView noteHeightOfRowsWithIndexesChanged:updates];
+            [_nsTableView reloadDataForRowIndexes:updates columnIndexes:[NSIndexSet indexSetWithIndex:0]];
+        }
+
+        visibleRowsChanged();
+    }
 
     void ListViewCore::refreshDone()
     {
@@ -267,6 +367,23 @@ namespace bdn::ui::mac
 
     void ListViewCore::fireRefresh() { _refreshCallback.fire(); }
 
+    float ListViewCore::rowHeight(size_t rowIndex)
+    {
+        if (auto source = dataSource.get()) {
+            return _rowHeights.height(*source, rowIndex);
+        }
+        return 0.0f;
+    }
+
+    void ListViewCore::visibleRowsChanged()
+    {
+        auto source = dataSource.get();
+        NSRange visible = [_nsTableView rowsInRect:_nsTableView.visibleRect];
+
+        _prefetcher.update(source, {visible.location, visible.location + visible.length},
+                           source ? source->numberOfRows() : 0);
+    }
+
     NSScrollView *ListViewCore::createNSTableView()
     {
         ListScrollView *nsScrollView = [[ListScrollView alloc] initWithFrame:CGRectMake(0, 0, 0, 0)];
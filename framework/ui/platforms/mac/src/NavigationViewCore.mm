@@ -89,6 +89,8 @@ namespace bdn::ui::mac
         return {};
     }
 
+    std::shared_ptr<View> NavigationViewCore::currentChild() { return _container; }
+
     void NavigationViewCore::setLayout(std::shared_ptr<Layout> layout)
     {
         if (_container) {
@@ -1,5 +1,8 @@
 #include <bdn/ui/ContainerView.h>
 
+#include <stdexcept>
+#include <utility>
+
 namespace bdn::ui
 {
     namespace detail
@@ -32,10 +35,9 @@ namespace bdn::ui
 
     void ContainerView::removeAllChildViews()
     {
-        auto copyChildren = childViews();
-
-        for (auto &childView : copyChildren) {
-            removeChildView(childView);
+        // Back to front, so that cores storing their children in a vector do not have to shift
+        for (size_t i = childCount(); i > 0; i--) {
+            removeChildView(childAt(i - 1));
         }
     }
 
@@ -48,6 +50,61 @@ namespace bdn::ui
         throw std::runtime_error("???");
     }
 
+    void ContainerView::forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function)
+    {
+        if (auto containerCore = core<ContainerView::Core>()) {
+            containerCore->forEachChild(function);
+        }
+    }
+
+    size_t ContainerView::childCount()
+    {
+        if (auto containerCore = core<ContainerView::Core>()) {
+            return containerCore->childCount();
+        }
+        return 0;
+    }
+
+    std::shared_ptr<View> ContainerView::childAt(size_t index)
+    {
+        if (auto containerCore = core<ContainerView::Core>()) {
+            return containerCore->childAt(index);
+        }
+        throw std::out_of_range("Child index out of range");
+    }
+
+    void ContainerView::beginUpdates()
+    {
+        if (_updateDepth++ > 0) {
+            return;
+        }
+
+        if (auto containerCore = core<ContainerView::Core>()) {
+            containerCore->beginUpdates();
+        }
+
+        // Remember the layout so the batch is closed on the same one, even if it changes meanwhile
+        _batchLayout = getLayout();
+        if (_batchLayout) {
+            _batchLayout->beginUpdates();
+        }
+    }
+
+    void ContainerView::endUpdates()
+    {
+        if (_updateDepth == 0 || --_updateDepth > 0) {
+            return;
+        }
+
+        if (auto layout = std::exchange(_batchLayout, nullptr)) {
+            layout->endUpdates();
+        }
+
+        if (auto containerCore = core<ContainerView::Core>()) {
+            containerCore->endUpdates();
+        }
+    }
+
     void ContainerView::childViewStolen(const std::shared_ptr<View> &childView)
     {
         if (auto containerCore = core<ContainerView::Core>()) {
@@ -0,0 +1,737 @@
+#include <bdn/Application.h>
+#include <bdn/ui/ImageCache.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace bdn::ui
+{
+    namespace
+    {
+        const char *const kFileScheme = "file://";
+
+        bool isFileUrl(const String &url) { return url.compare(0, std::strlen(kFileScheme), kFileScheme) == 0; }
+
+        // Full size images serve every request, so they are stored under the largest key.
+        size_t memoryKey(size_t bucket) { return bucket == 0 ? std::numeric_limits<size_t>::max() : bucket; }
+
+        std::optional<std::string> readFile(const String &path)
+        {
+            std::ifstream stream(path, std::ios::binary);
+            if (!stream) {
+                return std::nullopt;
+            }
+
+            std::ostringstream contents;
+            contents << stream.rdbuf();
+            if (stream.bad()) {
+                return std::nullopt;
+            }
+            return contents.str();
+        }
+
+        bool makeDirectory(const String &path)
+        {
+            if (path.empty()) {
+                return true;
+            }
+
+            for (size_t pos = path.find('/', 1);; pos = path.find('/', pos + 1)) {
+                auto part = path.substr(0, pos);
+                if (::mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) {
+                    return false;
+                }
+                if (pos == String::npos) {
+                    return true;
+                }
+            }
+        }
+
+        // Writes to a temporary file first, so that a crash never leaves a partially written file behind.
+        bool writeFile(const String &path, const std::string &data)
+        {
+            auto temporaryPath = path + ".tmp";
+            {
+                std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+                if (!stream.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+                    std::remove(temporaryPath.c_str());
+                    return false;
+                }
+            }
+            return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+        }
+
+        uint64_t contentHash(const std::string &data)
+        {
+            // FNV-1a
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            for (unsigned char c : data) {
+                hash ^= c;
+                hash *= 0x100000001b3ULL;
+            }
+            return hash;
+        }
+    }
+
+    namespace detail
+    {
+        /** Disk tier of ImageCache. Files are named after the hash of their contents and shared by all
+            URLs with the same contents. An index file maps the URLs to the files in least recently
+            used order. Changes are appended to a journal, which is folded into the index once it has
+            grown as large as the index itself. Not thread safe, the cache only uses it on its worker
+            queue. */
+        class ImageDiskStore
+        {
+          public:
+            ImageDiskStore(String directory, size_t budget) : _directory(std::move(directory)), _budget(budget)
+            {
+                makeDirectory(_directory + "/objects");
+                loadIndex();
+                if (_journalRecords > 0) {
+                    saveIndex();
+                }
+            }
+
+          public:
+            std::optional<std::string> read(const String &url)
+            {
+                auto it = _entries.find(url);
+                if (it == _entries.end()) {
+                    return std::nullopt;
+                }
+
+                auto data = readFile(objectPath(it->second.hash));
+                if (!data) {
+                    journalRemoval(url);
+                    remove(it);
+                    return std::nullopt;
+                }
+
+                _lru.splice(_lru.end(), _lru, it->second.lruPosition);
+                journalUse(url, it->second.hash);
+                return data;
+            }
+
+            void write(const String &url, const std::string &data)
+            {
+                auto hash = contentHash(data);
+
+                auto it = _entries.find(url);
+                if (it != _entries.end()) {
+                    if (it->second.hash == hash) {
+                        _lru.splice(_lru.end(), _lru, it->second.lruPosition);
+                        journalUse(url, hash);
+                        return;
+                    }
+                    remove(it);
+                }
+
+                auto objectIt = _objects.find(hash);
+                if (objectIt == _objects.end()) {
+                    if (!writeFile(objectPath(hash), data)) {
+                        return;
+                    }
+                    objectIt = _objects.emplace(hash, Object{data.size(), 0}).first;
+                    _totalBytes += data.size();
+                }
+                objectIt->second.references++;
+
+                _lru.push_back(url);
+                _entries.emplace(url, Entry{hash, std::prev(_lru.end())});
+                journalUse(url, hash);
+
+                // The entry that was just written is kept even if it exceeds the budget on its own
+                while (_totalBytes > _budget && _lru.size() > 1) {
+                    journalRemoval(_lru.front());
+                    remove(_entries.find(_lru.front()));
+                }
+
+                if (_journalRecords > std::max(kMinJournalRecords, _entries.size())) {
+                    saveIndex();
+                }
+            }
+
+          private:
+            struct Entry
+            {
+                uint64_t hash;
+                std::list<String>::iterator lruPosition;
+            };
+
+            struct Object
+            {
+                size_t size;
+                size_t references;
+            };
+
+            String objectPath(uint64_t hash) const
+            {
+                char name[17];
+                std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+                return _directory + "/objects/" + name;
+            }
+
+            String indexPath() const { return _directory + "/index"; }
+            String journalPath() const { return _directory + "/journal"; }
+
+            void remove(std::unordered_map<String, Entry>::iterator it)
+            {
+                auto objectIt = _objects.find(it->second.hash);
+                if (objectIt != _objects.end() && --objectIt->second.references == 0) {
+                    std::remove(objectPath(objectIt->first).c_str());
+                    _totalBytes -= objectIt->second.size;
+                    _objects.erase(objectIt);
+                }
+
+                _lru.erase(it->second.lruPosition);
+                _entries.erase(it);
+            }
+
+            // Index lines are <hash> <size> <url>, least recently used first. The journal repeats
+            // them with a leading '+' for URLs that were stored or used, and has '- <url>' lines for
+            // URLs that were removed.
+            void loadIndex()
+            {
+                std::ifstream index(indexPath());
+                std::string line;
+                while (std::getline(index, line)) {
+                    std::istringstream fields(line);
+                    loadEntry(fields);
+                }
+
+                std::ifstream journal(journalPath());
+                while (std::getline(journal, line)) {
+                    // The last record may have been cut off by a crash
+                    if (journal.eof()) {
+                        break;
+                    }
+                    _journalRecords++;
+
+                    std::istringstream fields(line);
+                    char kind = 0;
+                    fields >> kind;
+                    if (kind == '+') {
+                        loadEntry(fields);
+                    } else if (kind == '-') {
+                        String url;
+                        std::getline(fields >> std::ws, url);
+                        auto it = _entries.find(url);
+                        if (it != _entries.end()) {
+                            remove(it);
+                        }
+                    }
+                }
+            }
+
+            void loadEntry(std::istringstream &fields)
+            {
+                uint64_t hash = 0;
+                size_t size = 0;
+                if (!(fields >> std::hex >> hash >> std::dec >> size)) {
+                    return;
+                }
+
+                String url;
+                std::getline(fields >> std::ws, url);
+                if (url.empty()) {
+                    return;
+                }
+
+                auto it = _entries.find(url);
+                if (it != _entries.end()) {
+                    if (it->second.hash == hash) {
+                        _lru.splice(_lru.end(), _lru, it->second.lruPosition);
+                        return;
+                    }
+                    remove(it);
+                }
+
+                auto objectIt = _objects.find(hash);
+                if (objectIt == _objects.end()) {
+                    struct stat info;
+                    if (::stat(objectPath(hash).c_str(), &info) != 0) {
+                        return;
+                    }
+                    objectIt = _objects.emplace(hash, Object{size, 0}).first;
+                    _totalBytes += size;
+                }
+                objectIt->second.references++;
+
+                _lru.push_back(url);
+                _entries.emplace(url, Entry{hash, std::prev(_lru.end())});
+            }
+
+            void saveIndex()
+            {
+                std::ostringstream index;
+                for (auto &url : _lru) {
+                    auto hash = _entries[url].hash;
+                    index << std::hex << hash << std::dec << ' ' << _objects[hash].size << ' ' << url << '\n';
+                }
+
+                if (writeFile(indexPath(), index.str())) {
+                    _journal.close();
+                    std::remove(journalPath().c_str());
+                    _journalRecords = 0;
+                }
+            }
+
+            void journalUse(const String &url, uint64_t hash)
+            {
+                std::ostringstream record;
+                record << "+ " << std::hex << hash << std::dec << ' ' << _objects[hash].size << ' ' << url << '\n';
+                appendToJournal(record.str());
+            }
+
+            void journalRemoval(const String &url) { appendToJournal("- " + url + "\n"); }
+
+            void appendToJournal(const std::string &record)
+            {
+                if (!_journal.is_open()) {
+                    _journal.open(journalPath(), std::ios::binary | std::ios::app);
+                }
+                _journal << record << std::flush;
+                _journalRecords++;
+            }
+
+          private:
+            // Keeps small indices from being rewritten after every few changes
+            static constexpr size_t kMinJournalRecords = 64;
+
+            String _directory;
+            size_t _budget;
+            size_t _totalBytes = 0;
+
+            std::ofstream _journal;
+            size_t _journalRecords = 0;
+
+            std::list<String> _lru;
+            std::unordered_map<String, Entry> _entries;
+            std::unordered_map<uint64_t, Object> _objects;
+        };
+    }
+
+    namespace
+    {
+        std::shared_ptr<ImageCache> &sharedCache()
+        {
+            static std::shared_ptr<ImageCache> cache;
+            return cache;
+        }
+    }
+
+    ImageCache::ImageCache(Configuration configuration)
+        : _configuration(std::move(configuration)), _worker(std::make_unique<DispatchQueue>())
+    {
+        if (!_configuration.diskDirectory.empty()) {
+            _worker->dispatchAsync([this]() {
+                _diskStore =
+                    std::make_unique<detail::ImageDiskStore>(_configuration.diskDirectory, _configuration.diskBudget);
+            });
+        }
+    }
+
+    ImageCache::~ImageCache() = default;
+
+    std::shared_ptr<ImageCache> ImageCache::shared() { return sharedCache(); }
+
+    void ImageCache::setShared(std::shared_ptr<ImageCache> cache) { sharedCache() = std::move(cache); }
+
+    size_t ImageCache::pixelSizeBucket(size_t maxPixelSize)
+    {
+        if (maxPixelSize == 0) {
+            return 0;
+        }
+
+        size_t bucket = 32;
+        while (bucket < maxPixelSize) {
+            if (bucket > std::numeric_limits<size_t>::max() / 2) {
+                return 0;
+            }
+            bucket *= 2;
+        }
+        return bucket;
+    }
+
+    ImageCache::LoadId ImageCache::load(const String &url, size_t maxPixelSize, Handler handler, Priority priority)
+    {
+        size_t bucket = pixelSizeBucket(maxPixelSize);
+
+        if (auto image = lookupMemory(url, bucket)) {
+            _statistics.memoryHits++;
+            if (handler) {
+                handler(image);
+            }
+            return 0;
+        }
+
+        if (!App()) {
+            if (handler) {
+                handler(nullptr);
+            }
+            return 0;
+        }
+
+        LoadId id = ++_nextLoadId;
+        _pendingUrls.emplace(id, url);
+
+        auto [it, inserted] = _pendingLoads.try_emplace(url);
+        it->second.push_back(Waiter{id, bucket, std::move(handler), priority});
+        if (inserted) {
+            startLoading(url);
+        }
+
+        return id;
+    }
+
+    void ImageCache::cancel(LoadId id)
+    {
+        auto urlIt = _pendingUrls.find(id);
+        if (urlIt == _pendingUrls.end()) {
+            return;
+        }
+
+        String url = urlIt->second;
+        _pendingUrls.erase(urlIt);
+
+        auto loadIt = _pendingLoads.find(url);
+        if (loadIt == _pendingLoads.end()) {
+            return;
+        }
+
+        auto &waiters = loadIt->second;
+        auto cancelled = [id](auto &waiter) { return waiter.id == id; };
+        waiters.erase(std::remove_if(waiters.begin(), waiters.end(), cancelled), waiters.end());
+        if (!waiters.empty()) {
+            return;
+        }
+
+        // Nobody waits for the image anymore. Loads that already got past fetching are finished and
+        // cached, fetches are dropped.
+        auto queuedIt = std::find(_queuedFetches.begin(), _queuedFetches.end(), url);
+        if (queuedIt != _queuedFetches.end()) {
+            _queuedFetches.erase(queuedIt);
+            _pendingLoads.erase(loadIt);
+            return;
+        }
+
+        auto activeIt = _activeFetches.find(url);
+        if (activeIt != _activeFetches.end()) {
+            auto cancelFetch = std::move(activeIt->second.cancel);
+            _activeFetches.erase(activeIt);
+            _pendingLoads.erase(loadIt);
+            _statistics.cancelledFetches++;
+
+            if (cancelFetch) {
+                cancelFetch();
+            }
+            startFetches();
+        }
+    }
+
+    void ImageCache::setPriority(LoadId id, Priority priority)
+    {
+        auto urlIt = _pendingUrls.find(id);
+        if (urlIt == _pendingUrls.end()) {
+            return;
+        }
+
+        for (auto &waiter : _pendingLoads[urlIt->second]) {
+            if (waiter.id == id) {
+                waiter.priority = priority;
+            }
+        }
+    }
+
+    std::shared_ptr<const ImageCache::Image> ImageCache::cachedImage(const String &url, size_t maxPixelSize)
+    {
+        return lookupMemory(url, pixelSizeBucket(maxPixelSize));
+    }
+
+    void ImageCache::clearMemory()
+    {
+        _memory.clear();
+        _memoryIndex.clear();
+        _statistics.memoryBytes = 0;
+    }
+
+    ImageCache::Statistics ImageCache::statistics() const { return _statistics; }
+
+    void ImageCache::startLoading(const String &url)
+    {
+        // Without a disk tier there is nothing to look up on the worker
+        if (_configuration.diskDirectory.empty() && !isFileUrl(url)) {
+            fetch(url);
+            return;
+        }
+
+        _worker->dispatchAsync([this, url]() {
+            if (isFileUrl(url)) {
+                auto data = readFile(url.substr(std::strlen(kFileScheme)));
+                postToMain([url, data = std::move(data)](ImageCache &self) {
+                    if (data) {
+                        self.dataAvailable(url, std::make_shared<const std::string>(*data), false);
+                    } else {
+                        self.failed(url);
+                    }
+                });
+                return;
+            }
+
+            if (_diskStore) {
+                if (auto data = _diskStore->read(url)) {
+                    postToMain([url, data = std::make_shared<const std::string>(std::move(*data))](ImageCache &self) {
+                        self._statistics.diskHits++;
+                        self.dataAvailable(url, data, false);
+                    });
+                    return;
+                }
+            }
+
+            postToMain([url](ImageCache &self) { self.fetch(url); });
+        });
+    }
+
+    void ImageCache::fetch(const String &url)
+    {
+        // All loads may have been cancelled while the disk tier was checked
+        auto loadIt = _pendingLoads.find(url);
+        if (loadIt == _pendingLoads.end() || loadIt->second.empty()) {
+            _pendingLoads.erase(url);
+            return;
+        }
+
+        _queuedFetches.push_back(url);
+        startFetches();
+    }
+
+    void ImageCache::startFetches()
+    {
+        size_t maxConcurrentFetches = std::max<size_t>(1, _configuration.maxConcurrentFetches);
+
+        while (_activeFetches.size() < maxConcurrentFetches && !_queuedFetches.empty()) {
+            // Highest priority first, in order of arrival otherwise
+            auto next = _queuedFetches.begin();
+            for (auto it = next + 1; it != _queuedFetches.end(); ++it) {
+                if (priority(*it) > priority(*next)) {
+                    next = it;
+                }
+            }
+
+            String url = *next;
+            _queuedFetches.erase(next);
+            _statistics.fetches++;
+
+            if (!_configuration.fetcher) {
+                failed(url);
+                continue;
+            }
+
+            uint64_t fetchId = ++_nextFetchId;
+            _activeFetches[url] = ActiveFetch{fetchId, nullptr};
+
+            auto done = [weakSelf = weak_from_this(), url, fetchId](std::optional<std::string> data) {
+                if (auto self = weakSelf.lock()) {
+                    self->postToMain([url, fetchId, data = std::move(data)](ImageCache &self) {
+                        self.fetchDone(url, fetchId, data);
+                    });
+                }
+            };
+
+            auto cancelFetch = _configuration.fetcher(url, done);
+
+            auto activeIt = _activeFetches.find(url);
+            if (activeIt != _activeFetches.end() && activeIt->second.id == fetchId) {
+                activeIt->second.cancel = std::move(cancelFetch);
+            }
+        }
+    }
+
+    void ImageCache::fetchDone(const String &url, uint64_t fetchId, std::optional<std::string> data)
+    {
+        // Results of aborted fetches are ignored, the URL may already be fetched again
+        auto activeIt = _activeFetches.find(url);
+        if (activeIt == _activeFetches.end() || activeIt->second.id != fetchId) {
+            return;
+        }
+        _activeFetches.erase(activeIt);
+
+        if (data) {
+            dataAvailable(url, std::make_shared<const std::string>(std::move(*data)), true);
+        } else {
+            failed(url);
+        }
+
+        startFetches();
+    }
+
+    ImageCache::Priority ImageCache::priority(const String &url) const
+    {
+        auto result = Priority::Prefetch;
+
+        auto loadIt = _pendingLoads.find(url);
+        if (loadIt != _pendingLoads.end()) {
+            for (auto &waiter : loadIt->second) {
+                result = std::max(result, waiter.priority);
+            }
+        }
+        return result;
+    }
+
+    void ImageCache::dataAvailable(const String &url, std::shared_ptr<const std::string> data, bool storeOnDisk)
+    {
+        // Decode once for every distinct size that is waited for
+        std::set<size_t> buckets;
+        for (auto &waiter : _pendingLoads[url]) {
+            buckets.insert(waiter.bucket);
+        }
+
+        _worker->dispatchAsync([this, url, data, storeOnDisk, buckets]() {
+            if (storeOnDisk && _diskStore) {
+                _diskStore->write(url, *data);
+            }
+
+            DecodedImages images;
+            for (auto bucket : buckets) {
+                std::shared_ptr<const Image> image;
+                if (_configuration.decoder) {
+                    image = _configuration.decoder(*data, bucket);
+                }
+                images.emplace_back(bucket, std::move(image));
+            }
+
+            postToMain([url, images = std::move(images)](ImageCache &self) { self.decoded(url, images); });
+        });
+    }
+
+    void ImageCache::decoded(const String &url, const DecodedImages &images)
+    {
+        for (auto &[bucket, image] : images) {
+            if (image) {
+                _statistics.decodes++;
+                insertMemory(url, bucket, image);
+            }
+        }
+
+        auto waiters = std::move(_pendingLoads[url]);
+        _pendingLoads.erase(url);
+
+        std::vector<Waiter> unsatisfied;
+        for (auto &waiter : waiters) {
+            // Use the smallest decoded size that is large enough. The memory tier may already have
+            // evicted it again if the image alone exceeds the budget.
+            const std::pair<size_t, std::shared_ptr<const Image>> *match = nullptr;
+            for (auto &decodedImage : images) {
+                if (memoryKey(decodedImage.first) >= memoryKey(waiter.bucket) &&
+                    (!match || memoryKey(decodedImage.first) < memoryKey(match->first))) {
+                    match = &decodedImage;
+                }
+            }
+
+            // Waiters that came in while decoding may need a larger size
+            if (!match) {
+                unsatisfied.push_back(std::move(waiter));
+                continue;
+            }
+
+            _pendingUrls.erase(waiter.id);
+            if (waiter.handler) {
+                waiter.handler(match->second);
+            }
+        }
+
+        if (!unsatisfied.empty()) {
+            auto [it, inserted] = _pendingLoads.try_emplace(url);
+            it->second.insert(it->second.end(), std::make_move_iterator(unsatisfied.begin()),
+                              std::make_move_iterator(unsatisfied.end()));
+            if (inserted) {
+                startLoading(url);
+            }
+        }
+    }
+
+    void ImageCache::failed(const String &url)
+    {
+        auto waiters = std::move(_pendingLoads[url]);
+        _pendingLoads.erase(url);
+
+        for (auto &waiter : waiters) {
+            _pendingUrls.erase(waiter.id);
+            if (waiter.handler) {
+                waiter.handler(nullptr);
+            }
+        }
+    }
+
+    std::shared_ptr<const ImageCache::Image> ImageCache::lookupMemory(const String &url, size_t bucket)
+    {
+        auto indexIt = _memoryIndex.find(url);
+        if (indexIt == _memoryIndex.end()) {
+            return nullptr;
+        }
+
+        auto it = indexIt->second.lower_bound(memoryKey(bucket));
+        if (it == indexIt->second.end()) {
+            return nullptr;
+        }
+
+        _memory.splice(_memory.begin(), _memory, it->second);
+        return it->second->image;
+    }
+
+    void ImageCache::insertMemory(const String &url, size_t bucket, std::shared_ptr<const Image> image)
+    {
+        auto key = memoryKey(bucket);
+        auto &sizes = _memoryIndex[url];
+
+        // A larger image supersedes all smaller ones of the same URL
+        if (sizes.upper_bound(key) != sizes.end()) {
+            return;
+        }
+        for (auto &[smallerKey, position] : sizes) {
+            _statistics.memoryBytes -= position->image->byteCost;
+            _memory.erase(position);
+        }
+        sizes.clear();
+
+        _memory.push_front(MemoryEntry{url, key, image});
+        sizes.emplace(key, _memory.begin());
+        _statistics.memoryBytes += image->byteCost;
+
+        trimMemory();
+    }
+
+    void ImageCache::trimMemory()
+    {
+        while (_statistics.memoryBytes > _configuration.memoryBudget && !_memory.empty()) {
+            auto &entry = _memory.back();
+            _statistics.memoryBytes -= entry.image->byteCost;
+
+            auto indexIt = _memoryIndex.find(entry.url);
+            indexIt->second.erase(entry.key);
+            if (indexIt->second.empty()) {
+                _memoryIndex.erase(indexIt);
+            }
+
+            _memory.pop_back();
+        }
+    }
+
+    void ImageCache::postToMain(std::function<void(ImageCache &)> function)
+    {
+        if (auto app = App()) {
+            app->dispatchQueue()->dispatchAsync([weakSelf = weak_from_this(), function = std::move(function)]() {
+                if (auto self = weakSelf.lock()) {
+                    function(*self);
+                }
+            });
+        }
+    }
+}
@@ -1,4 +1,7 @@
 #include <bdn/ui/ImageView.h>
+#include <bdn/ui/ScrollView.h>
+
+#include <bdn/Application.h>
 
 namespace bdn::ui
 {
@@ -10,6 +13,16 @@ namespace bdn::ui
     ImageView::ImageView(std::shared_ptr<ViewCoreFactory> viewCoreFactory) : View(std::move(viewCoreFactory))
     {
         detail::VIEW_CORE_REGISTER(ImageView, View::viewCoreFactory());
+
+        url.onChange() += [=](auto &property) { scheduleViewportUpdate(); };
+        geometry.onChange() += [=](auto &property) { scheduleViewportUpdate(); };
+    }
+
+    ImageView::~ImageView()
+    {
+        if (auto scrollView = _scrollView.lock()) {
+            scrollView->untrackViewport(this);
+        }
     }
 
     void ImageView::bindViewCore()
@@ -21,6 +34,58 @@ namespace bdn::ui
         iOriginalSize.bind(imageCore->originalSize, BindMode::unidirectional);
         iAspectRatio.bind(imageCore->aspectRatio, BindMode::unidirectional);
 
+        // Bound before the url, so that the core does not start loading an image that is off screen
+        imageCore->viewportPosition.bind(iViewportPosition);
         imageCore->url.bind(url);
     }
+
+    void ImageView::scheduleViewportUpdate()
+    {
+        if (_viewportUpdateScheduled) {
+            return;
+        }
+        _viewportUpdateScheduled = true;
+
+        // Wait for the layout pass to finish, the geometry of the parents may not be final yet
+        if (auto app = App()) {
+            app->dispatchQueue()->dispatchAsync([weakSelf = weak_from_this()]() {
+                if (auto self = std::static_pointer_cast<ImageView>(weakSelf.lock())) {
+                    self->updateViewportPosition();
+                }
+            });
+        } else {
+            updateViewportPosition();
+        }
+    }
+
+    void ImageView::updateViewportPosition()
+    {
+        _viewportUpdateScheduled = false;
+
+        std::vector<std::shared_ptr<View>> ancestors;
+        std::shared_ptr<ScrollView> scrollView;
+        for (auto parent = getParentView(); parent && !scrollView; parent = parent->getParentView()) {
+            scrollView = std::dynamic_pointer_cast<ScrollView>(parent);
+            if (!scrollView) {
+                ancestors.push_back(parent);
+            }
+        }
+
+        auto current = _scrollView.lock();
+        if (current && current != scrollView) {
+            current->untrackViewport(this);
+        }
+        _scrollView = scrollView;
+
+        if (!scrollView) {
+            iViewportPosition = ViewportPosition::Inside;
+            return;
+        }
+
+        // Scrolling and layouts of the ancestors are handled by the scroll view for all of its image views
+        scrollView->trackViewport(std::static_pointer_cast<ImageView>(shared_from_this()), ancestors);
+
+        std::unordered_map<View *, Point> offsets;
+        scrollView->updateViewportPosition(*this, offsets);
+    }
 }
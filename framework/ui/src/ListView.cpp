@@ -24,6 +24,27 @@ namespace bdn::ui
         listCore->refreshDone();
     }
 
+    void ListView::applyChanges(const ListViewChanges &changes)
+    {
+        if (changes.empty()) {
+            return;
+        }
+
+        auto listCore = core<ListView::Core>();
+
+        auto selected = selectedRowIndex.get();
+        auto source = dataSource.get();
+        if (selected && source) {
+            size_t rowCount = source->numberOfRows() + changes.deletes.size();
+            if (rowCount >= changes.inserts.size()) {
+                auto mapping = changes.indexMapping(rowCount - changes.inserts.size());
+                selectedRowIndex = *selected < mapping.size() ? mapping[*selected] : std::nullopt;
+            }
+        }
+
+        listCore->applyChanges(changes);
+    }
+
     void ListView::bindViewCore()
     {
         View::bindViewCore();
@@ -0,0 +1,99 @@
+#include <bdn/ui/ListViewChanges.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace bdn::ui
+{
+    size_t ListViewChanges::newRowCount(size_t oldRowCount) const
+    {
+        if (oldRowCount < deletes.size()) {
+            throw std::invalid_argument("ListViewChanges: more rows deleted than there were");
+        }
+        return oldRowCount - deletes.size() + inserts.size();
+    }
+
+    std::vector<std::optional<size_t>> ListViewChanges::indexMapping(size_t oldRowCount) const
+    {
+        size_t rowCount = newRowCount(oldRowCount);
+
+        std::vector<std::optional<size_t>> mapping(oldRowCount);
+        std::vector<bool> oldHandled(oldRowCount, false);
+        std::vector<bool> newTaken(rowCount, false);
+
+        for (auto index : deletes) {
+            oldHandled.at(index) = true;
+        }
+        for (auto index : inserts) {
+            newTaken.at(index) = true;
+        }
+        for (auto &move : moves) {
+            oldHandled.at(move.from) = true;
+            newTaken.at(move.to) = true;
+            mapping[move.from] = move.to;
+        }
+
+        // All other rows keep their relative order and fill the remaining slots
+        size_t next = 0;
+        for (size_t i = 0; i < oldRowCount; i++) {
+            if (oldHandled[i]) {
+                continue;
+            }
+            while (next < rowCount && newTaken[next]) {
+                next++;
+            }
+            if (next >= rowCount) {
+                throw std::out_of_range("ListViewChanges: changes do not match the row count");
+            }
+            mapping[i] = next++;
+        }
+
+        return mapping;
+    }
+
+    std::vector<ListViewChanges::Move> ListViewChanges::sequentialMoves(size_t oldRowCount) const
+    {
+        auto mapping = indexMapping(oldRowCount);
+
+        // New index of each surviving row, in their current order
+        std::vector<size_t> current;
+        current.reserve(oldRowCount);
+        for (auto &newIndex : mapping) {
+            if (newIndex) {
+                current.push_back(*newIndex);
+            }
+        }
+
+        std::vector<bool> placed(mapping.size() + inserts.size(), true);
+        std::vector<size_t> targets;
+        for (auto &move : moves) {
+            placed[move.to] = false;
+            targets.push_back(move.to);
+        }
+        std::sort(targets.begin(), targets.end());
+
+        // Rows that do not move are already in the right relative order. Each moved row is put
+        // directly behind the row that precedes it in the new order, which is in place by then.
+        std::vector<Move> result;
+        for (auto target : targets) {
+            auto from = static_cast<size_t>(std::find(current.begin(), current.end(), target) - current.begin());
+            current.erase(current.begin() + from);
+
+            size_t to = 0;
+            for (size_t i = 0; i < current.size(); i++) {
+                if (placed[current[i]] && current[i] < target) {
+                    to = i + 1;
+                }
+            }
+
+            current.insert(current.begin() + to, target);
+            placed[target] = true;
+
+            if (from != to) {
+                result.push_back(Move{from, to});
+            }
+        }
+
+        return result;
+    }
+}
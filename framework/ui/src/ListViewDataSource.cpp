@@ -0,0 +1,121 @@
+#include <bdn/ui/ListViewDataSource.h>
+
+#include <algorithm>
+
+namespace bdn::ui::detail
+{
+    namespace
+    {
+        using RowRange = ListViewDataSource::RowRange;
+
+        // Appends the parts of range that are not covered by any of others to out.
+        void appendDifference(RowRange range, const std::vector<RowRange> &others, std::vector<RowRange> &out)
+        {
+            std::vector<RowRange> pieces{range};
+
+            for (auto &other : others) {
+                std::vector<RowRange> remaining;
+                for (auto &piece : pieces) {
+                    if (other.empty() || other.end <= piece.begin || other.begin >= piece.end) {
+                        remaining.push_back(piece);
+                        continue;
+                    }
+                    if (piece.begin < other.begin) {
+                        remaining.push_back(RowRange{piece.begin, other.begin});
+                    }
+                    if (other.end < piece.end) {
+                        remaining.push_back(RowRange{other.end, piece.end});
+                    }
+                }
+                pieces = std::move(remaining);
+            }
+
+            for (auto &piece : pieces) {
+                if (!piece.empty()) {
+                    out.push_back(piece);
+                }
+            }
+        }
+    }
+
+    void ListViewRowHeights::reset(size_t rowCount)
+    {
+        _heights.assign(rowCount, 0.0f);
+        _loadedBlocks.assign((rowCount + kBlockSize - 1) / kBlockSize, false);
+    }
+
+    float ListViewRowHeights::height(ListViewDataSource &dataSource, size_t rowIndex)
+    {
+        if (rowIndex >= _heights.size()) {
+            return dataSource.heightForRowIndex(rowIndex);
+        }
+
+        size_t block = rowIndex / kBlockSize;
+        if (!_loadedBlocks[block]) {
+            size_t begin = block * kBlockSize;
+            size_t end = std::min(begin + kBlockSize, _heights.size());
+            dataSource.heightsForRange(begin, end, _heights.data() + begin);
+            _loadedBlocks[block] = true;
+        }
+
+        return _heights[rowIndex];
+    }
+
+    void ListViewPrefetcher::update(const std::shared_ptr<ListViewDataSource> &dataSource, RowRange visible,
+                                    size_t rowCount)
+    {
+        auto previousDataSource = _dataSource.lock();
+        if (previousDataSource != dataSource) {
+            if (previousDataSource) {
+                for (auto &window : _windows) {
+                    previousDataSource->cancelPrefetch(window);
+                }
+            }
+            _windows.clear();
+            _dataSource = dataSource;
+        }
+
+        if (!dataSource) {
+            return;
+        }
+
+        visible.end = std::min(visible.end, rowCount);
+        visible.begin = std::min(visible.begin, visible.end);
+
+        std::vector<RowRange> windows;
+        RowRange behind{visible.begin - std::min(visible.begin, _distance), visible.begin};
+        RowRange ahead{visible.end, std::min(visible.end + _distance, rowCount)};
+        if (!behind.empty()) {
+            windows.push_back(behind);
+        }
+        if (!ahead.empty()) {
+            windows.push_back(ahead);
+        }
+
+        // Rows that scrolled from a window into view are still wanted, so only cancel the ones that
+        // are neither visible nor in one of the new windows.
+        std::vector<RowRange> retained = windows;
+        retained.push_back(visible);
+
+        std::vector<RowRange> cancelled;
+        for (auto &window : _windows) {
+            appendDifference(window, retained, cancelled);
+        }
+
+        std::vector<RowRange> added;
+        for (auto &window : windows) {
+            appendDifference(window, _windows, added);
+        }
+
+        _windows = std::move(windows);
+
+        for (auto &range : cancelled) {
+            dataSource->cancelPrefetch(range);
+        }
+        for (auto &range : added) {
+            dataSource->prefetchRows(range);
+        }
+    }
+
+    void ListViewPrefetcher::invalidate() { _windows.clear(); }
+}
@@ -0,0 +1,139 @@
+#include <bdn/Application.h>
+#include <bdn/ui/ListViewDiff.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace bdn::ui
+{
+    namespace
+    {
+        // Heckel's symbol table entry
+        struct Occurrences
+        {
+            size_t oldCount = 0;
+            size_t newCount = 0;
+            size_t oldIndex = 0;
+        };
+
+        // Returns the positions in values that form a longest strictly increasing subsequence.
+        std::vector<size_t> longestIncreasingSubsequence(const std::vector<size_t> &values)
+        {
+            std::vector<size_t> tails; // position of the smallest tail of each subsequence length
+            std::vector<size_t> predecessors(values.size());
+
+            for (size_t i = 0; i < values.size(); i++) {
+                auto less = [&values](size_t position, size_t value) { return values[position] < value; };
+                auto it = std::lower_bound(tails.begin(), tails.end(), values[i], less);
+
+                predecessors[i] = it == tails.begin() ? i : *(it - 1);
+
+                if (it == tails.end()) {
+                    tails.push_back(i);
+                } else {
+                    *it = i;
+                }
+            }
+
+            std::vector<size_t> result(tails.size());
+            if (!tails.empty()) {
+                size_t position = tails.back();
+                for (size_t i = tails.size(); i > 0; i--) {
+                    result[i - 1] = position;
+                    position = predecessors[position];
+                }
+            }
+            return result;
+        }
+    }
+
+    ListViewDiff::ListViewDiff() : _worker(std::make_unique<DispatchQueue>()) {}
+
+    ListViewDiff::~ListViewDiff() = default;
+
+    ListViewChanges ListViewDiff::calculate(const Snapshot &before, const Snapshot &after)
+    {
+        std::unordered_map<ListViewDataSource::RowId, Occurrences> table;
+        table.reserve(before.size() + after.size());
+
+        for (size_t i = 0; i < before.size(); i++) {
+            auto &entry = table[before[i].id];
+            entry.oldCount++;
+            entry.oldIndex = i;
+        }
+        for (auto &row : after) {
+            table[row.id].newCount++;
+        }
+
+        ListViewChanges changes;
+
+        // Rows whose id occurs exactly once in both snapshots are matched, everything else is
+        // deleted or inserted.
+        std::vector<bool> oldMatched(before.size(), false);
+        std::vector<size_t> matchedNew;
+        std::vector<size_t> matchedOld;
+
+        for (size_t i = 0; i < after.size(); i++) {
+            auto &entry = table[after[i].id];
+            if (entry.oldCount == 1 && entry.newCount == 1) {
+                oldMatched[entry.oldIndex] = true;
+                matchedNew.push_back(i);
+                matchedOld.push_back(entry.oldIndex);
+
+                if (before[entry.oldIndex].version != after[i].version) {
+                    changes.updates.push_back(i);
+                }
+            } else {
+                changes.inserts.push_back(i);
+            }
+        }
+
+        for (size_t i = 0; i < before.size(); i++) {
+            if (!oldMatched[i]) {
+                changes.deletes.push_back(i);
+            }
+        }
+
+        auto stationary = longestIncreasingSubsequence(matchedOld);
+        auto stationaryIt = stationary.begin();
+        for (size_t i = 0; i < matchedOld.size(); i++) {
+            if (stationaryIt != stationary.end() && *stationaryIt == i) {
+                ++stationaryIt;
+            } else {
+                changes.moves.push_back(ListViewChanges::Move{matchedOld[i], matchedNew[i]});
+            }
+        }
+
+        return changes;
+    }
+
+    void ListViewDiff::calculateAsync(Snapshot before, Snapshot after, std::function<void(ListViewChanges)> done)
+    {
+        size_t generation = ++_generation;
+
+        // There is no main queue to deliver the result on
+        if (!App()) {
+            done(calculate(before, after));
+            return;
+        }
+
+        // The worker must not take ownership of this object, otherwise it might end up joining itself.
+        _worker->dispatchAsync([weakSelf = weak_from_this(), generation, before = std::move(before),
+                                after = std::move(after), done = std::move(done)]() {
+            auto changes = calculate(before, after);
+
+            auto deliver = [weakSelf, generation, changes = std::move(changes), done]() {
+                auto self = weakSelf.lock();
+                if (self && self->_generation == generation) {
+                    done(changes);
+                }
+            };
+
+            if (auto app = App()) {
+                app->dispatchQueue()->dispatchAsync(deliver);
+            } else {
+                deliver();
+            }
+        });
+    }
+}
@@ -1,5 +1,6 @@
 #include <bdn/ui/NavigationView.h>
 
+#include <stdexcept>
 #include <utility>
 
 namespace bdn::ui
@@ -36,5 +37,34 @@ namespace bdn::ui
         return {};
     }
 
+    void NavigationView::forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function)
+    {
+        if (auto navigationViewCore = core<NavigationView::Core>()) {
+            if (auto child = navigationViewCore->currentChild()) {
+                function(child);
+            }
+        }
+    }
+
+    size_t NavigationView::childCount()
+    {
+        if (auto navigationViewCore = core<NavigationView::Core>()) {
+            return navigationViewCore->currentChild() ? 1 : 0;
+        }
+        return 0;
+    }
+
+    std::shared_ptr<View> NavigationView::childAt(size_t index)
+    {
+        if (index == 0) {
+            if (auto navigationViewCore = core<NavigationView::Core>()) {
+                if (auto child = navigationViewCore->currentChild()) {
+                    return child;
+                }
+            }
+        }
+        throw std::out_of_range("Child index out of range");
+    }
+
     void NavigationView::bindViewCore() { View::bindViewCore(); }
 }
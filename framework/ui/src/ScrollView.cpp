@@ -1,8 +1,11 @@
 
+#include <bdn/ui/ImageView.h>
 #include <bdn/ui/ScrollView.h>
 
 #include <bdn/Application.h>
 
+#include <algorithm>
+
 namespace bdn::ui
 {
     namespace detail
@@ -10,11 +13,22 @@ namespace bdn::ui
         VIEW_CORE_REGISTRY_IMPLEMENTATION(ScrollView)
     }
 
+    namespace
+    {
+        // Touching edges count as overlapping, so that empty views at the border are not skipped.
+        bool overlaps(const Rect &a, const Rect &b)
+        {
+            return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+        }
+    }
+
     ScrollView::ScrollView(std::shared_ptr<ViewCoreFactory> viewCoreFactory)
         : View(std::move(viewCoreFactory)), verticalScrollingEnabled(true)
     {
         detail::VIEW_CORE_REGISTER(ScrollView, View::viewCoreFactory());
         contentView.onChange() += [=](auto &property) { _contentView.update(shared_from_this(), property.get()); };
+        visibleClientRect.onChange() += [=](auto &property) { scheduleViewportUpdate(); };
+        lookAheadMargin.onChange() += [=](auto &property) { scheduleViewportUpdate(); };
     }
 
     void ScrollView::bindViewCore()
@@ -25,6 +39,7 @@ namespace bdn::ui
         scrollCore->contentView.bind(contentView);
         scrollCore->horizontalScrollingEnabled.bind(horizontalScrollingEnabled);
         scrollCore->verticalScrollingEnabled.bind(verticalScrollingEnabled);
+        visibleClientRect.bind(scrollCore->visibleClientRect, BindMode::unidirectional);
     }
 
     void ScrollView::scrollClientRectToVisible(const Rect &area)
@@ -54,4 +69,166 @@ namespace bdn::ui
             contentView = nullptr;
         }
     }
+
+    void ScrollView::trackViewport(const std::shared_ptr<ImageView> &imageView,
+                                   const std::vector<std::shared_ptr<View>> &ancestors)
+    {
+        std::vector<View *> ancestorPointers;
+        ancestorPointers.reserve(ancestors.size());
+        for (auto &ancestor : ancestors) {
+            ancestorPointers.push_back(ancestor.get());
+        }
+
+        auto &tracked = _trackedImageViews[imageView.get()];
+        tracked.imageView = imageView;
+        if (tracked.ancestors == ancestorPointers) {
+            return;
+        }
+
+        // Views between an image view and the scroll view move the image when they are laid out
+        // again, without the visible client rect changing.
+        for (auto &ancestor : ancestors) {
+            auto &trackedAncestor = _trackedAncestors[ancestor.get()];
+            if (trackedAncestor.view.lock() != ancestor) {
+                trackedAncestor.view = ancestor;
+                trackedAncestor.subscription =
+                    ancestor->geometry.onChange().subscribe([weakSelf = weak_from_this()](auto &property) {
+                        if (auto self = std::static_pointer_cast<ScrollView>(weakSelf.lock())) {
+                            self->scheduleViewportUpdate();
+                        }
+                    });
+            }
+            trackedAncestor.references++;
+        }
+
+        releaseAncestors(tracked.ancestors);
+        tracked.ancestors = std::move(ancestorPointers);
+    }
+
+    void ScrollView::untrackViewport(const ImageView *imageView)
+    {
+        auto it = _trackedImageViews.find(imageView);
+        if (it == _trackedImageViews.end()) {
+            return;
+        }
+
+        releaseAncestors(it->second.ancestors);
+        _trackedImageViews.erase(it);
+    }
+
+    void ScrollView::releaseAncestors(const std::vector<View *> &ancestors)
+    {
+        for (auto *pointer : ancestors) {
+            auto it = _trackedAncestors.find(pointer);
+            if (it == _trackedAncestors.end() || --it->second.references > 0) {
+                continue;
+            }
+
+            if (auto ancestor = it->second.view.lock()) {
+                ancestor->geometry.onChange().unsubscribe(it->second.subscription);
+            }
+            _trackedAncestors.erase(it);
+        }
+    }
+
+    void ScrollView::scheduleViewportUpdate()
+    {
+        if (_viewportUpdateScheduled || _trackedImageViews.empty()) {
+            return;
+        }
+        _viewportUpdateScheduled = true;
+
+        // Wait for the layout pass to finish, the geometry of the ancestors may not be final yet
+        if (auto app = App()) {
+            app->dispatchQueue()->dispatchAsync([weakSelf = weak_from_this()]() {
+                if (auto self = std::static_pointer_cast<ScrollView>(weakSelf.lock())) {
+                    self->updateViewportPositions();
+                }
+            });
+        } else {
+            updateViewportPositions();
+        }
+    }
+
+    void ScrollView::updateViewportPositions()
+    {
+        _viewportUpdateScheduled = false;
+
+        // Updating the positions may start or cancel loads, which must not change the tracked views
+        // while they are iterated.
+        std::vector<std::shared_ptr<ImageView>> imageViews;
+        imageViews.reserve(_trackedImageViews.size());
+        for (auto &[pointer, tracked] : _trackedImageViews) {
+            if (auto imageView = tracked.imageView.lock()) {
+                imageViews.push_back(std::move(imageView));
+            }
+        }
+
+        // Image views in the same container share the offset of their ancestors
+        std::unordered_map<View *, Point> offsets;
+        for (auto &imageView : imageViews) {
+            updateViewportPosition(*imageView, offsets);
+        }
+    }
+
+    void ScrollView::updateViewportPosition(ImageView &imageView, std::unordered_map<View *, Point> &offsets)
+    {
+        using Position = ImageView::ViewportPosition;
+
+        // Nothing is known to be visible before the scroll view was laid out
+        Rect visibleRect = visibleClientRect.get();
+        if (visibleRect.width <= 0 || visibleRect.height <= 0) {
+            imageView.iViewportPosition = Position::Outside;
+            return;
+        }
+
+        // Image views that were moved out of this scroll view register elsewhere on their next update
+        auto offset = clientOffset(imageView.getParentView(), offsets);
+        if (!offset) {
+            return;
+        }
+
+        Rect rect = imageView.geometry.get();
+        rect.x += offset->x;
+        rect.y += offset->y;
+
+        double margin = std::max(0.0, lookAheadMargin.get());
+        Rect lookAheadRect{visibleRect.x - margin, visibleRect.y - margin, visibleRect.width + 2 * margin,
+                           visibleRect.height + 2 * margin};
+
+        if (overlaps(rect, visibleRect)) {
+            imageView.iViewportPosition = Position::Inside;
+        } else if (overlaps(rect, lookAheadRect)) {
+            imageView.iViewportPosition = Position::Nearby;
+        } else {
+            imageView.iViewportPosition = Position::Outside;
+        }
+    }
+
+    std::optional<Point> ScrollView::clientOffset(std::shared_ptr<View> view,
+                                                  std::unordered_map<View *, Point> &offsets)
+    {
+        // Walks up until an ancestor whose offset is already known, then fills in the ones below it
+        std::vector<View *> unknown;
+        Point offset;
+        for (; view.get() != this; view = view->getParentView()) {
+            if (!view) {
+                return std::nullopt;
+            }
+
+            auto it = offsets.find(view.get());
+            if (it != offsets.end()) {
+                offset = it->second;
+                break;
+            }
+            unknown.push_back(view.get());
+        }
+
+        for (auto it = unknown.rbegin(); it != unknown.rend(); ++it) {
+            offset.x += (*it)->geometry->x;
+            offset.y += (*it)->geometry->y;
+            offsets[*it] = offset;
+        }
+        return offset;
+    }
 }
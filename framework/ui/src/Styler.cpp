@@ -1,75 +1,238 @@
+#include <bdn/Application.h>
 #include <bdn/log.h>
 #include <bdn/ui/Styler.h>
 
+#include <algorithm>
+
 namespace bdn::ui
 {
+    namespace
+    {
+        class LayoutUpdateBatch
+        {
+          public:
+            explicit LayoutUpdateBatch(const std::vector<std::shared_ptr<View>> &views)
+            {
+                for (auto &view : views) {
+                    auto layout = view->getLayout();
+                    if (layout && std::find(_layouts.begin(), _layouts.end(), layout) == _layouts.end()) {
+                        layout->beginUpdates();
+                        _layouts.push_back(layout);
+                    }
+                }
+            }
+
+            ~LayoutUpdateBatch()
+            {
+                for (auto &layout : _layouts) {
+                    layout->endUpdates();
+                }
+            }
+
+            LayoutUpdateBatch(const LayoutUpdateBatch &) = delete;
+            LayoutUpdateBatch &operator=(const LayoutUpdateBatch &) = delete;
+
+          private:
+            std::vector<std::shared_ptr<Layout>> _layouts;
+        };
+    }
+
+    Styler::Styler() { _flushReceiver = _flushCallback.set([this]() { flush(); }); }
+
     void Styler::setStyleSheet(std::shared_ptr<View> view, json json)
     {
-        _data[view] = Data{json};
-        rematchView(view);
+        auto program = compile(json);
+
+        auto it = _data.find(view);
+        if (it == _data.end()) {
+            _data.emplace(view, program);
+        } else if (it->second != program) {
+            it->second->views.erase(view);
+            it->second = program;
+        }
+
+        program->views.insert(view);
+        view->stylesheet = program->result;
     }
 
     void Styler::setCondition(String name, std::shared_ptr<Styler::condition> condition)
     {
-        _conditions[name] = condition;
-        rematchAllViews(name);
+        auto &slot = _conditions[name];
+        slot.matcher = std::move(condition);
+
+        for (auto it = slot.programs.begin(); it != slot.programs.end();) {
+            if (auto program = it->lock()) {
+                if (!program->stale) {
+                    program->stale = true;
+                    _stalePrograms.push_back(program);
+                }
+                ++it;
+            } else {
+                it = slot.programs.erase(it);
+            }
+        }
+
+        if (!_stalePrograms.empty()) {
+            scheduleFlush();
+        }
     }
 
-    void Styler::rematchView(const std::shared_ptr<View> &view)
+    void Styler::scheduleFlush()
     {
-        auto it = _data.find(view);
-        if (it != _data.end()) {
-            json result;
+        if (_flushScheduled) {
+            return;
+        }
 
-            if (!it->second.json.is_array()) {
-                throw std::runtime_error("Root must be an array");
+        if (auto app = App()) {
+            _flushScheduled = true;
+            app->dispatchQueue()->dispatchAsync([callback = _flushCallback]() mutable { callback.fire(); });
+        } else {
+            flush();
+        }
+    }
+
+    void Styler::flush()
+    {
+        _flushScheduled = false;
+
+        auto programs = std::move(_stalePrograms);
+        _stalePrograms.clear();
+
+        std::vector<std::shared_ptr<View>> changedViews;
+        for (auto &weakProgram : programs) {
+            if (auto program = weakProgram.lock()) {
+                program->stale = false;
+                rematchProgram(program, changedViews);
             }
+        }
 
-            for (auto &option : it->second.json.items()) {
-                if (option.value().count("if") == 0) {
-                    result.merge_patch(option.value());
-                } else {
-                    auto &v_if = option.value().at("if");
+        if (changedViews.empty()) {
+            return;
+        }
 
-                    bool doesMatch = true;
+        LayoutUpdateBatch batch(changedViews);
+        for (auto &view : changedViews) {
+            auto it = _data.find(view);
+            if (it != _data.end()) {
+                view->stylesheet = it->second->result;
+            }
+        }
+    }
 
-                    for (auto &matches : v_if.items()) {
-                        auto matcher = _conditions.find(matches.key());
+    std::shared_ptr<Styler::RuleProgram> Styler::compile(const json &stylesheet)
+    {
+        Stylesheet source(stylesheet);
+
+        auto range = _programs.equal_range(source.hash());
+        for (auto it = range.first; it != range.second;) {
+            if (auto existing = it->second.lock()) {
+                if (existing->source == source) {
+                    return existing;
+                }
+                ++it;
+            } else {
+                it = _programs.erase(it);
+            }
+        }
+
+        if (!stylesheet.is_array()) {
+            throw std::runtime_error("Root must be an array");
+        }
 
-                        if (matcher == _conditions.end()) {
-                            throw std::runtime_error("Invalid matcher specified");
-                        }
+        auto program = std::make_shared<RuleProgram>();
+        program->source = source;
 
-                        it->second.usedMatchers.insert(matches.key());
+        for (auto &option : stylesheet) {
+            Rule rule{option, {}};
 
-                        if (!(*matcher->second)(matches.value())) {
-                            doesMatch = false;
-                        }
+            if (option.count("if") != 0) {
+                for (auto &matches : option.at("if").items()) {
+                    auto slot = _conditions.find(matches.key());
+
+                    if (slot == _conditions.end()) {
+                        throw std::runtime_error("Invalid matcher specified");
                     }
 
-                    if (doesMatch) {
-                        result.merge_patch(option.value());
+                    auto predicate = std::find_if(
+                        program->predicates.begin(), program->predicates.end(), [&](const Predicate &p) {
+                            return p.slot == &slot->second && p.argument == matches.value();
+                        });
+
+                    if (predicate == program->predicates.end()) {
+                        program->predicates.push_back(Predicate{&slot->second, matches.value()});
+                        predicate = std::prev(program->predicates.end());
                     }
+
+                    rule.predicates.push_back(std::distance(program->predicates.begin(), predicate));
                 }
             }
 
-            view->stylesheet = result;
+            program->rules.push_back(std::move(rule));
+        }
+
+        std::vector<ConditionSlot *> slots;
+        for (auto &predicate : program->predicates) {
+            if (std::find(slots.begin(), slots.end(), predicate.slot) == slots.end()) {
+                slots.push_back(predicate.slot);
+                predicate.slot->programs.push_back(program);
+            }
         }
+
+        evaluate(*program);
+
+        _programs.emplace(source.hash(), program);
+        return program;
     }
 
-    void Styler::rematchAllViews(const String &matcherName)
+    void Styler::evaluate(RuleProgram &program)
     {
-        for (auto it = _data.begin(); it != _data.end();) {
-            if (it->second.usedMatchers.find(matcherName) != it->second.usedMatchers.end()) {
-                if (auto view = it->first.lock()) {
-                    rematchView(view);
-                } else {
-                    it = _data.erase(it);
-                    continue;
+        ConditionMask mask(program.predicates.size());
+
+        for (size_t i = 0; i < program.predicates.size(); i++) {
+            auto &predicate = program.predicates[i];
+
+            if (!predicate.slot->matcher) {
+                throw std::runtime_error("Invalid matcher specified");
+            }
+
+            mask[i] = (*predicate.slot->matcher)(predicate.argument);
+        }
+
+        auto memoIt = program.memo.find(mask);
+        if (memoIt == program.memo.end()) {
+            json result;
+
+            for (auto &rule : program.rules) {
+                if (std::all_of(rule.predicates.begin(), rule.predicates.end(), [&](size_t i) { return mask[i]; })) {
+                    result.merge_patch(rule.patch);
                 }
             }
 
-            ++it;
+            memoIt = program.memo.emplace(std::move(mask), Stylesheet(std::move(result))).first;
+        }
+
+        program.result = memoIt->second;
+    }
+
+    void Styler::rematchProgram(const std::shared_ptr<RuleProgram> &program,
+                                std::vector<std::shared_ptr<View>> &changedViews)
+    {
+        auto previousResult = program->result;
+        evaluate(*program);
+
+        // Views sharing this program only need an update if the merged result actually changed
+        if (program->result == previousResult) {
+            return;
+        }
+
+        for (auto it = program->views.begin(); it != program->views.end();) {
+            if (auto view = it->lock()) {
+                changedViews.push_back(view);
+                ++it;
+            } else {
+                _data.erase(*it);
+                it = program->views.erase(it);
+            }
         }
     }
 }
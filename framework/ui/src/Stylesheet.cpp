@@ -0,0 +1,95 @@
+#include <bdn/ui/Stylesheet.h>
+
+#include <unordered_map>
+
+namespace bdn::ui
+{
+    namespace
+    {
+        class StylesheetRegistry
+        {
+            // Expired entries are only dropped lazily. Do a full sweep every so many insertions
+            // so hash buckets that are never looked up again do not pile up.
+            static constexpr size_t kSweepInterval = 1024;
+
+          public:
+            static StylesheetRegistry &get()
+            {
+                static StylesheetRegistry s_registry;
+                return s_registry;
+            }
+
+            template <class JsonType> std::shared_ptr<const detail::StylesheetData> intern(JsonType &&value)
+            {
+                auto hash = std::hash<json>{}(value);
+
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                auto range = _entries.equal_range(hash);
+                for (auto it = range.first; it != range.second;) {
+                    if (auto existing = it->second.lock()) {
+                        if (existing->value == value) {
+                            return existing;
+                        }
+                        ++it;
+                    } else {
+                        it = _entries.erase(it);
+                    }
+                }
+
+                auto data = std::make_shared<const detail::StylesheetData>(std::forward<JsonType>(value), hash);
+                _entries.emplace(hash, data);
+
+                if (++_insertionsSinceSweep >= kSweepInterval) {
+                    sweep();
+                }
+
+                return data;
+            }
+
+            size_t count()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                sweep();
+                return _entries.size();
+            }
+
+          private:
+            void sweep()
+            {
+                _insertionsSinceSweep = 0;
+
+                for (auto it = _entries.begin(); it != _entries.end();) {
+                    if (it->second.expired()) {
+                        it = _entries.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+          private:
+            std::mutex _mutex;
+            std::unordered_multimap<size_t, std::weak_ptr<const detail::StylesheetData>> _entries;
+            size_t _insertionsSinceSweep = 0;
+        };
+
+        const std::shared_ptr<const detail::StylesheetData> &emptyStylesheetData()
+        {
+            static const auto s_empty = StylesheetRegistry::get().intern(json());
+            return s_empty;
+        }
+    }
+
+    Stylesheet::Stylesheet() : _data(emptyStylesheetData()) {}
+
+    Stylesheet::Stylesheet(const json &value)
+        : _data(value.is_null() ? emptyStylesheetData() : StylesheetRegistry::get().intern(value))
+    {}
+
+    Stylesheet::Stylesheet(json &&value)
+        : _data(value.is_null() ? emptyStylesheetData() : StylesheetRegistry::get().intern(std::move(value)))
+    {}
+
+    size_t Stylesheet::internedCount() { return StylesheetRegistry::get().count(); }
+}
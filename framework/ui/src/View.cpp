@@ -4,6 +4,8 @@
 
 #include <bdn/ui/UIApplicationController.h>
 
+#include <iterator>
+#include <stdexcept>
 #include <utility>
 
 namespace bdn::ui
@@ -44,6 +46,13 @@ namespace bdn::ui
         if (auto layout = _layout.get()) {
             layout->unregisterView(this);
         }
+
+        if (_core) {
+            // The core's properties are bound back to these, resetting it must not reach this view anymore
+            visible.unbind();
+            geometry.unbind();
+            _viewCoreFactory->recycleCore(*_coreViewType, std::move(_core));
+        }
     }
 
     void View::setLayout(std::shared_ptr<Layout> layout)
@@ -73,12 +82,29 @@ namespace bdn::ui
             viewCore()->setLayout(newLayout);
         }
 
+        forEachChild([&newLayout](const std::shared_ptr<View> &child) { child->offerLayout(newLayout); });
+    }
+
+    std::shared_ptr<Layout> View::getLayout() { return _layout.get(); }
+
+    // The defaults go through childViews() so that views which only override that keep working
+    void View::forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function)
+    {
         for (const auto &child : childViews()) {
-            child->offerLayout(newLayout);
+            function(child);
         }
     }
 
-    std::shared_ptr<Layout> View::getLayout() { return _layout.get(); }
+    size_t View::childCount() { return childViews().size(); }
+
+    std::shared_ptr<View> View::childAt(size_t index)
+    {
+        auto children = childViews();
+        if (index >= children.size()) {
+            throw std::out_of_range("Child index out of range");
+        }
+        return *std::next(children.begin(), index);
+    }
 
     void View::setParentView(const std::shared_ptr<View> &parentView)
     {
@@ -101,14 +127,13 @@ namespace bdn::ui
 
     void View::updateFromStylesheet()
     {
-        if (stylesheet->count("visible")) {
-            visible = (bool)stylesheet->at("visible");
-        } else {
-            visible = true;
-        }
+        auto currentStylesheet = stylesheet.get();
+
+        auto visibleSection = currentStylesheet.section<bool>("visible");
+        visible = visibleSection ? *visibleSection : true;
 
         if (auto core = viewCore()) {
-            core->updateFromStylesheet(stylesheet.get());
+            core->updateFromStylesheet(currentStylesheet);
         }
     }
 
@@ -141,7 +166,8 @@ namespace bdn::ui
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
         auto un_const_this = const_cast<View *>(this);
 
-        _core = _viewCoreFactory->createViewCore(typeInfoForCoreCreation());
+        _coreViewType = &typeInfoForCoreCreation();
+        _core = _viewCoreFactory->createViewCore(*_coreViewType);
         un_const_this->bindViewCore();
     }
 
@@ -183,4 +209,15 @@ namespace bdn::ui
     Size View::sizeForSpace(Size availableSpace) const { return viewCore()->sizeForSpace(availableSpace); }
 
     View::Core::Core(std::shared_ptr<ViewCoreFactory> viewCoreFactory) : _viewCoreFactory(std::move(viewCoreFactory)) {}
+
+    void View::Core::resetViewCore()
+    {
+        geometry.unbind();
+        visible.unbind();
+
+        geometry = Rect{};
+        visible = false;
+
+        _layout = nullptr;
+    }
 }
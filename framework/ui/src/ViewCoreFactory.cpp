@@ -1,16 +1,147 @@
 #include <bdn/ui/ViewCoreFactory.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace bdn::ui
 {
     std::shared_ptr<View::Core> ViewCoreFactory::createViewCore(const std::type_info &viewType)
     {
-        auto core = create(viewType.name(), shared_from_this());
+        if (auto core = reclaimCore(viewType)) {
+            return core;
+        }
 
-        if (!core) {
+        auto construct = findConstructionFunction(viewType);
+
+        if (construct == nullptr) {
             throw ViewCoreTypeNotSupportedError(viewType.name());
         }
 
-        return *core;
+        return (*construct)(shared_from_this());
+    }
+
+    const ViewCoreFactory::ConstructionFunction *
+    ViewCoreFactory::findConstructionFunction(const std::type_info &viewType)
+    {
+        auto &entry = _cache[viewType.hash_code() % kCacheSize];
+
+        // type_info objects are usually unique, but may be duplicated across shared libraries
+        if (entry.viewType == &viewType || (entry.viewType != nullptr && *entry.viewType == viewType)) {
+            return entry.construct;
+        }
+
+        const ConstructionFunction *construct = nullptr;
+
+        auto it = _coreConstructors.find(std::type_index(viewType));
+        if (it != _coreConstructors.end()) {
+            construct = &it->second;
+        } else if (auto byName = constructionFunction(viewType.name())) {
+            // Registered by name only, e.g. by a plugin. Remember it under the type.
+            construct = &_coreConstructors.emplace(std::type_index(viewType), *byName).first->second;
+        } else {
+            return nullptr;
+        }
+
+        // Node based map, so pointers to its values stay valid when it grows
+        entry = CacheEntry{&viewType, construct};
+        return construct;
+    }
+
+    std::shared_ptr<View::Core> ViewCoreFactory::reclaimCore(const std::type_info &viewType)
+    {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+
+        auto &pool = _pools[std::type_index(viewType)];
+        if (pool.cores.empty()) {
+            pool.statistics.misses++;
+            return nullptr;
+        }
+
+        pool.statistics.hits++;
+        pool.statistics.parked--;
+
+        auto core = std::move(pool.cores.back());
+        pool.cores.pop_back();
+        return core;
+    }
+
+    void ViewCoreFactory::recycleCore(const std::type_info &viewType, std::shared_ptr<View::Core> core)
+    {
+        if (!core || core.use_count() != 1) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_poolMutex);
+            auto &pool = _pools[std::type_index(viewType)];
+            if (pool.cores.size() >= poolSize(pool)) {
+                return;
+            }
+        }
+
+        // Outside of the lock: resetting a container releases its children, which recycles their cores
+        if (!core->prepareForReuse()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        auto &pool = _pools[std::type_index(viewType)];
+        if (pool.cores.size() < poolSize(pool)) {
+            pool.cores.push_back(std::move(core));
+            pool.statistics.parked++;
+        }
+    }
+
+    void ViewCoreFactory::setPoolSize(const std::type_info &viewType, size_t size)
+    {
+        // Declared before the lock so that excess cores are released after it
+        std::vector<std::shared_ptr<View::Core>> released;
+
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        auto &pool = _pools[std::type_index(viewType)];
+        pool.size = size;
+        trimPool(pool, released);
+    }
+
+    void ViewCoreFactory::setDefaultPoolSize(size_t size)
+    {
+        std::vector<std::shared_ptr<View::Core>> released;
+
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        _defaultPoolSize = size;
+        for (auto &entry : _pools) {
+            trimPool(entry.second, released);
+        }
+    }
+
+    ViewCoreFactory::PoolStatistics ViewCoreFactory::poolStatistics(const std::type_info &viewType)
+    {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        auto it = _pools.find(std::type_index(viewType));
+        return it != _pools.end() ? it->second.statistics : PoolStatistics{};
+    }
+
+    void ViewCoreFactory::drainPools()
+    {
+        std::vector<std::shared_ptr<View::Core>> released;
+
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        for (auto &entry : _pools) {
+            auto &pool = entry.second;
+            std::move(pool.cores.begin(), pool.cores.end(), std::back_inserter(released));
+            pool.cores.clear();
+            pool.statistics.parked = 0;
+        }
+    }
+
+    void ViewCoreFactory::trimPool(CorePool &pool, std::vector<std::shared_ptr<View::Core>> &released)
+    {
+        size_t size = poolSize(pool);
+        while (pool.cores.size() > size) {
+            released.push_back(std::move(pool.cores.back()));
+            pool.cores.pop_back();
+        }
+        pool.statistics.parked = pool.cores.size();
     }
 
     ViewCoreFactory::ContextStack *ViewCoreFactory::contextStack()
@@ -0,0 +1,115 @@
+#include <bdn/StopWatch.h>
+#include <bdn/log.h>
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPResponse.h>
+#include <bdn/net/posix/ContentDecoder.h>
+#include <bdn/net/posix/HTTPClient.h>
+#include <bdn/net/posix/LoopbackServer.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <zlib.h>
+
+namespace bdn
+{
+    using namespace bdn::net;
+    using posix::ContentDecoder;
+    using posix::HTTPClient;
+    using posix::LoopbackServer;
+
+    namespace
+    {
+        constexpr size_t kPayloadSize = 16 * 1024 * 1024;
+        constexpr int kDecodeRounds = 10;
+        constexpr int kLargeRequests = 10;
+
+        // A JSON feed, which compresses about as well as real ones
+        std::string payload()
+        {
+            std::string json = "[";
+            for (int i = 0; json.size() < kPayloadSize; i++) {
+                json += R"({"id":)" + std::to_string(i * 7919) + R"(,"title":"Post number )" + std::to_string(i) +
+                        R"(","author":"user)" + std::to_string(i % 331) + R"(","score":)" +
+                        std::to_string(i * 31 % 1000) + "},";
+            }
+            json.back() = ']';
+            return json;
+        }
+
+        std::string compress(const std::string &data, int windowBits)
+        {
+            z_stream stream{};
+            deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+
+            std::string compressed(deflateBound(&stream, data.size()), '\0');
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+            stream.avail_in = static_cast<uInt>(data.size());
+            stream.next_out = reinterpret_cast<Bytef *>(compressed.data());
+            stream.avail_out = static_cast<uInt>(compressed.size());
+            deflate(&stream, Z_FINISH);
+            compressed.resize(stream.total_out);
+            deflateEnd(&stream);
+            return compressed;
+        }
+
+        double megabytes(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+    }
+
+    TEST(ContentDecoderBenchmark, DecodeThroughput)
+    {
+        auto json = payload();
+
+        for (auto [encoding, windowBits] : {std::pair("gzip", 31), {"deflate", 15}}) {
+            auto compressed = compress(json, windowBits);
+            size_t decodedSize = 0;
+
+            StopWatch watch;
+            for (int i = 0; i < kDecodeRounds; i++) {
+                auto decoder = ContentDecoder::create(encoding);
+                // Fed in pieces of the size the client reads from its sockets
+                for (size_t offset = 0; offset < compressed.size(); offset += 64 * 1024) {
+                    decoder->decode(compressed.data() + offset, std::min<size_t>(64 * 1024, compressed.size() - offset),
+                                    [&](const char * /*unused*/, size_t size) { decodedSize += size; });
+                }
+                EXPECT_TRUE(decoder->finished());
+            }
+            double elapsed = watch.elapsed().count();
+
+            EXPECT_EQ(decodedSize, json.size() * kDecodeRounds);
+            logstream() << encoding << ": " << megabytes(json.size()) << "MB compressed to "
+                        << megabytes(compressed.size()) << "MB, decoded at " << megabytes(decodedSize) / elapsed
+                        << "MB/s";
+        }
+    }
+
+    TEST(ContentDecoderBenchmark, LargeResponses)
+    {
+        auto json = payload();
+        auto gzipped = compress(json, 31);
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            LoopbackServer::Response response;
+            if (request.target == "/gzip") {
+                response.headerFields.emplace_back("Content-Encoding", "gzip");
+                response.body = gzipped;
+            } else {
+                response.body = json;
+            }
+            return response;
+        });
+        HTTPClient client;
+
+        for (String target : {"/identity", "/gzip"}) {
+            StopWatch watch;
+            for (int i = 0; i < kLargeRequests; i++) {
+                std::promise<std::shared_ptr<HTTPResponse>> promise;
+                client.request(HTTPRequest(server.url(target), [&](auto response) { promise.set_value(response); }));
+                EXPECT_EQ(promise.get_future().get()->data.size(), json.size());
+            }
+            double elapsed = watch.elapsed().count();
+
+            logstream() << kLargeRequests << " x " << megabytes(json.size()) << "MB " << target << ": "
+                        << elapsed * 1000.0 << "ms, " << kLargeRequests * megabytes(json.size()) / elapsed
+                        << "MB/s decoded";
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#include <bdn/StopWatch.h>
+#include <bdn/log.h>
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPResponse.h>
+#include <bdn/net/posix/HTTPClient.h>
+#include <bdn/net/posix/LoopbackServer.h>
+#include <gtest/gtest.h>
+
+#include <future>
+
+namespace bdn
+{
+    using namespace bdn::net;
+    using posix::HTTPClient;
+    using posix::LoopbackServer;
+
+    namespace
+    {
+        constexpr int kSequentialRequests = 2000;
+        constexpr int kConcurrentRequests = 10000;
+        constexpr int kLargeRequests = 20;
+        constexpr size_t kLargeBodySize = 8 * 1024 * 1024;
+
+        // Sends count requests, at most inFlight at a time, and returns the number of successful ones
+        int run(HTTPClient &client, const String &url, int count, int inFlight)
+        {
+            std::mutex mutex;
+            std::condition_variable finished;
+            int started = 0;
+            int done = 0;
+            int succeeded = 0;
+
+            std::function<void()> startNext = [&]() {
+                started++;
+                client.request(HTTPRequest(url, [&](const std::shared_ptr<HTTPResponse> &response) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done++;
+                    succeeded += response->responseCode == 200 ? 1 : 0;
+                    if (started < count) {
+                        startNext();
+                    }
+                    finished.notify_all();
+                }));
+            };
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (started < std::min(count, inFlight)) {
+                startNext();
+            }
+            finished.wait(lock, [&]() { return done == count; });
+            return succeeded;
+        }
+
+        LoopbackServer::Response smallResponse(const LoopbackServer::Request & /*unused*/)
+        {
+            LoopbackServer::Response response;
+            response.body = R"({"id":1,"title":"hello"})";
+            return response;
+        }
+    }
+
+    TEST(HTTPClientBenchmark, SequentialRequests)
+    {
+        LoopbackServer keepAliveServer(smallResponse);
+        LoopbackServer closingServer([](const LoopbackServer::Request &request) {
+            auto response = smallResponse(request);
+            response.close = true;
+            return response;
+        });
+        HTTPClient client;
+
+        StopWatch keepAliveWatch;
+        EXPECT_EQ(run(client, keepAliveServer.url("/"), kSequentialRequests, 1), kSequentialRequests);
+        double keepAlive = keepAliveWatch.elapsed().count();
+
+        StopWatch closingWatch;
+        EXPECT_EQ(run(client, closingServer.url("/"), kSequentialRequests, 1), kSequentialRequests);
+        double closing = closingWatch.elapsed().count();
+
+        logstream() << kSequentialRequests << " sequential requests, kept alive: " << keepAlive * 1000.0
+                    << "ms (" << keepAliveServer.statistics().connections
+                    << " connections), new connection each: " << closing * 1000.0 << "ms";
+
+        EXPECT_EQ(keepAliveServer.statistics().connections, 1u);
+    }
+
+    TEST(HTTPClientBenchmark, ConcurrentRequests)
+    {
+        LoopbackServer server(smallResponse);
+        HTTPClient client;
+
+        StopWatch watch;
+        EXPECT_EQ(run(client, server.url("/"), kConcurrentRequests, 64), kConcurrentRequests);
+        double elapsed = watch.elapsed().count();
+
+        logstream() << kConcurrentRequests << " requests, 64 in flight: " << elapsed * 1000.0
+                    << "ms, requests per second: " << kConcurrentRequests / elapsed
+                    << " connections: " << server.statistics().connections;
+
+        EXPECT_LE(server.statistics().connections, HTTPClient::Configuration().maxConnectionsPerHost);
+    }
+
+    TEST(HTTPClientBenchmark, LargeBodies)
+    {
+        std::string body(kLargeBodySize, 'x');
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            LoopbackServer::Response response;
+            response.body = body;
+            response.chunked = request.target == "/chunked";
+            return response;
+        });
+        HTTPClient client;
+
+        for (String target : {"/length", "/chunked"}) {
+            StopWatch watch;
+            EXPECT_EQ(run(client, server.url(target), kLargeRequests, 1), kLargeRequests);
+            double elapsed = watch.elapsed().count();
+
+            logstream() << kLargeRequests << " x " << kLargeBodySize / (1024 * 1024) << "MB " << target << ": "
+                        << elapsed * 1000.0 << "ms, "
+                        << kLargeRequests * kLargeBodySize / (1024.0 * 1024.0) / elapsed << "MB/s";
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include <bdn/Application.h>
+#include <bdn/StopWatch.h>
+#include <bdn/log.h>
+#include <bdn/net/JsonStream.h>
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <future>
+
+namespace bdn
+{
+    using namespace bdn::net;
+
+    namespace
+    {
+        constexpr size_t kFeedSize = 5 * 1024 * 1024;
+        constexpr size_t kChunkSize = 64 * 1024;
+        constexpr int kRounds = 5;
+
+        struct Post
+        {
+            String title;
+            String url;
+            String thumbnail;
+        };
+
+        // Shaped like reddit's listings: three wanted fields among many unwanted ones per post
+        std::string feed()
+        {
+            std::string json = R"({"kind":"Listing","data":{"after":"t3_x","children":[)";
+            for (int i = 0; json.size() < kFeedSize; i++) {
+                auto id = std::to_string(i);
+                json += R"({"kind":"t3","data":{"subreddit":"pics","selftext":"","author_fullname":"t2_)" + id +
+                        R"(","title":"Post number )" + id + R"( with a title of typical length","ups":)" + id +
+                        R"(,"score":)" + id + R"(,"thumbnail":"https://b.thumbs.redditmedia.com/)" + id +
+                        R"(.jpg","preview":{"images":[{"source":{"url":"https://preview.redd.it/)" + id +
+                        R"(.jpg","width":640,"height":480},"resolutions":[{"width":108,"height":81},)"
+                        R"({"width":216,"height":162}]}],"enabled":true},"over_18":false,"num_comments":12,)"
+                        R"("url":"https://i.redd.it/)" + id + R"(.jpg","created_utc":1546300800.0}},)";
+            }
+            json.back() = ']';
+            json += "}}";
+            return json;
+        }
+
+        size_t parseDom(const std::string &body)
+        {
+            std::vector<Post> posts;
+            auto document = nlohmann::json::parse(body);
+            for (auto &child : document["data"]["children"]) {
+                auto &data = child["data"];
+                posts.push_back(Post{data["title"], data["url"], data["thumbnail"]});
+            }
+            return posts.size();
+        }
+    }
+
+    TEST(JsonStreamBenchmark, CompareWithDomOnFeed)
+    {
+        auto body = feed();
+
+        JsonStream<Post> stream("/data/children/*/data");
+        stream.field("/title", &Post::title).field("/url", &Post::url).field("/thumbnail", &Post::thumbnail);
+
+        double dom = 0.0;
+        double streamed = 0.0;
+        double mainThread = 0.0;
+        size_t domPosts = 0;
+        size_t streamedPosts = 0;
+
+        for (int round = 0; round < kRounds; round++) {
+            StopWatch domWatch;
+            domPosts = parseDom(body);
+            dom += domWatch.elapsed().count();
+
+            // Chunks are passed as a backend would while the body arrives, the done handler once it is complete
+            std::promise<void> done;
+            std::vector<Post> posts;
+            StopWatch streamWatch;
+            auto request = stream.prepare(
+                HTTPRequest("http://localhost/hot.json", nullptr),
+                [&](std::vector<Post> batch) {
+                    StopWatch batchWatch;
+                    posts.insert(posts.end(), std::make_move_iterator(batch.begin()),
+                                 std::make_move_iterator(batch.end()));
+                    mainThread += batchWatch.elapsed().count();
+                },
+                [&](auto, auto parseError) {
+                    EXPECT_EQ(parseError, std::nullopt);
+                    done.set_value();
+                });
+            for (size_t offset = 0; offset < body.size(); offset += kChunkSize) {
+                request.dataHandler(asBytes(body.data() + offset, std::min(kChunkSize, body.size() - offset)));
+            }
+            App()->dispatchQueue()->dispatchAsync(
+                [request]() { request.doneHandler(std::make_shared<HTTPResponse>()); });
+            done.get_future().wait();
+            streamed += streamWatch.elapsed().count();
+            streamedPosts = posts.size();
+        }
+
+        EXPECT_EQ(streamedPosts, domPosts);
+        logstream() << body.size() / (1024 * 1024) << "MB feed, " << domPosts << " posts. DOM on the main thread: "
+                    << dom / kRounds * 1000.0 << "ms, JsonStream: " << streamed / kRounds * 1000.0
+                    << "ms of which " << mainThread / kRounds * 1000.0 << "ms on the main thread";
+    }
+}
@@ -0,0 +1,153 @@
+#include "../boden/FakeContainerCore.h"
+#include <bdn/Application.h>
+#include <bdn/StopWatch.h>
+#include <bdn/log.h>
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/ViewCoreFactory.h>
+#include <bdn/ui/yoga.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+
+    namespace
+    {
+        constexpr int kCellsPerRow = 24;
+        constexpr int kIterations = 20;
+        constexpr std::chrono::microseconds kMeasureTime{5};
+
+        class BenchmarkContainerCore : public FakeContainerCore
+        {
+          public:
+            using FakeContainerCore::FakeContainerCore;
+
+            // Stands in for text measurement, which dominates real layouts
+            Size sizeForSpace(Size /*availableSize*/) const override
+            {
+                auto end = std::chrono::steady_clock::now() + kMeasureTime;
+                while (std::chrono::steady_clock::now() < end) {
+                }
+                return Size{12, 10};
+            }
+        };
+
+        struct Scene
+        {
+            std::shared_ptr<ContainerView> root;
+            std::vector<std::shared_ptr<ContainerView>> rows;
+            std::vector<std::shared_ptr<ContainerView>> cells;
+        };
+
+        Scene buildScene(const std::shared_ptr<yoga::Layout> &layout, int rowCount)
+        {
+            auto factory = std::make_shared<ViewCoreFactory>();
+            factory->registerCoreType<BenchmarkContainerCore, ContainerView>();
+
+            Scene scene;
+            scene.root = std::make_shared<ContainerView>(factory);
+            scene.root->geometry = Rect{0, 0, 400, 60.0 * rowCount};
+            scene.root->setLayout(layout);
+
+            for (int r = 0; r < rowCount; r++) {
+                auto row = std::make_shared<ContainerView>(factory);
+                row->stylesheet =
+                    FlexJsonStringify({"direction" : "Row", "flexWrap" : "Wrap", "size" : {"height" : 60.0}});
+                scene.root->addChildView(row);
+                row->isLayoutRoot = true;
+                row->geometry = Rect{0, 60.0 * r, 400, 60};
+
+                for (int c = 0; c < kCellsPerRow; c++) {
+                    auto cell = std::make_shared<ContainerView>(factory);
+                    cell->stylesheet = FlexJsonStringify({"flexGrow" : 1.0, "margin" : {"all" : 2.0}});
+                    row->addChildView(cell);
+                    scene.cells.push_back(cell);
+                }
+
+                scene.rows.push_back(row);
+            }
+
+            return scene;
+        }
+
+        // Every cell changes its content, so every cell has to be measured again
+        void dirtyAllCells(const std::shared_ptr<yoga::Layout> &layout, const Scene &scene)
+        {
+            for (auto &cell : scene.cells) {
+                layout->markDirty(cell.get());
+            }
+        }
+
+        double runSequential(int rowCount)
+        {
+            auto layout = std::make_shared<yoga::Layout>();
+            auto scene = buildScene(layout, rowCount);
+
+            StopWatch watch;
+            for (int i = 0; i < kIterations; i++) {
+                dirtyAllCells(layout, scene);
+                for (auto &row : scene.rows) {
+                    layout->layout(row.get());
+                }
+            }
+            return watch.elapsed().count();
+        }
+
+        double runCoordinated(int rowCount, size_t workerCount)
+        {
+            auto coordinator = std::make_shared<yoga::LayoutCoordinator>(workerCount, true);
+            auto layout = std::make_shared<yoga::Layout>(coordinator);
+            auto scene = buildScene(layout, rowCount);
+
+            // The first pass teaches the measurement caches which constraints yoga asks for
+            for (auto &row : scene.rows) {
+                layout->layout(row.get());
+            }
+            coordinator->flush();
+
+            StopWatch watch;
+            for (int i = 0; i < kIterations; i++) {
+                dirtyAllCells(layout, scene);
+                for (auto &row : scene.rows) {
+                    layout->layout(row.get());
+                }
+                coordinator->flush();
+            }
+            return watch.elapsed().count();
+        }
+    }
+
+    TEST(LayoutCoordinatorBenchmark, ScalesWithNumberOfRoots)
+    {
+        size_t hardwareThreads = std::thread::hardware_concurrency();
+
+        for (int rowCount : {1, 8, 32, 128, 512}) {
+            double sequential = 0.0;
+            double singleWorker = 0.0;
+            double allWorkers = 0.0;
+
+            // Layout and flushing are main thread business
+            App()->dispatchQueue()->dispatchSync([&]() {
+                sequential = runSequential(rowCount);
+                singleWorker = runCoordinated(rowCount, 1);
+                allWorkers = runCoordinated(rowCount, 0);
+            });
+
+            logstream() << "layout roots: " << rowCount << " sequential: " << sequential * 1000.0 / kIterations
+                        << "ms/frame one worker: " << singleWorker * 1000.0 / kIterations
+                        << "ms/frame " << hardwareThreads << " workers: " << allWorkers * 1000.0 / kIterations
+                        << "ms/frame";
+
+            EXPECT_GT(sequential, 0.0);
+
+            // A coordinator that runs its roots one after another does not get faster with more workers
+            if (hardwareThreads >= 2 && rowCount >= 32) {
+                EXPECT_LT(allWorkers, singleWorker * 0.8) << rowCount << " roots";
+            }
+        }
+    }
+}
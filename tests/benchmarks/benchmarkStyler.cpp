@@ -0,0 +1,65 @@
+#include <bdn/Application.h>
+#include <bdn/StopWatch.h>
+#include <bdn/log.h>
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/Styler.h>
+#include <gtest/gtest.h>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+
+    namespace
+    {
+        constexpr int kViewCount = 2000;
+        constexpr int kIterations = 50;
+
+        json styleForIndex(int index)
+        {
+            // Every tenth view reacts to the window width, the rest only to the platform
+            if (index % 10 == 0) {
+                return JsonStringify([
+                    {"flex" : {"flexGrow" : 1.0}},
+                    {"if" : {"max-width" : 600}, "flex" : {"direction" : "Column"}},
+                    {"if" : {"os" : "linux"}, "flex" : {"margin" : {"all" : 2.0}}}
+                ]);
+            }
+            return JsonStringify([ {"flex" : {"flexGrow" : 1.0}}, {"if" : {"os" : "linux"}, "visible" : true} ]);
+        }
+    }
+
+    TEST(StylerBenchmark, WindowSizeFlip)
+    {
+        int changedViews = 0;
+        double elapsed = 0.0;
+
+        // The styler applies condition changes on the main queue
+        App()->dispatchQueue()->dispatchSync([&]() {
+            Styler styler;
+            styler.setCondition("os", std::make_shared<Styler::equals_condition>("linux"));
+            styler.setCondition("max-width", std::make_shared<Styler::less_condition>(400));
+
+            std::vector<std::shared_ptr<ContainerView>> views;
+            views.reserve(kViewCount);
+
+            for (int i = 0; i < kViewCount; i++) {
+                auto view = std::make_shared<ContainerView>();
+                styler.setStyleSheet(view, styleForIndex(i));
+                view->stylesheet.onChange() += [&](auto & /*unused*/) { changedViews++; };
+                views.push_back(view);
+            }
+
+            StopWatch watch;
+            for (int i = 0; i < kIterations; i++) {
+                styler.setCondition("max-width", std::make_shared<Styler::less_condition>(i % 2 == 0 ? 800 : 400));
+                styler.flush();
+            }
+            elapsed = watch.elapsed().count();
+
+            logstream() << "styled views: " << kViewCount << " changed per flip: " << changedViews / kIterations
+                        << " time per flip: " << elapsed * 1000.0 / kIterations << "ms";
+        });
+
+        EXPECT_EQ(changedViews, kIterations * kViewCount / 10);
+    }
+}
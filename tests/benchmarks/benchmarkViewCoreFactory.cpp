@@ -0,0 +1,50 @@
+#include "../boden/FakeContainerCore.h"
+#include <bdn/StopWatch.h>
+#include <bdn/log.h>
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/ViewCoreFactory.h>
+#include <gtest/gtest.h>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+
+    namespace
+    {
+        constexpr int kViewCount = 100000;
+    }
+
+    TEST(ViewCoreFactoryBenchmark, CreateViews)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+        factory->registerCoreType<FakeContainerCore, ContainerView>();
+
+        // Lookup by type name, as createViewCore used to do
+        StopWatch byNameWatch;
+        for (int i = 0; i < kViewCount; i++) {
+            auto core = factory->create(typeid(ContainerView).name(), factory);
+            ASSERT_TRUE(core.has_value());
+        }
+        double byName = byNameWatch.elapsed().count();
+
+        StopWatch byTypeWatch;
+        for (int i = 0; i < kViewCount; i++) {
+            auto core = factory->createViewCore(typeid(ContainerView));
+            ASSERT_NE(core, nullptr);
+        }
+        double byType = byTypeWatch.elapsed().count();
+
+        StopWatch viewsWatch;
+        for (int i = 0; i < kViewCount; i++) {
+            auto view = std::make_shared<ContainerView>(factory);
+            ASSERT_NE(view->viewCore(), nullptr);
+        }
+        double views = viewsWatch.elapsed().count();
+
+        logstream() << kViewCount << " cores by name: " << byName * 1000.0 << "ms by type: " << byType * 1000.0
+                    << "ms, " << kViewCount << " views: " << views * 1000.0 << "ms";
+
+        EXPECT_GT(byName, 0.0);
+        EXPECT_GT(byType, 0.0);
+    }
+}
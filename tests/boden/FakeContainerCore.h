@@ -0,0 +1,43 @@
+#pragma once
+
+#include <bdn/ui/ContainerView.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace bdn
+{
+    /** Platform independent core for views and containers, for tests and benchmarks that only
+        exercise the framework side. It keeps track of its children but does nothing else. */
+    class FakeContainerCore : public ui::View::Core, public ui::ContainerView::Core
+    {
+      public:
+        using ui::View::Core::Core;
+
+        void init() override { initialized = true; }
+        bool canMoveToParentView(std::shared_ptr<ui::View> /*unused*/) const override { return true; }
+        void scheduleLayout() override {}
+
+        void addChildView(std::shared_ptr<ui::View> child) override { _children.push_back(child); }
+        void removeChildView(std::shared_ptr<ui::View> child) override
+        {
+            _children.erase(std::remove(_children.begin(), _children.end(), child), _children.end());
+        }
+        std::list<std::shared_ptr<ui::View>> childViews() override { return {_children.begin(), _children.end()}; }
+
+        void forEachChild(const std::function<void(const std::shared_ptr<ui::View> &)> &function) override
+        {
+            for (const auto &child : _children) {
+                function(child);
+            }
+        }
+        size_t childCount() override { return _children.size(); }
+        std::shared_ptr<ui::View> childAt(size_t index) override { return _children.at(index); }
+
+      public:
+        bool initialized = false;
+
+      private:
+        std::vector<std::shared_ptr<ui::View>> _children;
+    };
+}
@@ -0,0 +1,176 @@
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPResponse.h>
+#include <bdn/net/posix/ContentDecoder.h>
+#include <bdn/net/posix/HTTPClient.h>
+#include <bdn/net/posix/LoopbackServer.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <optional>
+#include <zlib.h>
+
+namespace bdn
+{
+    using namespace bdn::net;
+    using posix::ContentDecoder;
+    using posix::HTTPClient;
+    using posix::LoopbackServer;
+
+    namespace
+    {
+        // windowBits as for deflateInit2(): 31 for gzip, 15 for zlib wrapped and -15 for raw deflate data
+        std::string compress(const std::string &data, int windowBits)
+        {
+            z_stream stream{};
+            deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+
+            std::string compressed(deflateBound(&stream, data.size()), '\0');
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+            stream.avail_in = static_cast<uInt>(data.size());
+            stream.next_out = reinterpret_cast<Bytef *>(compressed.data());
+            stream.avail_out = static_cast<uInt>(compressed.size());
+            deflate(&stream, Z_FINISH);
+            compressed.resize(stream.total_out);
+            deflateEnd(&stream);
+            return compressed;
+        }
+
+        // Decodes data in pieces of pieceSize bytes, returns std::nullopt if the decoder fails
+        std::optional<std::string> decode(ContentDecoder &decoder, const std::string &data, size_t pieceSize)
+        {
+            std::string decoded;
+            auto output = [&](const char *piece, size_t size) {
+                EXPECT_LE(size, ContentDecoder::kOutputSize);
+                decoded.append(piece, size);
+            };
+
+            for (size_t offset = 0; offset < data.size(); offset += pieceSize) {
+                if (!decoder.decode(data.data() + offset, std::min(pieceSize, data.size() - offset), output)) {
+                    return std::nullopt;
+                }
+            }
+            return decoded;
+        }
+
+        std::string sampleText()
+        {
+            std::string text;
+            for (int i = 0; i < 20000; i++) {
+                text += "{\"id\":" + std::to_string(i) + ",\"title\":\"post " + std::to_string(i * 7) + "\"},";
+            }
+            return text;
+        }
+    }
+
+    TEST(ContentDecoder, DecodesGzipAndDeflateInAnyPieces)
+    {
+        auto text = sampleText();
+
+        for (auto [encoding, windowBits] : {std::pair("gzip", 31), {"x-gzip", 31}, {"deflate", 15}, {"deflate", -15}}) {
+            auto compressed = compress(text, windowBits);
+            for (size_t pieceSize : {size_t(1), size_t(1000), compressed.size()}) {
+                auto decoder = ContentDecoder::create(encoding);
+                ASSERT_NE(decoder, nullptr);
+                EXPECT_EQ(decode(*decoder, compressed, pieceSize), text) << encoding << " " << windowBits;
+                EXPECT_TRUE(decoder->finished());
+            }
+        }
+    }
+
+    TEST(ContentDecoder, DecodesConcatenatedGzipMembers)
+    {
+        auto decoder = ContentDecoder::create("GZIP");
+        EXPECT_EQ(decode(*decoder, compress("first ", 31) + compress("second", 31), 7), "first second");
+        EXPECT_TRUE(decoder->finished());
+    }
+
+    TEST(ContentDecoder, DetectsCorruptAndTruncatedData)
+    {
+        auto compressed = compress(sampleText(), 31);
+
+        auto truncated = ContentDecoder::create("gzip");
+        EXPECT_TRUE(decode(*truncated, compressed.substr(0, compressed.size() / 2), 512).has_value());
+        EXPECT_FALSE(truncated->finished());
+
+        auto corrupt = ContentDecoder::create("gzip");
+        compressed[compressed.size() / 2] ^= 0x55;
+        compressed[compressed.size() / 2 + 1] ^= 0x55;
+        EXPECT_FALSE(decode(*corrupt, compressed, 512).has_value());
+
+        auto trailingData = ContentDecoder::create("deflate");
+        EXPECT_FALSE(decode(*trailingData, compress("text", 15) + "garbage", 100).has_value());
+
+        EXPECT_EQ(ContentDecoder::create("compress"), nullptr);
+        EXPECT_EQ(ContentDecoder::create("gzip, deflate"), nullptr);
+        EXPECT_EQ(ContentDecoder::create("identity"), nullptr);
+    }
+
+    TEST(ContentDecoder, DecodesBrotliIfAvailable)
+    {
+        auto decoder = ContentDecoder::create("br");
+        if (!decoder) {
+            EXPECT_EQ(ContentDecoder::acceptEncoding(), "gzip, deflate");
+            return;
+        }
+        EXPECT_EQ(ContentDecoder::acceptEncoding(), "gzip, deflate, br");
+
+        const char compressed[] = "\x1b\x26\x00\xf8\x1d\x09\x76\x0c\xb1\x0d\x0a\x44\xec\xaa\x85\xc2\xdc\xe4\x24\x08"
+                                  "\x0b\x5d\x93\xa5\xb1\xbd\xc9\x41\x4c\xd1\x27\x05\x70\x20\x8d\xc1\x9f\x29\x06\x03";
+        auto decoded = decode(*decoder, std::string(compressed, sizeof(compressed) - 1), 3);
+        EXPECT_EQ(decoded, "Brotli, Brotli, Brotli and Brotli again");
+        EXPECT_TRUE(decoder->finished());
+    }
+
+    TEST(ContentDecoder, HTTPClientDecodesNegotiatedEncodings)
+    {
+        auto text = sampleText();
+        auto gzipped = compress(text, 31);
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            LoopbackServer::Response response;
+            response.headerFields.emplace_back("X-Accept-Encoding", request.headerField("Accept-Encoding"));
+            response.headerFields.emplace_back("Content-Encoding", "gzip");
+            response.body = gzipped;
+            response.chunked = request.target == "/chunked";
+            if (request.target == "/corrupt") {
+                response.body.resize(response.body.size() / 2);
+            }
+            return response;
+        });
+        HTTPClient client;
+
+        auto fetch = [&](HTTPRequest request) {
+            auto promise = std::make_shared<std::promise<std::shared_ptr<HTTPResponse>>>();
+            auto future = promise->get_future();
+            request.doneHandler = [promise](auto response) { promise->set_value(response); };
+            client.request(std::move(request));
+            return future.get();
+        };
+
+        for (String target : {"/length", "/chunked"}) {
+            auto response = fetch(HTTPRequest(server.url(target), nullptr));
+            EXPECT_EQ(response->responseCode, 200);
+            EXPECT_EQ(response->data, text);
+            EXPECT_EQ(response->header.get("X-Accept-Encoding"), ContentDecoder::acceptEncoding());
+            EXPECT_FALSE(response->header.contains("Content-Encoding"));
+            EXPECT_FALSE(response->header.contains("Content-Length"));
+        }
+
+        // Decoded chunks are streamed as they arrive
+        std::string streamed;
+        HTTPRequest streaming(server.url("/length"), nullptr);
+        streaming.dataHandler = [&](ByteSpan chunk) {
+            streamed.append(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+        };
+        EXPECT_EQ(fetch(streaming)->responseCode, 200);
+        EXPECT_EQ(streamed, text);
+
+        // Requests that negotiate themselves get the body as it was sent
+        HTTPRequest raw(server.url("/length"), nullptr);
+        raw.header.add("Accept-Encoding", "gzip");
+        auto rawResponse = fetch(raw);
+        EXPECT_EQ(rawResponse->data, gzipped);
+        EXPECT_EQ(rawResponse->header.get("Content-Encoding"), "gzip");
+
+        EXPECT_EQ(fetch(HTTPRequest(server.url("/corrupt"), nullptr))->responseCode, 0);
+    }
+}
@@ -0,0 +1,292 @@
+#include <bdn/net/HTTPCache.h>
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPResponse.h>
+#include <bdn/net/posix/HTTPClient.h>
+#include <bdn/net/posix/LoopbackServer.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <dirent.h>
+#include <future>
+#include <unistd.h>
+
+namespace bdn
+{
+    using namespace bdn::net;
+    using posix::HTTPClient;
+    using posix::LoopbackServer;
+
+    namespace
+    {
+        using ResponsePtr = std::shared_ptr<HTTPResponse>;
+
+        HTTPCache::Configuration sendingThrough(HTTPClient &client)
+        {
+            HTTPCache::Configuration configuration;
+            configuration.transport = [&client](HTTPRequest request) { return client.request(std::move(request)); };
+            return configuration;
+        }
+
+        ResponsePtr fetch(HTTPCache &cache, HTTPRequest request)
+        {
+            auto promise = std::make_shared<std::promise<ResponsePtr>>();
+            auto future = promise->get_future();
+            request.doneHandler = [promise](ResponsePtr response) { promise->set_value(response); };
+            cache.request(std::move(request));
+            return future.get();
+        }
+
+        ResponsePtr fetch(HTTPCache &cache, const String &url) { return fetch(cache, HTTPRequest(url, nullptr)); }
+
+        LoopbackServer::Response cacheable(const String &body, const String &cacheControl)
+        {
+            LoopbackServer::Response response;
+            response.headerFields.emplace_back("Cache-Control", cacheControl);
+            response.body = body;
+            return response;
+        }
+
+        class TemporaryDirectory
+        {
+          public:
+            TemporaryDirectory()
+            {
+                char path[] = "/tmp/bdnHTTPCacheXXXXXX";
+                _path = ::mkdtemp(path);
+            }
+
+            ~TemporaryDirectory()
+            {
+                if (DIR *directory = ::opendir(_path.c_str())) {
+                    while (auto entry = ::readdir(directory)) {
+                        ::unlink((_path + "/" + entry->d_name).c_str());
+                    }
+                    ::closedir(directory);
+                }
+                ::rmdir(_path.c_str());
+            }
+
+            const String &path() const { return _path; }
+
+          private:
+            String _path;
+        };
+    }
+
+    TEST(HTTPCache, FreshResponsesComeFromMemory)
+    {
+        LoopbackServer server([](const LoopbackServer::Request &request) {
+            return cacheable("body of " + request.target, "max-age=60");
+        });
+        HTTPClient client;
+        HTTPCache cache(sendingThrough(client));
+
+        EXPECT_EQ(fetch(cache, server.url("/a"))->data, "body of /a");
+        auto response = fetch(cache, server.url("/a#fragment"));
+        EXPECT_EQ(response->responseCode, 200);
+        EXPECT_EQ(response->data, "body of /a");
+        EXPECT_EQ(response->header.get("Cache-Control"), "max-age=60");
+
+        std::string streamed;
+        HTTPRequest request(server.url("/a"), nullptr);
+        request.dataHandler = [&](ByteSpan chunk) {
+            streamed.append(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+        };
+        EXPECT_TRUE(fetch(cache, request)->data.empty());
+        EXPECT_EQ(streamed, "body of /a");
+
+        EXPECT_EQ(server.statistics().requests, 1u);
+        EXPECT_EQ(cache.statistics().misses, 1u);
+        EXPECT_EQ(cache.statistics().hits, 2u);
+        EXPECT_EQ(cache.statistics().bytesSaved, 2 * String("body of /a").size());
+        EXPECT_GT(cache.statistics().memorySize, 0u);
+    }
+
+    TEST(HTTPCache, RevalidatesStaleResponses)
+    {
+        const String lastModified = "Sun, 06 Nov 1994 08:49:37 GMT";
+        std::vector<String> conditions;
+
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            auto condition = request.target == "/etag" ? request.headerField("If-None-Match")
+                                                        : request.headerField("If-Modified-Since");
+            conditions.push_back(condition);
+
+            auto response = cacheable("body of " + request.target, "max-age=0");
+            if (request.target == "/etag") {
+                response.headerFields.emplace_back("ETag", "\"v1\"");
+            } else {
+                response.headerFields.emplace_back("Last-Modified", lastModified);
+            }
+            if (!condition.empty()) {
+                response.responseCode = 304;
+                response.headerFields.emplace_back("X-Revalidated", "yes");
+                response.body.clear();
+            }
+            return response;
+        });
+        HTTPClient client;
+        HTTPCache cache(sendingThrough(client));
+
+        for (String target : {"/etag", "/dated"}) {
+            EXPECT_EQ(fetch(cache, server.url(target))->data, "body of " + target);
+            auto response = fetch(cache, server.url(target));
+            EXPECT_EQ(response->responseCode, 200);
+            EXPECT_EQ(response->data, "body of " + target);
+            EXPECT_EQ(response->header.get("X-Revalidated"), "yes");
+        }
+
+        EXPECT_EQ(conditions, (std::vector<String>{"", "\"v1\"", "", lastModified}));
+        EXPECT_EQ(cache.statistics().revalidations, 2u);
+        EXPECT_EQ(cache.statistics().notModified, 2u);
+        EXPECT_EQ(cache.statistics().hits, 0u);
+    }
+
+    TEST(HTTPCache, ServesStaleResponsesWhileRevalidating)
+    {
+        std::atomic<int> version{0};
+        LoopbackServer server([&](const LoopbackServer::Request &) {
+            return cacheable("v" + std::to_string(++version), "max-age=0, stale-while-revalidate=60");
+        });
+        HTTPClient client;
+        HTTPCache cache(sendingThrough(client));
+
+        EXPECT_EQ(fetch(cache, server.url("/"))->data, "v1");
+        EXPECT_EQ(fetch(cache, server.url("/"))->data, "v1");
+
+        // The response of the background revalidation replaces the stored one
+        String data = "v1";
+        for (int i = 0; i < 1000 && data == "v1"; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            data = fetch(cache, server.url("/"))->data;
+        }
+        EXPECT_NE(data, "v1");
+        EXPECT_GE(cache.statistics().hits, 2u);
+        EXPECT_EQ(cache.statistics().misses, 1u);
+    }
+
+    TEST(HTTPCache, ExpiresAndHeuristicFreshness)
+    {
+        char inOneHour[64];
+        auto time = std::time(nullptr) + 3600;
+        std::tm parts{};
+        std::strftime(inOneHour, sizeof(inOneHour), "%a, %d %b %Y %H:%M:%S GMT", ::gmtime_r(&time, &parts));
+
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            LoopbackServer::Response response;
+            if (request.target == "/future") {
+                response.headerFields.emplace_back("Expires", inOneHour);
+            } else if (request.target == "/past") {
+                response.headerFields.emplace_back("Expires", "0");
+            } else {
+                response.headerFields.emplace_back("Last-Modified", "Sun Nov  6 08:49:37 1994");
+            }
+            return response;
+        });
+        HTTPClient client;
+        HTTPCache cache(sendingThrough(client));
+
+        for (String target : {"/future", "/past", "/lastModified"}) {
+            fetch(cache, server.url(target));
+            fetch(cache, server.url(target));
+        }
+
+        EXPECT_EQ(server.statistics().requests, 4u);
+        EXPECT_EQ(cache.statistics().hits, 2u);
+    }
+
+    TEST(HTTPCache, DiskTierOutlivesTheCache)
+    {
+        TemporaryDirectory directory;
+        std::string large(256 * 1024, 'x');
+        LoopbackServer server([&](const LoopbackServer::Request &) { return cacheable(large, "max-age=60"); });
+        HTTPClient client;
+
+        auto configuration = sendingThrough(client);
+        configuration.directory = directory.path() + "/responses";
+        configuration.memoryCapacity = 0;
+
+        {
+            HTTPCache cache(configuration);
+            EXPECT_EQ(fetch(cache, server.url("/large"))->data, large);
+            EXPECT_EQ(cache.statistics().memorySize, 0u);
+            EXPECT_GT(cache.statistics().diskSize, large.size());
+        }
+
+        HTTPCache cache(configuration);
+        EXPECT_GT(cache.statistics().diskSize, large.size());
+        EXPECT_EQ(fetch(cache, server.url("/large"))->data, large);
+        EXPECT_EQ(fetch(cache, server.url("/large"))->data, large);
+        EXPECT_EQ(cache.statistics().hits, 2u);
+        EXPECT_EQ(server.statistics().requests, 1u);
+
+        cache.clear();
+        EXPECT_EQ(cache.statistics().diskSize, 0u);
+        EXPECT_EQ(fetch(cache, server.url("/large"))->data, large);
+        EXPECT_EQ(server.statistics().requests, 2u);
+    }
+
+    TEST(HTTPCache, NoStoreVaryAndUnsafeMethods)
+    {
+        LoopbackServer server([](const LoopbackServer::Request &request) {
+            if (request.target == "/private") {
+                return cacheable("secret", "no-store");
+            }
+            auto response = cacheable(request.method + " " + request.headerField("Accept-Language"), "max-age=60");
+            response.headerFields.emplace_back("Vary", "Accept-Language");
+            return response;
+        });
+        HTTPClient client;
+        HTTPCache cache(sendingThrough(client));
+
+        fetch(cache, server.url("/private"));
+        fetch(cache, server.url("/private"));
+        EXPECT_EQ(server.statistics().requests, 2u);
+
+        auto fetchIn = [&](const String &language, http::Method method = http::Method::GET) {
+            HTTPRequest request(method, server.url("/item"), nullptr);
+            request.header.add("Accept-Language", language);
+            return fetch(cache, request)->data;
+        };
+        EXPECT_EQ(fetchIn("de"), "GET de");
+        EXPECT_EQ(fetchIn("de"), "GET de");
+        EXPECT_EQ(fetchIn("en"), "GET en");
+        EXPECT_EQ(server.statistics().requests, 4u);
+
+        EXPECT_EQ(fetchIn("en"), "GET en");
+        EXPECT_EQ(fetchIn("en", http::Method::POST), "POST en");
+        EXPECT_EQ(fetchIn("en"), "GET en");
+        EXPECT_EQ(server.statistics().requests, 6u);
+
+        // Safe methods leave the stored response alone
+        EXPECT_EQ(fetchIn("en", http::Method::OPTIONS), "OPTIONS en");
+        EXPECT_EQ(fetchIn("en"), "GET en");
+        EXPECT_EQ(server.statistics().requests, 7u);
+    }
+
+    TEST(HTTPCache, EvictsLeastRecentlyUsedResponses)
+    {
+        LoopbackServer server([](const LoopbackServer::Request &) {
+            return cacheable(std::string(1000, 'x'), "max-age=60");
+        });
+        HTTPClient client;
+
+        auto configuration = sendingThrough(client);
+        configuration.memoryCapacity = 2500;
+        HTTPCache cache(configuration);
+
+        fetch(cache, server.url("/a"));
+        fetch(cache, server.url("/b"));
+        fetch(cache, server.url("/a"));
+        fetch(cache, server.url("/c"));
+        EXPECT_EQ(server.statistics().requests, 3u);
+
+        fetch(cache, server.url("/a"));
+        EXPECT_EQ(server.statistics().requests, 3u);
+        fetch(cache, server.url("/b"));
+        EXPECT_EQ(server.statistics().requests, 4u);
+        EXPECT_LE(cache.statistics().memorySize, configuration.memoryCapacity);
+    }
+}
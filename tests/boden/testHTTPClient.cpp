@@ -0,0 +1,545 @@
+#include <bdn/net/HTTPObserver.h>
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPRequestHandle.h>
+#include <bdn/net/HTTPResponse.h>
+#include <bdn/net/posix/HTTPClient.h>
+#include <bdn/net/posix/LoopbackServer.h>
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace bdn
+{
+    using namespace bdn::net;
+    using posix::HTTPClient;
+    using posix::LoopbackServer;
+
+    namespace
+    {
+        using ResponsePtr = std::shared_ptr<HTTPResponse>;
+
+        LoopbackServer::Response echoTarget(const LoopbackServer::Request &request)
+        {
+            LoopbackServer::Response response;
+            response.headerFields.emplace_back("Content-Type", "text/plain");
+            response.body = request.method + " " + request.target;
+            return response;
+        }
+
+        ResponsePtr fetch(HTTPClient &client, HTTPRequest request)
+        {
+            auto promise = std::make_shared<std::promise<ResponsePtr>>();
+            auto future = promise->get_future();
+            request.doneHandler = [promise](ResponsePtr response) { promise->set_value(response); };
+            client.request(std::move(request));
+            return future.get();
+        }
+
+        ResponsePtr fetch(HTTPClient &client, const String &url) { return fetch(client, HTTPRequest(url, nullptr)); }
+
+        std::vector<ResponsePtr> fetchAll(HTTPClient &client, const std::vector<String> &urls)
+        {
+            std::vector<std::future<ResponsePtr>> futures;
+            for (auto &url : urls) {
+                auto promise = std::make_shared<std::promise<ResponsePtr>>();
+                futures.push_back(promise->get_future());
+                client.request(HTTPRequest(url, [promise](ResponsePtr response) { promise->set_value(response); }));
+            }
+
+            std::vector<ResponsePtr> responses;
+            for (auto &future : futures) {
+                responses.push_back(future.get());
+            }
+            return responses;
+        }
+
+        // Holds up the server's thread in the handler until release() is called
+        class Gate
+        {
+          public:
+            void wait()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _entered = true;
+                _changed.notify_all();
+                _changed.wait(lock, [this]() { return _released; });
+            }
+
+            void waitUntilEntered()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _changed.wait(lock, [this]() { return _entered; });
+            }
+
+            void release()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _released = true;
+                _changed.notify_all();
+            }
+
+          private:
+            std::mutex _mutex;
+            std::condition_variable _changed;
+            bool _entered = false;
+            bool _released = false;
+        };
+
+        class RecordingObserver : public HTTPObserver
+        {
+          public:
+            void requestStarted(const HTTPRequest &request) override
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                started.push_back(request.url);
+            }
+
+            void requestFinished(const HTTPResponse &response) override
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                finished.push_back(response);
+                _changed.notify_all();
+            }
+
+            void waitForFinished(size_t count)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _changed.wait(lock, [&]() { return finished.size() >= count; });
+            }
+
+          public:
+            std::vector<String> started;
+            std::vector<HTTPResponse> finished;
+
+          private:
+            std::mutex _mutex;
+            std::condition_variable _changed;
+        };
+    }
+
+    TEST(HTTPClient, ContentLengthAndChunkedBodies)
+    {
+        std::string large(200 * 1024, 'x');
+        for (size_t i = 0; i < large.size(); i += 1000) {
+            large[i] = static_cast<char>('a' + i % 26);
+        }
+
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            LoopbackServer::Response response;
+            response.body = large;
+            response.chunked = request.target == "/chunked";
+            return response;
+        });
+        HTTPClient client;
+
+        for (String target : {"/plain", "/chunked"}) {
+            auto response = fetch(client, server.url(target));
+            EXPECT_EQ(response->responseCode, 200);
+            EXPECT_EQ(response->url, server.url(target));
+            EXPECT_EQ(response->data, large);
+        }
+
+        auto response = fetch(client, server.url("/chunked"));
+        EXPECT_EQ(response->header.get("transfer-encoding"), "chunked");
+    }
+
+    TEST(HTTPClient, RejectsInvalidContentLengths)
+    {
+        // The server adds the actual Content-Length of "body" after these fields
+        LoopbackServer server([](const LoopbackServer::Request &request) {
+            LoopbackServer::Response response;
+            response.body = "body";
+            if (request.target == "/empty") {
+                response.headerFields.emplace_back("Content-Length", "");
+            } else if (request.target == "/overflowing") {
+                response.headerFields.emplace_back("Content-Length", "184467440737095516160");
+            } else if (request.target == "/conflicting") {
+                response.headerFields.emplace_back("Content-Length", "3");
+            } else if (request.target == "/conflictingList") {
+                response.headerFields.emplace_back("Content-Length", "4, 5");
+            } else if (request.target == "/repeated") {
+                response.headerFields.emplace_back("Content-Length", "4, 4");
+            }
+            return response;
+        });
+        HTTPClient client;
+
+        for (String target : {"/empty", "/overflowing", "/conflicting", "/conflictingList"}) {
+            EXPECT_EQ(fetch(client, server.url(target))->responseCode, 0) << target;
+        }
+        EXPECT_EQ(client.statistics().failedRequests, 4u);
+
+        // Identical lengths are allowed, and the connection stays usable
+        auto response = fetch(client, server.url("/repeated"));
+        EXPECT_EQ(response->responseCode, 200);
+        EXPECT_EQ(response->data, "body");
+        EXPECT_EQ(fetch(client, server.url("/"))->data, "body");
+        EXPECT_EQ(client.statistics().connectionsReused, 1u);
+    }
+
+    TEST(HTTPClient, StreamsBodyToDataHandler)
+    {
+        std::string large(1024 * 1024, 'x');
+        for (size_t i = 0; i < large.size(); i += 1000) {
+            large[i] = static_cast<char>('a' + i % 26);
+        }
+
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            LoopbackServer::Response response;
+            response.body = large;
+            response.chunked = request.target == "/chunked";
+            return response;
+        });
+        HTTPClient client;
+
+        for (String target : {"/plain", "/chunked"}) {
+            std::string received;
+            size_t chunkCount = 0;
+
+            HTTPRequest request(server.url(target), nullptr);
+            request.dataHandler = [&](ByteSpan chunk) {
+                received.append(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+                chunkCount++;
+            };
+            auto response = fetch(client, request);
+
+            EXPECT_EQ(response->responseCode, 200);
+            EXPECT_TRUE(response->data.empty());
+            EXPECT_EQ(received, large);
+            EXPECT_GT(chunkCount, 1u);
+        }
+    }
+
+    TEST(HTTPClient, SendsMethodTargetAndHeaderFields)
+    {
+        String userAgent;
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            userAgent = request.headerField("user-agent");
+            return echoTarget(request);
+        });
+        HTTPClient client;
+
+        HTTPRequest request(http::Method::DELETE, server.url("/items/7?force=1#top"), nullptr);
+        request.header = HTTPHeader::parse("User-Agent: boden\nAccept: */*\n");
+        auto response = fetch(client, request);
+
+        EXPECT_EQ(response->responseCode, 200);
+        EXPECT_EQ(response->data, "DELETE /items/7?force=1");
+        EXPECT_EQ(userAgent, "boden");
+        EXPECT_EQ(response->header.get("Content-Type"), "text/plain");
+
+        request.method = http::Method::HEAD;
+        response = fetch(client, request);
+        EXPECT_EQ(response->responseCode, 200);
+        EXPECT_TRUE(response->data.empty());
+    }
+
+    TEST(HTTPClient, SendsByteAndFileBodies)
+    {
+        std::vector<LoopbackServer::Request> received;
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            received.push_back(request);
+            return echoTarget(request);
+        });
+        HTTPClient client;
+
+        std::string large(3 * 1024 * 1024, 'x');
+        for (size_t i = 0; i < large.size(); i += 1000) {
+            large[i] = static_cast<char>('a' + i % 26);
+        }
+        char path[] = "/tmp/bdnHTTPBodyXXXXXX";
+        int fd = ::mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(::write(fd, large.data(), large.size()), static_cast<ssize_t>(large.size()));
+        ::close(fd);
+
+        HTTPRequest post(http::Method::POST, server.url("/bytes"), nullptr);
+        post.header.add("Content-Type", "application/json");
+        post.header.add("Content-Length", "1");
+        post.body = HTTPRequestBody::fromBytes(String("{\"a\": 1}"));
+        EXPECT_EQ(fetch(client, post)->responseCode, 200);
+
+        HTTPRequest put(http::Method::PUT, server.url("/file"), nullptr);
+        put.body = HTTPRequestBody::fromFile(path);
+        EXPECT_EQ(fetch(client, put)->responseCode, 200);
+
+        put.body = HTTPRequestBody::fromFile(String(path) + ".missing");
+        EXPECT_EQ(fetch(client, put)->responseCode, 0);
+        ::unlink(path);
+
+        ASSERT_EQ(received.size(), 2u);
+        EXPECT_EQ(received[0].body, "{\"a\": 1}");
+        EXPECT_EQ(received[0].headerField("Content-Length"), "8");
+        EXPECT_EQ(received[0].headerField("Content-Type"), "application/json");
+        EXPECT_EQ(received[1].body, large);
+        EXPECT_EQ(server.statistics().connections, 1u);
+    }
+
+    TEST(HTTPClient, ReusesKeptAliveConnections)
+    {
+        LoopbackServer server(echoTarget);
+        HTTPClient client;
+
+        for (int i = 0; i < 20; i++) {
+            auto target = "/" + std::to_string(i);
+            EXPECT_EQ(fetch(client, server.url(target))->data, "GET " + target);
+        }
+
+        EXPECT_EQ(server.statistics().connections, 1u);
+        EXPECT_EQ(server.statistics().requests, 20u);
+        EXPECT_EQ(client.statistics().connectionsOpened, 1u);
+        EXPECT_EQ(client.statistics().connectionsReused, 19u);
+    }
+
+    TEST(HTTPClient, LimitsConnectionsPerHost)
+    {
+        LoopbackServer server(echoTarget);
+
+        HTTPClient::Configuration configuration;
+        configuration.maxConnectionsPerHost = 2;
+        HTTPClient client(configuration);
+
+        std::vector<String> urls;
+        for (int i = 0; i < 50; i++) {
+            urls.push_back(server.url("/" + std::to_string(i)));
+        }
+
+        auto responses = fetchAll(client, urls);
+        for (size_t i = 0; i < responses.size(); i++) {
+            EXPECT_EQ(responses[i]->data, "GET /" + std::to_string(i));
+        }
+
+        EXPECT_LE(server.statistics().connections, 2u);
+        EXPECT_EQ(client.statistics().connectionsOpened + client.statistics().connectionsReused, 50u);
+    }
+
+    TEST(HTTPClient, ReconnectsWhenServerClosesConnection)
+    {
+        LoopbackServer server([](const LoopbackServer::Request &request) {
+            auto response = echoTarget(request);
+            response.close = request.target == "/close";
+            return response;
+        });
+        HTTPClient client;
+
+        EXPECT_EQ(fetch(client, server.url("/close"))->responseCode, 200);
+        EXPECT_EQ(fetch(client, server.url("/after"))->data, "GET /after");
+        EXPECT_EQ(server.statistics().connections, 2u);
+    }
+
+    TEST(HTTPClient, IdleConnectionsExpire)
+    {
+        LoopbackServer server(echoTarget);
+
+        HTTPClient::Configuration configuration;
+        configuration.idleTimeout = std::chrono::milliseconds(20);
+        HTTPClient client(configuration);
+
+        EXPECT_EQ(fetch(client, server.url("/first"))->responseCode, 200);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(fetch(client, server.url("/second"))->responseCode, 200);
+
+        EXPECT_EQ(client.statistics().connectionsOpened, 2u);
+        EXPECT_EQ(client.statistics().connectionsReused, 0u);
+    }
+
+    TEST(HTTPClient, FailedRequestsHaveResponseCodeZero)
+    {
+        HTTPClient client;
+
+        uint16_t closedPort = 0;
+        {
+            LoopbackServer server(echoTarget);
+            closedPort = server.port();
+        }
+
+        EXPECT_EQ(fetch(client, "http://127.0.0.1:" + std::to_string(closedPort) + "/")->responseCode, 0);
+        EXPECT_EQ(fetch(client, "https://127.0.0.1/")->responseCode, 0);
+        EXPECT_EQ(fetch(client, "http://:80/")->responseCode, 0);
+        EXPECT_EQ(client.statistics().failedRequests, 3u);
+    }
+
+    TEST(HTTPClient, CancelledRequestsAreNotDelivered)
+    {
+        Gate gate;
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            if (request.target == "/blocked") {
+                gate.wait();
+            }
+            return echoTarget(request);
+        });
+
+        HTTPClient::Configuration configuration;
+        configuration.maxConnectionsPerHost = 1;
+        HTTPClient client(configuration);
+
+        std::atomic<int> delivered{0};
+        HTTPRequest inFlight(server.url("/blocked"), [&](auto) { delivered++; });
+        inFlight.dataHandler = [&](ByteSpan) { delivered++; };
+        auto inFlightHandle = client.request(inFlight);
+        auto pendingHandle = client.request(HTTPRequest(server.url("/pending"), [&](auto) { delivered++; }));
+
+        gate.waitUntilEntered();
+        pendingHandle->cancel();
+        inFlightHandle->cancel();
+        inFlightHandle->cancel();
+        EXPECT_TRUE(inFlightHandle->isCancelled());
+        while (client.statistics().cancelledRequests < 2) {
+            std::this_thread::yield();
+        }
+        gate.release();
+
+        EXPECT_EQ(fetch(client, server.url("/after"))->data, "GET /after");
+        EXPECT_EQ(delivered, 0);
+        EXPECT_EQ(client.statistics().cancelledRequests, 2u);
+        EXPECT_EQ(client.statistics().connectionsOpened, 2u);
+        EXPECT_EQ(server.statistics().requests, 2u);
+    }
+
+    TEST(HTTPClient, RequestsTimeOut)
+    {
+        Gate gate;
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            if (request.target == "/blocked") {
+                gate.wait();
+            }
+            return echoTarget(request);
+        });
+        HTTPClient client;
+
+        HTTPRequest request(server.url("/blocked"), nullptr);
+        request.timeout = std::chrono::milliseconds(50);
+        EXPECT_EQ(fetch(client, request)->responseCode, 0);
+        gate.release();
+
+        request.url = server.url("/fast");
+        request.timeout = std::chrono::milliseconds(5000);
+        EXPECT_EQ(fetch(client, request)->responseCode, 200);
+
+        EXPECT_EQ(client.statistics().timedOutRequests, 1u);
+        EXPECT_EQ(client.statistics().failedRequests, 1u);
+    }
+
+    TEST(HTTPClient, HigherPrioritiesStartFirst)
+    {
+        Gate gate;
+        std::vector<String> targets;
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            targets.push_back(request.target);
+            if (request.target == "/blocked") {
+                gate.wait();
+            }
+            return echoTarget(request);
+        });
+
+        HTTPClient::Configuration configuration;
+        configuration.maxConnectionsPerHost = 1;
+        HTTPClient client(configuration);
+
+        std::vector<std::future<ResponsePtr>> futures;
+        auto send = [&](const String &target, http::Priority priority) {
+            auto promise = std::make_shared<std::promise<ResponsePtr>>();
+            futures.push_back(promise->get_future());
+            HTTPRequest request(server.url(target), [promise](ResponsePtr response) { promise->set_value(response); });
+            request.priority = priority;
+            client.request(request);
+        };
+
+        send("/blocked", http::Priority::Low);
+        gate.waitUntilEntered();
+        send("/low", http::Priority::Low);
+        send("/normal1", http::Priority::Normal);
+        send("/high", http::Priority::High);
+        send("/normal2", http::Priority::Normal);
+        while (client.statistics().requests < 5) {
+            std::this_thread::yield();
+        }
+        gate.release();
+
+        for (auto &future : futures) {
+            EXPECT_EQ(future.get()->responseCode, 200);
+        }
+        EXPECT_EQ(targets, (std::vector<String>{"/blocked", "/high", "/normal1", "/normal2", "/low"}));
+    }
+
+    TEST(HTTPClient, MeasuresRequestPhases)
+    {
+        LoopbackServer server([](const LoopbackServer::Request &request) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            LoopbackServer::Response response;
+            response.body = std::string(100 * 1024, 'x');
+            response.chunked = request.target == "/chunked";
+            return response;
+        });
+        HTTPClient client;
+
+        HTTPRequest request(server.url("/plain"), nullptr);
+        request.method = http::Method::POST;
+        request.body = HTTPRequestBody::fromBytes(String(1000, 'b'));
+        auto first = fetch(client, request);
+        auto &metrics = first->metrics;
+        EXPECT_FALSE(metrics.reusedConnection);
+        EXPECT_FALSE(metrics.cancelled);
+        EXPECT_GE(metrics.timeToFirstByte, std::chrono::milliseconds(20));
+        EXPECT_EQ(metrics.tlsHandshake.count(), 0);
+        EXPECT_GE(metrics.total, metrics.dnsLookup + metrics.connect + metrics.timeToFirstByte + metrics.transfer);
+        EXPECT_LE(metrics.startTime + metrics.total, HTTPMetrics::Clock::now());
+        EXPECT_GT(metrics.bytesSent, 1000u);
+        EXPECT_GT(metrics.bytesReceived, 100u * 1024u);
+
+        // The host is resolved and the connection is reused
+        auto second = fetch(client, server.url("/chunked"));
+        EXPECT_TRUE(second->metrics.reusedConnection);
+        EXPECT_EQ(second->metrics.dnsLookup.count(), 0);
+        EXPECT_EQ(second->metrics.connect.count(), 0);
+        EXPECT_GE(second->metrics.timeToFirstByte, std::chrono::milliseconds(20));
+        EXPECT_GT(second->metrics.bytesReceived, 100u * 1024u);
+    }
+
+    TEST(HTTPClient, ObserverSeesEveryRequest)
+    {
+        Gate gate;
+        LoopbackServer server([&](const LoopbackServer::Request &request) {
+            if (request.target == "/blocked") {
+                gate.wait();
+            }
+            return echoTarget(request);
+        });
+        HTTPClient client;
+
+        auto observer = std::make_shared<RecordingObserver>();
+        http::setObserver(observer);
+        EXPECT_EQ(http::observer(), observer);
+
+        // Observed before the doneHandler is called
+        std::promise<size_t> finishedBeforeDone;
+        client.request(HTTPRequest(server.url("/ok"),
+                                   [&](auto) { finishedBeforeDone.set_value(observer->finished.size()); }));
+        EXPECT_EQ(finishedBeforeDone.get_future().get(), 1u);
+        fetch(client, "https://127.0.0.1/");
+
+        auto handle = client.request(HTTPRequest(server.url("/blocked"), [](auto) { FAIL(); }));
+        gate.waitUntilEntered();
+        handle->cancel();
+        observer->waitForFinished(3);
+        gate.release();
+
+        http::setObserver(nullptr);
+        fetch(client, server.url("/unobserved"));
+
+        ASSERT_EQ(observer->started.size(), 3u);
+        EXPECT_EQ(observer->started[0], server.url("/ok"));
+        ASSERT_EQ(observer->finished.size(), 3u);
+        EXPECT_EQ(observer->finished[0].responseCode, 200);
+        EXPECT_EQ(observer->finished[0].data, "GET /ok");
+        EXPECT_GT(observer->finished[0].metrics.total.count(), 0);
+        EXPECT_EQ(observer->finished[1].responseCode, 0);
+        EXPECT_FALSE(observer->finished[1].metrics.cancelled);
+        EXPECT_TRUE(observer->finished[2].metrics.cancelled);
+        EXPECT_EQ(observer->finished[2].originalRequest.url, server.url("/blocked"));
+    }
+}
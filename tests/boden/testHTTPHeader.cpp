@@ -0,0 +1,75 @@
+#include <bdn/net/HTTPHeader.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace bdn
+{
+    using net::HTTPHeader;
+
+    TEST(HTTPHeader, ParsesAndLooksUpFieldsCaseInsensitively)
+    {
+        auto header = HTTPHeader::parse("Content-Type:text/plain\r\n"
+                                        "  not a field\n"
+                                        "X-Empty:\n"
+                                        ": no name\r\n"
+                                        "Cache-Control:  no-cache \r\n"
+                                        "cache-control: max-age=0");
+
+        EXPECT_EQ(header.size(), 4u);
+        EXPECT_EQ(header.get("content-type"), "text/plain");
+        EXPECT_EQ(header.get("X-EMPTY"), "");
+        EXPECT_EQ(header.get("Cache-Control"), "no-cache");
+        EXPECT_EQ(header.combined("CACHE-CONTROL"), "no-cache, max-age=0");
+        EXPECT_FALSE(header.get("Accept").has_value());
+        EXPECT_FALSE(header.combined("Accept").has_value());
+        EXPECT_EQ(header.toString(), "Content-Type: text/plain\r\n"
+                                     "X-Empty: \r\n"
+                                     "Cache-Control: no-cache\r\n"
+                                     "cache-control: max-age=0\r\n");
+        EXPECT_EQ(HTTPHeader::parse(header.toString()), header);
+    }
+
+    TEST(HTTPHeader, ParseSkipsValuesWithABareCarriageReturn)
+    {
+        HTTPHeader header;
+        EXPECT_NO_THROW(header = HTTPHeader::parse("X: a\rb\r\n"
+                                                   "Y: c\r\n"));
+        EXPECT_FALSE(header.contains("X"));
+        EXPECT_EQ(header.get("Y"), "c");
+        EXPECT_EQ(header.size(), 1u);
+    }
+
+    TEST(HTTPHeader, AddsSetsAndRemovesFields)
+    {
+        HTTPHeader header{{"Accept", "*/*"}, {"Vary", "Accept"}};
+        header.add("vary", "Accept-Language");
+        header.set("ACCEPT", "text/html");
+        EXPECT_EQ(header.toString(), "Vary: Accept\r\nvary: Accept-Language\r\nACCEPT: text/html\r\n");
+
+        std::vector<String> names;
+        for (auto field : header) {
+            names.emplace_back(field.name);
+        }
+        EXPECT_EQ(names, (std::vector<String>{"Vary", "vary", "ACCEPT"}));
+
+        EXPECT_EQ(header.remove("VARY"), 2u);
+        EXPECT_EQ(header.remove("Vary"), 0u);
+        EXPECT_EQ(header.size(), 1u);
+
+        header.clear();
+        EXPECT_TRUE(header.empty());
+        EXPECT_EQ(header.begin(), header.end());
+    }
+
+    TEST(HTTPHeader, RejectsFieldsThatWouldBreakTheMessage)
+    {
+        HTTPHeader header;
+        EXPECT_THROW(header.add("", "value"), std::invalid_argument);
+        EXPECT_THROW(header.add("Bad Name", "value"), std::invalid_argument);
+        EXPECT_THROW(header.add("Name:", "value"), std::invalid_argument);
+        EXPECT_THROW(header.add("X-Injected", "value\r\nSet-Cookie: a=b"), std::invalid_argument);
+        EXPECT_TRUE(header.empty());
+    }
+}
@@ -0,0 +1,155 @@
+#include <bdn/net/HTTPRequest.h>
+#include <bdn/net/HTTPResponse.h>
+#include <bdn/net/HTTPSingleFlight.h>
+#include <bdn/net/posix/HTTPClient.h>
+#include <bdn/net/posix/LoopbackServer.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <vector>
+
+namespace bdn
+{
+    using namespace bdn::net;
+    using posix::HTTPClient;
+    using posix::LoopbackServer;
+
+    namespace
+    {
+        using ResponsePtr = std::shared_ptr<HTTPResponse>;
+
+        // Answers once release() was called, so that requests pile up in flight
+        class HeldServer
+        {
+          public:
+            HeldServer()
+                : _released(_release.get_future().share()), _server([this](const LoopbackServer::Request &request) {
+                      _released.wait();
+                      LoopbackServer::Response response;
+                      response.body = request.method + " " + request.target + " " + request.headerField("Accept");
+                      return response;
+                  })
+            {}
+
+            String url(const String &target) const { return _server.url(target); }
+            size_t requests() const { return _server.statistics().requests; }
+            void release() { _release.set_value(); }
+
+          private:
+            std::promise<void> _release;
+            std::shared_future<void> _released;
+            LoopbackServer _server;
+        };
+
+        std::future<ResponsePtr> send(HTTPSingleFlight &flight, HTTPRequest request,
+                                      std::shared_ptr<HTTPRequestHandle> *handle = nullptr)
+        {
+            auto promise = std::make_shared<std::promise<ResponsePtr>>();
+            auto future = promise->get_future();
+            request.doneHandler = [promise](ResponsePtr response) { promise->set_value(response); };
+            auto requestHandle = flight.request(std::move(request));
+            if (handle != nullptr) {
+                *handle = requestHandle;
+            }
+            return future;
+        }
+
+        std::future<ResponsePtr> send(HTTPSingleFlight &flight, const String &url)
+        {
+            return send(flight, HTTPRequest(url, nullptr));
+        }
+    }
+
+    TEST(HTTPSingleFlight, IdenticalRequestsAreSentOnce)
+    {
+        HeldServer server;
+        HTTPClient client;
+        HTTPSingleFlight flight([&client](HTTPRequest request) { return client.request(std::move(request)); });
+
+        std::vector<std::future<ResponsePtr>> futures;
+        for (int i = 0; i < 30; i++) {
+            futures.push_back(send(flight, server.url(i % 2 == 0 ? "/avatar" : "/avatar#row" + std::to_string(i))));
+        }
+        server.release();
+
+        std::vector<ResponsePtr> responses;
+        for (auto &future : futures) {
+            responses.push_back(future.get());
+        }
+
+        for (size_t i = 0; i < responses.size(); i++) {
+            EXPECT_EQ(responses[i]->responseCode, 200);
+            EXPECT_EQ(responses[i]->body(), "GET /avatar ");
+            EXPECT_TRUE(responses[i]->data.empty());
+            EXPECT_EQ(responses[i]->sharedData, responses[0]->sharedData);
+        }
+        EXPECT_EQ(responses[1]->originalRequest.url, server.url("/avatar#row1"));
+        EXPECT_EQ(server.requests(), 1u);
+        EXPECT_EQ(flight.statistics().requests, 1u);
+        EXPECT_EQ(flight.statistics().attached, 29u);
+
+        // Finished flights are not reused, and single requests keep their body in data
+        auto response = send(flight, server.url("/avatar")).get();
+        EXPECT_EQ(response->data, "GET /avatar ");
+        EXPECT_EQ(response->sharedData, nullptr);
+        EXPECT_EQ(server.requests(), 2u);
+    }
+
+    TEST(HTTPSingleFlight, MethodsAndHeadersAreDistinguished)
+    {
+        HeldServer server;
+        HTTPClient client;
+        HTTPSingleFlight flight([&client](HTTPRequest request) { return client.request(std::move(request)); });
+
+        HTTPRequest json(server.url("/item"), nullptr);
+        json.header.add("Accept", "application/json");
+        HTTPRequest post(http::Method::POST, server.url("/item"), nullptr);
+        HTTPRequest streamed(server.url("/item"), nullptr);
+        streamed.dataHandler = [](ByteSpan) {};
+
+        std::vector<std::future<ResponsePtr>> futures;
+        futures.push_back(send(flight, server.url("/item")));
+        futures.push_back(send(flight, json));
+        futures.push_back(send(flight, json));
+        futures.push_back(send(flight, post));
+        futures.push_back(send(flight, post));
+        futures.push_back(send(flight, streamed));
+        server.release();
+
+        EXPECT_EQ(futures[0].get()->body(), "GET /item ");
+        EXPECT_EQ(futures[1].get()->body(), "GET /item application/json");
+        EXPECT_EQ(futures[2].get()->body(), "GET /item application/json");
+        EXPECT_EQ(futures[3].get()->body(), "POST /item ");
+        EXPECT_EQ(futures[4].get()->body(), "POST /item ");
+        EXPECT_EQ(futures[5].get()->responseCode, 200);
+        EXPECT_EQ(server.requests(), 5u);
+        EXPECT_EQ(flight.statistics().attached, 1u);
+    }
+
+    TEST(HTTPSingleFlight, CancellingDetaches)
+    {
+        HeldServer server;
+        HTTPClient client;
+        HTTPSingleFlight flight([&client](HTTPRequest request) { return client.request(std::move(request)); });
+
+        std::shared_ptr<HTTPRequestHandle> first, second, third;
+        auto kept = send(flight, HTTPRequest(server.url("/kept"), nullptr), &first);
+        send(flight, HTTPRequest(server.url("/kept"), nullptr), &second);
+        send(flight, HTTPRequest(server.url("/dropped"), nullptr), &third);
+        second->cancel();
+        third->cancel();
+
+        // A cancelled flight is not joined anymore
+        auto again = send(flight, server.url("/dropped"));
+        while (client.statistics().cancelledRequests < 1) {
+            std::this_thread::yield();
+        }
+        server.release();
+
+        EXPECT_EQ(kept.get()->body(), "GET /kept ");
+        EXPECT_EQ(again.get()->body(), "GET /dropped ");
+        EXPECT_EQ(flight.statistics().requests, 3u);
+        EXPECT_EQ(flight.statistics().attached, 1u);
+        EXPECT_EQ(client.statistics().cancelledRequests, 1u);
+    }
+}
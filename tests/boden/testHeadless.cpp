@@ -0,0 +1,482 @@
+#include <bdn/headless/ButtonCore.h>
+#include <bdn/headless/FontMetrics.h>
+#include <bdn/headless/ListViewCore.h>
+#include <bdn/headless/ScrollViewCore.h>
+#include <bdn/ui/Button.h>
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/CoreLess.h>
+#include <bdn/ui/ImageView.h>
+#include <bdn/ui/Label.h>
+#include <bdn/ui/ListView.h>
+#include <bdn/ui/ScrollView.h>
+#include <bdn/ui/yoga.h>
+#include <gtest/gtest.h>
+
+#include <bdn/Application.h>
+
+#include <algorithm>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+    using namespace bdn::ui::headless;
+
+    namespace
+    {
+        void expectSize(Size actual, double width, double height)
+        {
+            EXPECT_DOUBLE_EQ(actual.width, width);
+            EXPECT_DOUBLE_EQ(actual.height, height);
+        }
+
+        void expectRect(Rect actual, double x, double y, double width, double height)
+        {
+            EXPECT_DOUBLE_EQ(actual.x, x);
+            EXPECT_DOUBLE_EQ(actual.y, y);
+            EXPECT_DOUBLE_EQ(actual.width, width);
+            EXPECT_DOUBLE_EQ(actual.height, height);
+        }
+
+        class RecordingDataSource : public ListViewDataSource
+        {
+          public:
+            size_t numberOfRows() override { return ids.size(); }
+
+            std::shared_ptr<View> viewForRowIndex(size_t rowIndex, std::shared_ptr<View> reusableView) override
+            {
+                boundRows.push_back(rowIndex);
+
+                // Odd rows are buttons when view types are enabled
+                if (viewTypeForRowIndex(rowIndex) == 1) {
+                    auto button = std::dynamic_pointer_cast<Button>(reusableView);
+                    mismatchedReuses += (reusableView && !button) ? 1 : 0;
+                    if (!button) {
+                        button = std::make_shared<Button>();
+                        createdViews++;
+                    }
+                    button->label = std::to_string(ids[rowIndex]);
+                    return button;
+                }
+
+                auto label = std::dynamic_pointer_cast<Label>(reusableView);
+                mismatchedReuses += (reusableView && !label) ? 1 : 0;
+                if (!label) {
+                    label = std::make_shared<Label>();
+                    createdViews++;
+                }
+                label->text = std::to_string(ids[rowIndex]);
+                return label;
+            }
+
+            float heightForRowIndex(size_t rowIndex) override { return 20.0f; }
+
+            void heightsForRange(size_t begin, size_t end, float *out) override
+            {
+                heightQueries++;
+                std::fill(out, out + (end - begin), 20.0f);
+            }
+
+            void prefetchRows(RowRange range) override { prefetched.push_back(range); }
+            void cancelPrefetch(RowRange range) override { cancelled.push_back(range); }
+
+            bool hasStableRowIds() override { return stableRowIds; }
+            RowId rowIdForRowIndex(size_t rowIndex) override { return ids[rowIndex]; }
+
+            size_t viewTypeCount() override { return viewTypes ? 2 : 1; }
+            size_t viewTypeForRowIndex(size_t rowIndex) override { return viewTypes ? ids[rowIndex] % 2 : 0; }
+
+          public:
+            std::vector<RowId> ids;
+            bool stableRowIds = false;
+            bool viewTypes = false;
+
+            int createdViews = 0;
+            int mismatchedReuses = 0;
+
+            int heightQueries = 0;
+            std::vector<size_t> boundRows;
+            std::vector<RowRange> prefetched;
+            std::vector<RowRange> cancelled;
+        };
+
+        // Counts how often the layout enumerates the children, i.e. rebuilds the container's yoga children
+        class EnumerationCountingContainer : public CoreLess<ContainerView>
+        {
+          public:
+            using CoreLess<ContainerView>::CoreLess;
+
+            void forEachChild(const std::function<void(const std::shared_ptr<View> &)> &function) override
+            {
+                enumerations++;
+                ContainerView::forEachChild(function);
+            }
+
+          public:
+            int enumerations = 0;
+        };
+
+        std::shared_ptr<RecordingDataSource> makeDataSource(size_t rowCount)
+        {
+            auto dataSource = std::make_shared<RecordingDataSource>();
+            for (size_t i = 0; i < rowCount; i++) {
+                dataSource->ids.push_back(i);
+            }
+            return dataSource;
+        }
+    }
+
+    TEST(Headless, MonospaceMetrics)
+    {
+        MonospaceFontMetrics metrics(10.0, 20.0);
+
+        expectSize(metrics.measure(""), 0, 20);
+        expectSize(metrics.measure("Hello"), 50, 20);
+        expectSize(metrics.measure("Hello\nWorld!"), 60, 40);
+
+        // Wrapping happens at word boundaries only
+        expectSize(metrics.measure("Hello World", 80), 50, 40);
+        expectSize(metrics.measure("Hello World", 110), 110, 20);
+        expectSize(metrics.measure("Unbreakable", 30), 110, 20);
+    }
+
+    TEST(Headless, LabelUsesFontMetrics)
+    {
+        auto label = std::make_shared<Label>();
+        label->text = "Hello World";
+
+        // Labels wrap by default
+        label->wrap = false;
+
+        expectSize(label->sizeForSpace(), 88, 16);
+        expectSize(label->sizeForSpace(Size(60, Size::componentNone())), 88, 16);
+
+        label->wrap = true;
+        expectSize(label->sizeForSpace(Size(60, Size::componentNone())), 40, 32);
+    }
+
+    TEST(Headless, ButtonClick)
+    {
+        auto button = std::make_shared<Button>();
+        int clicks = 0;
+        button->onClick() += [&](auto) { clicks++; };
+
+        button->core<ButtonCore>()->click();
+        EXPECT_EQ(clicks, 1);
+    }
+
+    TEST(Headless, YogaLayout)
+    {
+        App()->dispatchQueue()->dispatchSync([&]() {
+            auto layout = std::make_shared<yoga::Layout>();
+
+            auto container = std::make_shared<ContainerView>();
+            container->setLayout(layout);
+            container->geometry = Rect{0, 0, 200, 300};
+
+            auto first = std::make_shared<Label>();
+            first->text = "First";
+            container->addChildView(first);
+
+            auto second = std::make_shared<Label>();
+            second->text = "Second";
+            container->addChildView(second);
+
+            layout->layout(container.get());
+
+            expectRect(first->geometry, 0, 0, 200, 16);
+            expectRect(second->geometry, 0, 16, 200, 16);
+        });
+    }
+
+    TEST(Headless, ChildEnumeration)
+    {
+        auto container = std::make_shared<ContainerView>();
+        auto first = std::make_shared<Label>();
+        auto second = std::make_shared<Label>();
+        container->addChildView(first);
+        container->addChildView(second);
+
+        ASSERT_EQ(container->childCount(), 2U);
+        EXPECT_EQ(container->childAt(0), first);
+        EXPECT_EQ(container->childAt(1), second);
+        EXPECT_THROW(container->childAt(2), std::out_of_range);
+
+        std::vector<std::shared_ptr<View>> visited;
+        container->forEachChild([&visited](const std::shared_ptr<View> &child) { visited.push_back(child); });
+        EXPECT_EQ(visited, (std::vector<std::shared_ptr<View>>{first, second}));
+
+        container->removeAllChildViews();
+        EXPECT_EQ(container->childCount(), 0U);
+        EXPECT_EQ(first->getParentView(), nullptr);
+    }
+
+    TEST(Headless, SetChildViews)
+    {
+        App()->dispatchQueue()->dispatchSync([&]() {
+            auto layout = std::make_shared<yoga::Layout>();
+
+            auto container = std::make_shared<ContainerView>();
+            container->setLayout(layout);
+            container->geometry = Rect{0, 0, 200, 4000};
+
+            std::vector<std::shared_ptr<Label>> labels;
+            for (int i = 0; i < 200; i++) {
+                labels.push_back(std::make_shared<Label>());
+                labels.back()->text = "Row";
+            }
+
+            container->setChildViews(labels);
+            layout->layout(container.get());
+
+            ASSERT_EQ(container->childCount(), 200U);
+            expectRect(labels[199]->geometry, 0, 199 * 16, 200, 16);
+
+            // The common prefix stays, the rest is replaced
+            auto replacement = std::make_shared<Label>();
+            replacement->text = "New";
+            std::vector<std::shared_ptr<View>> newChildren{labels[0], labels[1], replacement};
+
+            container->setChildViews(newChildren);
+            layout->layout(container.get());
+
+            ASSERT_EQ(container->childCount(), 3U);
+            EXPECT_EQ(container->childAt(0), labels[0]);
+            EXPECT_EQ(container->childAt(2), replacement);
+            EXPECT_EQ(labels[2]->getParentView(), nullptr);
+            expectRect(replacement->geometry, 0, 32, 200, 16);
+        });
+    }
+
+    TEST(Headless, BatchedChildUpdates)
+    {
+        App()->dispatchQueue()->dispatchSync([&]() {
+            auto layout = std::make_shared<yoga::Layout>();
+
+            auto container = std::make_shared<EnumerationCountingContainer>();
+            container->setLayout(layout);
+            container->geometry = Rect{0, 0, 200, 300};
+
+            auto first = std::make_shared<Label>();
+            first->text = "First";
+            auto second = std::make_shared<Label>();
+            second->text = "Second";
+
+            container->enumerations = 0;
+            container->beginUpdates();
+            container->addChildView(first);
+            container->beginUpdates();
+            container->addChildView(second);
+            container->endUpdates();
+            EXPECT_EQ(container->enumerations, 0);
+            container->endUpdates();
+
+            // The yoga children were rebuilt once for the whole batch instead of once per child
+            EXPECT_EQ(container->enumerations, 1);
+
+            layout->layout(container.get());
+
+            expectRect(first->geometry, 0, 0, 200, 16);
+            expectRect(second->geometry, 0, 16, 200, 16);
+        });
+    }
+
+    TEST(Headless, ListViewPrefetch)
+    {
+        // Views and their cores are only ever touched on the main queue
+        App()->dispatchQueue()->dispatchSync([&]() {
+            using RowRange = ListViewDataSource::RowRange;
+
+            auto dataSource = makeDataSource(1000);
+
+            auto list = std::make_shared<ListView>();
+            list->geometry = Rect{0, 0, 200, 100};
+            list->dataSource = dataSource;
+
+            auto core = list->core<ListViewCore>();
+            EXPECT_EQ(dataSource->heightQueries, 1);
+            EXPECT_EQ(core->visibleRows().size(), 5U);
+            EXPECT_EQ(dataSource->prefetched, (std::vector<RowRange>{{5, 15}}));
+
+            dataSource->prefetched.clear();
+            core->scrollTo(200);
+
+            // Rows 10-15 scrolled from the lookahead window into view, so they are not cancelled
+            EXPECT_TRUE(dataSource->cancelled.empty());
+            EXPECT_EQ(dataSource->prefetched, (std::vector<RowRange>{{0, 5}, {15, 25}}));
+
+            dataSource->prefetched.clear();
+            core->scrollTo(1000);
+
+            EXPECT_EQ(dataSource->cancelled, (std::vector<RowRange>{{0, 10}, {15, 25}}));
+            EXPECT_EQ(dataSource->prefetched, (std::vector<RowRange>{{40, 50}, {55, 65}}));
+        });
+    }
+
+    TEST(Headless, ListViewStableRowIds)
+    {
+        // Views and their cores are only ever touched on the main queue
+        App()->dispatchQueue()->dispatchSync([&]() {
+            auto dataSource = makeDataSource(100);
+            dataSource->stableRowIds = true;
+
+            auto list = std::make_shared<ListView>();
+            list->geometry = Rect{0, 0, 200, 100};
+            list->dataSource = dataSource;
+
+            auto core = list->core<ListViewCore>();
+            auto firstRow = core->visibleRows().at(0);
+
+            // Inserting a row at the top only binds the new row, the others keep their views
+            dataSource->boundRows.clear();
+            dataSource->ids.insert(dataSource->ids.begin(), 1000);
+            list->reloadData();
+
+            EXPECT_EQ(dataSource->boundRows, (std::vector<size_t>{0}));
+            EXPECT_EQ(core->visibleRows().at(1), firstRow);
+            expectRect(firstRow->getParentView()->geometry, 0, 20, 200, 20);
+        });
+    }
+
+    TEST(Headless, ListViewApplyChanges)
+    {
+        // Views and their cores are only ever touched on the main queue
+        App()->dispatchQueue()->dispatchSync([&]() {
+            auto dataSource = makeDataSource(100);
+
+            auto list = std::make_shared<ListView>();
+            list->geometry = Rect{0, 0, 200, 100};
+            list->dataSource = dataSource;
+
+            auto core = list->core<ListViewCore>();
+            core->scrollTo(200);
+            auto topRow = core->visibleRows().at(10);
+
+            // Rows inserted above the viewport neither rebind nor move the visible rows
+            dataSource->boundRows.clear();
+            dataSource->ids.insert(dataSource->ids.begin(), {1000, 1001, 1002});
+
+            ListViewChanges changes;
+            changes.inserts = {0, 1, 2};
+            list->applyChanges(changes);
+
+            EXPECT_TRUE(dataSource->boundRows.empty());
+            EXPECT_DOUBLE_EQ(core->scrollOffset(), 260);
+            EXPECT_EQ(core->visibleRows().at(13), topRow);
+
+            changes = ListViewChanges{};
+            changes.updates = {14};
+            list->applyChanges(changes);
+
+            EXPECT_EQ(dataSource->boundRows, (std::vector<size_t>{14}));
+        });
+    }
+
+    TEST(Headless, ListViewRecyclesPerViewType)
+    {
+        // Views and their cores are only ever touched on the main queue
+        App()->dispatchQueue()->dispatchSync([&]() {
+            auto dataSource = makeDataSource(1000);
+            dataSource->viewTypes = true;
+
+            auto list = std::make_shared<ListView>();
+            list->geometry = Rect{0, 0, 200, 100};
+            list->dataSource = dataSource;
+
+            auto core = list->core<ListViewCore>();
+            auto firstRow = core->visibleRows().at(0);
+            auto firstContainer = firstRow->getParentView();
+
+            for (double offset = 0; offset < 2000; offset += 7) {
+                core->scrollTo(offset);
+            }
+
+            // Rows only ever get views of their own type, so the few views created up front are enough
+            EXPECT_EQ(dataSource->mismatchedReuses, 0);
+            EXPECT_LE(dataSource->createdViews, 14);
+
+            // Views are rebound in place instead of being moved to another container
+            auto rows = core->visibleRows();
+            for (auto &row : rows) {
+                EXPECT_EQ(row.second->getParentView()->childCount(), 1U);
+            }
+            EXPECT_EQ(firstRow->getParentView(), firstContainer);
+        });
+    }
+
+    TEST(Headless, ImageViewViewportPosition)
+    {
+        using Position = ImageView::ViewportPosition;
+
+        // Viewport positions are updated asynchronously on the main thread
+        auto onMain = [](const std::function<void()> &function) { App()->dispatchQueue()->dispatchSync(function); };
+
+        std::shared_ptr<ScrollView> scrollView;
+        std::shared_ptr<ContainerView> group;
+        std::shared_ptr<ImageView> groupedImage;
+        std::vector<std::shared_ptr<ImageView>> images;
+
+        onMain([&]() {
+            scrollView = std::make_shared<ScrollView>();
+            scrollView->lookAheadMargin = 100;
+
+            auto content = std::make_shared<ContainerView>();
+            for (int i = 0; i < 4; i++) {
+                auto image = std::make_shared<ImageView>();
+                image->geometry = Rect{0, 250.0 * i, 100, 100};
+                content->addChildView(image);
+                images.push_back(image);
+            }
+
+            group = std::make_shared<ContainerView>();
+            group->geometry = Rect{0, 900, 100, 100};
+            groupedImage = std::make_shared<ImageView>();
+            groupedImage->geometry = Rect{0, 0, 100, 100};
+            group->addChildView(groupedImage);
+            content->addChildView(group);
+
+            content->geometry = Rect{0, 0, 100, 1000};
+            scrollView->contentView = content;
+
+            scrollView->core<ScrollViewCore>();
+            scrollView->geometry = Rect{0, 0, 100, 200};
+        });
+
+        onMain([&]() {
+            EXPECT_EQ(images[0]->viewportPosition.get(), Position::Inside);
+            EXPECT_EQ(images[1]->viewportPosition.get(), Position::Nearby);
+            EXPECT_EQ(images[2]->viewportPosition.get(), Position::Outside);
+            EXPECT_EQ(images[3]->viewportPosition.get(), Position::Outside);
+
+            scrollView->core<ScrollViewCore>()->scrollTo(Point{0, 400});
+        });
+
+        onMain([&]() {
+            EXPECT_EQ(images[0]->viewportPosition.get(), Position::Outside);
+            EXPECT_EQ(images[1]->viewportPosition.get(), Position::Nearby);
+            EXPECT_EQ(images[2]->viewportPosition.get(), Position::Inside);
+            EXPECT_EQ(images[3]->viewportPosition.get(), Position::Outside);
+            EXPECT_EQ(groupedImage->viewportPosition.get(), Position::Outside);
+
+            // Moving an ancestor moves the image without scrolling
+            group->geometry = Rect{0, 450, 100, 100};
+        });
+
+        onMain([&]() {
+            EXPECT_EQ(groupedImage->viewportPosition.get(), Position::Inside);
+
+            // Outside of scroll views images are always visible
+            auto image = std::make_shared<ImageView>();
+            image->url = "image.png";
+            images.push_back(image);
+        });
+
+        onMain([&]() { EXPECT_EQ(images.back()->viewportPosition.get(), Position::Inside); });
+
+        onMain([&]() {
+            images.clear();
+            groupedImage.reset();
+            group.reset();
+            scrollView.reset();
+        });
+    }
+}
@@ -0,0 +1,419 @@
+#include <bdn/Application.h>
+#include <bdn/ui/ImageCache.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <future>
+#include <map>
+#include <mutex>
+#include <unistd.h>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+
+    namespace
+    {
+        using ImagePtr = std::shared_ptr<const ImageCache::Image>;
+
+        // Stands in for a server and an image codec: the "encoded" images are strings like "64x32".
+        class FakeBackend
+        {
+          public:
+            std::map<String, std::string> resources;
+
+            size_t fetchCount() const
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _fetchCount;
+            }
+
+            std::vector<size_t> decodedSizes() const
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _decodedSizes;
+            }
+
+            std::vector<String> startedFetches() const
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _startedFetches;
+            }
+
+            std::vector<String> abortedFetches() const
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _abortedFetches;
+            }
+
+            // With manual completion, fetches only finish when complete() is called
+            void setManualCompletion(bool manual) { _manualCompletion = manual; }
+
+            void complete(const String &url)
+            {
+                ImageCache::FetchHandler done;
+                std::optional<std::string> data;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    done = std::move(_pendingFetches.at(url));
+                    _pendingFetches.erase(url);
+                    data = resources.at(url);
+                }
+                done(data);
+            }
+
+            ImageCache::Configuration configuration(size_t memoryBudget = 32 * 1024 * 1024)
+            {
+                ImageCache::Configuration configuration;
+                configuration.memoryBudget = memoryBudget;
+
+                configuration.fetcher = [this](const String &url,
+                                               ImageCache::FetchHandler done) -> ImageCache::CancelFetch {
+                    std::optional<std::string> data;
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _fetchCount++;
+                        _startedFetches.push_back(url);
+
+                        if (_manualCompletion) {
+                            _pendingFetches[url] = std::move(done);
+                            return [this, url]() {
+                                std::lock_guard<std::mutex> lock(_mutex);
+                                _abortedFetches.push_back(url);
+                                _pendingFetches.erase(url);
+                            };
+                        }
+
+                        auto it = resources.find(url);
+                        if (it != resources.end()) {
+                            data = it->second;
+                        }
+                    }
+                    done(data);
+                    return nullptr;
+                };
+
+                configuration.decoder = [this](const std::string &data, size_t maxPixelSize) -> ImagePtr {
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _decodedSizes.push_back(maxPixelSize);
+                    }
+
+                    double width = 0;
+                    double height = 0;
+                    if (std::sscanf(data.c_str(), "%lfx%lf", &width, &height) != 2) {
+                        return nullptr;
+                    }
+
+                    auto image = std::make_shared<ImageCache::Image>();
+                    image->originalSize = Size{width, height};
+
+                    double scale = 1.0;
+                    if (maxPixelSize != 0) {
+                        scale = std::min(1.0, static_cast<double>(maxPixelSize) / std::max(width, height));
+                    }
+                    image->pixelSize = Size{std::round(width * scale), std::round(height * scale)};
+                    image->byteCost = static_cast<size_t>(image->pixelSize.width * image->pixelSize.height * 4);
+                    return image;
+                };
+
+                return configuration;
+            }
+
+          private:
+            mutable std::mutex _mutex;
+            size_t _fetchCount = 0;
+            std::vector<size_t> _decodedSizes;
+            std::vector<String> _startedFetches;
+            std::vector<String> _abortedFetches;
+            std::map<String, ImageCache::FetchHandler> _pendingFetches;
+            bool _manualCompletion = false;
+        };
+
+        // The cache must only be used on the main thread
+        void onMain(const std::function<void()> &function) { App()->dispatchQueue()->dispatchSync(function); }
+
+        ImagePtr load(const std::shared_ptr<ImageCache> &cache, const String &url, size_t maxPixelSize)
+        {
+            std::promise<ImagePtr> promise;
+            onMain([&]() { cache->load(url, maxPixelSize, [&promise](ImagePtr image) { promise.set_value(image); }); });
+
+            auto future = promise.get_future();
+            EXPECT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+            return future.get();
+        }
+
+        ImageCache::Statistics statistics(const std::shared_ptr<ImageCache> &cache)
+        {
+            ImageCache::Statistics result;
+            onMain([&]() { result = cache->statistics(); });
+            return result;
+        }
+
+        ImagePtr cachedImage(const std::shared_ptr<ImageCache> &cache, const String &url, size_t maxPixelSize)
+        {
+            ImagePtr result;
+            onMain([&]() { result = cache->cachedImage(url, maxPixelSize); });
+            return result;
+        }
+
+        size_t countFiles(const String &directory)
+        {
+            size_t count = 0;
+            if (DIR *dir = ::opendir(directory.c_str())) {
+                while (dirent *entry = ::readdir(dir)) {
+                    count += entry->d_name[0] != '.' ? 1 : 0;
+                }
+                ::closedir(dir);
+            }
+            return count;
+        }
+
+        void removeDirectory(const String &directory)
+        {
+            if (DIR *dir = ::opendir(directory.c_str())) {
+                while (dirent *entry = ::readdir(dir)) {
+                    String name = entry->d_name;
+                    if (name != "." && name != "..") {
+                        auto path = directory + "/" + name;
+                        if (::unlink(path.c_str()) != 0) {
+                            removeDirectory(path);
+                        }
+                    }
+                }
+                ::closedir(dir);
+            }
+            ::rmdir(directory.c_str());
+        }
+    }
+
+    TEST(ImageCache, PixelSizeBucket)
+    {
+        EXPECT_EQ(ImageCache::pixelSizeBucket(0), 0U);
+        EXPECT_EQ(ImageCache::pixelSizeBucket(1), 32U);
+        EXPECT_EQ(ImageCache::pixelSizeBucket(32), 32U);
+        EXPECT_EQ(ImageCache::pixelSizeBucket(33), 64U);
+        EXPECT_EQ(ImageCache::pixelSizeBucket(1000), 1024U);
+    }
+
+    TEST(ImageCache, DeduplicatesConcurrentLoads)
+    {
+        FakeBackend backend;
+        backend.resources["http://host/a"] = "400x200";
+        auto cache = std::make_shared<ImageCache>(backend.configuration());
+
+        std::promise<ImagePtr> first;
+        std::promise<ImagePtr> second;
+        onMain([&]() {
+            cache->load("http://host/a", 100, [&first](ImagePtr image) { first.set_value(image); });
+            cache->load("http://host/a", 120, [&second](ImagePtr image) { second.set_value(image); });
+        });
+
+        auto firstImage = first.get_future().get();
+        auto secondImage = second.get_future().get();
+
+        ASSERT_TRUE(firstImage);
+        EXPECT_EQ(firstImage, secondImage);
+        EXPECT_EQ(backend.fetchCount(), 1U);
+        EXPECT_EQ(backend.decodedSizes(), (std::vector<size_t>{128}));
+
+        EXPECT_DOUBLE_EQ(firstImage->originalSize.width, 400);
+        EXPECT_DOUBLE_EQ(firstImage->pixelSize.width, 128);
+        EXPECT_DOUBLE_EQ(firstImage->pixelSize.height, 64);
+    }
+
+    TEST(ImageCache, LargerImagesServeSmallerSizes)
+    {
+        FakeBackend backend;
+        backend.resources["http://host/a"] = "2000x1000";
+        auto cache = std::make_shared<ImageCache>(backend.configuration());
+
+        auto large = load(cache, "http://host/a", 500);
+        ASSERT_TRUE(large);
+        EXPECT_DOUBLE_EQ(large->pixelSize.width, 512);
+
+        EXPECT_EQ(load(cache, "http://host/a", 100), large);
+        EXPECT_EQ(statistics(cache).memoryHits, 1U);
+
+        EXPECT_FALSE(cachedImage(cache, "http://host/a", 1000));
+        auto full = load(cache, "http://host/a", 0);
+        ASSERT_TRUE(full);
+        EXPECT_DOUBLE_EQ(full->pixelSize.width, 2000);
+
+        // The full size image replaced the smaller one
+        EXPECT_EQ(cachedImage(cache, "http://host/a", 300), full);
+        EXPECT_EQ(statistics(cache).memoryBytes, full->byteCost);
+        EXPECT_EQ(backend.decodedSizes(), (std::vector<size_t>{512, 0}));
+    }
+
+    TEST(ImageCache, EvictsLeastRecentlyUsed)
+    {
+        FakeBackend backend;
+        backend.resources["http://host/a"] = "64x64";
+        backend.resources["http://host/b"] = "64x64";
+        backend.resources["http://host/c"] = "64x64";
+        auto cache = std::make_shared<ImageCache>(backend.configuration(2 * 64 * 64 * 4));
+
+        ASSERT_TRUE(load(cache, "http://host/a", 0));
+        ASSERT_TRUE(load(cache, "http://host/b", 0));
+        ASSERT_TRUE(cachedImage(cache, "http://host/a", 0));
+        ASSERT_TRUE(load(cache, "http://host/c", 0));
+
+        EXPECT_TRUE(cachedImage(cache, "http://host/a", 0));
+        EXPECT_FALSE(cachedImage(cache, "http://host/b", 0));
+        EXPECT_TRUE(cachedImage(cache, "http://host/c", 0));
+        EXPECT_EQ(statistics(cache).memoryBytes, 2U * 64 * 64 * 4);
+    }
+
+    TEST(ImageCache, DiskTier)
+    {
+        char directoryTemplate[] = "/tmp/bdnImageCacheXXXXXX";
+        ASSERT_NE(::mkdtemp(directoryTemplate), nullptr);
+        String directory = directoryTemplate;
+
+        FakeBackend backend;
+        backend.resources["http://host/a"] = "64x64";
+        backend.resources["http://host/b"] = "64x64";
+        backend.resources["http://host/c"] = "32x32";
+
+        auto configuration = backend.configuration();
+        configuration.diskDirectory = directory;
+
+        {
+            auto cache = std::make_shared<ImageCache>(configuration);
+            ASSERT_TRUE(load(cache, "http://host/a", 0));
+            ASSERT_TRUE(load(cache, "http://host/b", 0));
+            ASSERT_TRUE(load(cache, "http://host/c", 0));
+        }
+        EXPECT_EQ(backend.fetchCount(), 3U);
+
+        // a and b have the same contents
+        EXPECT_EQ(countFiles(directory + "/objects"), 2U);
+
+        // The writes were only journaled, the index is written when the journal is folded into it
+        EXPECT_EQ(::access((directory + "/index").c_str(), F_OK), -1);
+        EXPECT_EQ(::access((directory + "/journal").c_str(), F_OK), 0);
+
+        auto cache = std::make_shared<ImageCache>(configuration);
+        auto image = load(cache, "http://host/b", 0);
+        ASSERT_TRUE(image);
+        EXPECT_DOUBLE_EQ(image->originalSize.width, 64);
+
+        auto stats = statistics(cache);
+        EXPECT_EQ(stats.diskHits, 1U);
+        EXPECT_EQ(stats.fetches, 0U);
+        EXPECT_EQ(backend.fetchCount(), 3U);
+
+        cache.reset();
+        EXPECT_EQ(::access((directory + "/index").c_str(), F_OK), 0);
+
+        removeDirectory(directory);
+    }
+
+    TEST(ImageCache, FileUrls)
+    {
+        char path[] = "/tmp/bdnImageCacheFileXXXXXX";
+        int fd = ::mkstemp(path);
+        ASSERT_NE(fd, -1);
+        ASSERT_EQ(::write(fd, "16x8", 4), 4);
+        ::close(fd);
+
+        FakeBackend backend;
+        auto cache = std::make_shared<ImageCache>(backend.configuration());
+
+        auto image = load(cache, String("file://") + path, 0);
+        ASSERT_TRUE(image);
+        EXPECT_DOUBLE_EQ(image->originalSize.height, 8);
+        EXPECT_EQ(backend.fetchCount(), 0U);
+
+        ::unlink(path);
+    }
+
+    TEST(ImageCache, FailuresAndCancellation)
+    {
+        FakeBackend backend;
+        backend.resources["http://host/broken"] = "not an image";
+        backend.resources["http://host/a"] = "64x64";
+        auto cache = std::make_shared<ImageCache>(backend.configuration());
+
+        EXPECT_FALSE(load(cache, "http://host/missing", 0));
+        EXPECT_FALSE(load(cache, "http://host/broken", 0));
+
+        bool cancelledHandlerCalled = false;
+        std::promise<ImagePtr> promise;
+        onMain([&]() {
+            auto id = cache->load("http://host/a", 0, [&](ImagePtr) { cancelledHandlerCalled = true; });
+            cache->cancel(id);
+            cache->load("http://host/a", 0, [&promise](ImagePtr image) { promise.set_value(image); });
+        });
+
+        // The first fetch was aborted when its only load was cancelled
+        EXPECT_TRUE(promise.get_future().get());
+        EXPECT_EQ(backend.fetchCount(), 4U);
+        EXPECT_EQ(statistics(cache).cancelledFetches, 1U);
+        onMain([&]() { EXPECT_FALSE(cancelledHandlerCalled); });
+    }
+
+    TEST(ImageCache, SchedulesFetchesByPriority)
+    {
+        FakeBackend backend;
+        backend.setManualCompletion(true);
+        for (auto name : {"a", "b", "c", "d", "e"}) {
+            backend.resources[String("http://host/") + name] = "64x64";
+        }
+
+        auto configuration = backend.configuration();
+        configuration.maxConcurrentFetches = 1;
+        auto cache = std::make_shared<ImageCache>(configuration);
+
+        std::promise<ImagePtr> a;
+        std::promise<ImagePtr> c;
+        ImageCache::LoadId cLoad = 0;
+        ImageCache::LoadId e = 0;
+        onMain([&]() {
+            cache->load("http://host/a", 0, [&a](ImagePtr image) { a.set_value(image); });
+            cache->prefetch("http://host/b", 0);
+            cLoad = cache->load(
+                "http://host/c", 0, [&c](ImagePtr image) { c.set_value(image); }, ImageCache::Priority::Prefetch);
+            auto d = cache->prefetch("http://host/d", 0);
+            e = cache->prefetch("http://host/e", 0);
+
+            // d is dropped before it was fetched, e becomes visible
+            cache->cancel(d);
+            cache->setPriority(e, ImageCache::Priority::Visible);
+        });
+        EXPECT_EQ(backend.startedFetches(), (std::vector<String>{"http://host/a"}));
+
+        backend.complete("http://host/a");
+        EXPECT_TRUE(a.get_future().get());
+
+        // e was raised to visible and overtook b and c
+        EXPECT_EQ(backend.startedFetches(), (std::vector<String>{"http://host/a", "http://host/e"}));
+
+        // Raising c while e is running does not exceed the fetch limit
+        onMain([&]() { cache->setPriority(cLoad, ImageCache::Priority::Visible); });
+        EXPECT_EQ(backend.startedFetches(), (std::vector<String>{"http://host/a", "http://host/e"}));
+
+        // Cancelling the only load of a running fetch aborts it, c now goes before b
+        onMain([&]() { cache->cancel(e); });
+        EXPECT_EQ(backend.abortedFetches(), (std::vector<String>{"http://host/e"}));
+        EXPECT_EQ(backend.startedFetches(), (std::vector<String>{"http://host/a", "http://host/e", "http://host/c"}));
+
+        backend.complete("http://host/c");
+        EXPECT_TRUE(c.get_future().get());
+        EXPECT_EQ(backend.startedFetches(),
+                  (std::vector<String>{"http://host/a", "http://host/e", "http://host/c", "http://host/b"}));
+
+        backend.complete("http://host/b");
+        onMain([&]() {});
+        onMain([&]() {});
+
+        auto stats = statistics(cache);
+        EXPECT_EQ(stats.fetches, 4U);
+        EXPECT_EQ(stats.cancelledFetches, 1U);
+    }
+}
@@ -0,0 +1,195 @@
+#include <bdn/Application.h>
+#include <bdn/DispatchQueue.h>
+#include <bdn/net/JsonStream.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace bdn
+{
+    using namespace bdn::net;
+
+    namespace
+    {
+        struct Post
+        {
+            String title;
+            std::optional<int> score;
+            double ratio = 0;
+            bool over18 = true;
+            String firstTag;
+        };
+
+        JsonStream<Post> postStream()
+        {
+            JsonStream<Post> stream("/data/children/*/data");
+            stream.field("/title", &Post::title)
+                .field("/score", &Post::score)
+                .field("/ratio", &Post::ratio)
+                .field("/over_18", &Post::over18)
+                .field("/tags/0", &Post::firstTag);
+            return stream;
+        }
+
+        template <class Record> struct Result
+        {
+            std::vector<std::vector<Record>> batches;
+            std::shared_ptr<HTTPResponse> response;
+            std::optional<String> parseError;
+        };
+
+        // Passes body to the prepared request in pieces of pieceSize bytes, as a backend would
+        template <class Record>
+        Result<Record> stream(const JsonStream<Record> &jsonStream, const std::string &body, size_t pieceSize)
+        {
+            auto result = std::make_shared<Result<Record>>();
+            std::promise<void> done;
+            auto request = jsonStream.prepare(
+                HTTPRequest("http://localhost/feed.json", nullptr),
+                [result](std::vector<Record> batch) { result->batches.push_back(std::move(batch)); },
+                [result, &done](std::shared_ptr<HTTPResponse> response, std::optional<String> parseError) {
+                    result->response = std::move(response);
+                    result->parseError = std::move(parseError);
+                    done.set_value();
+                });
+
+            for (size_t offset = 0; offset < body.size(); offset += pieceSize) {
+                auto size = std::min(pieceSize, body.size() - offset);
+                request.dataHandler(asBytes(body.data() + offset, size));
+            }
+
+            auto response = std::make_shared<HTTPResponse>();
+            response->responseCode = 200;
+            App()->dispatchQueue()->dispatchAsync([request, response]() { request.doneHandler(response); });
+
+            done.get_future().wait();
+            return *result;
+        }
+
+        const std::string kFeed = R"({
+            "kind": "Listing",
+            "data": {
+                "after": "t3_abc",
+                "children": [
+                    {"kind": "t3", "data": {"title": "First", "score": 42, "ratio": 0.5, "over_18": false,
+                                            "tags": ["news", "world"], "nested": {"title": "ignored"}}},
+                    {"kind": "t3", "data": {"title": "Second \"quoted\"", "score": null, "ratio": 1,
+                                            "over_18": "yes", "tags": []}},
+                    {"kind": "t3", "data": {"title": 3, "score": 7.9, "ratio": -2.5e3}},
+                    {"kind": "t1", "data": {"title": "Fourth", "tags": ["a"]}}
+                ]
+            }
+        })";
+    }
+
+    TEST(JsonStream, ExtractsSelectedFieldsInBatches)
+    {
+        for (size_t pieceSize : {size_t(1), size_t(13), kFeed.size()}) {
+            auto result = stream(postStream().batchSize(3), kFeed, pieceSize);
+
+            EXPECT_EQ(result.parseError, std::nullopt);
+            EXPECT_EQ(result.response->responseCode, 200);
+            ASSERT_EQ(result.batches.size(), 2u);
+            ASSERT_EQ(result.batches[0].size(), 3u);
+            ASSERT_EQ(result.batches[1].size(), 1u);
+
+            auto &first = result.batches[0][0];
+            EXPECT_EQ(first.title, "First");
+            EXPECT_EQ(first.score, 42);
+            EXPECT_EQ(first.ratio, 0.5);
+            EXPECT_FALSE(first.over18);
+            EXPECT_EQ(first.firstTag, "news");
+
+            // Null resets optionals, values of other types are ignored
+            auto &second = result.batches[0][1];
+            EXPECT_EQ(second.title, "Second \"quoted\"");
+            EXPECT_EQ(second.score, std::nullopt);
+            EXPECT_EQ(second.ratio, 1.0);
+            EXPECT_TRUE(second.over18);
+            EXPECT_EQ(second.firstTag, "");
+
+            auto &third = result.batches[0][2];
+            EXPECT_EQ(third.title, "");
+            EXPECT_EQ(third.score, 7);
+            EXPECT_EQ(third.ratio, -2500.0);
+
+            EXPECT_EQ(result.batches[1][0].title, "Fourth");
+        }
+    }
+
+    TEST(JsonStream, MatchesWildcardsIndicesAndEscapedKeys)
+    {
+        struct Entry
+        {
+            String name;
+            int64_t size = 0;
+        };
+
+        const std::string document =
+            R"({"files": {"a/b": {"name": "slash", "size": 1}, "c~d": {"name": "tilde", "size": 2}},
+                "list": [{"name": "zero"}, {"name": "one"}], "names": ["x", "y"]})";
+
+        JsonStream<Entry> members("/files/*");
+        members.field("/name", &Entry::name).field("/size", &Entry::size);
+        auto result = stream(members, document, 5);
+        ASSERT_EQ(result.batches.size(), 1u);
+        ASSERT_EQ(result.batches[0].size(), 2u);
+        EXPECT_EQ(result.batches[0][1].name, "tilde");
+        EXPECT_EQ(result.batches[0][1].size, 2);
+
+        JsonStream<Entry> escaped("/files/a~1b");
+        escaped.field("/name", &Entry::name);
+        result = stream(escaped, document, 5);
+        ASSERT_EQ(result.batches.size(), 1u);
+        EXPECT_EQ(result.batches[0][0].name, "slash");
+
+        JsonStream<Entry> index("/list/1");
+        index.field("/name", &Entry::name);
+        result = stream(index, document, 5);
+        ASSERT_EQ(result.batches.size(), 1u);
+        EXPECT_EQ(result.batches[0][0].name, "one");
+
+        // The empty pointer is the record itself
+        JsonStream<Entry> scalars("/names/*");
+        scalars.field("", &Entry::name);
+        result = stream(scalars, document, 5);
+        ASSERT_EQ(result.batches.size(), 1u);
+        ASSERT_EQ(result.batches[0].size(), 2u);
+        EXPECT_EQ(result.batches[0][1].name, "y");
+
+        EXPECT_THROW(JsonStream<Entry>("files").prepare(HTTPRequest(), nullptr, nullptr), std::invalid_argument);
+    }
+
+    TEST(JsonStream, ReportsParseErrors)
+    {
+        auto truncated = stream(postStream().batchSize(1), kFeed.substr(0, kFeed.find("Second")), 10);
+        ASSERT_TRUE(truncated.parseError.has_value());
+        EXPECT_EQ(truncated.response->responseCode, 200);
+        ASSERT_EQ(truncated.batches.size(), 1u);
+        EXPECT_EQ(truncated.batches[0][0].title, "First");
+
+        EXPECT_TRUE(stream(postStream(), "", 1).parseError.has_value());
+        EXPECT_TRUE(stream(postStream(), "{} {}", 1).parseError.has_value());
+    }
+
+    TEST(JsonStream, CancelledRequestsAreNotReported)
+    {
+        auto calls = std::make_shared<std::atomic<int>>(0);
+        {
+            auto request = postStream().batchSize(1).prepare(
+                HTTPRequest("http://localhost/feed.json", nullptr), [calls](auto) { (*calls)++; },
+                [calls](auto, auto) { (*calls)++; });
+
+            // Ends within the first record, so that no batch can be delivered before the request is dropped
+            request.dataHandler(asBytes(kFeed.data(), kFeed.find("First")));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        App()->dispatchQueue()->dispatchSync([]() {});
+        EXPECT_EQ(*calls, 0);
+    }
+}
@@ -0,0 +1,140 @@
+#include <bdn/ui/ListViewDiff.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <future>
+#include <numeric>
+#include <random>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+
+    namespace
+    {
+        using RowId = ListViewDataSource::RowId;
+
+        ListViewDiff::Snapshot snapshot(const std::vector<RowId> &ids)
+        {
+            ListViewDiff::Snapshot result;
+            for (auto id : ids) {
+                result.push_back(ListViewDiff::Row{id, 0});
+            }
+            return result;
+        }
+
+        // Applies changes the way NSTableView does: deletes, then moves one at a time, then inserts.
+        std::vector<RowId> applySequentially(std::vector<RowId> rows, const ListViewChanges &changes,
+                                             const std::vector<RowId> &after)
+        {
+            auto moves = changes.sequentialMoves(rows.size());
+
+            auto deletes = changes.deletes;
+            std::sort(deletes.rbegin(), deletes.rend());
+            for (auto index : deletes) {
+                rows.erase(rows.begin() + index);
+            }
+
+            for (auto &move : moves) {
+                auto id = rows[move.from];
+                rows.erase(rows.begin() + move.from);
+                rows.insert(rows.begin() + move.to, id);
+            }
+
+            auto inserts = changes.inserts;
+            std::sort(inserts.begin(), inserts.end());
+            for (auto index : inserts) {
+                rows.insert(rows.begin() + index, after[index]);
+            }
+
+            return rows;
+        }
+
+        void expectValid(const std::vector<RowId> &before, const std::vector<RowId> &after)
+        {
+            auto changes = ListViewDiff::calculate(snapshot(before), snapshot(after));
+
+            ASSERT_EQ(changes.newRowCount(before.size()), after.size());
+
+            auto mapping = changes.indexMapping(before.size());
+            for (size_t i = 0; i < before.size(); i++) {
+                if (mapping[i]) {
+                    EXPECT_EQ(after[*mapping[i]], before[i]);
+                }
+            }
+
+            EXPECT_EQ(applySequentially(before, changes, after), after);
+        }
+    }
+
+    TEST(ListViewDiff, InsertAndDelete)
+    {
+        auto changes = ListViewDiff::calculate(snapshot({1, 2, 3, 4}), snapshot({0, 1, 3, 4, 5}));
+
+        EXPECT_EQ(changes.inserts, (std::vector<size_t>{0, 4}));
+        EXPECT_EQ(changes.deletes, (std::vector<size_t>{1}));
+        EXPECT_TRUE(changes.moves.empty());
+        EXPECT_TRUE(changes.updates.empty());
+    }
+
+    TEST(ListViewDiff, MovesAreMinimal)
+    {
+        auto changes = ListViewDiff::calculate(snapshot({1, 2, 3, 4, 5}), snapshot({2, 3, 4, 5, 1}));
+
+        EXPECT_TRUE(changes.inserts.empty());
+        EXPECT_TRUE(changes.deletes.empty());
+        EXPECT_EQ(changes.moves, (std::vector<ListViewChanges::Move>{{0, 4}}));
+        EXPECT_EQ(changes.sequentialMoves(5), (std::vector<ListViewChanges::Move>{{0, 4}}));
+    }
+
+    TEST(ListViewDiff, Updates)
+    {
+        ListViewDiff::Snapshot before{{1, 0}, {2, 0}, {3, 0}};
+        ListViewDiff::Snapshot after{{3, 1}, {1, 0}, {2, 7}};
+
+        auto changes = ListViewDiff::calculate(before, after);
+
+        EXPECT_EQ(changes.updates, (std::vector<size_t>{0, 2}));
+        EXPECT_EQ(changes.moves.size(), 1U);
+    }
+
+    TEST(ListViewDiff, ChangesCanBeApplied)
+    {
+        expectValid({}, {1, 2, 3});
+        expectValid({1, 2, 3}, {});
+        expectValid({3, 2, 1}, {1, 2, 3});
+        expectValid({1, 2, 3, 4, 5, 6}, {6, 5, 1, 7, 3, 2});
+
+        // Duplicate ids are deleted and reinserted
+        expectValid({1, 1, 2}, {2, 1, 1});
+
+        std::mt19937 random(42);
+        for (int run = 0; run < 50; run++) {
+            std::vector<RowId> before(100);
+            std::iota(before.begin(), before.end(), 0);
+
+            auto after = before;
+            std::shuffle(after.begin() + 10, after.begin() + 30, random);
+            after.erase(after.begin() + static_cast<ptrdiff_t>(random() % after.size()));
+            after.insert(after.begin() + static_cast<ptrdiff_t>(random() % after.size()), 1000 + run);
+
+            expectValid(before, after);
+        }
+    }
+
+    TEST(ListViewDiff, CalculateAsync)
+    {
+        auto diff = std::make_shared<ListViewDiff>();
+
+        std::promise<ListViewChanges> promise;
+        diff->calculateAsync(snapshot({1, 2}), snapshot({2, 3}),
+                             [&promise](ListViewChanges changes) { promise.set_value(std::move(changes)); });
+
+        auto future = promise.get_future();
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+        auto changes = future.get();
+        EXPECT_EQ(changes.deletes, (std::vector<size_t>{0}));
+        EXPECT_EQ(changes.inserts, (std::vector<size_t>{1}));
+    }
+}
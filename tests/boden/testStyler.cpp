@@ -1,3 +1,4 @@
+#include <bdn/Application.h>
 #include <bdn/ui/ContainerView.h>
 #include <bdn/ui/Styler.h>
 #include <gtest/gtest.h>
@@ -41,16 +42,51 @@ namespace bdn
 
     TEST(Styler, ConditionEqualUpdate)
     {
+        // Condition changes are applied on the main queue
+        App()->dispatchQueue()->dispatchSync([]() {
+            auto view = std::make_shared<ContainerView>();
+            Styler styler;
+            styler.setCondition("test", std::make_shared<Styler::equals_condition>(42));
+
+            styler.setStyleSheet(view, JsonStringify([ {"if" : {"test" : 10}, "test" : 1} ]));
+            EXPECT_EQ(view->stylesheet->count("test"), 0);
+
+            styler.setCondition("test", std::make_shared<Styler::equals_condition>(10));
+            styler.flush();
+            EXPECT_EQ(view->stylesheet->count("test"), 1);
+            EXPECT_EQ(view->stylesheet->at("test"), 1);
+        });
+    }
+
+    TEST(Styler, ConditionUpdatesAreDeferred)
+    {
+        auto styler = std::make_shared<Styler>();
         auto view = std::make_shared<ContainerView>();
-        Styler styler;
-        styler.setCondition("test", std::make_shared<Styler::equals_condition>(42));
+        int changes = 0;
 
-        styler.setStyleSheet(view, JsonStringify([ {"if" : {"test" : 10}, "test" : 1} ]));
-        EXPECT_EQ(view->stylesheet->count("test"), 0);
+        App()->dispatchQueue()->dispatchSync([&]() {
+            styler->setCondition("orientation", std::make_shared<Styler::equals_condition>("portrait"));
+            styler->setCondition("dark", std::make_shared<Styler::equals_condition>(false));
+            styler->setStyleSheet(view, JsonStringify([
+                {"if" : {"orientation" : "landscape"}, "landscape" : true},
+                {"if" : {"dark" : true}, "dark" : true}
+            ]));
+            view->stylesheet.onChange() += [&](auto & /*unused*/) { changes++; };
 
-        styler.setCondition("test", std::make_shared<Styler::equals_condition>(10));
-        EXPECT_EQ(view->stylesheet->count("test"), 1);
-        EXPECT_EQ(view->stylesheet->at("test"), 1);
+            styler->setCondition("orientation", std::make_shared<Styler::equals_condition>("landscape"));
+            styler->setCondition("dark", std::make_shared<Styler::equals_condition>(true));
+            EXPECT_EQ(changes, 0);
+        });
+
+        // Wait for the scheduled rematch pass
+        App()->dispatchQueue()->dispatchSync([&]() {
+            EXPECT_EQ(changes, 1);
+            EXPECT_EQ(view->stylesheet->at("landscape"), true);
+            EXPECT_EQ(view->stylesheet->at("dark"), true);
+
+            styler.reset();
+            view.reset();
+        });
     }
 
     TEST(Styler, CombineIf)
@@ -63,4 +99,58 @@ namespace bdn
         EXPECT_EQ(view->stylesheet->at("test"), 1);
         EXPECT_EQ(view->stylesheet->at("hello"), "world");
     }
+
+    TEST(Styler, ConditionUpdateOnlyTouchesDependentViews)
+    {
+        App()->dispatchQueue()->dispatchSync([]() {
+            Styler styler;
+            styler.setCondition("width", std::make_shared<Styler::less_condition>(300));
+            styler.setCondition("dark", std::make_shared<Styler::equals_condition>(false));
+
+            auto widthView = std::make_shared<ContainerView>();
+            auto otherWidthView = std::make_shared<ContainerView>();
+            auto darkView = std::make_shared<ContainerView>();
+
+            auto widthSheet = JsonStringify([ {"test" : 1}, {"if" : {"width" : 500}, "test" : 2} ]);
+            styler.setStyleSheet(widthView, widthSheet);
+            styler.setStyleSheet(otherWidthView, widthSheet);
+            styler.setStyleSheet(darkView, JsonStringify([ {"if" : {"dark" : true}, "test" : 3} ]));
+
+            EXPECT_EQ(widthView->stylesheet->at("test"), 1);
+            EXPECT_EQ(widthView->stylesheet.get(), otherWidthView->stylesheet.get());
+
+            int widthChanges = 0;
+            int darkChanges = 0;
+            widthView->stylesheet.onChange() += [&](auto & /*unused*/) { widthChanges++; };
+            darkView->stylesheet.onChange() += [&](auto & /*unused*/) { darkChanges++; };
+
+            styler.setCondition("width", std::make_shared<Styler::less_condition>(800));
+            styler.flush();
+            EXPECT_EQ(widthView->stylesheet->at("test"), 2);
+            EXPECT_EQ(otherWidthView->stylesheet->at("test"), 2);
+            EXPECT_EQ(widthChanges, 1);
+            EXPECT_EQ(darkChanges, 0);
+
+            // Same outcome for the predicate, nothing to do
+            styler.setCondition("width", std::make_shared<Styler::less_condition>(900));
+            styler.flush();
+            EXPECT_EQ(widthChanges, 1);
+
+            styler.setCondition("dark", std::make_shared<Styler::equals_condition>(true));
+            styler.flush();
+            EXPECT_EQ(darkView->stylesheet->at("test"), 3);
+            EXPECT_EQ(widthChanges, 1);
+            EXPECT_EQ(darkChanges, 1);
+        });
+    }
+
+    TEST(Styler, InvalidMatcher)
+    {
+        auto view = std::make_shared<ContainerView>();
+        Styler styler;
+
+        EXPECT_THROW(styler.setStyleSheet(view, JsonStringify([ {"if" : {"unknown" : 1}, "test" : 1} ])),
+                     std::runtime_error);
+        EXPECT_THROW(styler.setStyleSheet(view, JsonStringify({"test" : 1})), std::runtime_error);
+    }
 }
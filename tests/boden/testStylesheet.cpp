@@ -0,0 +1,89 @@
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/Stylesheet.h>
+#include <gtest/gtest.h>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+
+    namespace
+    {
+        int g_decodeCount = 0;
+
+        struct CountingSection
+        {
+            int value = 0;
+        };
+
+        void from_json(const json &j, CountingSection &section)
+        {
+            g_decodeCount++;
+            section.value = j.get<int>();
+        }
+    }
+
+    TEST(Stylesheet, EqualContentIsShared)
+    {
+        Stylesheet a = JsonStringify({"test" : 1, "hello" : "world"});
+        Stylesheet b = JsonStringify({"hello" : "world", "test" : 1});
+        Stylesheet c = JsonStringify({"test" : 2});
+
+        EXPECT_EQ(a, b);
+        EXPECT_NE(a, c);
+        EXPECT_EQ(a.hash(), b.hash());
+        EXPECT_EQ(&a.toJson(), &b.toJson());
+    }
+
+    TEST(Stylesheet, JsonRoundTrip)
+    {
+        json value = JsonStringify({"test" : 1, "nested" : {"a" : [ 1, 2, 3 ]}});
+        Stylesheet stylesheet = value;
+
+        EXPECT_EQ(stylesheet.toJson(), value);
+        EXPECT_EQ(stylesheet->at("test"), 1);
+        EXPECT_EQ(Stylesheet(), Stylesheet(json()));
+        EXPECT_TRUE(Stylesheet().toJson().is_null());
+    }
+
+    TEST(Stylesheet, SectionIsDecodedOnce)
+    {
+        g_decodeCount = 0;
+
+        Stylesheet a = JsonStringify({"counting" : 42});
+        Stylesheet b = JsonStringify({"counting" : 42});
+
+        auto first = a.section<CountingSection>("counting");
+        auto second = b.section<CountingSection>("counting");
+
+        ASSERT_NE(first, nullptr);
+        EXPECT_EQ(first->value, 42);
+        EXPECT_EQ(first, second);
+        EXPECT_EQ(g_decodeCount, 1);
+
+        EXPECT_EQ(a.section<CountingSection>("missing"), nullptr);
+    }
+
+    TEST(Stylesheet, UnusedStylesheetsAreReleased)
+    {
+        auto before = Stylesheet::internedCount();
+        {
+            Stylesheet temporary = JsonStringify({"unique-test-key" : "UnusedStylesheetsAreReleased"});
+            EXPECT_EQ(Stylesheet::internedCount(), before + 1);
+        }
+        EXPECT_EQ(Stylesheet::internedCount(), before);
+    }
+
+    TEST(Stylesheet, AssigningEqualContentDoesNotNotify)
+    {
+        auto view = std::make_shared<ContainerView>();
+        int changes = 0;
+        view->stylesheet.onChange() += [&](auto & /*unused*/) { changes++; };
+
+        view->stylesheet = JsonStringify({"test" : 1});
+        view->stylesheet = JsonStringify({"test" : 1});
+        EXPECT_EQ(changes, 1);
+
+        view->stylesheet = JsonStringify({"test" : 2});
+        EXPECT_EQ(changes, 2);
+    }
+}
@@ -0,0 +1,154 @@
+#include "FakeContainerCore.h"
+#include <bdn/ui/ContainerView.h>
+#include <bdn/ui/Label.h>
+#include <bdn/ui/ViewCoreFactory.h>
+#include <gtest/gtest.h>
+
+namespace bdn
+{
+    using namespace bdn::ui;
+
+    namespace
+    {
+        using TestCore = FakeContainerCore;
+
+        class OtherTestCore : public TestCore
+        {
+          public:
+            using TestCore::TestCore;
+        };
+
+        class ReusableTestCore : public TestCore
+        {
+          public:
+            using TestCore::TestCore;
+
+            bool prepareForReuse() override
+            {
+                resetViewCore();
+                resetCount++;
+                return true;
+            }
+
+            int resetCount = 0;
+        };
+    }
+
+    TEST(ViewCoreFactory, CreatesRegisteredType)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+        factory->registerCoreType<TestCore, ContainerView>();
+
+        for (int i = 0; i < 3; i++) {
+            auto core = std::dynamic_pointer_cast<TestCore>(factory->createViewCore(typeid(ContainerView)));
+            ASSERT_NE(core, nullptr);
+            EXPECT_TRUE(core->initialized);
+        }
+    }
+
+    TEST(ViewCoreFactory, FirstRegistrationWins)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+        factory->registerCoreType<TestCore, ContainerView>();
+        factory->registerCoreType<OtherTestCore, ContainerView>();
+
+        auto core = factory->createViewCore(typeid(ContainerView));
+        EXPECT_EQ(std::dynamic_pointer_cast<OtherTestCore>(core), nullptr);
+    }
+
+    TEST(ViewCoreFactory, NameRegistration)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+
+        int calls = 0;
+        auto construct = [&calls](const std::shared_ptr<ViewCoreFactory> &f) -> std::shared_ptr<View::Core> {
+            calls++;
+            return std::make_shared<OtherTestCore>(f);
+        };
+        factory->registerConstruction(typeid(Label).name(), construct);
+
+        EXPECT_NE(std::dynamic_pointer_cast<OtherTestCore>(factory->createViewCore(typeid(Label))), nullptr);
+        EXPECT_NE(std::dynamic_pointer_cast<OtherTestCore>(factory->createViewCore(typeid(Label))), nullptr);
+        EXPECT_EQ(calls, 2);
+    }
+
+    TEST(ViewCoreFactory, UnsupportedType)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+        EXPECT_THROW(factory->createViewCore(typeid(ContainerView)), ViewCoreTypeNotSupportedError);
+    }
+
+    TEST(ViewCoreFactory, PoolReusesCores)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+        factory->registerCoreType<ReusableTestCore, ContainerView>();
+
+        auto view = std::make_shared<ContainerView>(factory);
+        view->geometry = Rect{1, 2, 3, 4};
+        auto core = view->core<ReusableTestCore>();
+        auto *corePtr = core.get();
+        core = nullptr;
+        view = nullptr;
+
+        auto statistics = factory->poolStatistics<ContainerView>();
+        EXPECT_EQ(statistics.misses, 1U);
+        EXPECT_EQ(statistics.parked, 1U);
+
+        view = std::make_shared<ContainerView>(factory);
+        core = view->core<ReusableTestCore>();
+        EXPECT_EQ(core.get(), corePtr);
+        EXPECT_EQ(core->resetCount, 1);
+        EXPECT_EQ(core->geometry->width, 0.0);
+
+        statistics = factory->poolStatistics<ContainerView>();
+        EXPECT_EQ(statistics.hits, 1U);
+        EXPECT_EQ(statistics.parked, 0U);
+
+        // The reclaimed core is bound to the new view
+        view->geometry = Rect{0, 0, 10, 10};
+        EXPECT_EQ(core->geometry->width, 10.0);
+    }
+
+    TEST(ViewCoreFactory, PoolSize)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+        factory->registerCoreType<ReusableTestCore, ContainerView>();
+        factory->setPoolSize<ContainerView>(2);
+
+        std::vector<std::shared_ptr<ContainerView>> views;
+        for (int i = 0; i < 5; i++) {
+            views.push_back(std::make_shared<ContainerView>(factory));
+            views.back()->viewCore();
+        }
+        views.clear();
+
+        EXPECT_EQ(factory->poolStatistics<ContainerView>().parked, 2U);
+
+        factory->setPoolSize<ContainerView>(1);
+        EXPECT_EQ(factory->poolStatistics<ContainerView>().parked, 1U);
+
+        factory->drainPools();
+        EXPECT_EQ(factory->poolStatistics<ContainerView>().parked, 0U);
+
+        factory->setPoolSize<ContainerView>(0);
+        std::make_shared<ContainerView>(factory)->viewCore();
+        EXPECT_EQ(factory->poolStatistics<ContainerView>().parked, 0U);
+    }
+
+    TEST(ViewCoreFactory, PoolSkipsUnsupportedAndSharedCores)
+    {
+        auto factory = std::make_shared<ViewCoreFactory>();
+        factory->registerCoreType<TestCore, ContainerView>();
+
+        std::make_shared<ContainerView>(factory)->viewCore();
+        EXPECT_EQ(factory->poolStatistics<ContainerView>().parked, 0U);
+
+        auto reusableFactory = std::make_shared<ViewCoreFactory>();
+        reusableFactory->registerCoreType<ReusableTestCore, ContainerView>();
+
+        auto view = std::make_shared<ContainerView>(reusableFactory);
+        auto stillInUse = view->viewCore();
+        view = nullptr;
+        EXPECT_EQ(reusableFactory->poolStatistics<ContainerView>().parked, 0U);
+    }
+}
@@ -0,0 +1,145 @@
+// bdn/jni.h only provides JNI on Android, so the fake declarations are included directly
+#include <bdn/fake_jni/jni.h>
+
+#include <bdn/java/wrapper/ByteBuffer.h>
+#include <bdn/net/android/VolleyResponse.h>
+#include <gtest/gtest.h>
+
+#include <map>
+
+namespace bdn
+{
+    using namespace bdn::net;
+
+    namespace
+    {
+        // Stands in for the JVM: jstrings point to FakeString instances, ByteBuffers to FakeBuffer instances
+        struct FakeString : _jstring
+        {
+            std::string utf;
+        };
+
+        struct FakeBuffer : _jobject
+        {
+            // Null for indirect buffers, which are backed by a Java array
+            void *address = nullptr;
+            jlong capacity = -1;
+        };
+
+        std::map<const char *, int> pinnedStrings;
+
+        class FakeEnv
+        {
+          public:
+            FakeEnv()
+            {
+                _functions.GetStringUTFChars = [](JNIEnv *, jstring string, jboolean *isCopy) -> const char * {
+                    if (isCopy != nullptr) {
+                        *isCopy = 0;
+                    }
+                    auto chars = static_cast<FakeString *>(string)->utf.c_str();
+                    pinnedStrings[chars]++;
+                    return chars;
+                };
+                _functions.ReleaseStringUTFChars = [](JNIEnv *, jstring, const char *chars) {
+                    pinnedStrings[chars]--;
+                };
+                _functions.GetDirectBufferAddress = [](JNIEnv *, jobject buffer) -> void * {
+                    return static_cast<FakeBuffer *>(buffer)->address;
+                };
+                _functions.GetDirectBufferCapacity = [](JNIEnv *, jobject buffer) -> jlong {
+                    auto fakeBuffer = static_cast<FakeBuffer *>(buffer);
+                    return fakeBuffer->address != nullptr ? fakeBuffer->capacity : -1;
+                };
+                _env.functions = &_functions;
+            }
+
+            JNIEnv *get() { return &_env; }
+
+          private:
+            JNINativeInterface _functions{};
+            JNIEnv _env{};
+        };
+
+        FakeBuffer directBuffer(std::string &body)
+        {
+            FakeBuffer buffer;
+            buffer.address = body.data();
+            buffer.capacity = static_cast<jlong>(body.size());
+            return buffer;
+        }
+
+        // Passes buffer on the way VolleyAdapter.handleResponse() does
+        void handleResponse(JNIEnv *env, HTTPResponse &response, jint statusCode, jobject buffer, jstring headers)
+        {
+            http::android::fillResponse(env, response, statusCode, java::wrapper::ByteBuffer::getBytes_(env, buffer),
+                                        headers);
+        }
+
+        std::string binaryBody()
+        {
+            std::string body;
+            for (int i = 0; i < 1024; i++) {
+                body += static_cast<char>(i % 256);
+            }
+            return body;
+        }
+    }
+
+    TEST(VolleyResponse, BinaryBodyArrivesUnchanged)
+    {
+        FakeEnv env;
+        auto body = binaryBody();
+        auto buffer = directBuffer(body);
+        FakeString headers;
+        headers.utf = "Content-Type: application/octet-stream\r\n";
+
+        HTTPResponse response;
+        handleResponse(env.get(), response, 200, &buffer, &headers);
+
+        EXPECT_EQ(response.responseCode, 200);
+        EXPECT_EQ(response.data, body);
+        EXPECT_EQ(response.header.toString(), headers.utf);
+        EXPECT_EQ(response.header.get("content-type"), "application/octet-stream");
+        EXPECT_EQ(pinnedStrings[headers.utf.c_str()], 0);
+    }
+
+    TEST(VolleyResponse, DataHandlerSeesBufferWithoutCopy)
+    {
+        FakeEnv env;
+        auto body = binaryBody();
+        auto buffer = directBuffer(body);
+
+        std::vector<ByteSpan> chunks;
+        HTTPResponse response;
+        response.originalRequest.dataHandler = [&](ByteSpan chunk) { chunks.push_back(chunk); };
+        handleResponse(env.get(), response, 200, &buffer, nullptr);
+
+        ASSERT_EQ(chunks.size(), 1u);
+        EXPECT_EQ(static_cast<const void *>(chunks[0].data()), static_cast<const void *>(body.data()));
+        EXPECT_EQ(chunks[0].size(), body.size());
+        EXPECT_EQ(response.metrics.bytesReceived, body.size());
+        EXPECT_TRUE(response.data.empty());
+        EXPECT_TRUE(response.header.empty());
+    }
+
+    TEST(VolleyResponse, EmptyBodies)
+    {
+        FakeEnv env;
+
+        HTTPResponse response;
+        handleResponse(env.get(), response, 0, nullptr, nullptr);
+        EXPECT_EQ(response.responseCode, 0);
+        EXPECT_TRUE(response.data.empty());
+        EXPECT_EQ(response.metrics.bytesReceived, 0u);
+
+        // Indirect buffers have no address to read from, so they count as empty as well
+        FakeBuffer indirectBuffer;
+        bool dataHandlerCalled = false;
+        response.originalRequest.dataHandler = [&](ByteSpan) { dataHandlerCalled = true; };
+        handleResponse(env.get(), response, 404, &indirectBuffer, nullptr);
+        EXPECT_EQ(response.responseCode, 404);
+        EXPECT_EQ(response.metrics.bytesReceived, 0u);
+        EXPECT_FALSE(dataHandlerCalled);
+    }
+}